@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+
+# Converts the raw.bin (and the digicluster.bin, tracks.bin and
+# vertices.bin validation files, if present) binary dumps into the
+# single-file, indexed container.bin read by the Source with
+# --container. The format is described in src/cuda/bin/RawContainer.h.
+
+import os
+import struct
+import argparse
+
+MAGIC = b"PXRAWCNT"
+VERSION = 1
+HAS_VALIDATION = 1 << 0
+
+HEADER = struct.Struct("<8sIIQQQ")
+EVENT_ENTRY = struct.Struct("<QQII")
+FED_ENTRY = struct.Struct("<IIQ")
+VALIDATION_ENTRY = struct.Struct("<IIIII")
+UINT = struct.Struct("<I")
+
+def align(offset, alignment=8):
+    return (offset + alignment - 1) // alignment * alignment
+
+def readUInts(f, n):
+    data = f.read(UINT.size*n)
+    if len(data) != UINT.size*n:
+        raise Exception("Unexpected end of file in %s" % f.name)
+    return struct.unpack("<%dI" % n, data)
+
+def readRaw(f):
+    """Yields the events of raw.bin as lists of (fedId, payload)"""
+    while True:
+        data = f.read(UINT.size)
+        if len(data) == 0:
+            return
+        (nfeds,) = UINT.unpack(data)
+        feds = []
+        for i in range(nfeds):
+            (fedId, size) = readUInts(f, 2)
+            payload = f.read(size)
+            if len(payload) != size:
+                raise Exception("Unexpected end of file in %s" % f.name)
+            feds.append((fedId, payload))
+        yield feds
+
+def main(opts):
+    validationFiles = [os.path.join(opts.data, x) for x in ["digicluster.bin", "tracks.bin", "vertices.bin"]]
+    validation = not opts.noValidation and all(os.path.exists(x) for x in validationFiles)
+
+    events = []
+    validationEntries = []
+    with open(os.path.join(opts.data, "raw.bin"), "rb") as raw, open(opts.output, "wb") as out:
+        # header and tables are written at the end, when the offsets are known
+        offset = align(HEADER.size)
+        out.seek(offset)
+        for feds in readRaw(raw):
+            feds.sort(key=lambda x: x[0])
+            directory = bytearray()
+            payloads = bytearray()
+            payloadOffset = align(FED_ENTRY.size*len(feds))
+            for (fedId, payload) in feds:
+                directory += FED_ENTRY.pack(fedId, len(payload), payloadOffset + len(payloads))
+                payloads += payload
+                payloads += bytes(align(len(payload)) - len(payload))
+            directory += bytes(payloadOffset - len(directory))
+            record = directory + payloads
+            out.write(record)
+            events.append(EVENT_ENTRY.pack(offset, len(record), len(feds), 0))
+            offset += len(record)
+        if len(events) == 0:
+            raise Exception("No events in raw.bin")
+
+        if validation:
+            with open(validationFiles[0], "rb") as digiclusters, open(validationFiles[1], "rb") as tracks, open(validationFiles[2], "rb") as vertices:
+                for i in range(len(events)):
+                    (nm, nd, nc) = readUInts(digiclusters, 3)
+                    (nt,) = readUInts(tracks, 1)
+                    (nv,) = readUInts(vertices, 1)
+                    validationEntries.append(VALIDATION_ENTRY.pack(nm, nd, nc, nt, nv))
+
+        eventTableOffset = offset
+        out.write(b"".join(events))
+        offset += EVENT_ENTRY.size*len(events)
+        validationOffset = 0
+        if validation:
+            validationOffset = offset
+            out.write(b"".join(validationEntries))
+
+        out.seek(0)
+        out.write(HEADER.pack(MAGIC, VERSION, HAS_VALIDATION if validation else 0, len(events), eventTableOffset, validationOffset))
+
+    print("Wrote %d events %s validation data to %s" % (len(events), "with" if validation else "without", opts.output))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert the raw and validation binary dumps into container.bin")
+    parser.add_argument("--data", type=str, default="data",
+                        help="Path to the directory with raw.bin and the validation files (default: data)")
+    parser.add_argument("-o", "--output", type=str, default=None,
+                        help="Output file (default: container.bin in the data directory)")
+    parser.add_argument("--noValidation", action="store_true",
+                        help="Do not include the validation data")
+    opts = parser.parse_args()
+    if opts.output is None:
+        opts.output = os.path.join(opts.data, "container.bin")
+    main(opts)
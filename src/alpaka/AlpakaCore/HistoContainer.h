@@ -0,0 +1,107 @@
+#ifndef AlpakaCore_HistoContainer_h
+#define AlpakaCore_HistoContainer_h
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/prefixScan.h"
+
+namespace cms {
+  namespace Alpaka {
+
+    // Block-level port of the CUDA HistoContainer: the histogram is meant to live in the shared memory of a
+    // block, and is filled and finalized by the threads of that block only.
+    template <typename T,                  // the type of the discretized input values
+              uint32_t NBINS,              // number of bins
+              uint32_t SIZE,               // max number of element
+              uint32_t S = sizeof(T) * 8,  // number of significant bits in T
+              typename I = uint32_t,  // type stored in the container (usually an index in a vector of the input values)
+              uint32_t NHISTS = 1     // number of histos stored
+              >
+    class HistoContainer {
+    public:
+      using Counter = uint32_t;
+
+      using index_type = I;
+      using UT = typename std::make_unsigned<T>::type;
+
+      static constexpr uint32_t ilog2(uint32_t v) {
+        constexpr uint32_t b[] = {0x2, 0xC, 0xF0, 0xFF00, 0xFFFF0000};
+        constexpr uint32_t s[] = {1, 2, 4, 8, 16};
+
+        uint32_t r = 0;  // result of log2(v) will go here
+        for (auto i = 4; i >= 0; i--)
+          if (v & b[i]) {
+            v >>= s[i];
+            r |= s[i];
+          }
+        return r;
+      }
+
+      static constexpr uint32_t sizeT() { return S; }
+      static constexpr uint32_t nbins() { return NBINS; }
+      static constexpr uint32_t nhists() { return NHISTS; }
+      static constexpr uint32_t totbins() { return NHISTS * NBINS + 1; }
+      static constexpr uint32_t nbits() { return ilog2(NBINS - 1) + 1; }
+      static constexpr uint32_t capacity() { return SIZE; }
+
+      static constexpr auto histOff(uint32_t nh) { return NBINS * nh; }
+
+      static constexpr UT bin(T t) {
+        constexpr uint32_t shift = sizeT() - nbits();
+        constexpr uint32_t mask = (1 << nbits()) - 1;
+        return (t >> shift) & mask;
+      }
+
+      template <typename T_Acc>
+      ALPAKA_FN_ACC ALPAKA_FN_INLINE void zero(const T_Acc& acc) {
+        uint32_t const blockDimension(alpaka::workdiv::getWorkDiv<alpaka::Block, alpaka::Threads>(acc)[0u]);
+        uint32_t const blockThreadIdx(alpaka::idx::getIdx<alpaka::Block, alpaka::Threads>(acc)[0u]);
+        for (auto j = blockThreadIdx; j < totbins(); j += blockDimension) {
+          off[j] = 0;
+        }
+      }
+
+      template <typename T_Acc>
+      ALPAKA_FN_ACC ALPAKA_FN_INLINE void count(const T_Acc& acc, T t) {
+        uint32_t b = bin(t);
+        assert(b < nbins());
+        alpaka::atomic::atomicOp<alpaka::atomic::op::Add>(acc, &off[b], 1u, alpaka::hierarchy::Threads{});
+      }
+
+      template <typename T_Acc>
+      ALPAKA_FN_ACC ALPAKA_FN_INLINE void fill(const T_Acc& acc, T t, index_type j) {
+        uint32_t b = bin(t);
+        assert(b < nbins());
+        auto w = alpaka::atomic::atomicOp<alpaka::atomic::op::Sub>(acc, &off[b], 1u, alpaka::hierarchy::Threads{});
+        assert(w > 0);
+        bins[w - 1] = j;
+      }
+
+      template <typename T_Acc>
+      ALPAKA_FN_ACC ALPAKA_FN_INLINE void finalize(const T_Acc& acc, Counter* ws = nullptr) {
+        assert(off[totbins() - 1] == 0);
+        blockPrefixScan(acc, off, totbins(), ws);
+        assert(off[totbins() - 1] == off[totbins() - 2]);
+      }
+
+      constexpr auto size() const { return uint32_t(off[totbins() - 1]); }
+      constexpr auto size(uint32_t b) const { return off[b + 1] - off[b]; }
+
+      constexpr index_type const* begin() const { return bins; }
+      constexpr index_type const* end() const { return begin() + size(); }
+
+      constexpr index_type const* begin(uint32_t b) const { return bins + off[b]; }
+      constexpr index_type const* end(uint32_t b) const { return bins + off[b + 1]; }
+
+      Counter off[totbins()];
+      index_type bins[capacity()];
+    };
+
+  }  // namespace Alpaka
+}  // namespace cms
+
+#endif  // AlpakaCore_HistoContainer_h
@@ -0,0 +1,71 @@
+#ifndef AlpakaCore_SimpleVector_h
+#define AlpakaCore_SimpleVector_h
+
+//  author: Felice Pantaleo, CERN, 2018
+
+#include <type_traits>
+#include <utility>
+
+#include "AlpakaCore/alpakaConfig.h"
+
+namespace cms {
+  namespace Alpaka {
+
+    template <class T>
+    struct SimpleVector {
+      constexpr SimpleVector() = default;
+
+      // ownership of m_data stays within the caller
+      constexpr void construct(int capacity, T *data) {
+        m_size = 0;
+        m_capacity = capacity;
+        m_data = data;
+      }
+
+      inline constexpr int push_back_unsafe(const T &element) {
+        auto previousSize = m_size;
+        m_size++;
+        if (previousSize < m_capacity) {
+          m_data[previousSize] = element;
+          return previousSize;
+        } else {
+          --m_size;
+          return -1;
+        }
+      }
+
+      // thread-safe version of the vector, when used in a kernel
+      template <typename T_Acc>
+      ALPAKA_FN_ACC int push_back(const T_Acc &acc, const T &element) {
+        auto previousSize = alpaka::atomic::atomicOp<alpaka::atomic::op::Add>(acc, &m_size, 1);
+        if (previousSize < m_capacity) {
+          m_data[previousSize] = element;
+          return previousSize;
+        } else {
+          alpaka::atomic::atomicOp<alpaka::atomic::op::Sub>(acc, &m_size, 1);
+          return -1;
+        }
+      }
+
+      inline constexpr bool empty() const { return m_size <= 0; }
+      inline constexpr bool full() const { return m_size >= m_capacity; }
+      inline constexpr T &operator[](int i) { return m_data[i]; }
+      inline constexpr const T &operator[](int i) const { return m_data[i]; }
+      inline constexpr void reset() { m_size = 0; }
+      inline constexpr int size() const { return m_size; }
+      inline constexpr int capacity() const { return m_capacity; }
+      inline constexpr T const *data() const { return m_data; }
+      inline constexpr void resize(int size) { m_size = size; }
+      inline constexpr void set_data(T *data) { m_data = data; }
+
+    private:
+      int m_size;
+      int m_capacity;
+
+      T *m_data;
+    };
+
+  }  // namespace Alpaka
+}  // namespace cms
+
+#endif  // AlpakaCore_SimpleVector_h
@@ -0,0 +1,46 @@
+#ifndef AlpakaCore_alpakaMemoryHelper_h
+#define AlpakaCore_alpakaMemoryHelper_h
+
+#include "AlpakaCore/alpakaConfig.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  // 1D buffers and views of nElements elements of type TData
+  template <typename TData>
+  using AlpakaAccBuf1 = alpaka::mem::buf::Buf<DevAcc, TData, Dim, Idx>;
+
+  template <typename TData>
+  using AlpakaHostBuf1 = alpaka::mem::buf::Buf<DevHost, TData, Dim, Idx>;
+
+  template <typename TData>
+  using AlpakaAccView1 = alpaka::mem::view::ViewPlainPtr<DevAcc, TData, Dim, Idx>;
+
+  template <typename TData>
+  using AlpakaHostView1 = alpaka::mem::view::ViewPlainPtr<DevHost, TData, Dim, Idx>;
+
+  template <typename TData>
+  AlpakaAccBuf1<TData> allocAccBuf(DevAcc const& device, Idx nElements) {
+    return alpaka::mem::buf::alloc<TData, Idx>(device, Vec::all(nElements));
+  }
+
+  template <typename TData>
+  AlpakaHostBuf1<TData> allocHostBuf(Idx nElements) {
+    const DevHost host(alpaka::pltf::getDevByIdx<PltfHost>(0u));
+    return alpaka::mem::buf::alloc<TData, Idx>(host, Vec::all(nElements));
+  }
+
+  // wrap memory owned elsewhere, e.g. to copy it to or from the device
+  template <typename TData>
+  AlpakaHostView1<TData> createHostView(TData* data, Idx nElements) {
+    const DevHost host(alpaka::pltf::getDevByIdx<PltfHost>(0u));
+    return AlpakaHostView1<TData>(data, host, Vec::all(nElements));
+  }
+
+  template <typename TData>
+  AlpakaAccView1<TData> createAccView(DevAcc const& device, TData* data, Idx nElements) {
+    return AlpakaAccView1<TData>(data, device, Vec::all(nElements));
+  }
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+#endif  // AlpakaCore_alpakaMemoryHelper_h
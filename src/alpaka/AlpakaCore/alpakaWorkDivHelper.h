@@ -0,0 +1,48 @@
+#ifndef AlpakaCore_alpakaWorkDivHelper_h
+#define AlpakaCore_alpakaWorkDivHelper_h
+
+#include <algorithm>
+
+#include "AlpakaCore/alpakaConfig.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  // Create a 1D work division:
+  //   - on the GPU, run with threadsPerBlockOrElementsPerThread threads per block, each looking at a single element;
+  //   - on the CPU, run serially with a single thread per block, over threadsPerBlockOrElementsPerThread elements.
+  inline WorkDiv make_workdiv(Idx blocksPerGrid, Idx threadsPerBlockOrElementsPerThread) {
+#ifdef ALPAKA_ACC_GPU_CUDA_ENABLED
+    return WorkDiv(Vec::all(blocksPerGrid), Vec::all(threadsPerBlockOrElementsPerThread), Vec::all(Idx{1}));
+#else
+    return WorkDiv(Vec::all(blocksPerGrid), Vec::all(Idx{1}), Vec::all(threadsPerBlockOrElementsPerThread));
+#endif
+  }
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+namespace cms {
+  namespace Alpaka {
+
+    // Call func(i) for each element i in [0, maxNumberOfElements) assigned to the current thread,
+    // looping with a grid-size stride over the elements of all the threads in the grid.
+    template <typename T_Acc, typename Func>
+    ALPAKA_FN_ACC ALPAKA_FN_INLINE void for_each_element_1D_grid_stride(const T_Acc& acc,
+                                                                        uint32_t maxNumberOfElements,
+                                                                        Func func) {
+      uint32_t const elementsPerThread(alpaka::workdiv::getWorkDiv<alpaka::Thread, alpaka::Elems>(acc)[0u]);
+      uint32_t const threadsInGrid(alpaka::workdiv::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc)[0u]);
+      uint32_t const threadIdxInGrid(alpaka::idx::getIdx<alpaka::Grid, alpaka::Threads>(acc)[0u]);
+      uint32_t const stride = threadsInGrid * elementsPerThread;
+
+      for (uint32_t first = threadIdxInGrid * elementsPerThread; first < maxNumberOfElements; first += stride) {
+        uint32_t const last = std::min(first + elementsPerThread, maxNumberOfElements);
+        for (uint32_t i = first; i < last; ++i) {
+          func(i);
+        }
+      }
+    }
+
+  }  // namespace Alpaka
+}  // namespace cms
+
+#endif  // AlpakaCore_alpakaWorkDivHelper_h
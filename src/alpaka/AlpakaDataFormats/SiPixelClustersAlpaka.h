@@ -0,0 +1,57 @@
+#ifndef AlpakaDataFormats_SiPixelClustersAlpaka_h
+#define AlpakaDataFormats_SiPixelClustersAlpaka_h
+
+#include <cstdint>
+
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  class SiPixelClustersAlpaka {
+  public:
+    explicit SiPixelClustersAlpaka(DevAcc const& device, size_t maxClusters)
+        : moduleStart_d{allocAccBuf<uint32_t>(device, maxClusters + 1)},
+          clusInModule_d{allocAccBuf<uint32_t>(device, maxClusters)},
+          moduleId_d{allocAccBuf<uint32_t>(device, maxClusters)},
+          clusModuleStart_d{allocAccBuf<uint32_t>(device, maxClusters + 1)} {}
+    ~SiPixelClustersAlpaka() = default;
+
+    SiPixelClustersAlpaka(const SiPixelClustersAlpaka &) = delete;
+    SiPixelClustersAlpaka &operator=(const SiPixelClustersAlpaka &) = delete;
+    SiPixelClustersAlpaka(SiPixelClustersAlpaka &&) = default;
+    SiPixelClustersAlpaka &operator=(SiPixelClustersAlpaka &&) = default;
+
+    void setNClusters(uint32_t nClusters) { nClusters_h = nClusters; }
+
+    uint32_t nClusters() const { return nClusters_h; }
+
+    uint32_t *moduleStart() { return alpaka::mem::view::getPtrNative(moduleStart_d); }
+    uint32_t *clusInModule() { return alpaka::mem::view::getPtrNative(clusInModule_d); }
+    uint32_t *moduleId() { return alpaka::mem::view::getPtrNative(moduleId_d); }
+    uint32_t *clusModuleStart() { return alpaka::mem::view::getPtrNative(clusModuleStart_d); }
+
+    uint32_t const *moduleStart() const { return alpaka::mem::view::getPtrNative(moduleStart_d); }
+    uint32_t const *clusInModule() const { return alpaka::mem::view::getPtrNative(clusInModule_d); }
+    uint32_t const *moduleId() const { return alpaka::mem::view::getPtrNative(moduleId_d); }
+    uint32_t const *clusModuleStart() const { return alpaka::mem::view::getPtrNative(clusModuleStart_d); }
+
+    uint32_t const *c_moduleStart() const { return alpaka::mem::view::getPtrNative(moduleStart_d); }
+    uint32_t const *c_clusInModule() const { return alpaka::mem::view::getPtrNative(clusInModule_d); }
+    uint32_t const *c_moduleId() const { return alpaka::mem::view::getPtrNative(moduleId_d); }
+    uint32_t const *c_clusModuleStart() const { return alpaka::mem::view::getPtrNative(clusModuleStart_d); }
+
+  private:
+    AlpakaAccBuf1<uint32_t> moduleStart_d;   // index of the first pixel of each module
+    AlpakaAccBuf1<uint32_t> clusInModule_d;  // number of clusters found in each module
+    AlpakaAccBuf1<uint32_t> moduleId_d;      // module id of each module
+
+    // originally from rechits
+    AlpakaAccBuf1<uint32_t> clusModuleStart_d;  // index of the first cluster of each module
+
+    uint32_t nClusters_h = 0;
+  };
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+#endif  // AlpakaDataFormats_SiPixelClustersAlpaka_h
@@ -0,0 +1,56 @@
+#ifndef AlpakaDataFormats_SiPixelDigiErrorsAlpaka_h
+#define AlpakaDataFormats_SiPixelDigiErrorsAlpaka_h
+
+#include <cassert>
+
+#include "AlpakaCore/SimpleVector.h"
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+#include "DataFormats/PixelErrors.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  class SiPixelDigiErrorsAlpaka {
+  public:
+    explicit SiPixelDigiErrorsAlpaka(DevAcc const& device,
+                                     size_t maxFedWords,
+                                     PixelFormatterErrors errors,
+                                     Queue& queue)
+        : data_d{allocAccBuf<PixelErrorCompact>(device, maxFedWords)},
+          error_d{allocAccBuf<cms::Alpaka::SimpleVector<PixelErrorCompact>>(device, 1u)},
+          error_h{allocHostBuf<cms::Alpaka::SimpleVector<PixelErrorCompact>>(1u)},
+          formatterErrors_h{std::move(errors)} {
+      auto& error = *alpaka::mem::view::getPtrNative(error_h);
+      error.construct(maxFedWords, alpaka::mem::view::getPtrNative(data_d));
+      assert(error.empty());
+      assert(error.capacity() == static_cast<int>(maxFedWords));
+      // error_h is kept alive by this object until the asynchronous copy is done
+      alpaka::mem::view::copy(queue, error_d, error_h, Vec::all(1u));
+    }
+    ~SiPixelDigiErrorsAlpaka() = default;
+
+    SiPixelDigiErrorsAlpaka(const SiPixelDigiErrorsAlpaka&) = delete;
+    SiPixelDigiErrorsAlpaka& operator=(const SiPixelDigiErrorsAlpaka&) = delete;
+    SiPixelDigiErrorsAlpaka(SiPixelDigiErrorsAlpaka&&) = default;
+    SiPixelDigiErrorsAlpaka& operator=(SiPixelDigiErrorsAlpaka&&) = default;
+
+    const PixelFormatterErrors& formatterErrors() const { return formatterErrors_h; }
+
+    cms::Alpaka::SimpleVector<PixelErrorCompact>* error() { return alpaka::mem::view::getPtrNative(error_d); }
+    cms::Alpaka::SimpleVector<PixelErrorCompact> const* error() const {
+      return alpaka::mem::view::getPtrNative(error_d);
+    }
+    cms::Alpaka::SimpleVector<PixelErrorCompact> const* c_error() const {
+      return alpaka::mem::view::getPtrNative(error_d);
+    }
+
+  private:
+    AlpakaAccBuf1<PixelErrorCompact> data_d;
+    AlpakaAccBuf1<cms::Alpaka::SimpleVector<PixelErrorCompact>> error_d;
+    AlpakaHostBuf1<cms::Alpaka::SimpleVector<PixelErrorCompact>> error_h;
+    PixelFormatterErrors formatterErrors_h;
+  };
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+#endif  // AlpakaDataFormats_SiPixelDigiErrorsAlpaka_h
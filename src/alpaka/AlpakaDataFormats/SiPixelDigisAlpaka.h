@@ -0,0 +1,79 @@
+#ifndef AlpakaDataFormats_SiPixelDigisAlpaka_h
+#define AlpakaDataFormats_SiPixelDigisAlpaka_h
+
+#include <cstdint>
+
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  class SiPixelDigisAlpaka {
+  public:
+    explicit SiPixelDigisAlpaka(DevAcc const& device, size_t maxFedWords)
+        : xx_d{allocAccBuf<uint16_t>(device, maxFedWords)},
+          yy_d{allocAccBuf<uint16_t>(device, maxFedWords)},
+          adc_d{allocAccBuf<uint16_t>(device, maxFedWords)},
+          moduleInd_d{allocAccBuf<uint16_t>(device, maxFedWords)},
+          clus_d{allocAccBuf<int32_t>(device, maxFedWords)},
+          pdigi_d{allocAccBuf<uint32_t>(device, maxFedWords)},
+          rawIdArr_d{allocAccBuf<uint32_t>(device, maxFedWords)} {}
+    ~SiPixelDigisAlpaka() = default;
+
+    SiPixelDigisAlpaka(const SiPixelDigisAlpaka&) = delete;
+    SiPixelDigisAlpaka& operator=(const SiPixelDigisAlpaka&) = delete;
+    SiPixelDigisAlpaka(SiPixelDigisAlpaka&&) = default;
+    SiPixelDigisAlpaka& operator=(SiPixelDigisAlpaka&&) = default;
+
+    void setNModulesDigis(uint32_t nModules, uint32_t nDigis) {
+      nModules_h = nModules;
+      nDigis_h = nDigis;
+    }
+
+    uint32_t nModules() const { return nModules_h; }
+    uint32_t nDigis() const { return nDigis_h; }
+
+    uint16_t* xx() { return alpaka::mem::view::getPtrNative(xx_d); }
+    uint16_t* yy() { return alpaka::mem::view::getPtrNative(yy_d); }
+    uint16_t* adc() { return alpaka::mem::view::getPtrNative(adc_d); }
+    uint16_t* moduleInd() { return alpaka::mem::view::getPtrNative(moduleInd_d); }
+    int32_t* clus() { return alpaka::mem::view::getPtrNative(clus_d); }
+    uint32_t* pdigi() { return alpaka::mem::view::getPtrNative(pdigi_d); }
+    uint32_t* rawIdArr() { return alpaka::mem::view::getPtrNative(rawIdArr_d); }
+
+    uint16_t const* xx() const { return alpaka::mem::view::getPtrNative(xx_d); }
+    uint16_t const* yy() const { return alpaka::mem::view::getPtrNative(yy_d); }
+    uint16_t const* adc() const { return alpaka::mem::view::getPtrNative(adc_d); }
+    uint16_t const* moduleInd() const { return alpaka::mem::view::getPtrNative(moduleInd_d); }
+    int32_t const* clus() const { return alpaka::mem::view::getPtrNative(clus_d); }
+    uint32_t const* pdigi() const { return alpaka::mem::view::getPtrNative(pdigi_d); }
+    uint32_t const* rawIdArr() const { return alpaka::mem::view::getPtrNative(rawIdArr_d); }
+
+    uint16_t const* c_xx() const { return alpaka::mem::view::getPtrNative(xx_d); }
+    uint16_t const* c_yy() const { return alpaka::mem::view::getPtrNative(yy_d); }
+    uint16_t const* c_adc() const { return alpaka::mem::view::getPtrNative(adc_d); }
+    uint16_t const* c_moduleInd() const { return alpaka::mem::view::getPtrNative(moduleInd_d); }
+    int32_t const* c_clus() const { return alpaka::mem::view::getPtrNative(clus_d); }
+    uint32_t const* c_pdigi() const { return alpaka::mem::view::getPtrNative(pdigi_d); }
+    uint32_t const* c_rawIdArr() const { return alpaka::mem::view::getPtrNative(rawIdArr_d); }
+
+  private:
+    // These are consumed by downstream device code
+    AlpakaAccBuf1<uint16_t> xx_d;         // local coordinates of each pixel
+    AlpakaAccBuf1<uint16_t> yy_d;         //
+    AlpakaAccBuf1<uint16_t> adc_d;        // ADC of each pixel
+    AlpakaAccBuf1<uint16_t> moduleInd_d;  // module id of each pixel
+    AlpakaAccBuf1<int32_t> clus_d;        // cluster id of each pixel
+
+    // These are for CPU output; should we (eventually) place them to a
+    // separate product?
+    AlpakaAccBuf1<uint32_t> pdigi_d;
+    AlpakaAccBuf1<uint32_t> rawIdArr_d;
+
+    uint32_t nModules_h = 0;
+    uint32_t nDigis_h = 0;
+  };
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+#endif  // AlpakaDataFormats_SiPixelDigisAlpaka_h
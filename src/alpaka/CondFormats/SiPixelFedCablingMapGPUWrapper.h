@@ -0,0 +1,36 @@
+#ifndef RecoLocalTracker_SiPixelClusterizer_SiPixelFedCablingMapGPUWrapper_h
+#define RecoLocalTracker_SiPixelClusterizer_SiPixelFedCablingMapGPUWrapper_h
+
+#include <utility>
+
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+#include "CondFormats/SiPixelFedCablingMapGPU.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  class SiPixelFedCablingMapGPUWrapper {
+  public:
+    explicit SiPixelFedCablingMapGPUWrapper(AlpakaAccBuf1<SiPixelFedCablingMapGPU> cablingMap,
+                                            AlpakaAccBuf1<unsigned char> modToUnpDefault,
+                                            bool quality)
+        : cablingMapDevice_{std::move(cablingMap)},
+          modToUnpDefault_{std::move(modToUnpDefault)},
+          hasQuality_{quality} {}
+    ~SiPixelFedCablingMapGPUWrapper() = default;
+
+    bool hasQuality() const { return hasQuality_; }
+
+    // returns pointers to the device memory
+    const SiPixelFedCablingMapGPU* cablingMap() const { return alpaka::mem::view::getPtrNative(cablingMapDevice_); }
+    const unsigned char* modToUnpAll() const { return alpaka::mem::view::getPtrNative(modToUnpDefault_); }
+
+  private:
+    AlpakaAccBuf1<SiPixelFedCablingMapGPU> cablingMapDevice_;
+    AlpakaAccBuf1<unsigned char> modToUnpDefault_;
+    bool hasQuality_;
+  };
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef CalibTracker_SiPixelESProducers_interface_SiPixelGainCalibrationForHLTGPU_h
+#define CalibTracker_SiPixelESProducers_interface_SiPixelGainCalibrationForHLTGPU_h
+
+#include <utility>
+
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+#include "CondFormats/SiPixelGainForHLTonGPU.h"
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+
+  class SiPixelGainCalibrationForHLTGPU {
+  public:
+    // gainForHLT holds a copy of the calibration whose v_pedestals points to the memory owned by gainData
+    explicit SiPixelGainCalibrationForHLTGPU(AlpakaAccBuf1<SiPixelGainForHLTonGPU> gainForHLT,
+                                             AlpakaAccBuf1<SiPixelGainForHLTonGPU_DecodingStructure> gainData)
+        : gainForHLT_{std::move(gainForHLT)}, gainData_{std::move(gainData)} {}
+    ~SiPixelGainCalibrationForHLTGPU() = default;
+
+    // returns a pointer to the device memory
+    const SiPixelGainForHLTonGPU* getGPUProduct() const { return alpaka::mem::view::getPtrNative(gainForHLT_); }
+
+  private:
+    AlpakaAccBuf1<SiPixelGainForHLTonGPU> gainForHLT_;
+    AlpakaAccBuf1<SiPixelGainForHLTonGPU_DecodingStructure> gainData_;
+  };
+
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+#endif  // CalibTracker_SiPixelESProducers_interface_SiPixelGainCalibrationForHLTGPU_h
@@ -103,9 +103,13 @@ int main(int argc, char** argv) {
   std::vector<std::string> edmodules;
   std::vector<std::string> esmodules;
   if (not backends.empty()) {
+    esmodules = {"SiPixelFedIdsESProducer"};
     auto addModules = [&](std::string const& prefix, Backend backend) {
       if (std::find(backends.begin(), backends.end(), backend) != backends.end()) {
-        //edmodules.emplace_back(prefix + "SiPixelRawToCluster");
+        edmodules.emplace_back(prefix + "SiPixelRawToCluster");
+
+        esmodules.emplace_back(prefix + "SiPixelFedCablingMapESProducer");
+        esmodules.emplace_back(prefix + "SiPixelGainCalibrationForHLTESProducer");
       }
     };
     addModules("alpaka_serial_sync::", Backend::SERIAL);
@@ -0,0 +1,53 @@
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+#include "CondFormats/SiPixelFedCablingMapGPU.h"
+#include "CondFormats/SiPixelFedCablingMapGPUWrapper.h"
+#include "Framework/ESProducer.h"
+#include "Framework/EventSetup.h"
+#include "Framework/ESPluginFactory.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+  class SiPixelFedCablingMapESProducer : public edm::ESProducer {
+  public:
+    explicit SiPixelFedCablingMapESProducer(std::filesystem::path const& datadir) : data_(datadir) {}
+    void produce(edm::EventSetup& eventSetup);
+
+  private:
+    std::filesystem::path data_;
+  };
+
+  void SiPixelFedCablingMapESProducer::produce(edm::EventSetup& eventSetup) {
+    std::ifstream in(data_ / "cablingMap.bin", std::ios::binary);
+    in.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    auto obj = std::make_unique<SiPixelFedCablingMapGPU>();
+    in.read(reinterpret_cast<char*>(obj.get()), sizeof(SiPixelFedCablingMapGPU));
+    unsigned int modToUnpDefSize;
+    in.read(reinterpret_cast<char*>(&modToUnpDefSize), sizeof(unsigned int));
+    std::vector<unsigned char> modToUnpDefault(modToUnpDefSize);
+    in.read(reinterpret_cast<char*>(modToUnpDefault.data()), modToUnpDefSize);
+
+    const DevAcc device(alpaka::pltf::getDevByIdx<PltfAcc>(0u));
+    Queue queue(device);
+
+    auto cablingMap_d = allocAccBuf<SiPixelFedCablingMapGPU>(device, 1u);
+    auto cablingMap_h = createHostView(obj.get(), 1u);
+    alpaka::mem::view::copy(queue, cablingMap_d, cablingMap_h, Vec::all(1u));
+
+    auto modToUnp_d = allocAccBuf<unsigned char>(device, modToUnpDefSize);
+    auto modToUnp_h = createHostView(modToUnpDefault.data(), modToUnpDefSize);
+    alpaka::mem::view::copy(queue, modToUnp_d, modToUnp_h, Vec::all(modToUnpDefSize));
+
+    // the host copies go out of scope at the end of this function
+    alpaka::wait::wait(queue);
+
+    eventSetup.put(
+        std::make_unique<SiPixelFedCablingMapGPUWrapper>(std::move(cablingMap_d), std::move(modToUnp_d), true));
+  }
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+DEFINE_FWK_ALPAKA_EVENTSETUP_MODULE(SiPixelFedCablingMapESProducer);
@@ -0,0 +1,57 @@
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+#include "CondFormats/SiPixelGainCalibrationForHLTGPU.h"
+#include "CondFormats/SiPixelGainForHLTonGPU.h"
+#include "Framework/ESProducer.h"
+#include "Framework/EventSetup.h"
+#include "Framework/ESPluginFactory.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace ALPAKA_ACCELERATOR_NAMESPACE {
+  class SiPixelGainCalibrationForHLTESProducer : public edm::ESProducer {
+  public:
+    explicit SiPixelGainCalibrationForHLTESProducer(std::filesystem::path const& datadir) : data_(datadir) {}
+    void produce(edm::EventSetup& eventSetup);
+
+  private:
+    std::filesystem::path data_;
+  };
+
+  void SiPixelGainCalibrationForHLTESProducer::produce(edm::EventSetup& eventSetup) {
+    std::ifstream in(data_ / "gain.bin", std::ios::binary);
+    in.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    auto gain = std::make_unique<SiPixelGainForHLTonGPU>();
+    in.read(reinterpret_cast<char*>(gain.get()), sizeof(SiPixelGainForHLTonGPU));
+    unsigned int nbytes;
+    in.read(reinterpret_cast<char*>(&nbytes), sizeof(unsigned int));
+    std::vector<char> gainData(nbytes);
+    in.read(gainData.data(), nbytes);
+
+    const DevAcc device(alpaka::pltf::getDevByIdx<PltfAcc>(0u));
+    Queue queue(device);
+
+    const Idx nDecodingStructures = nbytes / sizeof(SiPixelGainForHLTonGPU_DecodingStructure);
+    auto gainData_d = allocAccBuf<SiPixelGainForHLTonGPU_DecodingStructure>(device, nDecodingStructures);
+    auto gainData_h = createHostView(reinterpret_cast<SiPixelGainForHLTonGPU_DecodingStructure*>(gainData.data()),
+                                     nDecodingStructures);
+    alpaka::mem::view::copy(queue, gainData_d, gainData_h, Vec::all(nDecodingStructures));
+
+    // the copy of the calibration on the device points to the gain data on the device
+    gain->v_pedestals = alpaka::mem::view::getPtrNative(gainData_d);
+    auto gainForHLT_d = allocAccBuf<SiPixelGainForHLTonGPU>(device, 1u);
+    auto gainForHLT_h = createHostView(gain.get(), 1u);
+    alpaka::mem::view::copy(queue, gainForHLT_d, gainForHLT_h, Vec::all(1u));
+
+    // the host copies go out of scope at the end of this function
+    alpaka::wait::wait(queue);
+
+    eventSetup.put(
+        std::make_unique<SiPixelGainCalibrationForHLTGPU>(std::move(gainForHLT_d), std::move(gainData_d)));
+  }
+}  // namespace ALPAKA_ACCELERATOR_NAMESPACE
+
+DEFINE_FWK_ALPAKA_EVENTSETUP_MODULE(SiPixelGainCalibrationForHLTESProducer);
@@ -0,0 +1,273 @@
+#ifndef RecoLocalTracker_SiPixelClusterizer_plugins_gpuClustering_h
+#define RecoLocalTracker_SiPixelClusterizer_plugins_gpuClustering_h
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "AlpakaCore/HistoContainer.h"
+#include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaWorkDivHelper.h"
+#include "AlpakaDataFormats/gpuClusteringConstants.h"
+#include "Geometry/phase1PixelTopology.h"
+
+namespace gpuClustering {
+
+  struct countModules {
+    template <typename T_Acc>
+    ALPAKA_FN_ACC void operator()(const T_Acc& acc,
+                                  uint16_t const* __restrict__ id,
+                                  uint32_t* __restrict__ moduleStart,
+                                  int32_t* __restrict__ clusterId,
+                                  int numElements) const {
+      cms::Alpaka::for_each_element_1D_grid_stride(acc, numElements, [&](uint32_t index) {
+        int i = index;
+        clusterId[i] = i;
+        if (InvId == id[i])
+          return;
+        auto j = i - 1;
+        while (j >= 0 and id[j] == InvId)
+          --j;
+        if (j < 0 or id[j] != id[i]) {
+          // boundary...
+          auto loc = alpaka::atomic::atomicOp<alpaka::atomic::op::Inc>(acc, moduleStart, MaxNumModules);
+          moduleStart[loc + 1] = i;
+        }
+      });
+    }
+  };
+
+  // One block per module. On the GPU the threads of each block share the pixels of the module;
+  // on the CPU each block has a single thread, that loops over all the pixels of the module.
+  struct findClus {
+    template <typename T_Acc>
+    ALPAKA_FN_ACC void operator()(const T_Acc& acc,
+                                  uint16_t const* __restrict__ id,           // module id of each pixel
+                                  uint16_t const* __restrict__ x,            // local coordinates of each pixel
+                                  uint16_t const* __restrict__ y,            //
+                                  uint32_t const* __restrict__ moduleStart,  // index of the first pixel of each module
+                                  uint32_t* __restrict__ nClustersInModule,  // output: number of clusters per module
+                                  uint32_t* __restrict__ moduleId,           // output: module id of each module
+                                  int32_t* __restrict__ clusterId,           // output: cluster id of each pixel
+                                  int numElements) const {
+      uint32_t const blockIdx(alpaka::idx::getIdx<alpaka::Grid, alpaka::Blocks>(acc)[0u]);
+      uint32_t const blockDimension(alpaka::workdiv::getWorkDiv<alpaka::Block, alpaka::Threads>(acc)[0u]);
+      uint32_t const threadIdx(alpaka::idx::getIdx<alpaka::Block, alpaka::Threads>(acc)[0u]);
+
+      if (blockIdx >= moduleStart[0])
+        return;
+
+      auto firstPixel = moduleStart[1 + blockIdx];
+      auto thisModuleId = id[firstPixel];
+      assert(thisModuleId < MaxNumModules);
+
+#ifdef GPU_DEBUG
+      if (thisModuleId % 100 == 1)
+        if (threadIdx == 0)
+          printf("start clusterizer for module %d in block %d\n", thisModuleId, blockIdx);
+#endif
+
+      int first = firstPixel + threadIdx;
+
+      // find the index of the first pixel not belonging to this module (or invalid)
+      auto&& msize = alpaka::block::shared::st::allocVar<int, __COUNTER__>(acc);
+      if (threadIdx == 0)
+        msize = numElements;
+      alpaka::block::sync::syncBlockThreads(acc);
+
+      // skip threads not associated to an existing pixel
+      for (int i = first; i < numElements; i += blockDimension) {
+        if (id[i] == InvId)  // skip invalid pixels
+          continue;
+        if (id[i] != thisModuleId) {  // find the first pixel in a different module
+          alpaka::atomic::atomicOp<alpaka::atomic::op::Min>(acc, &msize, i, alpaka::hierarchy::Threads{});
+          break;
+        }
+      }
+
+      //init hist  (ymax=416 < 512 : 9bits)
+      constexpr uint32_t maxPixInModule = 4000;
+      constexpr auto nbins = phase1PixelTopology::numColsInModule + 2;  //2+2;
+      using Hist = cms::Alpaka::HistoContainer<uint16_t, nbins, maxPixInModule, 9, uint16_t>;
+      auto&& hist = alpaka::block::shared::st::allocVar<Hist, __COUNTER__>(acc);
+      auto&& ws = alpaka::block::shared::st::allocVar<typename Hist::Counter[32], __COUNTER__>(acc);
+      hist.zero(acc);
+      alpaka::block::sync::syncBlockThreads(acc);
+
+      assert((msize == numElements) or ((msize < numElements) and (id[msize] != thisModuleId)));
+
+      // limit to maxPixInModule  (FIXME if recurrent (and not limited to simulation with low threshold) one will need to implement something cleverer)
+      if (0 == threadIdx) {
+        if (msize - firstPixel > maxPixInModule) {
+          printf("too many pixels in module %d: %d > %d\n", thisModuleId, msize - firstPixel, maxPixInModule);
+          msize = maxPixInModule + firstPixel;
+        }
+      }
+
+      alpaka::block::sync::syncBlockThreads(acc);
+      assert(msize - firstPixel <= maxPixInModule);
+
+      // fill histo
+      for (int i = first; i < msize; i += blockDimension) {
+        if (id[i] == InvId)  // skip invalid pixels
+          continue;
+        hist.count(acc, y[i]);
+      }
+      alpaka::block::sync::syncBlockThreads(acc);
+      for (uint32_t j = threadIdx; j < 32; j += blockDimension)
+        ws[j] = 0;  // used by prefix scan...
+      alpaka::block::sync::syncBlockThreads(acc);
+      hist.finalize(acc, ws);
+      alpaka::block::sync::syncBlockThreads(acc);
+#ifdef GPU_DEBUG
+      if (thisModuleId % 100 == 1)
+        if (threadIdx == 0)
+          printf("histo size %d\n", hist.size());
+#endif
+      for (int i = first; i < msize; i += blockDimension) {
+        if (id[i] == InvId)  // skip invalid pixels
+          continue;
+        hist.fill(acc, y[i], i - firstPixel);
+      }
+
+#ifdef ALPAKA_ACC_GPU_CUDA_ENABLED
+      // assume that we can cover the whole module with up to 16 blockDimension-wide iterations
+      constexpr unsigned int maxiter = 16;
+#else
+      // a single thread loops over all the pixels of the module
+      constexpr unsigned int maxiter = maxPixInModule;
+#endif
+      // allocate space for duplicate pixels: a pixel can appear more than once with different charge in the same event
+      constexpr int maxNeighbours = 10;
+      assert((hist.size() / blockDimension) <= maxiter);
+      // nearest neighbour
+      uint16_t nn[maxiter][maxNeighbours];
+      uint8_t nnn[maxiter];  // number of nn
+      for (uint32_t k = 0; k < maxiter; ++k)
+        nnn[k] = 0;
+
+      alpaka::block::sync::syncBlockThreads(acc);  // for hit filling!
+
+      // fill NN
+      for (auto j = threadIdx, k = 0U; j < hist.size(); j += blockDimension, ++k) {
+        assert(k < maxiter);
+        auto p = hist.begin() + j;
+        auto i = *p + firstPixel;
+        assert(id[i] != InvId);
+        assert(id[i] == thisModuleId);  // same module
+        int be = Hist::bin(y[i] + 1);
+        auto e = hist.end(be);
+        ++p;
+        assert(0 == nnn[k]);
+        for (; p < e; ++p) {
+          auto m = (*p) + firstPixel;
+          assert(m != i);
+          assert(int(y[m]) - int(y[i]) >= 0);
+          assert(int(y[m]) - int(y[i]) <= 1);
+          if (std::abs(int(x[m]) - int(x[i])) > 1)
+            continue;
+          auto l = nnn[k]++;
+          assert(l < maxNeighbours);
+          nn[k][l] = *p;
+        }
+      }
+
+      // for each pixel, look at all the pixels until the end of the module;
+      // when two valid pixels within +/- 1 in x or y are found, set their id to the minimum;
+      // after the loop, all the pixel in each cluster should have the id equeal to the lowest
+      // pixel in the cluster ( clus[i] == i ).
+      bool more = true;
+      int nloops = 0;
+      while (alpaka::block::sync::syncBlockThreadsPredicate<alpaka::block::sync::op::LogicalOr>(acc, more)) {
+        if (1 == nloops % 2) {
+          for (auto j = threadIdx, k = 0U; j < hist.size(); j += blockDimension, ++k) {
+            auto p = hist.begin() + j;
+            auto i = *p + firstPixel;
+            auto m = clusterId[i];
+            while (m != clusterId[m])
+              m = clusterId[m];
+            clusterId[i] = m;
+          }
+        } else {
+          more = false;
+          for (auto j = threadIdx, k = 0U; j < hist.size(); j += blockDimension, ++k) {
+            auto p = hist.begin() + j;
+            auto i = *p + firstPixel;
+            for (int kk = 0; kk < nnn[k]; ++kk) {
+              auto l = nn[k][kk];
+              auto m = l + firstPixel;
+              assert(m != i);
+              // the pixels of a module are only accessed by the threads of the same block
+              auto old = alpaka::atomic::atomicOp<alpaka::atomic::op::Min>(
+                  acc, &clusterId[m], clusterId[i], alpaka::hierarchy::Threads{});
+              if (old != clusterId[i]) {
+                // end the loop only if no changes were applied
+                more = true;
+              }
+              alpaka::atomic::atomicOp<alpaka::atomic::op::Min>(acc, &clusterId[i], old, alpaka::hierarchy::Threads{});
+            }  // nnloop
+          }    // pixel loop
+        }
+        ++nloops;
+      }  // end while
+
+#ifdef GPU_DEBUG
+      if (thisModuleId % 100 == 1)
+        if (threadIdx == 0)
+          printf("# loops %d\n", nloops);
+#endif
+
+      auto&& foundClusters = alpaka::block::shared::st::allocVar<unsigned int, __COUNTER__>(acc);
+      if (threadIdx == 0)
+        foundClusters = 0;
+      alpaka::block::sync::syncBlockThreads(acc);
+
+      // find the number of different clusters, identified by a pixels with clus[i] == i;
+      // mark these pixels with a negative id.
+      for (int i = first; i < msize; i += blockDimension) {
+        if (id[i] == InvId)  // skip invalid pixels
+          continue;
+        if (clusterId[i] == i) {
+          auto old = alpaka::atomic::atomicOp<alpaka::atomic::op::Inc>(
+              acc, &foundClusters, 0xffffffff, alpaka::hierarchy::Threads{});
+          clusterId[i] = -(old + 1);
+        }
+      }
+      alpaka::block::sync::syncBlockThreads(acc);
+
+      // propagate the negative id to all the pixels in the cluster.
+      for (int i = first; i < msize; i += blockDimension) {
+        if (id[i] == InvId)  // skip invalid pixels
+          continue;
+        if (clusterId[i] >= 0) {
+          // mark each pixel in a cluster with the same id as the first one
+          clusterId[i] = clusterId[clusterId[i]];
+        }
+      }
+      alpaka::block::sync::syncBlockThreads(acc);
+
+      // adjust the cluster id to be a positive value starting from 0
+      for (int i = first; i < msize; i += blockDimension) {
+        if (id[i] == InvId) {  // skip invalid pixels
+          clusterId[i] = -9999;
+          continue;
+        }
+        clusterId[i] = -clusterId[i] - 1;
+      }
+      alpaka::block::sync::syncBlockThreads(acc);
+
+      if (threadIdx == 0) {
+        nClustersInModule[thisModuleId] = foundClusters;
+        moduleId[blockIdx] = thisModuleId;
+#ifdef GPU_DEBUG
+        if (thisModuleId % 100 == 1)
+          printf("%d clusters in module %d\n", foundClusters, thisModuleId);
+#endif
+      }
+    }
+  };
+
+}  // namespace gpuClustering
+
+#endif  // RecoLocalTracker_SiPixelClusterizer_plugins_gpuClustering_h
@@ -1,8 +1,113 @@
+#include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <vector>
+
 #include "AlpakaCore/alpakaConfig.h"
+#include "AlpakaCore/alpakaMemoryHelper.h"
+#include "AlpakaCore/alpakaWorkDivHelper.h"
+
+// dirty, but works
+#include "plugin-SiPixelClusterizer/alpaka/gpuClusterChargeCut.h"
+#include "plugin-SiPixelClusterizer/alpaka/gpuClustering.h"
+
+using namespace ALPAKA_ACCELERATOR_NAMESPACE;
 
 int main() {
-  std::cout << "Exit success" << std::endl;
+  using namespace gpuClustering;
+
+  const DevAcc device(alpaka::pltf::getDevByIdx<PltfAcc>(0u));
+  Queue queue(device);
+
+  // module 200: a single pixel, a vertical pair and a diagonal pair, all above the 4000 charge cut
+  // module 300: a single pixel below the cut and a single pixel above it
+  // an invalid pixel sits between the two modules
+  std::vector<uint16_t> id = {200, 200, 200, 200, 200, InvId, 300, 300};
+  std::vector<uint16_t> x = {10, 20, 20, 30, 31, 0, 5, 50};
+  std::vector<uint16_t> y = {10, 20, 21, 30, 31, 0, 5, 50};
+  std::vector<uint16_t> adc = {5000, 3000, 3000, 2500, 2500, 0, 1000, 4500};
+  const uint32_t numElements = id.size();
+
+  auto id_d = allocAccBuf<uint16_t>(device, numElements);
+  auto x_d = allocAccBuf<uint16_t>(device, numElements);
+  auto y_d = allocAccBuf<uint16_t>(device, numElements);
+  auto adc_d = allocAccBuf<uint16_t>(device, numElements);
+  auto clus_d = allocAccBuf<int32_t>(device, numElements);
+  auto moduleStart_d = allocAccBuf<uint32_t>(device, MaxNumModules + 1);
+  auto clusInModule_d = allocAccBuf<uint32_t>(device, MaxNumModules);
+  auto moduleId_d = allocAccBuf<uint32_t>(device, MaxNumModules);
+
+  alpaka::mem::view::copy(queue, id_d, createHostView(id.data(), numElements), Vec::all(numElements));
+  alpaka::mem::view::copy(queue, x_d, createHostView(x.data(), numElements), Vec::all(numElements));
+  alpaka::mem::view::copy(queue, y_d, createHostView(y.data(), numElements), Vec::all(numElements));
+  alpaka::mem::view::copy(queue, adc_d, createHostView(adc.data(), numElements), Vec::all(numElements));
+  alpaka::mem::view::set(queue, moduleStart_d, 0, Vec::all(MaxNumModules + 1));
+  alpaka::mem::view::set(queue, clusInModule_d, 0, Vec::all(MaxNumModules));
+
+  alpaka::queue::enqueue(queue,
+                         alpaka::kernel::createTaskKernel<Acc>(make_workdiv(1u, 256u),
+                                                               countModules(),
+                                                               alpaka::mem::view::getPtrNative(id_d),
+                                                               alpaka::mem::view::getPtrNative(moduleStart_d),
+                                                               alpaka::mem::view::getPtrNative(clus_d),
+                                                               numElements));
+
+  const auto workDivOneBlockPerModule = make_workdiv(MaxNumModules, 256u);
+  alpaka::queue::enqueue(queue,
+                         alpaka::kernel::createTaskKernel<Acc>(workDivOneBlockPerModule,
+                                                               findClus(),
+                                                               alpaka::mem::view::getPtrNative(id_d),
+                                                               alpaka::mem::view::getPtrNative(x_d),
+                                                               alpaka::mem::view::getPtrNative(y_d),
+                                                               alpaka::mem::view::getPtrNative(moduleStart_d),
+                                                               alpaka::mem::view::getPtrNative(clusInModule_d),
+                                                               alpaka::mem::view::getPtrNative(moduleId_d),
+                                                               alpaka::mem::view::getPtrNative(clus_d),
+                                                               numElements));
+
+  auto nModules_h = allocHostBuf<uint32_t>(1u);
+  auto clusInModule_h = allocHostBuf<uint32_t>(MaxNumModules);
+  alpaka::mem::view::copy(queue, nModules_h, moduleStart_d, Vec::all(1u));
+  alpaka::mem::view::copy(queue, clusInModule_h, clusInModule_d, Vec::all(MaxNumModules));
+  alpaka::wait::wait(queue);
+
+  auto const* nClusters = alpaka::mem::view::getPtrNative(clusInModule_h);
+  std::cout << "found " << alpaka::mem::view::getPtrNative(nModules_h)[0] << " modules, " << nClusters[200] << " + "
+            << nClusters[300] << " clusters" << std::endl;
+  assert(2 == alpaka::mem::view::getPtrNative(nModules_h)[0]);
+  assert(3 == nClusters[200]);
+  assert(2 == nClusters[300]);
+
+  alpaka::queue::enqueue(queue,
+                         alpaka::kernel::createTaskKernel<Acc>(workDivOneBlockPerModule,
+                                                               clusterChargeCut(),
+                                                               alpaka::mem::view::getPtrNative(id_d),
+                                                               alpaka::mem::view::getPtrNative(adc_d),
+                                                               alpaka::mem::view::getPtrNative(moduleStart_d),
+                                                               alpaka::mem::view::getPtrNative(clusInModule_d),
+                                                               alpaka::mem::view::getPtrNative(moduleId_d),
+                                                               alpaka::mem::view::getPtrNative(clus_d),
+                                                               numElements));
+
+  auto id_h = allocHostBuf<uint16_t>(numElements);
+  auto clus_h = allocHostBuf<int32_t>(numElements);
+  alpaka::mem::view::copy(queue, id_h, id_d, Vec::all(numElements));
+  alpaka::mem::view::copy(queue, clus_h, clus_d, Vec::all(numElements));
+  alpaka::mem::view::copy(queue, clusInModule_h, clusInModule_d, Vec::all(MaxNumModules));
+  alpaka::wait::wait(queue);
+
+  // the pixel below the charge cut is invalidated, the other clusters survive
+  std::cout << "after the charge cut " << nClusters[200] << " + " << nClusters[300] << " clusters" << std::endl;
+  assert(3 == nClusters[200]);
+  assert(1 == nClusters[300]);
+  auto const* idAfter = alpaka::mem::view::getPtrNative(id_h);
+  auto const* clus = alpaka::mem::view::getPtrNative(clus_h);
+  assert(InvId == idAfter[6]);
+  assert(0 == clus[7]);
+  assert(clus[1] == clus[2]);
+  assert(clus[3] == clus[4]);
+  assert(clus[0] != clus[1] and clus[0] != clus[3] and clus[1] != clus[3]);
 
+  std::cout << "TEST PASSED" << std::endl;
   return 0;
 }
@@ -17,7 +17,8 @@ namespace cms {
     template <typename T>
     class ESProduct {
     public:
-      ESProduct() : gpuDataPerDevice_(deviceCount()) {
+      // can be constructed also without a GPU, e.g. for the CPU workflow
+      ESProduct() : gpuDataPerDevice_(deviceCountNoThrow()) {
         for (size_t i = 0; i < gpuDataPerDevice_.size(); ++i) {
           gpuDataPerDevice_[i].m_event = getEventCache().get();
         }
@@ -74,6 +75,9 @@ namespace cms {
             transferAsync(data.m_data, cudaStream);
             assert(data.m_fillingStream == nullptr);
             data.m_fillingStream = cudaStream;
+            // Record in the cudaStream an event to mark the readiness of the
+            // EventSetup data on the GPU, so other streams can check for it
+            cudaCheck(cudaEventRecord(data.m_event.get(), cudaStream));
             // Now the filling has been enqueued to the cudaStream, so we
             // can return the GPU data immediately, since all subsequent
             // work must be either enqueued to the cudaStream, or the cudaStream
@@ -84,7 +88,49 @@ namespace cms {
         return data.m_data;
       }
 
+      // As above, for a new version of a product whose previous version may
+      // already be on the device: in that case updateAsync, a function of
+      // (T&, T const&, cudaStream_t), enqueues the filling of the data from
+      // the previous ones (e.g. a device-to-device copy, followed by the
+      // transfer of the parts that changed), instead of transferAsync
+      template <typename F, typename G>
+      const T& dataForCurrentDeviceAsync(cudaStream_t cudaStream,
+                                         ESProduct const* previous,
+                                         F transferAsync,
+                                         G updateAsync) const {
+        return dataForCurrentDeviceAsync(cudaStream, [&](T& data, cudaStream_t stream) {
+          T const* previousData = previous ? previous->dataOnCurrentDevice(stream) : nullptr;
+          if (previousData) {
+            updateAsync(data, *previousData, stream);
+          } else {
+            transferAsync(data, stream);
+          }
+        });
+      }
+
     private:
+      // Returns the data of the current device if they have been filled or
+      // are being filled (in which case the cudaStream waits for them), or
+      // nullptr if they have not been requested yet
+      T const* dataOnCurrentDevice(cudaStream_t cudaStream) const {
+        auto& data = gpuDataPerDevice_[currentDevice()];
+        if (data.m_filled.load()) {
+          return &data.m_data;
+        }
+        std::scoped_lock<std::mutex> lk{data.m_mutex};
+        if (data.m_filled.load()) {
+          return &data.m_data;
+        }
+        if (data.m_fillingStream == nullptr) {
+          return nullptr;
+        }
+        if (data.m_fillingStream != cudaStream) {
+          cudaCheck(cudaStreamWaitEvent(cudaStream, data.m_event.get(), 0),
+                    "Failed to make a stream to wait for an event");
+        }
+        return &data.m_data;
+      }
+
       struct Item {
         mutable std::mutex m_mutex;
         mutable SharedEventPtr m_event;  // guarded by m_mutex
@@ -1,8 +1,9 @@
 #include "CUDACore/cudaCompat.h"
 
 namespace cudaCompat {
-  thread_local dim3 blockIdx;
-  thread_local dim3 gridDim;
+  // initialized in every thread, including the TBB workers that call the kernels directly
+  thread_local dim3 blockIdx = {0, 0, 0};
+  thread_local dim3 gridDim = {1, 1, 1};
 }  // namespace cudaCompat
 
 namespace {
@@ -2,16 +2,22 @@
 #define HeterogeneousCore_CUDAUtilities_interface_cudaCompat_h
 
 /*
- * Everything you need to run cuda code in plain sequential c++ code
+ * Everything you need to run cuda code in plain c++ code, sequentially or
+ * with the blocks of a grid running in parallel (see cudaCompat::launch)
  */
 
 #ifndef __CUDACC__
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
 
 #include <cuda_runtime.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 namespace cudaCompat {
 
@@ -26,43 +32,58 @@ namespace cudaCompat {
   extern thread_local dim3 blockIdx;
   extern thread_local dim3 gridDim;
 
+  // The atomic operations are relaxed, as in CUDA, and use the GCC/clang
+  // __atomic builtins (std::atomic_ref is available only from C++20) so
+  // that they are safe also when the blocks run concurrently (see launch()).
+  namespace detail {
+    template <typename T, typename F>
+    T atomicUpdate(T* a, F&& f) {
+      T old;
+      __atomic_load(a, &old, __ATOMIC_RELAXED);
+      T desired = f(old);
+      while (not __atomic_compare_exchange(a, &old, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        desired = f(old);
+      }
+      return old;
+    }
+  }  // namespace detail
+
   template <typename T1, typename T2>
   T1 atomicInc(T1* a, T2 b) {
-    auto ret = *a;
-    if ((*a) < T1(b))
-      (*a)++;
-    return ret;
+    return detail::atomicUpdate(a, [b](T1 x) { return x < T1(b) ? T1(x + 1) : x; });
   }
 
   template <typename T1, typename T2>
   T1 atomicAdd(T1* a, T2 b) {
-    auto ret = *a;
-    (*a) += b;
-    return ret;
+    if constexpr (std::is_integral_v<T1>) {
+      return __atomic_fetch_add(a, T1(b), __ATOMIC_RELAXED);
+    } else {
+      return detail::atomicUpdate(a, [b](T1 x) { return T1(x + b); });
+    }
   }
 
   template <typename T1, typename T2>
   T1 atomicSub(T1* a, T2 b) {
-    auto ret = *a;
-    (*a) -= b;
-    return ret;
+    if constexpr (std::is_integral_v<T1>) {
+      return __atomic_fetch_sub(a, T1(b), __ATOMIC_RELAXED);
+    } else {
+      return detail::atomicUpdate(a, [b](T1 x) { return T1(x - b); });
+    }
   }
 
   template <typename T1, typename T2>
   T1 atomicMin(T1* a, T2 b) {
-    auto ret = *a;
-    *a = std::min(*a, T1(b));
-    return ret;
+    return detail::atomicUpdate(a, [b](T1 x) { return std::min(x, T1(b)); });
   }
   template <typename T1, typename T2>
   T1 atomicMax(T1* a, T2 b) {
-    auto ret = *a;
-    *a = std::max(*a, T1(b));
-    return ret;
+    return detail::atomicUpdate(a, [b](T1 x) { return std::max(x, T1(b)); });
   }
 
+  // Each block is run by a single thread (blockDim is {1, 1, 1}), so the
+  // barriers are trivially satisfied
   inline void __syncthreads() {}
-  inline void __threadfence() {}
+  inline void __threadfence() { std::atomic_thread_fence(std::memory_order_seq_cst); }
   inline bool __syncthreads_or(bool x) { return x; }
   inline bool __syncthreads_and(bool x) { return x; }
   template <typename T>
@@ -75,6 +96,50 @@ namespace cudaCompat {
     gridDim = {1, 1, 1};
   }
 
+  // Runs the kernel over a grid of blocks, mapping the blocks to TBB tasks.
+  // Each block is run by a single thread, so the __syncthreads() calls need
+  // no synchronisation, and the __shared__ variables (that are plain local
+  // variables of the kernel) are private to each block. As on the GPU, the
+  // blocks run in no particular order and may communicate only through
+  // atomic operations, so only the kernels that are launched with more than
+  // one block on the GPU can be launched with more than one block here.
+  //
+  // The kernel is a template argument, so that it is called directly and
+  // inlined: the host stubs that nvcc generates for the __global__ functions
+  // of a .cu file built in the same library have the same symbol names.
+  //
+  // The blocks are run in an isolated region, so that the calling thread
+  // does not pick up unrelated tasks (e.g. of other events) while waiting.
+  // Each task restores the grid of the thread that runs it, so that the
+  // kernels called directly afterwards by the same thread (including the TBB
+  // workers) do not see the grid of this launch.
+  template <auto kernel, typename... Args>
+  void launch(dim3 grid, Args... args) {
+    uint32_t const nBlocks = grid.x * grid.y * grid.z;
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(tbb::blocked_range<uint32_t>(0, nBlocks), [&](tbb::blocked_range<uint32_t> const& range) {
+        auto const threadBlockIdx = blockIdx;
+        auto const threadGridDim = gridDim;
+        gridDim = grid;
+        for (auto i = range.begin(); i != range.end(); ++i) {
+          blockIdx = {i % grid.x, (i / grid.x) % grid.y, i / (grid.x * grid.y)};
+          kernel(args...);
+        }
+        blockIdx = threadBlockIdx;
+        gridDim = threadGridDim;
+      });
+    });
+  }
+
+  template <auto kernel, typename... Args>
+  void launch(uint32_t nBlocks, Args... args) {
+    launch<kernel>(dim3{nBlocks, 1, 1}, args...);
+  }
+
+  // Number of blocks used on the CPU for the kernels with grid-stride loops:
+  // a few blocks per thread, to balance the load among the threads
+  inline uint32_t cpuGridSize() { return 4 * tbb::this_task_arena::max_concurrency(); }
+
 }  // namespace cudaCompat
 
 // some  not needed as done by cuda runtime...
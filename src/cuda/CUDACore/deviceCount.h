@@ -12,6 +12,18 @@ namespace cms {
       cudaCheck(cudaGetDeviceCount(&ndevices));
       return ndevices;
     }
+
+    // Returns 0 instead of throwing when the CUDA runtime can not be
+    // initialized, e.g. on nodes without a GPU
+    inline int deviceCountNoThrow() {
+      int ndevices;
+      if (cudaSuccess != cudaGetDeviceCount(&ndevices)) {
+        // reset the error state of the runtime
+        cudaGetLastError();
+        return 0;
+      }
+      return ndevices;
+    }
   }  // namespace cuda
 }  // namespace cms
 
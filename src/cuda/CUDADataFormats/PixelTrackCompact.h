@@ -0,0 +1,158 @@
+#ifndef CUDADataFormatsTrackPixelTrackCompact_H
+#define CUDADataFormatsTrackPixelTrackCompact_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "CUDADataFormats/PixelTrackHeterogeneous.h"
+
+// A TrackSoA packed into a contiguous buffer, holding only the tracks of the
+// event and their hits, to reduce the size of the device-to-host copies:
+//
+//   nTracks, nHits                                          uint32_t
+//   chi2, eta, pt, state (5 rows), covariance (15 rows)     float[nTracks] each
+//   hit offsets                                             uint32_t[nTracks + 1]
+//   hit indices, det indices                                uint16_t[nHits] each
+//   quality                                                 uint8_t[nTracks]
+template <int32_t S>
+class TrackSoACompactT {
+public:
+  using TrackSoA = TrackSoAT<S>;
+  using Quality = trackQuality::Quality;
+  using hindex_type = typename TrackSoA::hindex_type;
+
+  static constexpr uint32_t maxTracks() { return S; }
+  static constexpr uint32_t maxHits() { return TrackSoA::HitContainer::capacity(); }
+
+  // bytes needed to hold nTracks tracks with nHits hits
+  static constexpr size_t bufferSize(uint32_t nTracks, uint32_t nHits) {
+    return headerSize() + nTracks * (nFloats * sizeof(float) + sizeof(uint8_t)) + (nTracks + 1) * sizeof(uint32_t) +
+           2 * nHits * sizeof(hindex_type);
+  }
+  static constexpr size_t maxBufferSize() { return bufferSize(maxTracks(), maxHits()); }
+  static constexpr size_t headerSize() { return 2 * sizeof(uint32_t); }
+
+  // the buffer must be at least headerSize() bytes, and the rest is interpreted according to the header
+  __host__ __device__ explicit TrackSoACompactT(uint8_t *buffer) : m_buffer(buffer) {}
+
+  __host__ __device__ uint32_t nTracks() const { return header()[0]; }
+  __host__ __device__ uint32_t nHits() const { return header()[1]; }
+  __host__ __device__ size_t bufferSize() const { return bufferSize(nTracks(), nHits()); }
+
+  __host__ __device__ float *chi2() const { return (float *)(m_buffer + headerSize()); }
+  __host__ __device__ float *eta() const { return chi2() + nTracks(); }
+  __host__ __device__ float *pt() const { return eta() + nTracks(); }
+  // the k-th parameter of the state is state()[k * nTracks() + i]
+  __host__ __device__ float *state() const { return pt() + nTracks(); }
+  __host__ __device__ float *covariance() const { return state() + 5 * nTracks(); }
+  __host__ __device__ uint32_t *hitOffsets() const { return (uint32_t *)(covariance() + 15 * nTracks()); }
+  __host__ __device__ hindex_type *hitIndices() const { return (hindex_type *)(hitOffsets() + nTracks() + 1); }
+  __host__ __device__ hindex_type *detIndices() const { return hitIndices() + nHits(); }
+  __host__ __device__ Quality *quality() const { return (Quality *)(detIndices() + nHits()); }
+
+  // accessors with the same meaning as the TrackSoA ones
+  float chi2(int32_t i) const { return chi2()[i]; }
+  float eta(int32_t i) const { return eta()[i]; }
+  float pt(int32_t i) const { return pt()[i]; }
+  float state(int32_t i, int k) const { return state()[k * nTracks() + i]; }
+  float charge(int32_t i) const { return std::copysign(1.f, state(i, 2)); }
+  float phi(int32_t i) const { return state(i, 0); }
+  float tip(int32_t i) const { return state(i, 1); }
+  float zip(int32_t i) const { return state(i, 4); }
+  Quality quality(int32_t i) const { return quality()[i]; }
+  int nHits(int32_t i) const { return hitOffsets()[i + 1] - hitOffsets()[i]; }
+  hindex_type const *hitsBegin(int32_t i) const { return hitIndices() + hitOffsets()[i]; }
+  hindex_type const *hitsEnd(int32_t i) const { return hitIndices() + hitOffsets()[i + 1]; }
+  hindex_type const *detsBegin(int32_t i) const { return detIndices() + hitOffsets()[i]; }
+  hindex_type const *detsEnd(int32_t i) const { return detIndices() + hitOffsets()[i + 1]; }
+
+  // fills a full TrackSoA, leaving the slots after the last track empty
+  void unpack(TrackSoA &tracks) const {
+    auto const n = nTracks();
+    auto const nh = nHits();
+    auto const *offsets = hitOffsets();
+    for (uint32_t i = 0; i < n; ++i) {
+      tracks.m_quality(i) = quality()[i];
+      tracks.chi2(i) = chi2()[i];
+      tracks.eta(i) = eta()[i];
+      tracks.pt(i) = pt()[i];
+      for (int k = 0; k < 5; ++k)
+        tracks.stateAtBS.state(i)(k) = state()[k * n + i];
+      for (int k = 0; k < 15; ++k)
+        tracks.stateAtBS.covariance(i)(k) = covariance()[k * n + i];
+    }
+    for (uint32_t i = 0; i <= n; ++i) {
+      tracks.hitIndices.off[i] = offsets[i];
+      tracks.detIndices.off[i] = offsets[i];
+    }
+    for (uint32_t i = n + 1; i < TrackSoA::HitContainer::totbins(); ++i) {
+      tracks.hitIndices.off[i] = nh;
+      tracks.detIndices.off[i] = nh;
+    }
+    std::copy(hitIndices(), hitIndices() + nh, tracks.hitIndices.bins);
+    std::copy(detIndices(), detIndices() + nh, tracks.detIndices.bins);
+    tracks.m_nTracks = n;
+  }
+
+private:
+  // chi2, eta, pt, state and covariance
+  static constexpr uint32_t nFloats = 3 + 5 + 15;
+
+  __host__ __device__ uint32_t *header() const { return (uint32_t *)m_buffer; }
+
+  uint8_t *m_buffer;
+};
+
+namespace pixelTrack {
+
+  using TrackSoACompact = TrackSoACompactT<maxNumber()>;
+
+  // first step of the packing: the number of tracks and of their hits
+  template <int32_t S>
+  __global__ void countTracks(TrackSoAT<S> const *__restrict__ tracks, uint8_t *__restrict__ buffer) {
+    auto const &hits = tracks->hitIndices;
+    auto *header = (uint32_t *)buffer;
+    // the tracks fill the first slots, so the first empty slot is the number of tracks
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (int32_t i = first; i < S; i += gridDim.x * blockDim.x) {
+      bool last = hits.size(i) > 0 and (i + 1 == S or hits.size(i + 1) == 0);
+      bool none = i == 0 and hits.size(0) == 0;
+      if (last or none) {
+        auto n = none ? 0 : i + 1;
+        header[0] = n;
+        header[1] = hits.off[n];
+      }
+    }
+  }
+
+  // second step of the packing, once the header has been filled by countTracks()
+  template <int32_t S>
+  __global__ void packTracks(TrackSoAT<S> const *__restrict__ tracks, uint8_t *__restrict__ buffer) {
+    TrackSoACompactT<S> compact(buffer);
+    auto const n = compact.nTracks();
+    auto const nh = compact.nHits();
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (uint32_t i = first; i < n; i += gridDim.x * blockDim.x) {
+      compact.quality()[i] = tracks->quality(i);
+      compact.chi2()[i] = tracks->chi2(i);
+      compact.eta()[i] = tracks->eta(i);
+      compact.pt()[i] = tracks->pt(i);
+      for (int k = 0; k < 5; ++k)
+        compact.state()[k * n + i] = tracks->stateAtBS.state(i)(k);
+      for (int k = 0; k < 15; ++k)
+        compact.covariance()[k * n + i] = tracks->stateAtBS.covariance(i)(k);
+    }
+    for (uint32_t i = first; i <= n; i += gridDim.x * blockDim.x) {
+      compact.hitOffsets()[i] = tracks->hitIndices.off[i];
+    }
+    for (uint32_t j = first; j < nh; j += gridDim.x * blockDim.x) {
+      compact.hitIndices()[j] = tracks->hitIndices.bins[j];
+      compact.detIndices()[j] = tracks->detIndices.bins[j];
+    }
+  }
+
+}  // namespace pixelTrack
+
+#endif  // CUDADataFormatsTrackPixelTrackCompact_H
@@ -0,0 +1,14 @@
+#include "CUDADataFormats/SiPixelClustersCPU.h"
+
+SiPixelClustersCPU::SiPixelClustersCPU(size_t maxClusters) {
+  moduleStart_h = std::make_unique<uint32_t[]>(maxClusters + 1);
+  clusInModule_h = std::make_unique<uint32_t[]>(maxClusters);
+  moduleId_h = std::make_unique<uint32_t[]>(maxClusters);
+  clusModuleStart_h = std::make_unique<uint32_t[]>(maxClusters + 1);
+
+  view_h = std::make_unique<DeviceConstView>();
+  view_h->moduleStart_ = moduleStart_h.get();
+  view_h->clusInModule_ = clusInModule_h.get();
+  view_h->moduleId_ = moduleId_h.get();
+  view_h->clusModuleStart_ = clusModuleStart_h.get();
+}
@@ -0,0 +1,57 @@
+#ifndef CUDADataFormats_SiPixelCluster_interface_SiPixelClustersCPU_h
+#define CUDADataFormats_SiPixelCluster_interface_SiPixelClustersCPU_h
+
+#include <cstdint>
+#include <memory>
+
+#include "CUDADataFormats/SiPixelClustersCUDA.h"
+
+// Host memory counterpart of SiPixelClustersCUDA, produced by the CPU workflow
+class SiPixelClustersCPU {
+public:
+  using DeviceConstView = SiPixelClustersCUDA::DeviceConstView;
+
+  SiPixelClustersCPU() = default;
+  explicit SiPixelClustersCPU(size_t maxClusters);
+  ~SiPixelClustersCPU() = default;
+
+  SiPixelClustersCPU(const SiPixelClustersCPU &) = delete;
+  SiPixelClustersCPU &operator=(const SiPixelClustersCPU &) = delete;
+  SiPixelClustersCPU(SiPixelClustersCPU &&) = default;
+  SiPixelClustersCPU &operator=(SiPixelClustersCPU &&) = default;
+
+  void setNClusters(uint32_t nClusters) { nClusters_h = nClusters; }
+
+  uint32_t nClusters() const { return nClusters_h; }
+
+  uint32_t *moduleStart() { return moduleStart_h.get(); }
+  uint32_t *clusInModule() { return clusInModule_h.get(); }
+  uint32_t *moduleId() { return moduleId_h.get(); }
+  uint32_t *clusModuleStart() { return clusModuleStart_h.get(); }
+
+  uint32_t const *moduleStart() const { return moduleStart_h.get(); }
+  uint32_t const *clusInModule() const { return clusInModule_h.get(); }
+  uint32_t const *moduleId() const { return moduleId_h.get(); }
+  uint32_t const *clusModuleStart() const { return clusModuleStart_h.get(); }
+
+  uint32_t const *c_moduleStart() const { return moduleStart_h.get(); }
+  uint32_t const *c_clusInModule() const { return clusInModule_h.get(); }
+  uint32_t const *c_moduleId() const { return moduleId_h.get(); }
+  uint32_t const *c_clusModuleStart() const { return clusModuleStart_h.get(); }
+
+  const DeviceConstView *view() const { return view_h.get(); }
+
+private:
+  std::unique_ptr<uint32_t[]> moduleStart_h;   // index of the first pixel of each module
+  std::unique_ptr<uint32_t[]> clusInModule_h;  // number of clusters found in each module
+  std::unique_ptr<uint32_t[]> moduleId_h;      // module id of each module
+
+  // originally from rechits
+  std::unique_ptr<uint32_t[]> clusModuleStart_h;  // index of the first cluster of each module
+
+  std::unique_ptr<DeviceConstView> view_h;  // "me" pointer
+
+  uint32_t nClusters_h = 0;
+};
+
+#endif
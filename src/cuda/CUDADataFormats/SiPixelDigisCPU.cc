@@ -0,0 +1,19 @@
+#include "CUDADataFormats/SiPixelDigisCPU.h"
+
+SiPixelDigisCPU::SiPixelDigisCPU(size_t maxFedWords) {
+  xx_h = std::make_unique<uint16_t[]>(maxFedWords);
+  yy_h = std::make_unique<uint16_t[]>(maxFedWords);
+  adc_h = std::make_unique<uint16_t[]>(maxFedWords);
+  moduleInd_h = std::make_unique<uint16_t[]>(maxFedWords);
+  clus_h = std::make_unique<int32_t[]>(maxFedWords);
+
+  pdigi_h = std::make_unique<uint32_t[]>(maxFedWords);
+  rawIdArr_h = std::make_unique<uint32_t[]>(maxFedWords);
+
+  view_h = std::make_unique<DeviceConstView>();
+  view_h->xx_ = xx_h.get();
+  view_h->yy_ = yy_h.get();
+  view_h->adc_ = adc_h.get();
+  view_h->moduleInd_ = moduleInd_h.get();
+  view_h->clus_ = clus_h.get();
+}
@@ -0,0 +1,72 @@
+#ifndef CUDADataFormats_SiPixelDigi_interface_SiPixelDigisCPU_h
+#define CUDADataFormats_SiPixelDigi_interface_SiPixelDigisCPU_h
+
+#include <cstdint>
+#include <memory>
+
+#include "CUDADataFormats/SiPixelDigisCUDA.h"
+
+// Host memory counterpart of SiPixelDigisCUDA, produced by the CPU workflow
+class SiPixelDigisCPU {
+public:
+  using DeviceConstView = SiPixelDigisCUDA::DeviceConstView;
+
+  SiPixelDigisCPU() = default;
+  explicit SiPixelDigisCPU(size_t maxFedWords);
+  ~SiPixelDigisCPU() = default;
+
+  SiPixelDigisCPU(const SiPixelDigisCPU &) = delete;
+  SiPixelDigisCPU &operator=(const SiPixelDigisCPU &) = delete;
+  SiPixelDigisCPU(SiPixelDigisCPU &&) = default;
+  SiPixelDigisCPU &operator=(SiPixelDigisCPU &&) = default;
+
+  void setNModulesDigis(uint32_t nModules, uint32_t nDigis) {
+    nModules_h = nModules;
+    nDigis_h = nDigis;
+  }
+
+  uint32_t nModules() const { return nModules_h; }
+  uint32_t nDigis() const { return nDigis_h; }
+
+  uint16_t *xx() { return xx_h.get(); }
+  uint16_t *yy() { return yy_h.get(); }
+  uint16_t *adc() { return adc_h.get(); }
+  uint16_t *moduleInd() { return moduleInd_h.get(); }
+  int32_t *clus() { return clus_h.get(); }
+  uint32_t *pdigi() { return pdigi_h.get(); }
+  uint32_t *rawIdArr() { return rawIdArr_h.get(); }
+
+  uint16_t const *xx() const { return xx_h.get(); }
+  uint16_t const *yy() const { return yy_h.get(); }
+  uint16_t const *adc() const { return adc_h.get(); }
+  uint16_t const *moduleInd() const { return moduleInd_h.get(); }
+  int32_t const *clus() const { return clus_h.get(); }
+  uint32_t const *pdigi() const { return pdigi_h.get(); }
+  uint32_t const *rawIdArr() const { return rawIdArr_h.get(); }
+
+  uint16_t const *c_xx() const { return xx_h.get(); }
+  uint16_t const *c_yy() const { return yy_h.get(); }
+  uint16_t const *c_adc() const { return adc_h.get(); }
+  uint16_t const *c_moduleInd() const { return moduleInd_h.get(); }
+  int32_t const *c_clus() const { return clus_h.get(); }
+  uint32_t const *c_pdigi() const { return pdigi_h.get(); }
+  uint32_t const *c_rawIdArr() const { return rawIdArr_h.get(); }
+
+  const DeviceConstView *view() const { return view_h.get(); }
+
+private:
+  std::unique_ptr<uint16_t[]> xx_h;         // local coordinates of each pixel
+  std::unique_ptr<uint16_t[]> yy_h;         //
+  std::unique_ptr<uint16_t[]> adc_h;        // ADC of each pixel
+  std::unique_ptr<uint16_t[]> moduleInd_h;  // module id of each pixel
+  std::unique_ptr<int32_t[]> clus_h;        // cluster id of each pixel
+  std::unique_ptr<DeviceConstView> view_h;  // "me" pointer
+
+  std::unique_ptr<uint32_t[]> pdigi_h;
+  std::unique_ptr<uint32_t[]> rawIdArr_h;
+
+  uint32_t nModules_h = 0;
+  uint32_t nDigis_h = 0;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef CUDADataFormatsVertexZVertexCompact_H
+#define CUDADataFormatsVertexZVertexCompact_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "CUDACore/cudaCompat.h"
+#include "CUDADataFormats/ZVertexSoA.h"
+
+// A ZVertexSoA packed into a contiguous buffer, holding only the vertices
+// and the tracks of the event, to reduce the size of the device-to-host copies:
+//
+//   nvFinal, nTracks           uint32_t
+//   zv, wv, chi2, ptv2         float[nvFinal] each
+//   ndof                       int32_t[nvFinal]
+//   sortInd                    uint16_t[nvFinal]
+//   idv                        int16_t[nTracks]
+class ZVertexCompact {
+public:
+  // bytes needed to hold nv vertices and nTracks tracks
+  static constexpr size_t bufferSize(uint32_t nv, uint32_t nTracks) {
+    return headerSize() + nv * (4 * sizeof(float) + sizeof(int32_t) + sizeof(uint16_t)) + nTracks * sizeof(int16_t);
+  }
+  static constexpr size_t maxBufferSize() { return bufferSize(ZVertexSoA::MAXVTX, ZVertexSoA::MAXTRACKS); }
+  static constexpr size_t headerSize() { return 2 * sizeof(uint32_t); }
+
+  // the buffer must be at least headerSize() bytes, and the rest is interpreted according to the header
+  __host__ __device__ explicit ZVertexCompact(uint8_t *buffer) : m_buffer(buffer) {}
+
+  __host__ __device__ uint32_t nvFinal() const { return header()[0]; }
+  __host__ __device__ uint32_t nTracks() const { return header()[1]; }
+  __host__ __device__ size_t bufferSize() const { return bufferSize(nvFinal(), nTracks()); }
+
+  __host__ __device__ float *zv() const { return (float *)(m_buffer + headerSize()); }
+  __host__ __device__ float *wv() const { return zv() + nvFinal(); }
+  __host__ __device__ float *chi2() const { return wv() + nvFinal(); }
+  __host__ __device__ float *ptv2() const { return chi2() + nvFinal(); }
+  __host__ __device__ int32_t *ndof() const { return (int32_t *)(ptv2() + nvFinal()); }
+  __host__ __device__ uint16_t *sortInd() const { return (uint16_t *)(ndof() + nvFinal()); }
+  __host__ __device__ int16_t *idv() const { return (int16_t *)(sortInd() + nvFinal()); }
+
+  // fills a full ZVertexSoA, the entries after the last vertex and the last track are left untouched
+  void unpack(ZVertexSoA &vertices) const {
+    auto const nv = nvFinal();
+    std::copy(zv(), zv() + nv, vertices.zv);
+    std::copy(wv(), wv() + nv, vertices.wv);
+    std::copy(chi2(), chi2() + nv, vertices.chi2);
+    std::copy(ptv2(), ptv2() + nv, vertices.ptv2);
+    std::copy(ndof(), ndof() + nv, vertices.ndof);
+    std::copy(sortInd(), sortInd() + nv, vertices.sortInd);
+    std::copy(idv(), idv() + nTracks(), vertices.idv);
+    vertices.nvFinal = nv;
+    vertices.nTracks = nTracks();
+  }
+
+private:
+  __host__ __device__ uint32_t *header() const { return (uint32_t *)m_buffer; }
+
+  uint8_t *m_buffer;
+};
+
+namespace gpuVertexFinder {
+
+  __global__ void packVertices(ZVertexSoA const *__restrict__ vertices, uint8_t *__restrict__ buffer) {
+    auto const nv = vertices->nvFinal;
+    auto const nt = std::min(vertices->nTracks, ZVertexSoA::MAXTRACKS);
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    if (0 == first) {
+      auto *header = (uint32_t *)buffer;
+      header[0] = nv;
+      header[1] = nt;
+    }
+    // the layout is computed from the SoA, as the header may not be visible yet to the other blocks
+    auto *zv = (float *)(buffer + ZVertexCompact::headerSize());
+    auto *wv = zv + nv;
+    auto *chi2 = wv + nv;
+    auto *ptv2 = chi2 + nv;
+    auto *ndof = (int32_t *)(ptv2 + nv);
+    auto *sortInd = (uint16_t *)(ndof + nv);
+    auto *idv = (int16_t *)(sortInd + nv);
+    for (uint32_t i = first; i < nv; i += gridDim.x * blockDim.x) {
+      zv[i] = vertices->zv[i];
+      wv[i] = vertices->wv[i];
+      chi2[i] = vertices->chi2[i];
+      ptv2[i] = vertices->ptv2[i];
+      ndof[i] = vertices->ndof[i];
+      sortInd[i] = vertices->sortInd[i];
+    }
+    for (uint32_t i = first; i < nt; i += gridDim.x * blockDim.x) {
+      idv[i] = vertices->idv[i];
+    }
+  }
+
+}  // namespace gpuVertexFinder
+
+#endif  // CUDADataFormatsVertexZVertexCompact_H
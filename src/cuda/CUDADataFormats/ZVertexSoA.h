@@ -19,8 +19,12 @@ struct ZVertexSoA {
   int32_t ndof[MAXTRACKS];   // vertices number of dof (reused as workspace for the number of nearest neighbours FIXME)
   uint16_t sortInd[MAXVTX];  // sorted index (by pt2)  ascending
   uint32_t nvFinal;          // the number of vertices
+  uint32_t nTracks;          // the number of tracks idv refers to
 
-  __host__ __device__ void init() { nvFinal = 0; }
+  __host__ __device__ void init() {
+    nvFinal = 0;
+    nTracks = MAXTRACKS;
+  }
 };
 
 #endif  // CUDADataFormatsVertexZVertexSoA.H
@@ -2,19 +2,20 @@
 #define RecoLocalTracker_SiPixelClusterizer_SiPixelFedCablingMapGPUWrapper_h
 
 #include "CUDACore/ESProduct.h"
-#include "CUDACore/CUDAHostAllocator.h"
 #include "CUDACore/device_unique_ptr.h"
 #include "CondFormats/SiPixelFedCablingMapGPU.h"
 
 #include <cuda_runtime.h>
 
+#include <memory>
 #include <set>
+#include <vector>
 
 class SiPixelFedCablingMapGPUWrapper {
 public:
   explicit SiPixelFedCablingMapGPUWrapper(SiPixelFedCablingMapGPU const &cablingMap,
                                           std::vector<unsigned char> modToUnp);
-  ~SiPixelFedCablingMapGPUWrapper();
+  ~SiPixelFedCablingMapGPUWrapper() = default;
 
   bool hasQuality() const { return hasQuality_; }
 
@@ -24,11 +25,18 @@ public:
   // returns pointer to GPU memory
   const unsigned char *getModToUnpAllAsync(cudaStream_t cudaStream) const;
 
+  // returns pointer to CPU memory
+  const SiPixelFedCablingMapGPU *getCPUProduct() const { return cablingMapHost.get(); }
+
+  // returns pointer to CPU memory
+  const unsigned char *getModToUnpAll() const { return modToUnpDefault.data(); }
+
 private:
-  std::vector<unsigned char, CUDAHostAllocator<unsigned char>> modToUnpDefault;
+  // pageable memory, so that the wrapper can be constructed also without a GPU
+  std::vector<unsigned char> modToUnpDefault;
   bool hasQuality_;
 
-  SiPixelFedCablingMapGPU *cablingMapHost = nullptr;  // pointer to struct in CPU
+  std::unique_ptr<SiPixelFedCablingMapGPU> cablingMapHost;  // struct in CPU
 
   struct GPUData {
     ~GPUData();
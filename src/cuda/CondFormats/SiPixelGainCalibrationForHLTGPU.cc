@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
 #include <cuda.h>
 
 #include "CondFormats/SiPixelGainCalibrationForHLTGPU.h"
@@ -6,12 +11,35 @@
 
 SiPixelGainCalibrationForHLTGPU::SiPixelGainCalibrationForHLTGPU(SiPixelGainForHLTonGPU const& gain,
                                                                  std::vector<char> gainData)
-    : gainData_(std::move(gainData)) {
-  cudaCheck(cudaMallocHost(&gainForHLTonHost_, sizeof(SiPixelGainForHLTonGPU)));
-  *gainForHLTonHost_ = gain;
+    : gainForHLTonHost_(std::make_unique<SiPixelGainForHLTonGPU>(gain)), gainData_(std::move(gainData)) {
+  gainForHLTonHost_->v_pedestals = reinterpret_cast<SiPixelGainForHLTonGPU_DecodingStructure*>(gainData_.data());
 }
 
-SiPixelGainCalibrationForHLTGPU::~SiPixelGainCalibrationForHLTGPU() { cudaCheck(cudaFreeHost(gainForHLTonHost_)); }
+SiPixelGainCalibrationForHLTGPU::~SiPixelGainCalibrationForHLTGPU() = default;
+
+std::unique_ptr<SiPixelGainCalibrationForHLTGPU> SiPixelGainCalibrationForHLTGPU::update(
+    std::shared_ptr<SiPixelGainCalibrationForHLTGPU const> const& previous, std::vector<Patch> const& patches) {
+  auto gainData = previous->gainData_;
+  apply(patches, gainData);
+  auto updated = std::make_unique<SiPixelGainCalibrationForHLTGPU>(*previous->gainForHLTonHost_, std::move(gainData));
+  updated->previous_ = previous;
+  updated->patched_.reserve(patches.size());
+  for (auto const& patch : patches) {
+    updated->patched_.emplace_back(patch.offset, patch.bytes.size());
+  }
+  return updated;
+}
+
+void SiPixelGainCalibrationForHLTGPU::apply(std::vector<Patch> const& patches, std::vector<char>& gainData) {
+  for (auto const& patch : patches) {
+    if (patch.offset > gainData.size() or patch.bytes.size() > gainData.size() - patch.offset) {
+      throw std::runtime_error("Patch of " + std::to_string(patch.bytes.size()) + " bytes at offset " +
+                               std::to_string(patch.offset) + " is outside of the " + std::to_string(gainData.size()) +
+                               " bytes of gain data");
+    }
+    std::copy(patch.bytes.begin(), patch.bytes.end(), gainData.begin() + patch.offset);
+  }
+}
 
 SiPixelGainCalibrationForHLTGPU::GPUData::~GPUData() {
   cudaCheck(cudaFree(gainForHLTonGPU));
@@ -19,20 +47,43 @@ SiPixelGainCalibrationForHLTGPU::GPUData::~GPUData() {
 }
 
 const SiPixelGainForHLTonGPU* SiPixelGainCalibrationForHLTGPU::getGPUProductAsync(cudaStream_t cudaStream) const {
-  const auto& data = gpuData_.dataForCurrentDeviceAsync(cudaStream, [this](GPUData& data, cudaStream_t stream) {
-    cudaCheck(cudaMalloc((void**)&data.gainForHLTonGPU, sizeof(SiPixelGainForHLTonGPU)));
-    cudaCheck(cudaMalloc((void**)&data.gainDataOnGPU, this->gainData_.size()));
-    // gains.data().data() is used also for non-GPU code, we cannot allocate it on aligned and write-combined memory
-    cudaCheck(
-        cudaMemcpyAsync(data.gainDataOnGPU, this->gainData_.data(), this->gainData_.size(), cudaMemcpyDefault, stream));
-
-    cudaCheck(cudaMemcpyAsync(
-        data.gainForHLTonGPU, this->gainForHLTonHost_, sizeof(SiPixelGainForHLTonGPU), cudaMemcpyDefault, stream));
-    cudaCheck(cudaMemcpyAsync(&(data.gainForHLTonGPU->v_pedestals),
-                              &(data.gainDataOnGPU),
-                              sizeof(SiPixelGainForHLTonGPU_DecodingStructure*),
-                              cudaMemcpyDefault,
-                              stream));
-  });
+  // if the previous version is released while the device-to-device copy is in flight, cudaFree()
+  // waits for the copy to complete before freeing its memory
+  auto previous = previous_.lock();
+  const auto& data = gpuData_.dataForCurrentDeviceAsync(
+      cudaStream,
+      previous ? &previous->gpuData_ : nullptr,
+      [this](GPUData& data, cudaStream_t stream) {
+        cudaCheck(cudaMalloc((void**)&data.gainDataOnGPU, this->gainData_.size()));
+        // gains.data().data() is used also for non-GPU code, we cannot allocate it on aligned and write-combined memory
+        cudaCheck(cudaMemcpyAsync(
+            data.gainDataOnGPU, this->gainData_.data(), this->gainData_.size(), cudaMemcpyDefault, stream));
+        transferGainAsync(data, stream);
+      },
+      [this, &previous](GPUData& data, GPUData const& previousData, cudaStream_t stream) {
+        assert(previous->gainData_.size() == this->gainData_.size());
+        cudaCheck(cudaMalloc((void**)&data.gainDataOnGPU, this->gainData_.size()));
+        cudaCheck(cudaMemcpyAsync(
+            data.gainDataOnGPU, previousData.gainDataOnGPU, this->gainData_.size(), cudaMemcpyDeviceToDevice, stream));
+        for (auto [offset, size] : this->patched_) {
+          cudaCheck(cudaMemcpyAsync(reinterpret_cast<char*>(data.gainDataOnGPU) + offset,
+                                    this->gainData_.data() + offset,
+                                    size,
+                                    cudaMemcpyDefault,
+                                    stream));
+        }
+        transferGainAsync(data, stream);
+      });
   return data.gainForHLTonGPU;
 }
+
+void SiPixelGainCalibrationForHLTGPU::transferGainAsync(GPUData& data, cudaStream_t stream) const {
+  cudaCheck(cudaMalloc((void**)&data.gainForHLTonGPU, sizeof(SiPixelGainForHLTonGPU)));
+  cudaCheck(cudaMemcpyAsync(
+      data.gainForHLTonGPU, this->gainForHLTonHost_.get(), sizeof(SiPixelGainForHLTonGPU), cudaMemcpyDefault, stream));
+  cudaCheck(cudaMemcpyAsync(&(data.gainForHLTonGPU->v_pedestals),
+                            &(data.gainDataOnGPU),
+                            sizeof(SiPixelGainForHLTonGPU_DecodingStructure*),
+                            cudaMemcpyDefault,
+                            stream));
+}
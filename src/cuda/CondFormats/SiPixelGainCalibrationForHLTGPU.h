@@ -1,6 +1,11 @@
 #ifndef CalibTracker_SiPixelESProducers_interface_SiPixelGainCalibrationForHLTGPU_h
 #define CalibTracker_SiPixelESProducers_interface_SiPixelGainCalibrationForHLTGPU_h
 
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "CUDACore/ESProduct.h"
 
 class SiPixelGainForHLTonGPU;
@@ -8,21 +13,47 @@ struct SiPixelGainForHLTonGPU_DecodingStructure;
 
 class SiPixelGainCalibrationForHLTGPU {
 public:
+  // bytes of the gain data to be replaced, starting at offset
+  struct Patch {
+    uint32_t offset;
+    std::vector<char> bytes;
+  };
+
   explicit SiPixelGainCalibrationForHLTGPU(SiPixelGainForHLTonGPU const &gain, std::vector<char> gainData);
   ~SiPixelGainCalibrationForHLTGPU();
 
+  // A new version of the calibration, with the patches applied to the gain data of the previous one.
+  // While the previous version is alive and on the GPU, the new one is copied from it on the device,
+  // and only the patched bytes are transferred from the host.
+  static std::unique_ptr<SiPixelGainCalibrationForHLTGPU> update(
+      std::shared_ptr<SiPixelGainCalibrationForHLTGPU const> const &previous, std::vector<Patch> const &patches);
+
+  // throws if a patch is outside of the gain data
+  static void apply(std::vector<Patch> const &patches, std::vector<char> &gainData);
+
   const SiPixelGainForHLTonGPU *getGPUProductAsync(cudaStream_t cudaStream) const;
-  const SiPixelGainForHLTonGPU *getCPUProduct() const { return gainForHLTonHost_; }
+  const SiPixelGainForHLTonGPU *getCPUProduct() const { return gainForHLTonHost_.get(); }
+  SiPixelGainForHLTonGPU const &gain() const { return *gainForHLTonHost_; }
+  std::vector<char> const &gainData() const { return gainData_; }
 
 private:
-  SiPixelGainForHLTonGPU *gainForHLTonHost_ = nullptr;
+  // pageable memory, so that the calibration can be constructed also without a GPU;
+  // v_pedestals points to gainData_
+  std::unique_ptr<SiPixelGainForHLTonGPU> gainForHLTonHost_;
   std::vector<char> gainData_;
   struct GPUData {
     ~GPUData();
     SiPixelGainForHLTonGPU *gainForHLTonGPU = nullptr;
     SiPixelGainForHLTonGPU_DecodingStructure *gainDataOnGPU = nullptr;
   };
+  // the gain data must be on the device already
+  void transferGainAsync(GPUData &data, cudaStream_t stream) const;
+
   cms::cuda::ESProduct<GPUData> gpuData_;
+
+  // the version this one has been patched from, and the (offset, size) of the patched bytes
+  std::weak_ptr<SiPixelGainCalibrationForHLTGPU const> previous_;
+  std::vector<std::pair<uint32_t, uint32_t>> patched_;
 };
 
 #endif  // CalibTracker_SiPixelESProducers_interface_SiPixelGainCalibrationForHLTGPU_h
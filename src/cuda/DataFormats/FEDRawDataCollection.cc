@@ -7,11 +7,52 @@
 #include "DataFormats/FEDRawDataCollection.h"
 #include "DataFormats/FEDNumbering.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 FEDRawDataCollection::FEDRawDataCollection() : data_(FEDNumbering::lastFEDId() + 1) {}
 
-FEDRawDataCollection::FEDRawDataCollection(const FEDRawDataCollection& in) : data_(in.data_) {}
+FEDRawDataCollection::FEDRawDataCollection(const View* view) : view_(view) {
+  if (view_->decompress) {
+    cache_ = std::make_unique<Cache>(view_->fedIds.size());
+  }
+}
+
+FEDRawDataCollection::FEDRawDataCollection(const FEDRawDataCollection& in) : data_(in.data_), view_(in.view_) {
+  // the copy decompresses the FEDs again, so that they are released together with it
+  if (in.cache_) {
+    cache_ = std::make_unique<Cache>(view_->fedIds.size());
+  }
+}
+FEDRawDataCollection::FEDRawDataCollection(FEDRawDataCollection&& in) noexcept
+    : data_(std::move(in.data_)), view_(in.view_), cache_(std::move(in.cache_)) {}
 FEDRawDataCollection::~FEDRawDataCollection() {}
 
-const FEDRawData& FEDRawDataCollection::FEDData(int fedid) const { return data_[fedid]; }
+const FEDRawData& FEDRawDataCollection::FEDData(int fedid) const {
+  if (view_) {
+    static const FEDRawData empty;
+    auto found = std::lower_bound(view_->fedIds.begin(), view_->fedIds.end(), fedid);
+    if (found == view_->fedIds.end() or *found != fedid) {
+      return empty;
+    }
+    auto const index = found - view_->fedIds.begin();
+    auto const& stored = view_->data[index];
+    if (not cache_ or stored.size() == view_->sizes[index]) {
+      return stored;
+    }
+    auto& data = cache_->data[index];
+    std::call_once(cache_->once[index], [&]() {
+      data.resize(view_->sizes[index]);
+      view_->decompress(stored, data.data(), data.size());
+    });
+    return data;
+  }
+  return data_[fedid];
+}
 
-FEDRawData& FEDRawDataCollection::FEDData(int fedid) { return data_[fedid]; }
+FEDRawData& FEDRawDataCollection::FEDData(int fedid) {
+  if (view_) {
+    throw std::runtime_error("FEDRawDataCollection::FEDData: non-const access to a read-only view.");
+  }
+  return data_[fedid];
+}
@@ -6,31 +6,74 @@
  *  
  *  Reference: DaqPrototype/DaqPersistentData/interface/DaqFEDOpaqueData.h
  *
+ *  The collection either owns one FEDRawData per possible FED id, or
+ *  refers to a sparse, read-only View of the FEDs present in the event
+ *  that is owned (together with the payloads) by someone else.
+ *
+ *  The payloads of a View may be compressed; each copy of the collection
+ *  then decompresses a FED the first time it is asked for it, and keeps
+ *  it for its own lifetime.
+ *
  *  \author N. Amapane - S. Argiro'
  */
 
 #include "DataFormats/FEDRawData.h"
 
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 class FEDRawDataCollection {
 public:
+  /// Sparse set of FEDs, sorted by FED id
+  struct View {
+    std::vector<int> fedIds;
+    std::vector<FEDRawData> data;
+
+    /// For compressed payloads, the size of each FED once decompressed by
+    /// decompress(data[i], output, sizes[i]); a payload of sizes[i] bytes
+    /// is stored uncompressed
+    using Decompress = void (*)(const FEDRawData& compressed, unsigned char* output, std::size_t size);
+    std::vector<std::size_t> sizes;
+    Decompress decompress = nullptr;
+  };
+
   FEDRawDataCollection();
 
+  /// Non-owning collection, the view must outlive this object and all its copies
+  explicit FEDRawDataCollection(const View* view);
+
   virtual ~FEDRawDataCollection();
 
-  /// retrieve data for fed @param fedid
+  /// retrieve data for fed @param fedid (thread safe)
   const FEDRawData& FEDData(int fedid) const;
 
-  /// retrieve data for fed @param fedid
+  /// retrieve data for fed @param fedid (throws for a non-owning collection)
   FEDRawData& FEDData(int fedid);
 
   FEDRawDataCollection(const FEDRawDataCollection&);
 
-  void swap(FEDRawDataCollection& other) { data_.swap(other.data_); }
+  FEDRawDataCollection(FEDRawDataCollection&&) noexcept;
+
+  void swap(FEDRawDataCollection& other) {
+    data_.swap(other.data_);
+    std::swap(view_, other.view_);
+    cache_.swap(other.cache_);
+  }
 
 private:
+  /// The FEDs of a compressed View decompressed so far
+  struct Cache {
+    explicit Cache(std::size_t nfeds) : data(nfeds), once(new std::once_flag[nfeds]) {}
+    std::vector<FEDRawData> data;
+    std::unique_ptr<std::once_flag[]> once;
+  };
+
   std::vector<FEDRawData> data_;  ///< the raw data
+  const View* view_ = nullptr;    ///< the raw data, if not owned
+  std::unique_ptr<Cache> cache_;  ///< for a compressed view, not shared with the copies
 };
 
 inline void swap(FEDRawDataCollection& a, FEDRawDataCollection& b) { a.swap(b); }
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "Framework/BlockCompression.h"
+
+namespace {
+  constexpr std::size_t kMinMatch = 4;
+  constexpr std::size_t kMaxOffset = 65535;
+  constexpr unsigned int kHashBits = 14;
+
+  uint32_t read32(std::byte const* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - kHashBits); }
+
+  // lengths of 15 or more are continued in bytes of 255, terminated by a byte smaller than 255
+  void writeLength(std::vector<std::byte>& out, std::size_t length) {
+    while (length >= 255) {
+      out.push_back(std::byte{255});
+      length -= 255;
+    }
+    out.push_back(std::byte(length));
+  }
+
+  void writeSequence(std::vector<std::byte>& out,
+                     std::byte const* literals,
+                     std::size_t nLiterals,
+                     std::size_t offset,
+                     std::size_t matchLength) {
+    auto const extraMatch = matchLength > 0 ? matchLength - kMinMatch : 0;
+    auto token = std::byte((std::min<std::size_t>(nLiterals, 15) << 4) | std::min<std::size_t>(extraMatch, 15));
+    out.push_back(token);
+    if (nLiterals >= 15) {
+      writeLength(out, nLiterals - 15);
+    }
+    out.insert(out.end(), literals, literals + nLiterals);
+    if (matchLength > 0) {
+      out.push_back(std::byte(offset & 0xff));
+      out.push_back(std::byte(offset >> 8));
+      if (extraMatch >= 15) {
+        writeLength(out, extraMatch - 15);
+      }
+    }
+  }
+
+  std::size_t readLength(std::byte const*& in, std::byte const* end, std::size_t length) {
+    if (length < 15) {
+      return length;
+    }
+    std::byte b;
+    do {
+      if (in == end) {
+        throw std::runtime_error("Corrupted compressed block: truncated length");
+      }
+      b = *in++;
+      length += std::to_integer<std::size_t>(b);
+    } while (b == std::byte{255});
+    return length;
+  }
+
+  void shuffle(std::byte const* in, std::byte* out, std::size_t size, std::size_t elementSize) {
+    auto const n = size / elementSize;
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t b = 0; b < elementSize; ++b) {
+        out[b * n + i] = in[i * elementSize + b];
+      }
+    }
+    // a trailing partial element is left as it is
+    std::memcpy(out + n * elementSize, in + n * elementSize, size - n * elementSize);
+  }
+
+  void unshuffle(std::byte const* in, std::byte* out, std::size_t size, std::size_t elementSize) {
+    auto const n = size / elementSize;
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t b = 0; b < elementSize; ++b) {
+        out[i * elementSize + b] = in[b * n + i];
+      }
+    }
+    std::memcpy(out + n * elementSize, in + n * elementSize, size - n * elementSize);
+  }
+}  // namespace
+
+namespace edm::blockCompression {
+  std::vector<std::byte> compress(std::byte const* data, std::size_t size, std::size_t elementSize) {
+    std::vector<std::byte> shuffled;
+    if (elementSize > 1) {
+      shuffled.resize(size);
+      shuffle(data, shuffled.data(), size, elementSize);
+      data = shuffled.data();
+    }
+
+    std::vector<std::byte> out;
+    out.reserve(size / 2 + 16);
+    std::vector<int64_t> table(1 << kHashBits, -1);
+    std::size_t anchor = 0;
+    std::size_t ip = 0;
+    while (ip + kMinMatch <= size) {
+      auto const sequence = read32(data + ip);
+      auto& entry = table[hash(sequence)];
+      auto const ref = entry;
+      entry = ip;
+      if (ref < 0 or ip - std::size_t(ref) > kMaxOffset or read32(data + ref) != sequence) {
+        ++ip;
+        continue;
+      }
+      auto length = kMinMatch;
+      while (ip + length < size and data[ref + length] == data[ip + length]) {
+        ++length;
+      }
+      writeSequence(out, data + anchor, ip - anchor, ip - ref, length);
+      ip += length;
+      anchor = ip;
+    }
+    // the last literals, without a match
+    writeSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+  }
+
+  void decompress(std::byte const* compressed,
+                  std::size_t compressedSize,
+                  std::byte* data,
+                  std::size_t size,
+                  std::size_t elementSize) {
+    std::vector<std::byte> shuffled;
+    std::byte* out = data;
+    if (elementSize > 1) {
+      shuffled.resize(size);
+      out = shuffled.data();
+    }
+
+    auto const* in = compressed;
+    auto const* end = compressed + compressedSize;
+    std::size_t op = 0;
+    while (in < end) {
+      auto const token = std::to_integer<std::size_t>(*in++);
+      auto const nLiterals = readLength(in, end, token >> 4);
+      if (nLiterals > std::size_t(end - in) or op + nLiterals > size) {
+        throw std::runtime_error("Corrupted compressed block: literals out of range");
+      }
+      std::memcpy(out + op, in, nLiterals);
+      in += nLiterals;
+      op += nLiterals;
+      if (in == end) {
+        break;
+      }
+      if (end - in < 2) {
+        throw std::runtime_error("Corrupted compressed block: truncated offset");
+      }
+      auto const offset = std::to_integer<std::size_t>(in[0]) | (std::to_integer<std::size_t>(in[1]) << 8);
+      in += 2;
+      auto const length = readLength(in, end, token & 0xf) + kMinMatch;
+      if (offset == 0 or offset > op or op + length > size) {
+        throw std::runtime_error("Corrupted compressed block: match out of range");
+      }
+      // the match may overlap the bytes it produces
+      for (std::size_t i = 0; i < length; ++i, ++op) {
+        out[op] = out[op - offset];
+      }
+    }
+    if (op != size) {
+      throw std::runtime_error("Corrupted compressed block: expected " + std::to_string(size) + " bytes, found " +
+                               std::to_string(op));
+    }
+
+    if (elementSize > 1) {
+      unshuffle(shuffled.data(), data, size, elementSize);
+    }
+  }
+}  // namespace edm::blockCompression
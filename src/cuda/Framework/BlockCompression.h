@@ -0,0 +1,28 @@
+#ifndef BlockCompression_h
+#define BlockCompression_h
+
+#include <cstddef>
+#include <vector>
+
+namespace edm {
+  // A small LZ77 block codec in the spirit of LZ4: the output is a sequence
+  // of literal runs and back-references of at least 4 bytes within the last
+  // 64 kB. It is fast rather than strong, which suits the output of columns
+  // of numbers on the fly.
+  //
+  // The bytes of the elements of elementSize bytes are shuffled (all the
+  // first bytes, then all the second bytes, ...) before the compression,
+  // to put the similar bytes of similar numbers next to each other.
+  namespace blockCompression {
+    std::vector<std::byte> compress(std::byte const* data, std::size_t size, std::size_t elementSize = 1);
+
+    // size is the size of the uncompressed data, throws std::runtime_error if the data are corrupted
+    void decompress(std::byte const* compressed,
+                    std::size_t compressedSize,
+                    std::byte* data,
+                    std::size_t size,
+                    std::size_t elementSize = 1);
+  }  // namespace blockCompression
+}  // namespace edm
+
+#endif
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "Framework/BlockCompression.h"
+#include "Framework/ColumnarWriter.h"
+
+namespace {
+  template <typename T>
+  void writeValue(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T readValue(std::ifstream& in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+  }
+}  // namespace
+
+namespace edm {
+  std::filesystem::path ColumnarOutput::fileName_;
+  ColumnarWriter::Compression ColumnarOutput::compression_ = ColumnarWriter::Compression::kNone;
+
+  void ColumnarOutput::setFileName(std::filesystem::path fileName, ColumnarWriter::Compression compression) {
+    fileName_ = std::move(fileName);
+    compression_ = compression;
+  }
+
+  std::size_t ColumnarWriter::sizeOf(Type type) {
+    switch (type) {
+      case Type::kUInt8:
+        return 1;
+      case Type::kUInt16:
+      case Type::kInt16:
+        return 2;
+      case Type::kUInt32:
+      case Type::kInt32:
+      case Type::kFloat:
+        return 4;
+    }
+    throw std::runtime_error("Invalid column type " + std::to_string(static_cast<int>(type)));
+  }
+
+  ColumnarWriter::ColumnarWriter(std::filesystem::path const& fileName,
+                                 std::vector<Column> columns,
+                                 Compression compression,
+                                 unsigned int eventsPerChunk,
+                                 unsigned int queueCapacity)
+      : columns_(std::move(columns)),
+        compression_(compression),
+        eventsPerChunk_(std::max(eventsPerChunk, 1U)),
+        file_(fileName, std::ios::binary),
+        chunk_(columns_.size()) {
+    if (not file_) {
+      throw std::runtime_error("Failed to open the output file " + fileName.string());
+    }
+    file_.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+
+    file_.write(magic, std::strlen(magic));
+    writeValue<uint32_t>(file_, columns_.size());
+    for (auto const& column : columns_) {
+      writeValue<uint16_t>(file_, column.name.size());
+      file_.write(column.name.data(), column.name.size());
+      writeValue(file_, column.type);
+    }
+
+    queue_.set_capacity(std::max(queueCapacity, 1U));
+    writer_ = std::thread([this]() { run(); });
+  }
+
+  ColumnarWriter::~ColumnarWriter() {
+    try {
+      close();
+    } catch (...) {
+      // the errors are reported by write() and close()
+    }
+  }
+
+  void ColumnarWriter::write(Record record) {
+    if (failed_) {
+      std::rethrow_exception(writerException_);
+    }
+    if (closed_) {
+      throw std::runtime_error("ColumnarWriter::write() called after close()");
+    }
+    queue_.push(std::make_unique<Record>(std::move(record)));
+  }
+
+  void ColumnarWriter::close() {
+    std::scoped_lock lock(closeMutex_);
+    if (writer_.joinable()) {
+      closed_ = true;
+      queue_.push(nullptr);
+      writer_.join();
+      if (failed_) {
+        std::rethrow_exception(writerException_);
+      }
+    }
+  }
+
+  void ColumnarWriter::run() {
+    try {
+      std::unique_ptr<Record> record;
+      while (true) {
+        queue_.pop(record);
+        if (not record) {
+          break;
+        }
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+          auto const& column = record->column(i);
+          chunk_[i].insert(chunk_[i].end(), column.begin(), column.end());
+        }
+        if (++chunkEvents_ == eventsPerChunk_) {
+          writeChunk();
+        }
+      }
+      if (chunkEvents_ > 0) {
+        writeChunk();
+      }
+      file_.flush();
+    } catch (...) {
+      writerException_ = std::current_exception();
+      failed_ = true;
+      // keep consuming the events, so that write() never blocks on a full queue
+      std::unique_ptr<Record> record;
+      do {
+        queue_.pop(record);
+      } while (record);
+    }
+  }
+
+  void ColumnarWriter::writeChunk() {
+    std::size_t bytes = sizeof(uint32_t);
+    writeValue<uint32_t>(file_, chunkEvents_);
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+      auto& column = chunk_[i];
+      std::vector<std::byte> compressed;
+      if (compression_ == Compression::kLZ and not column.empty()) {
+        compressed = blockCompression::compress(column.data(), column.size(), sizeOf(columns_[i].type));
+      }
+      // keep the column as it is if the compression does not help
+      bool useCompressed = not compressed.empty() and compressed.size() < column.size();
+      auto const& stored = useCompressed ? compressed : column;
+      writeValue(file_, useCompressed ? Compression::kLZ : Compression::kNone);
+      writeValue<uint64_t>(file_, column.size());
+      writeValue<uint64_t>(file_, stored.size());
+      file_.write(reinterpret_cast<char const*>(stored.data()), stored.size());
+      bytes += sizeof(Compression) + 2 * sizeof(uint64_t) + stored.size();
+      column.clear();
+    }
+    writtenEvents_ += chunkEvents_;
+    writtenBytes_ += bytes;
+    chunkEvents_ = 0;
+  }
+
+  ColumnarReader::ColumnarReader(std::filesystem::path const& fileName) : file_(fileName, std::ios::binary) {
+    if (not file_) {
+      throw std::runtime_error("Failed to open the input file " + fileName.string());
+    }
+    file_.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+
+    std::string magic(std::strlen(ColumnarWriter::magic), '\0');
+    file_.read(magic.data(), magic.size());
+    if (magic != ColumnarWriter::magic) {
+      throw std::runtime_error(fileName.string() + " is not a columnar file");
+    }
+    auto nColumns = readValue<uint32_t>(file_);
+    columns_.reserve(nColumns);
+    for (uint32_t i = 0; i < nColumns; ++i) {
+      std::string name(readValue<uint16_t>(file_), '\0');
+      file_.read(name.data(), name.size());
+      auto type = readValue<ColumnarWriter::Type>(file_);
+      columns_.push_back({std::move(name), type});
+    }
+  }
+
+  bool ColumnarReader::readChunk(uint32_t& nEvents, std::map<std::string, std::vector<std::byte>>& columns) {
+    file_.exceptions(std::ifstream::badbit);
+    if (file_.peek() == std::ifstream::traits_type::eof()) {
+      return false;
+    }
+    file_.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+
+    nEvents = readValue<uint32_t>(file_);
+    columns.clear();
+    for (auto const& column : columns_) {
+      auto compression = readValue<ColumnarWriter::Compression>(file_);
+      auto size = readValue<uint64_t>(file_);
+      auto storedSize = readValue<uint64_t>(file_);
+      std::vector<std::byte> stored(storedSize);
+      file_.read(reinterpret_cast<char*>(stored.data()), storedSize);
+      auto& data = columns[column.name];
+      if (compression == ColumnarWriter::Compression::kNone) {
+        data = std::move(stored);
+      } else if (compression == ColumnarWriter::Compression::kLZ) {
+        data.resize(size);
+        blockCompression::decompress(
+            stored.data(), stored.size(), data.data(), data.size(), ColumnarWriter::sizeOf(column.type));
+      } else {
+        throw std::runtime_error("Invalid compression of the column " + column.name);
+      }
+    }
+    return true;
+  }
+}  // namespace edm
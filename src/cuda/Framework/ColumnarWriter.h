@@ -0,0 +1,158 @@
+#ifndef ColumnarWriter_h
+#define ColumnarWriter_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/concurrent_queue.h>
+
+namespace edm {
+  // Writes the events to a chunked, column-oriented binary file in a
+  // background thread.
+  //
+  // The events are handed over as Records through a bounded queue, so the
+  // threads processing the events block only when the queue is full. The
+  // writer thread appends the columns of the Records to those of the
+  // current chunk, and writes the chunk, optionally compressed column by
+  // column, every eventsPerChunk events.
+  //
+  // The file starts with the schema, followed by the chunks:
+  //
+  //   "PXCOL001", uint32_t number of columns,
+  //   for each column: uint16_t name length, name, uint8_t Type
+  //   for each chunk: uint32_t number of events,
+  //     for each column: uint8_t Compression, uint64_t size, uint64_t stored size, stored bytes
+  //
+  // The numbers are in the native byte order (little endian on the supported
+  // platforms). The events are written in the order in which they are handed
+  // over, so an event number column is needed to identify them.
+  class ColumnarWriter {
+  public:
+    enum class Type : uint8_t { kUInt8 = 0, kUInt16, kInt16, kUInt32, kInt32, kFloat };
+    enum class Compression : uint8_t { kNone = 0, kLZ };
+
+    static constexpr char const* magic = "PXCOL001";
+
+    // the columns are declared once, before the first event
+    struct Column {
+      std::string name;
+      Type type;
+    };
+
+    // the columns of one event, indexed in the order of the declaration
+    class Record {
+    public:
+      explicit Record(std::size_t nColumns) : columns_(nColumns) {}
+
+      template <typename T>
+      void push(unsigned int column, T value) {
+        append(column, &value, 1);
+      }
+
+      template <typename T>
+      void append(unsigned int column, T const* values, std::size_t n) {
+        static_assert(std::is_arithmetic_v<T>);
+        auto& bytes = columns_[column];
+        auto const size = bytes.size();
+        bytes.resize(size + n * sizeof(T));
+        std::memcpy(bytes.data() + size, values, n * sizeof(T));
+      }
+
+      std::vector<std::byte> const& column(unsigned int i) const { return columns_[i]; }
+
+    private:
+      std::vector<std::vector<std::byte>> columns_;
+    };
+
+    ColumnarWriter(std::filesystem::path const& fileName,
+                   std::vector<Column> columns,
+                   Compression compression,
+                   unsigned int eventsPerChunk = 100,
+                   unsigned int queueCapacity = 16);
+    ~ColumnarWriter();
+    ColumnarWriter(ColumnarWriter const&) = delete;
+    ColumnarWriter& operator=(ColumnarWriter const&) = delete;
+
+    Record makeRecord() const { return Record(columns_.size()); }
+
+    // thread safe, blocks only if the queue is full; rethrows the errors of the writer thread
+    void write(Record record);
+
+    // writes the last chunk and waits for the writer thread; thread safe, the later calls have no effect
+    void close();
+
+    std::size_t writtenEvents() const { return writtenEvents_; }
+    std::size_t writtenBytes() const { return writtenBytes_; }
+
+    static std::size_t sizeOf(Type type);
+
+  private:
+    void run();
+    void writeChunk();
+
+    std::vector<Column> const columns_;
+    Compression const compression_;
+    unsigned int const eventsPerChunk_;
+
+    std::ofstream file_;
+    // a nullptr in the queue marks the end of the events
+    tbb::concurrent_bounded_queue<std::unique_ptr<Record>> queue_;
+    std::exception_ptr writerException_;
+    std::atomic<bool> failed_ = false;
+    std::atomic<bool> closed_ = false;
+    std::mutex closeMutex_;
+    std::thread writer_;
+
+    // accessed only by the writer thread
+    std::vector<std::vector<std::byte>> chunk_;
+    uint32_t chunkEvents_ = 0;
+    std::atomic<std::size_t> writtenEvents_ = 0;
+    std::atomic<std::size_t> writtenBytes_ = 0;
+  };
+
+  // Reads back the files written by ColumnarWriter, one chunk at a time.
+  class ColumnarReader {
+  public:
+    using Column = ColumnarWriter::Column;
+
+    explicit ColumnarReader(std::filesystem::path const& fileName);
+
+    std::vector<Column> const& columns() const { return columns_; }
+
+    // the (uncompressed) columns of the events of the next chunk, by name;
+    // returns false at the end of the file
+    bool readChunk(uint32_t& nEvents, std::map<std::string, std::vector<std::byte>>& columns);
+
+  private:
+    std::ifstream file_;
+    std::vector<Column> columns_;
+  };
+
+  // The output file requested on the command line, read by the output modules when they are constructed
+  class ColumnarOutput {
+  public:
+    static std::filesystem::path const& fileName() { return fileName_; }
+    static ColumnarWriter::Compression compression() { return compression_; }
+
+    // not thread safe, must be called before the modules are constructed
+    static void setFileName(std::filesystem::path fileName, ColumnarWriter::Compression compression);
+
+  private:
+    static std::filesystem::path fileName_;
+    static ColumnarWriter::Compression compression_;
+  };
+}  // namespace edm
+
+#endif
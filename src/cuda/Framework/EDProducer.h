@@ -20,6 +20,11 @@ namespace edm {
 
     virtual void produce(Event& event, EventSetup const& eventSetup) = 0;
 
+    void doEndStream() { endStream(); }
+
+    // called once the stream has no more events to process
+    virtual void endStream() {}
+
     void doEndJob() { endJob(); }
 
     virtual void endJob() {}
@@ -43,6 +48,10 @@ namespace edm {
     virtual void acquire(Event const& event, EventSetup const& eventSetup, WaitingTaskWithArenaHolder holder) = 0;
     virtual void produce(Event& event, EventSetup const& eventSetup) = 0;
 
+    void doEndStream() { endStream(); }
+    // called once the stream has no more events to process
+    virtual void endStream() {}
+
     void doEndJob() { endJob(); }
     virtual void endJob() {}
 
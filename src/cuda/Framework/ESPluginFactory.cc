@@ -6,6 +6,7 @@ namespace edm {
   namespace ESPluginFactory {
     namespace impl {
       void Registry::add(std::string const& name, std::unique_ptr<MakerBase> maker) {
+        std::lock_guard<std::mutex> guard(mutex_);
         auto found = pluginRegistry_.find(name);
         if (found != pluginRegistry_.end()) {
           throw std::logic_error("Plugin " + name + " is already registered");
@@ -14,6 +15,7 @@ namespace edm {
       }
 
       MakerBase const* Registry::get(std::string const& name) {
+        std::lock_guard<std::mutex> guard(mutex_);
         auto found = pluginRegistry_.find(name);
         if (found == pluginRegistry_.end()) {
           throw std::logic_error("Plugin " + name + " is not registered");
@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -10,7 +11,7 @@
 
 class ProductRegistry;
 
-// Nothing here is thread safe
+// The registry is thread safe, so that the plugins can be loaded and the ESProducers created concurrently
 namespace edm {
   namespace ESPluginFactory {
     namespace impl {
@@ -35,6 +36,7 @@ namespace edm {
         MakerBase const* get(std::string const& name);
 
       private:
+        std::mutex mutex_;
         std::unordered_map<std::string, std::unique_ptr<MakerBase>> pluginRegistry_;
       };
 
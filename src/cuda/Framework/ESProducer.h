@@ -1,15 +1,36 @@
 #ifndef ESProducer_h
 #define ESProducer_h
 
+#include <limits>
+#include <vector>
+
 namespace edm {
   class EventSetup;
 
+  // Interval of validity of the products of an ESProducer, between two event IDs (included)
+  struct IOV {
+    static constexpr int kEndOfJob = std::numeric_limits<int>::max();
+
+    bool contains(int eventID) const { return first <= eventID and eventID <= last; }
+
+    int first = 0;
+    int last = kEndOfJob;
+  };
+
   class ESProducer {
   public:
     ESProducer() = default;
     virtual ~ESProducer() = default;
 
+    // produces the products valid for the whole job, or for its first interval of validity
     virtual void produce(EventSetup& eventSetup) = 0;
+
+    // The producers whose products change during the job return the IDs of the first events of the
+    // intervals of validity after the first one, in increasing order, and produce the products of
+    // those intervals in produceIOV(). It may be called concurrently with the processing of the events
+    // of the previous intervals, but never concurrently with itself.
+    virtual std::vector<int> iovBoundaries() const { return {}; }
+    virtual void produceIOV(EventSetup& eventSetup, IOV const& iov) {}
   };
 }  // namespace edm
 
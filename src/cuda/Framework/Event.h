@@ -1,10 +1,12 @@
 #ifndef Event_h
 #define Event_h
 
-#include <memory>
+#include <cassert>
+#include <new>
 #include <utility>
 #include <vector>
 
+#include "Framework/EventArena.h"
 #include "Framework/ProductRegistry.h"
 
 // type erasure
@@ -28,10 +30,17 @@ namespace edm {
     T obj_;
   };
 
+  // The Event object of a stream is reused for all its events: the
+  // products are constructed in the EventArena, and destroyed by
+  // clear() at the end of each event.
   class Event {
   public:
     explicit Event(int streamId, int eventId, ProductRegistry const& reg)
-        : streamId_(streamId), eventId_(eventId), products_(reg.size()) {}
+        : streamId_(streamId), eventId_(eventId), products_(reg.size(), nullptr) {}
+    ~Event() { clear(); }
+
+    Event(Event const&) = delete;
+    Event& operator=(Event const&) = delete;
 
     StreamID streamID() const { return streamId_; }
     int eventID() const { return eventId_; }
@@ -43,13 +52,48 @@ namespace edm {
 
     template <typename T, typename... Args>
     void emplace(EDPutTokenT<T> const& token, Args&&... args) {
-      products_[token.index()] = std::make_unique<Wrapper<T>>(std::forward<Args>(args)...);
+      auto& product = products_[token.index()];
+      if (product) {
+        product->~WrapperBase();
+      }
+      product = nullptr;
+      void* mem = arena_.allocate(sizeof(Wrapper<T>), alignof(Wrapper<T>));
+      product = new (mem) Wrapper<T>(std::forward<Args>(args)...);
+    }
+
+    // prepare for the next event, after clear()
+    void setEventID(int eventId) {
+      assert(not hasProducts());
+      eventId_ = eventId;
+    }
+
+    // destroy all products and release their memory to the arena
+    void clear() {
+      for (auto& product : products_) {
+        if (product) {
+          product->~WrapperBase();
+          product = nullptr;
+        }
+      }
+      arena_.reset();
     }
 
+    EventArena const& arena() const { return arena_; }
+
   private:
+    bool hasProducts() const {
+      for (auto const* product : products_) {
+        if (product) {
+          return true;
+        }
+      }
+      return false;
+    }
+
     StreamID streamId_;
     int eventId_;
-    std::vector<std::unique_ptr<WrapperBase>> products_;
+    std::vector<WrapperBase*> products_;
+    EventArena arena_;
   };
 }  // namespace edm
 
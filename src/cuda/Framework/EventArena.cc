@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "Framework/EventArena.h"
+
+namespace edm {
+  EventArena::EventArena(std::size_t chunkSize) {
+    // a few chunks before the steady state is reached
+    chunks_.reserve(8);
+    addChunk(chunkSize);
+  }
+
+  void* EventArena::allocate(std::size_t bytes, std::size_t alignment) {
+    auto align = [alignment](std::byte* base, std::size_t offset) {
+      auto address = reinterpret_cast<std::uintptr_t>(base) + offset;
+      return offset + (alignment - address % alignment) % alignment;
+    };
+
+    auto* chunk = &chunks_.back();
+    auto begin = align(chunk->data.get(), offset_);
+    if (begin + bytes > chunk->size) {
+      addChunk(std::max(chunk->size * 2, bytes + alignment));
+      chunk = &chunks_.back();
+      begin = align(chunk->data.get(), 0);
+    }
+    offset_ = begin + bytes;
+    return chunk->data.get() + begin;
+  }
+
+  void EventArena::reset() {
+    if (chunks_.size() > 1) {
+      auto size = capacity();
+      chunks_.clear();
+      addChunk(size);
+    }
+    offset_ = 0;
+  }
+
+  std::size_t EventArena::capacity() const {
+    std::size_t size = 0;
+    for (auto const& chunk : chunks_) {
+      size += chunk.size;
+    }
+    return size;
+  }
+
+  void EventArena::addChunk(std::size_t size) {
+    // no need to zero the memory
+    chunks_.push_back(Chunk{std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+    offset_ = 0;
+    ++chunkAllocations_;
+  }
+}  // namespace edm
@@ -0,0 +1,54 @@
+#ifndef EventArena_h
+#define EventArena_h
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace edm {
+  // Bump allocator for the product wrappers of one Event. The memory is
+  // released all at once by reset() at the end of the event; the
+  // destructors of the objects must have been called before.
+  //
+  // If an event needed more than one chunk, reset() replaces them with
+  // a single chunk large enough for all of them, so that at steady
+  // state each event is served from one chunk without any allocation.
+  //
+  // Not thread safe, an arena is used by a single stream at a time.
+  class EventArena {
+  public:
+    static constexpr std::size_t kDefaultChunkSize = 4096;
+
+    explicit EventArena(std::size_t chunkSize = kDefaultChunkSize);
+    ~EventArena() = default;
+
+    EventArena(EventArena const&) = delete;
+    EventArena& operator=(EventArena const&) = delete;
+    EventArena(EventArena&&) = default;
+    EventArena& operator=(EventArena&&) = default;
+
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    void reset();
+
+    // total size of the chunks
+    std::size_t capacity() const;
+
+    // number of chunks allocated since construction
+    std::size_t chunkAllocations() const { return chunkAllocations_; }
+
+  private:
+    struct Chunk {
+      std::unique_ptr<std::byte[]> data;
+      std::size_t size;
+    };
+
+    void addChunk(std::size_t size);
+
+    std::vector<Chunk> chunks_;
+    std::size_t offset_ = 0;  // in the last chunk
+    std::size_t chunkAllocations_ = 0;
+  };
+}  // namespace edm
+
+#endif
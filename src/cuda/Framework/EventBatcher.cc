@@ -0,0 +1,15 @@
+#include <stdexcept>
+#include <string>
+
+#include "Framework/EventBatcher.h"
+
+namespace edm {
+  int EventBatching::batchSize_ = 1;
+
+  void EventBatching::setBatchSize(int batchSize) {
+    if (batchSize < 1) {
+      throw std::runtime_error("Invalid batch size " + std::to_string(batchSize) + ", must be at least 1");
+    }
+    batchSize_ = batchSize;
+  }
+}  // namespace edm
@@ -0,0 +1,91 @@
+#ifndef EventBatcher_h
+#define EventBatcher_h
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace edm {
+  // Groups the events of the concurrent streams into batches, for the
+  // modules that process several events at once. Each stream (i.e. each
+  // instance of the module, that share one EventBatcher) adds one entry per
+  // event, and the call that completes a batch returns it, so that the
+  // calling stream processes the whole batch and notifies the others.
+  //
+  // A batch is complete when it has batchSize() entries, or one entry from
+  // each of the streams that are still running: waiting for more would
+  // never end, as a stream does not start its next event before the
+  // current one is done. The streams are added by addStream(), and removed
+  // by removeStream() when they have no more events to process.
+  //
+  // All the functions are thread safe.
+  template <typename T>
+  class EventBatcher {
+  public:
+    explicit EventBatcher(int batchSize) : batchSize_(batchSize) { pending_.reserve(batchSize_); }
+
+    int batchSize() const { return batchSize_; }
+
+    void addStream() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++nStreams_;
+    }
+
+    // Returns the batch if it has been completed by this entry, or an empty
+    // vector if the entry will be processed with a batch returned later
+    std::vector<T> add(T entry) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(std::move(entry));
+      return takeIfComplete();
+    }
+
+    // Returns the batch if it was waiting only for the stream being removed
+    std::vector<T> removeStream() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --nStreams_;
+      return takeIfComplete();
+    }
+
+  private:
+    std::vector<T> takeIfComplete() {
+      std::vector<T> batch;
+      if (not pending_.empty() and pending_.size() >= static_cast<size_t>(std::min(batchSize_, nStreams_))) {
+        batch.swap(pending_);
+        pending_.reserve(batchSize_);
+      }
+      return batch;
+    }
+
+    std::mutex mutex_;
+    std::vector<T> pending_;
+    int const batchSize_;
+    int nStreams_ = 0;
+  };
+
+  // Calls f(begin, end) for each run of consecutive entries of the batch for
+  // which same(entry, first entry of the run) holds, e.g. the events that are
+  // in the same interval of validity of the ES products
+  template <typename T, typename Same, typename F>
+  void forEachGroup(std::vector<T>& batch, Same same, F f) {
+    for (auto begin = batch.begin(); begin != batch.end();) {
+      auto end = std::find_if_not(begin, batch.end(), [&](T const& entry) { return same(entry, *begin); });
+      f(begin, end);
+      begin = end;
+    }
+  }
+
+  // Number of events that the modules supporting it process in one batch,
+  // 1 (the default) disables the batching
+  class EventBatching {
+  public:
+    static int batchSize() { return batchSize_; }
+
+    // not thread safe, must be called before the modules are constructed
+    static void setBatchSize(int batchSize);
+
+  private:
+    static int batchSize_;
+  };
+}  // namespace edm
+
+#endif
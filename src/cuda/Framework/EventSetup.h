@@ -2,10 +2,13 @@
 #define EventSetup_h
 
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <typeindex>
 #include <unordered_map>
+#include <vector>
 
-#include <iostream>
+#include "Framework/ESProducer.h"
 
 namespace edm {
   // This is very different from CMSSW, but (hopefully) good-enough
@@ -18,22 +21,31 @@ namespace edm {
   template <typename T>
   class ESWrapper : public ESWrapperBase {
   public:
-    explicit ESWrapper(std::unique_ptr<T> obj) : obj_{std::move(obj)} {}
+    explicit ESWrapper(std::shared_ptr<T const> obj) : obj_{std::move(obj)} {}
 
     T const& product() const { return *obj_; }
 
   private:
-    std::unique_ptr<T> obj_;
+    std::shared_ptr<T const> obj_;
   };
 
+  // The products are shared by the EventSetups of the streams that process events in the
+  // same interval of validity, and are deleted when no stream uses them any more (see
+  // EventSetupProvider)
   class EventSetup {
   public:
     explicit EventSetup() {}
 
     template <typename T>
     void put(std::unique_ptr<T> prod) {
+      put(std::shared_ptr<T const>(std::move(prod)));
+    }
+
+    // for the ESProducers that keep a (weak) reference to the products, e.g. to build the next version from them
+    template <typename T>
+    void put(std::shared_ptr<T const> prod) {
       auto succeeded =
-          typeToProduct_.try_emplace(std::type_index(typeid(T)), std::make_unique<ESWrapper<T>>(std::move(prod)));
+          typeToProduct_.try_emplace(std::type_index(typeid(T)), std::make_shared<ESWrapper<T>>(std::move(prod)));
       if (not succeeded.second) {
         throw std::runtime_error(std::string("Product of type ") + typeid(T).name() + " already exists");
       }
@@ -49,7 +61,11 @@ namespace edm {
     }
 
   private:
-    std::unordered_map<std::type_index, std::unique_ptr<ESWrapperBase>> typeToProduct_;
+    friend class EventSetupProvider;
+
+    std::unordered_map<std::type_index, std::shared_ptr<ESWrapperBase const>> typeToProduct_;
+    // interval of validity of the products of each ESProducer, set by the EventSetupProvider
+    std::vector<IOV> iovs_;
   };
 }  // namespace edm
 
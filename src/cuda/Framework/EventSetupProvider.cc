@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+
+#include <tbb/parallel_for.h>
+
+#include "Framework/EventSetupProvider.h"
+#include "Framework/Tracer.h"
+
+namespace edm {
+  void EventSetupProvider::add(std::string const& name, std::unique_ptr<ESProducer> esp, EventSetup& eventSetup) {
+    auto producer = makeProducer(name, std::move(esp));
+    auto products = produce(*producer, 0);
+    insert(std::move(producer), std::move(products), eventSetup);
+  }
+
+  void EventSetupProvider::add(std::vector<std::string> const& names, Factory const& create, EventSetup& eventSetup) {
+    // the ESProducers do not read the products of each other, so they are all independent
+    std::vector<std::unique_ptr<Producer>> producers(names.size());
+    std::vector<std::vector<std::shared_ptr<ESWrapperBase const>>> products(names.size());
+    tbb::parallel_for(std::size_t(0), names.size(), [&](std::size_t i) {
+      producers[i] = makeProducer(names[i], create(names[i]));
+      products[i] = produce(*producers[i], 0);
+    });
+    // the same order as with sequential calls, also for the errors about duplicated products
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      insert(std::move(producers[i]), std::move(products[i]), eventSetup);
+    }
+  }
+
+  std::unique_ptr<EventSetupProvider::Producer> EventSetupProvider::makeProducer(std::string const& name,
+                                                                                 std::unique_ptr<ESProducer> esp) {
+    auto producer = std::make_unique<Producer>();
+    producer->producer = std::move(esp);
+    producer->name = name;
+    if (Tracer::enabled()) {
+      producer->traceName = Tracer::intern(name);
+    }
+    producer->boundaries = producer->producer->iovBoundaries();
+    if (not producer->boundaries.empty() and
+        (producer->boundaries.front() <= 0 or
+         std::adjacent_find(producer->boundaries.begin(), producer->boundaries.end(), std::greater_equal<int>()) !=
+             producer->boundaries.end())) {
+      throw std::runtime_error("The intervals of validity of the ESProducer " + name + " are not in increasing order");
+    }
+    producer->products.resize(producer->boundaries.size() + 1);
+    return producer;
+  }
+
+  void EventSetupProvider::insert(std::unique_ptr<Producer> producer,
+                                  std::vector<std::shared_ptr<ESWrapperBase const>> products,
+                                  EventSetup& eventSetup) {
+    for (std::size_t i = 0; i < products.size(); ++i) {
+      auto succeeded = eventSetup.typeToProduct_.try_emplace(producer->types[i], std::move(products[i]));
+      if (not succeeded.second) {
+        throw std::runtime_error(std::string("Product of type ") + producer->types[i].name() + " already exists");
+      }
+    }
+    eventSetup.iovs_.push_back(iov(*producer, 0));
+    producers_.push_back(std::move(producer));
+  }
+
+  void EventSetupProvider::update(EventSetup& eventSetup, int eventID) {
+    assert(eventSetup.iovs_.size() == producers_.size());
+    for (std::size_t i = 0; i < producers_.size(); ++i) {
+      if (eventSetup.iovs_[i].contains(eventID)) {
+        continue;
+      }
+
+      auto& producer = *producers_[i];
+      int index = std::upper_bound(producer.boundaries.begin(), producer.boundaries.end(), eventID) -
+                  producer.boundaries.begin();
+      std::vector<std::shared_ptr<ESWrapperBase const>> products;
+      {
+        std::lock_guard<std::mutex> guard(producer.mutex);
+        // reuse the products if another stream still uses them
+        for (auto const& product : producer.products[index]) {
+          products.push_back(product.lock());
+          if (not products.back()) {
+            products.clear();
+            break;
+          }
+        }
+        if (products.empty()) {
+          products = produce(producer, index);
+          ++reloads_;
+        }
+      }
+
+      // the products of the previous IOV are deleted here if no other stream uses them
+      for (std::size_t j = 0; j < products.size(); ++j) {
+        eventSetup.typeToProduct_[producer.types[j]] = std::move(products[j]);
+      }
+      eventSetup.iovs_[i] = iov(producer, index);
+    }
+  }
+
+  IOV EventSetupProvider::iov(Producer const& producer, int index) {
+    IOV iov;
+    if (index > 0) {
+      iov.first = producer.boundaries[index - 1];
+    }
+    if (index < int(producer.boundaries.size())) {
+      iov.last = producer.boundaries[index] - 1;
+    }
+    return iov;
+  }
+
+  std::vector<std::shared_ptr<ESWrapperBase const>> EventSetupProvider::produce(Producer& producer, int index) {
+    EventSetup produced;
+    Tracer::Clock::time_point begin;
+    if (producer.traceName) {
+      begin = Tracer::Clock::now();
+    }
+    if (index == 0) {
+      producer.producer->produce(produced);
+    } else {
+      producer.producer->produceIOV(produced, iov(producer, index));
+    }
+    if (producer.traceName) {
+      Tracer::complete("esproducer", producer.traceName, begin, Tracer::Clock::now(), -1, -1);
+    }
+
+    // the types of the products are those of the first IOV
+    if (index == 0 and producer.types.empty()) {
+      for (auto const& product : produced.typeToProduct_) {
+        producer.types.push_back(product.first);
+      }
+    }
+    if (produced.typeToProduct_.size() != producer.types.size()) {
+      throw std::runtime_error("The ESProducer " + producer.name +
+                               " produced different products in the interval of validity starting at event " +
+                               std::to_string(iov(producer, index).first));
+    }
+
+    std::vector<std::shared_ptr<ESWrapperBase const>> products;
+    auto& cached = producer.products[index];
+    cached.clear();
+    for (auto const& type : producer.types) {
+      auto found = produced.typeToProduct_.find(type);
+      if (found == produced.typeToProduct_.end()) {
+        throw std::runtime_error("The ESProducer " + producer.name + " did not produce the product of type " +
+                                 type.name() + " in the interval of validity starting at event " +
+                                 std::to_string(iov(producer, index).first));
+      }
+      cached.push_back(found->second);
+      products.push_back(std::move(found->second));
+    }
+    return products;
+  }
+}  // namespace edm
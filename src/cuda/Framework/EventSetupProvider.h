@@ -0,0 +1,77 @@
+#ifndef EventSetupProvider_h
+#define EventSetupProvider_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include "Framework/ESProducer.h"
+#include "Framework/EventSetup.h"
+
+namespace edm {
+  // Owns the ESProducers, and keeps the EventSetup of each stream valid for
+  // the event being processed by the stream.
+  //
+  // The products of an interval of validity (IOV) are produced by the first
+  // stream that reaches it, and shared with the other streams that reach it
+  // while they are still in use. Only the products of the ESProducers whose
+  // IOV changes are replaced; the previous ones are deleted when the last
+  // stream that uses them moves on, so that there is no need to wait for the
+  // events in flight.
+  class EventSetupProvider {
+  public:
+    EventSetupProvider() = default;
+    EventSetupProvider(EventSetupProvider const&) = delete;
+    EventSetupProvider& operator=(EventSetupProvider const&) = delete;
+
+    using Factory = std::function<std::unique_ptr<ESProducer>(std::string const& name)>;
+
+    // not thread safe, runs the producer for its first IOV, putting the
+    // products in eventSetup
+    void add(std::string const& name, std::unique_ptr<ESProducer> producer, EventSetup& eventSetup);
+
+    // not thread safe, creates the producers with create and runs them for
+    // their first IOV concurrently on the TBB pool; the products are put in
+    // eventSetup in the order of names, as with the add() above
+    void add(std::vector<std::string> const& names, Factory const& create, EventSetup& eventSetup);
+
+    // thread safe, updates the EventSetup of a stream to the IOVs that
+    // contain eventID
+    void update(EventSetup& eventSetup, int eventID);
+
+    // thread safe, number of times the products of an IOV have been produced
+    // after the construction
+    int reloads() const { return reloads_; }
+
+  private:
+    struct Producer {
+      std::unique_ptr<ESProducer> producer;
+      std::string name;
+      char const* traceName = nullptr;
+      std::vector<std::type_index> types;  // of the products
+      std::vector<int> boundaries;         // first events of the IOVs after the first one
+
+      // the products of each IOV, while some stream uses them
+      std::mutex mutex;
+      std::vector<std::vector<std::weak_ptr<ESWrapperBase const>>> products;  // guarded by mutex
+    };
+
+    static std::unique_ptr<Producer> makeProducer(std::string const& name, std::unique_ptr<ESProducer> esp);
+    void insert(std::unique_ptr<Producer> producer,
+                std::vector<std::shared_ptr<ESWrapperBase const>> products,
+                EventSetup& eventSetup);
+
+    static IOV iov(Producer const& producer, int index);
+    // runs the producer for the IOV index, and returns the products in the order of producer.types
+    static std::vector<std::shared_ptr<ESWrapperBase const>> produce(Producer& producer, int index);
+
+    std::vector<std::unique_ptr<Producer>> producers_;
+    std::atomic<int> reloads_ = 0;
+  };
+}  // namespace edm
+
+#endif
@@ -0,0 +1,29 @@
+#include <algorithm>
+#include <cctype>
+
+#include "Framework/IOVFiles.h"
+
+namespace edm {
+  std::vector<int> iovFirstEvents(std::filesystem::path const& datadir, std::string const& name) {
+    std::vector<int> firstEvents;
+    auto const prefix = name + "_";
+    for (auto const& entry : std::filesystem::directory_iterator(datadir)) {
+      auto const filename = entry.path().filename();
+      auto const stem = filename.stem().string();
+      if (filename.extension() != ".bin" or stem.size() <= prefix.size() or
+          stem.compare(0, prefix.size(), prefix) != 0) {
+        continue;
+      }
+      auto const number = stem.substr(prefix.size());
+      if (std::all_of(number.begin(), number.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        firstEvents.push_back(std::stoi(number));
+      }
+    }
+    std::sort(firstEvents.begin(), firstEvents.end());
+    return firstEvents;
+  }
+
+  std::filesystem::path iovFile(std::filesystem::path const& datadir, std::string const& name, int firstEvent) {
+    return datadir / (name + "_" + std::to_string(firstEvent) + ".bin");
+  }
+}  // namespace edm
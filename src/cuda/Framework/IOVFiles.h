@@ -0,0 +1,18 @@
+#ifndef IOVFiles_h
+#define IOVFiles_h
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace edm {
+  // The conditions of the intervals of validity after the first one are read from the files
+  // <name>_<ID of the first event>.bin of the data directory, e.g. beamspot_5000.bin
+
+  // returns the IDs of the first events of those intervals of validity, in increasing order
+  std::vector<int> iovFirstEvents(std::filesystem::path const& datadir, std::string const& name);
+
+  std::filesystem::path iovFile(std::filesystem::path const& datadir, std::string const& name, int firstEvent);
+}  // namespace edm
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef JsonQuoted_h
+#define JsonQuoted_h
+
+#include <cstdio>
+#include <ostream>
+
+namespace edm {
+  // Writes the string between quotes, escaped for JSON
+  struct JsonQuoted {
+    char const* str;
+  };
+
+  inline std::ostream& operator<<(std::ostream& out, JsonQuoted q) {
+    out << '"';
+    for (char const* c = q.str; *c != '\0'; ++c) {
+      if (*c == '"' or *c == '\\') {
+        out << '\\' << *c;
+      } else if (static_cast<unsigned char>(*c) < 0x20) {
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(*c));
+        out << buffer;
+      } else {
+        out << *c;
+      }
+    }
+    return out << '"';
+  }
+}  // namespace edm
+
+#endif
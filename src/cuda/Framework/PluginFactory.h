@@ -2,6 +2,7 @@
 #define PluginFactory_h
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -9,7 +10,7 @@
 
 class ProductRegistry;
 
-// Nothing here is thread safe
+// The registry is thread safe, so that the plugins can be loaded and the modules created concurrently
 namespace edm {
   namespace PluginFactory {
     namespace impl {
@@ -34,6 +35,7 @@ namespace edm {
         MakerBase const* get(std::string const& name);
 
       private:
+        std::mutex mutex_;
         std::unordered_map<std::string, std::unique_ptr<MakerBase>> pluginRegistry_;
       };
 
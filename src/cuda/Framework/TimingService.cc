@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+#include "Framework/JsonQuoted.h"
+#include "Framework/TimingService.h"
+
+namespace {
+  char const* const stageNames[] = {"queue", "acquire", "produce"};
+
+  struct Summary {
+    explicit Summary(std::vector<float> samples) : count(samples.size()) {
+      if (samples.empty()) {
+        return;
+      }
+      total = std::accumulate(samples.begin(), samples.end(), 0.);
+      mean = total / count;
+      std::sort(samples.begin(), samples.end());
+      p50 = samples[(count - 1) * 50 / 100];
+      p99 = samples[(count - 1) * 99 / 100];
+    }
+
+    std::size_t count = 0;
+    double mean = 0.;
+    double p50 = 0.;
+    double p99 = 0.;
+    double total = 0.;
+  };
+
+  // all times in microseconds
+  void writeJsonSummary(std::ostream& os, Summary const& s) {
+    os << "{\"count\": " << s.count << ", \"mean\": " << s.mean << ", \"p50\": " << s.p50 << ", \"p99\": " << s.p99
+       << ", \"total\": " << s.total << "}";
+  }
+}  // namespace
+
+namespace edm {
+  TimingService::Record* TimingService::record(std::string const& moduleName, int streamId) {
+    auto found = std::find_if(modules_.begin(), modules_.end(), [&](Module const& m) { return m.name == moduleName; });
+    if (found == modules_.end()) {
+      modules_.emplace_back(Module{moduleName, {}});
+      found = modules_.end() - 1;
+    }
+    auto& streams = found->streams;
+    if (static_cast<int>(streams.size()) <= streamId) {
+      streams.resize(streamId + 1);
+    }
+    if (not streams[streamId]) {
+      streams[streamId] = std::make_unique<Record>();
+    }
+    return streams[streamId].get();
+  }
+
+  void TimingService::printSummary(std::ostream& os) const {
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+    os << "Timing summary, times in ms, all streams combined\n"
+       << std::left << std::setw(32) << "Module" << std::setw(9) << "Stage" << std::right << std::setw(9) << "Calls"
+       << std::setw(12) << "Mean" << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(14) << "Total"
+       << "\n";
+    os << std::fixed << std::setprecision(3);
+    for (auto const& module : modules_) {
+      for (int stage = 0; stage < kNumberOfStages; ++stage) {
+        std::vector<float> samples;
+        for (auto const& stream : module.streams) {
+          if (stream) {
+            auto const& s = stream->samples(static_cast<Stage>(stage));
+            samples.insert(samples.end(), s.begin(), s.end());
+          }
+        }
+        if (samples.empty()) {
+          continue;
+        }
+        Summary s(std::move(samples));
+        os << std::left << std::setw(32) << module.name << std::setw(9) << stageNames[stage] << std::right
+           << std::setw(9) << s.count << std::setw(12) << s.mean / 1e3 << std::setw(12) << s.p50 / 1e3
+           << std::setw(12) << s.p99 / 1e3 << std::setw(14) << s.total / 1e3 << "\n";
+      }
+    }
+    os.flags(flags);
+    os.precision(precision);
+    os << std::flush;
+  }
+
+  void TimingService::writeJson(std::filesystem::path const& filename) const {
+    std::ofstream out(filename);
+    if (not out) {
+      throw std::runtime_error("Failed to open " + filename.string() + " for writing");
+    }
+    out << "{\n  \"unit\": \"us\",\n  \"modules\": [";
+    bool firstModule = true;
+    for (auto const& module : modules_) {
+      out << (firstModule ? "" : ",") << "\n    {\"name\": " << JsonQuoted{module.name.c_str()} << ", \"streams\": [";
+      firstModule = false;
+      bool firstStream = true;
+      for (std::size_t streamId = 0; streamId < module.streams.size(); ++streamId) {
+        auto const& stream = module.streams[streamId];
+        if (not stream) {
+          continue;
+        }
+        out << (firstStream ? "" : ",") << "\n      {\"stream\": " << streamId;
+        firstStream = false;
+        for (int stage = 0; stage < kNumberOfStages; ++stage) {
+          out << ", \"" << stageNames[stage] << "\": ";
+          writeJsonSummary(out, Summary(stream->samples(static_cast<Stage>(stage))));
+        }
+        out << "}";
+      }
+      out << "\n    ]}";
+    }
+    out << "\n  ]\n}\n";
+  }
+}  // namespace edm
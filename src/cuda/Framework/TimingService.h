@@ -0,0 +1,61 @@
+#ifndef TimingService_h
+#define TimingService_h
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace edm {
+  // Collects the per-module, per-stream latencies of the acquire() and
+  // produce() calls, and the queueing delay between the completion of
+  // the prefetching (i.e. all consumed products being available) and
+  // the start of the module execution.
+  //
+  // The Workers record the timings only if they have been given a
+  // Record, otherwise the cost is a single branch per call.
+  class TimingService {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Stage { kQueue = 0, kAcquire, kProduce, kNumberOfStages };
+
+    // Samples (in microseconds) of one module on one stream. Filled
+    // only by the tasks of that module on that stream, that never run
+    // concurrently, so no synchronization is needed.
+    class Record {
+    public:
+      void fill(Stage stage, Clock::time_point begin, Clock::time_point end) {
+        samples_[stage].push_back(std::chrono::duration<float, std::micro>(end - begin).count());
+      }
+
+      std::vector<float> const& samples(Stage stage) const { return samples_[stage]; }
+
+    private:
+      std::array<std::vector<float>, kNumberOfStages> samples_;
+    };
+
+    TimingService() = default;
+
+    // not thread safe
+    Record* record(std::string const& moduleName, int streamId);
+
+    // not thread safe, to be called after all events have been processed
+    void printSummary(std::ostream& os) const;
+    void writeJson(std::filesystem::path const& filename) const;
+
+  private:
+    struct Module {
+      std::string name;
+      std::vector<std::unique_ptr<Record>> streams;
+    };
+
+    // in the order of the first call to record()
+    std::vector<Module> modules_;
+  };
+}  // namespace edm
+
+#endif
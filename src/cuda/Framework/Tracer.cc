@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Framework/JsonQuoted.h"
+#include "Framework/Tracer.h"
+
+namespace {
+  enum class Kind : int8_t { kComplete, kEvent, kAsync };
+
+  struct Record {
+    Kind kind;
+    char const* category;
+    char const* name;
+    void const* id;
+    edm::Tracer::Clock::time_point begin;
+    edm::Tracer::Clock::time_point end;
+    int streamId;
+    int eventId;
+  };
+
+  // Filled only by its own thread, so appending needs no synchronization.
+  // Owned by the Tracer so that the records survive the thread.
+  struct ThreadBuffer {
+    explicit ThreadBuffer(int i) : index(i) { records.reserve(4096); }
+
+    int index;
+    std::vector<Record> records;
+  };
+
+  struct TracerData {
+    edm::Tracer::Clock::time_point start;
+    std::mutex mutex;  // protects buffers and names
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::deque<std::string> names;
+  };
+
+  TracerData& data() {
+    static TracerData data;
+    return data;
+  }
+
+  ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (not buffer) {
+      auto& d = data();
+      std::lock_guard<std::mutex> guard(d.mutex);
+      d.buffers.emplace_back(std::make_unique<ThreadBuffer>(d.buffers.size()));
+      buffer = d.buffers.back().get();
+    }
+    return *buffer;
+  }
+
+  double microseconds(edm::Tracer::Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  }
+
+  constexpr int kThreadsPid = 1;
+  constexpr int kStreamsPid = 2;
+}  // namespace
+
+namespace edm {
+  bool Tracer::enabled_ = false;
+
+  void Tracer::enable() {
+    data().start = Clock::now();
+    enabled_ = true;
+  }
+
+  char const* Tracer::intern(std::string const& name) {
+    auto& d = data();
+    std::lock_guard<std::mutex> guard(d.mutex);
+    return d.names.emplace_back(name).c_str();
+  }
+
+  void Tracer::complete(char const* category,
+                        char const* name,
+                        Clock::time_point begin,
+                        Clock::time_point end,
+                        int streamId,
+                        int eventId) {
+    threadBuffer().records.push_back(Record{Kind::kComplete, category, name, nullptr, begin, end, streamId, eventId});
+  }
+
+  void Tracer::event(int streamId, int eventId, Clock::time_point begin, Clock::time_point end) {
+    threadBuffer().records.push_back(Record{Kind::kEvent, "event", "event", nullptr, begin, end, streamId, eventId});
+  }
+
+  void Tracer::async(
+      char const* category, char const* name, void const* id, Clock::time_point begin, Clock::time_point end) {
+    threadBuffer().records.push_back(Record{Kind::kAsync, category, name, id, begin, end, -1, -1});
+  }
+
+  void Tracer::writeChromeTrace(std::filesystem::path const& filename) {
+    std::ofstream out(filename);
+    if (not out) {
+      throw std::runtime_error("Failed to open " + filename.string() + " for writing");
+    }
+    auto const& d = data();
+    int maxStreamId = -1;
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": " << kThreadsPid
+        << ", \"args\": {\"name\": \"threads\"}}";
+    out << ",\n{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": " << kStreamsPid
+        << ", \"args\": {\"name\": \"streams\"}}";
+    for (auto const& buffer : d.buffers) {
+      out << ",\n{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " << kThreadsPid << ", \"tid\": " << buffer->index
+          << ", \"args\": {\"name\": \"thread " << buffer->index << "\"}}";
+      for (auto const& r : buffer->records) {
+        auto const ts = microseconds(r.begin - d.start);
+        auto const dur = microseconds(r.end - r.begin);
+        switch (r.kind) {
+          case Kind::kComplete:
+            out << ",\n{\"ph\": \"X\", \"cat\": " << JsonQuoted{r.category} << ", \"name\": " << JsonQuoted{r.name}
+                << ", \"pid\": " << kThreadsPid << ", \"tid\": " << buffer->index << ", \"ts\": " << ts
+                << ", \"dur\": " << dur << ", \"args\": {\"stream\": " << r.streamId << ", \"event\": " << r.eventId
+                << "}}";
+            break;
+          case Kind::kEvent:
+            maxStreamId = std::max(maxStreamId, r.streamId);
+            out << ",\n{\"ph\": \"X\", \"cat\": " << JsonQuoted{r.category} << ", \"name\": \"event " << r.eventId
+                << "\", \"pid\": " << kStreamsPid << ", \"tid\": " << r.streamId << ", \"ts\": " << ts
+                << ", \"dur\": " << dur << ", \"args\": {\"stream\": " << r.streamId << ", \"event\": " << r.eventId
+                << "}}";
+            break;
+          case Kind::kAsync:
+            out << ",\n{\"ph\": \"b\", \"cat\": " << JsonQuoted{r.category} << ", \"name\": " << JsonQuoted{r.name}
+                << ", \"id\": \"" << r.id << "\", \"pid\": " << kThreadsPid << ", \"tid\": " << buffer->index
+                << ", \"ts\": " << ts << "}";
+            out << ",\n{\"ph\": \"e\", \"cat\": " << JsonQuoted{r.category} << ", \"name\": " << JsonQuoted{r.name}
+                << ", \"id\": \"" << r.id << "\", \"pid\": " << kThreadsPid << ", \"tid\": " << buffer->index
+                << ", \"ts\": " << ts + dur << "}";
+            break;
+        }
+      }
+    }
+    for (int i = 0; i <= maxStreamId; ++i) {
+      out << ",\n{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " << kStreamsPid << ", \"tid\": " << i
+          << ", \"args\": {\"name\": \"stream " << i << "\"}}";
+    }
+    out << "\n]}\n";
+  }
+}  // namespace edm
@@ -0,0 +1,52 @@
+#ifndef Tracer_h
+#define Tracer_h
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace edm {
+  // Records the begin and end of the framework activities (events,
+  // module acquire() and produce(), ESProducer produce(), and waits for
+  // external work in WaitingTaskWithArenaHolder) into per-thread
+  // buffers, and writes them in the Chrome Trace Event format that can
+  // be viewed with Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+  //
+  // The tracer is disabled by default, in which case the cost of the
+  // instrumentation is the check of a global flag.
+  class Tracer {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static bool enabled() { return enabled_; }
+
+    // not thread safe, must be called before any work is done
+    static void enable();
+
+    // thread safe, returns a pointer to a copy of name that stays valid until the end of the job
+    static char const* intern(std::string const& name);
+
+    // thread safe, the activity is shown on the track of the calling thread
+    static void complete(char const* category,
+                         char const* name,
+                         Clock::time_point begin,
+                         Clock::time_point end,
+                         int streamId,
+                         int eventId);
+
+    // thread safe, the event is shown on the track of its stream
+    static void event(int streamId, int eventId, Clock::time_point begin, Clock::time_point end);
+
+    // thread safe, for activities that begin and end on different threads
+    static void async(
+        char const* category, char const* name, void const* id, Clock::time_point begin, Clock::time_point end);
+
+    // not thread safe, must be called after all work is done
+    static void writeChromeTrace(std::filesystem::path const& filename);
+
+  private:
+    static bool enabled_;
+  };
+}  // namespace edm
+
+#endif
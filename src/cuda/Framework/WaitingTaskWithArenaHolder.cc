@@ -20,6 +20,9 @@ namespace edm {
   WaitingTaskWithArenaHolder::WaitingTaskWithArenaHolder(WaitingTask* iTask)
       : m_task(iTask), m_arena(std::make_shared<tbb::task_arena>(tbb::task_arena::attach())) {
     m_task->increment_ref_count();
+    if (Tracer::enabled()) {
+      m_begin = Tracer::Clock::now();
+    }
   }
 
   WaitingTaskWithArenaHolder::~WaitingTaskWithArenaHolder() {
@@ -29,14 +32,14 @@ namespace edm {
   }
 
   WaitingTaskWithArenaHolder::WaitingTaskWithArenaHolder(WaitingTaskWithArenaHolder const& iHolder)
-      : m_task(iHolder.m_task), m_arena(iHolder.m_arena) {
+      : m_task(iHolder.m_task), m_arena(iHolder.m_arena), m_begin(iHolder.m_begin) {
     if (m_task != nullptr) {
       m_task->increment_ref_count();
     }
   }
 
   WaitingTaskWithArenaHolder::WaitingTaskWithArenaHolder(WaitingTaskWithArenaHolder&& iOther)
-      : m_task(iOther.m_task), m_arena(std::move(iOther.m_arena)) {
+      : m_task(iOther.m_task), m_arena(std::move(iOther.m_arena)), m_begin(iOther.m_begin) {
     iOther.m_task = nullptr;
   }
 
@@ -44,6 +47,7 @@ namespace edm {
     WaitingTaskWithArenaHolder tmp(iRHS);
     std::swap(m_task, tmp.m_task);
     std::swap(m_arena, tmp.m_arena);
+    std::swap(m_begin, tmp.m_begin);
     return *this;
   }
 
@@ -51,6 +55,7 @@ namespace edm {
     WaitingTaskWithArenaHolder tmp(std::move(iRHS));
     std::swap(m_task, tmp.m_task);
     std::swap(m_arena, tmp.m_arena);
+    std::swap(m_begin, tmp.m_begin);
     return *this;
   }
 
@@ -69,6 +74,17 @@ namespace edm {
     auto task = m_task;
     m_task = nullptr;
     if (0 == task->decrement_ref_count()) {
+      if (Tracer::enabled()) {
+        // time spent waiting for the (possibly external) work, and then
+        // for a thread of the arena to pick up the task
+        auto end = Tracer::Clock::now();
+        Tracer::async("wait", "external work", task, m_begin, end);
+        m_arena->enqueue([task = task, end]() {
+          Tracer::async("wait", "arena enqueue", task, end, Tracer::Clock::now());
+          tbb::task::spawn(*task);
+        });
+        return;
+      }
       // The enqueue call will cause a worker thread to be created in
       // the arena if there is not one already.
       m_arena->enqueue([task = task]() { tbb::task::spawn(*task); });
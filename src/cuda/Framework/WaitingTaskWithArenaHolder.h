@@ -24,6 +24,8 @@
 
 #include "tbb/task_arena.h"
 
+#include "Framework/Tracer.h"
+
 namespace edm {
 
   class WaitingTask;
@@ -71,6 +73,8 @@ namespace edm {
     // ---------- member data --------------------------------
     WaitingTask* m_task;
     std::shared_ptr<tbb::task_arena> m_arena;
+    // creation time of the first holder of m_task, set only if the Tracer is enabled
+    Tracer::Clock::time_point m_begin;
   };
 
   template <typename F>
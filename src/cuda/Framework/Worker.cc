@@ -1,3 +1,6 @@
+#include <algorithm>
+
+#include "Framework/Event.h"
 #include "Framework/Worker.h"
 
 namespace edm {
@@ -6,6 +9,9 @@ namespace edm {
     bool expected = false;
     if (prefetchRequested_.compare_exchange_strong(expected, true)) {
       //std::cout << "first prefetch call" << std::endl;
+      if (instrumented()) {
+        prefetchTime_ = TimingService::Clock::now();
+      }
       //Need to be sure the ref count isn't set to 0 immediately
       iTask->increment_ref_count();
       for (Worker* dep : itemsToGet_) {
@@ -22,4 +28,42 @@ namespace edm {
       }
     }
   }
+
+  void Worker::recordAcquire(Event const& event,
+                             TimingService::Clock::time_point begin,
+                             TimingService::Clock::time_point end) {
+    if (timing_) {
+      timing_->fill(TimingService::kQueue, prefetchDoneTime(), begin);
+      timing_->fill(TimingService::kAcquire, begin, end);
+    }
+    if (Tracer::enabled()) {
+      Tracer::complete("acquire", traceName_, begin, end, event.streamID(), event.eventID());
+    }
+  }
+
+  void Worker::recordProduce(Event const& event,
+                             bool hasAcquire,
+                             TimingService::Clock::time_point begin,
+                             TimingService::Clock::time_point end) {
+    if (timing_) {
+      // for modules with acquire() the queueing time is measured before the acquire()
+      if (not hasAcquire) {
+        timing_->fill(TimingService::kQueue, prefetchDoneTime(), begin);
+      }
+      timing_->fill(TimingService::kProduce, begin, end);
+    }
+    if (Tracer::enabled()) {
+      Tracer::complete("produce", traceName_, begin, end, event.streamID(), event.eventID());
+    }
+    finishTime_ = end;
+  }
+
+  TimingService::Clock::time_point Worker::prefetchDoneTime() const {
+    // the consumed products are available when the last producer of them has finished
+    auto time = prefetchTime_;
+    for (Worker const* dep : itemsToGet_) {
+      time = std::max(time, dep->finishTime_);
+    }
+    return time;
+  }
 }  // namespace edm
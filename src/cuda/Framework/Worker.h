@@ -5,6 +5,8 @@
 #include <vector>
 //#include <iostream>
 
+#include "Framework/TimingService.h"
+#include "Framework/Tracer.h"
 #include "Framework/WaitingTask.h"
 #include "Framework/WaitingTaskHolder.h"
 #include "Framework/WaitingTaskList.h"
@@ -22,12 +24,21 @@ namespace edm {
     // not thread safe
     void setItemsToGet(std::vector<Worker*> workers) { itemsToGet_ = std::move(workers); }
 
+    // not thread safe, nullptr disables the timing
+    void setTiming(TimingService::Record* record) { timing_ = record; }
+
+    // not thread safe, name must outlive the Worker (see Tracer::intern())
+    void setTraceName(char const* name) { traceName_ = name; }
+
     // thread safe
     void prefetchAsync(Event& event, EventSetup const& eventSetup, WaitingTask* iTask);
 
     // not thread safe
     virtual void doWorkAsync(Event& event, EventSetup const& eventSetup, WaitingTask* iTask) = 0;
 
+    // not thread safe
+    virtual void doEndStream() = 0;
+
     // not thread safe
     virtual void doEndJob() = 0;
 
@@ -40,9 +51,29 @@ namespace edm {
   protected:
     virtual void doReset() = 0;
 
+    // true if the acquire() and produce() calls need to be timed
+    bool instrumented() const { return timing_ or Tracer::enabled(); }
+
+    // only to be called if instrumented()
+    void recordAcquire(Event const& event,
+                       TimingService::Clock::time_point begin,
+                       TimingService::Clock::time_point end);
+    void recordProduce(Event const& event,
+                       bool hasAcquire,
+                       TimingService::Clock::time_point begin,
+                       TimingService::Clock::time_point end);
+
   private:
+    // time when the last of the consumed products became available
+    TimingService::Clock::time_point prefetchDoneTime() const;
+
     std::vector<Worker*> itemsToGet_;
     std::atomic<bool> prefetchRequested_ = false;
+    TimingService::Record* timing_ = nullptr;
+    char const* traceName_ = "unknown";
+    TimingService::Clock::time_point prefetchTime_;
+    // time when the produce() has finished, set if instrumented()
+    TimingService::Clock::time_point finishTime_;
   };
 
   template <typename T>
@@ -65,7 +96,13 @@ namespace edm {
                 std::exception_ptr exceptionPtr;
                 try {
                   //std::cout << "calling doProduce " << this << std::endl;
-                  producer_.doProduce(event, eventSetup);
+                  if (instrumented()) {
+                    auto begin = TimingService::Clock::now();
+                    producer_.doProduce(event, eventSetup);
+                    recordProduce(event, producer_.hasAcquire(), begin, TimingService::Clock::now());
+                  } else {
+                    producer_.doProduce(event, eventSetup);
+                  }
                 } catch (...) {
                   exceptionPtr = std::current_exception();
                 }
@@ -83,7 +120,13 @@ namespace edm {
                                            } else {
                                              std::exception_ptr exceptionPtr;
                                              try {
-                                               producer_.doAcquire(event, eventSetup, runProduceHolder);
+                                               if (instrumented()) {
+                                                 auto begin = TimingService::Clock::now();
+                                                 producer_.doAcquire(event, eventSetup, runProduceHolder);
+                                                 recordAcquire(event, begin, TimingService::Clock::now());
+                                               } else {
+                                                 producer_.doAcquire(event, eventSetup, runProduceHolder);
+                                               }
                                              } catch (...) {
                                                exceptionPtr = std::current_exception();
                                              }
@@ -96,6 +139,8 @@ namespace edm {
       }
     }
 
+    void doEndStream() override { producer_.doEndStream(); }
+
     void doEndJob() override { producer_.doEndJob(); }
 
   private:
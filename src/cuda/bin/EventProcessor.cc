@@ -1,3 +1,7 @@
+#include <iostream>
+
+#include <tbb/task_group.h>
+
 #include "Framework/EmptyWaitingTask.h"
 #include "Framework/ESPluginFactory.h"
 #include "Framework/WaitingTask.h"
@@ -11,17 +15,45 @@ namespace edm {
                                  std::vector<std::string> const& path,
                                  std::vector<std::string> const& esproducers,
                                  std::filesystem::path const& datadir,
-                                 bool validation)
-      : source_(maxEvents, registry_, datadir, validation) {
-    for (auto const& name : esproducers) {
-      pluginManager_.load(name);
-      auto esp = ESPluginFactory::create(name, datadir);
-      esp->produce(eventSetup_);
+                                 bool validation,
+                                 Source::Mode sourceMode,
+                                 bool compressRaw)
+      : source_(maxEvents, registry_, datadir, validation, sourceMode, 2 * numberOfStreams, compressRaw) {
+    // The ESProducers and the modules of the streams do not depend on each other, so they are
+    // all constructed concurrently. Each task loads the plugins it needs, and waits in the
+    // PluginManager if another task is loading the same one.
+    EventSetup eventSetup;
+    schedules_.resize(numberOfStreams);
+    tbb::task_group group;
+    group.run([&]() {
+      eventSetupProvider_.add(
+          esproducers,
+          [this, &datadir](std::string const& name) {
+            pluginManager_.load(name);
+            return ESPluginFactory::create(name, datadir);
+          },
+          eventSetup);
+    });
+    for (int i = 0; i < numberOfStreams; ++i) {
+      group.run([this, &path, i]() {
+        schedules_[i] =
+            std::make_unique<StreamSchedule>(registry_, pluginManager_, &source_, &eventSetupProvider_, i, path);
+      });
     }
+    group.wait();
 
-    //schedules_.reserve(numberOfStreams);
-    for (int i = 0; i < numberOfStreams; ++i) {
-      schedules_.emplace_back(registry_, pluginManager_, &source_, &eventSetup_, i, path);
+    // the products of the first intervals of validity, copied by each stream; the streams
+    // update them as their events enter the following intervals of validity
+    for (auto& s : schedules_) {
+      s->setEventSetup(eventSetup);
+    }
+  }
+
+  void EventProcessor::enableTiming(std::filesystem::path const& jsonFile) {
+    timing_ = std::make_unique<TimingService>();
+    timingJsonFile_ = jsonFile;
+    for (auto& s : schedules_) {
+      s->enableTiming(*timing_);
     }
   }
 
@@ -29,8 +61,12 @@ namespace edm {
     // The task that waits for all other work
     auto globalWaitTask = make_empty_waiting_task();
     globalWaitTask->increment_ref_count();
+    runStartTime_ = std::chrono::steady_clock::now();
+    auto firstEventDone = [this]() {
+      std::call_once(firstEventFlag_, [this]() { firstEventTime_ = std::chrono::steady_clock::now(); });
+    };
     for (auto& s : schedules_) {
-      s.runToCompletionAsync(WaitingTaskHolder(globalWaitTask.get()));
+      s->runToCompletionAsync(WaitingTaskHolder(globalWaitTask.get()), firstEventDone);
     }
     globalWaitTask->wait_for_all();
     if (globalWaitTask->exceptionPtr()) {
@@ -40,6 +76,13 @@ namespace edm {
 
   void EventProcessor::endJob() {
     // Only on the first stream...
-    schedules_[0].endJob();
+    schedules_[0]->endJob();
+
+    if (timing_) {
+      timing_->printSummary(std::cout);
+      if (not timingJsonFile_.empty()) {
+        timing_->writeJson(timingJsonFile_);
+      }
+    }
   }
 }  // namespace edm
@@ -1,11 +1,15 @@
 #ifndef EventProcessor_h
 #define EventProcessor_h
 
+#include <chrono>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
-#include "Framework/EventSetup.h"
+#include "Framework/EventSetupProvider.h"
+#include "Framework/TimingService.h"
 
 #include "PluginManager.h"
 #include "StreamSchedule.h"
@@ -14,25 +18,43 @@
 namespace edm {
   class EventProcessor {
   public:
+    // The plugins are loaded, the ESProducers run and the modules of the
+    // streams constructed concurrently on the TBB pool, which must be
+    // initialized before
     explicit EventProcessor(int maxEvents,
                             int numberOfStreams,
                             std::vector<std::string> const& path,
                             std::vector<std::string> const& esproducers,
                             std::filesystem::path const& datadir,
-                            bool validation);
+                            bool validation,
+                            Source::Mode sourceMode = Source::Mode::kRead,
+                            bool compressRaw = false);
 
     int maxEvents() const { return source_.maxEvents(); }
+    int processedEvents() const { return source_.processedEvents(); }
+
+    // Record the per-module timings, summary is printed in endJob()
+    // and written also to jsonFile if that is not empty
+    void enableTiming(std::filesystem::path const& jsonFile);
 
     void runToCompletion();
 
+    // Time between the start of runToCompletion() and the end of the first event
+    std::chrono::steady_clock::duration firstEventLatency() const { return firstEventTime_ - runStartTime_; }
+
     void endJob();
 
   private:
     edmplugin::PluginManager pluginManager_;
     ProductRegistry registry_;
     Source source_;
-    EventSetup eventSetup_;
-    std::vector<StreamSchedule> schedules_;
+    EventSetupProvider eventSetupProvider_;
+    std::vector<std::unique_ptr<StreamSchedule>> schedules_;
+    std::unique_ptr<TimingService> timing_;
+    std::filesystem::path timingJsonFile_;
+    std::chrono::steady_clock::time_point runStartTime_;
+    std::chrono::steady_clock::time_point firstEventTime_;
+    std::once_flag firstEventFlag_;
   };
 }  // namespace edm
 
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "DataFormats/FEDNumbering.h"
+
+#include "RawContainer.h"
+
+namespace edm {
+  RawContainerReader::RawContainerReader(std::filesystem::path const& filename) : filename_(filename) {
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      throw std::runtime_error("Failed to open " + filename.string() + ": " + std::strerror(errno));
+    }
+
+    try {
+      rawcontainer::Header header;
+      readAt(&header, sizeof(header), 0);
+      if (std::memcmp(header.magic, rawcontainer::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(filename.string() + " is not a raw data container");
+      }
+      if (header.version != rawcontainer::kVersion) {
+        throw std::runtime_error("Unsupported raw data container version " + std::to_string(header.version) + " in " +
+                                 filename.string() + ", expected " + std::to_string(rawcontainer::kVersion));
+      }
+
+      events_.resize(header.nEvents);
+      readAt(events_.data(), events_.size() * sizeof(rawcontainer::EventEntry), header.eventTableOffset);
+      if (header.flags & rawcontainer::kHasValidation) {
+        validation_.resize(header.nEvents);
+        readAt(validation_.data(), validation_.size() * sizeof(rawcontainer::ValidationEntry), header.validationOffset);
+      }
+    } catch (...) {
+      close(fd_);
+      throw;
+    }
+  }
+
+  RawContainerReader::~RawContainerReader() { close(fd_); }
+
+  void RawContainerReader::readAt(void* buffer, uint64_t size, uint64_t offset) const {
+    auto* ptr = static_cast<char*>(buffer);
+    while (size > 0) {
+      auto ret = pread(fd_, ptr, size, offset);
+      if (ret < 0 and errno == EINTR) {
+        continue;
+      }
+      if (ret <= 0) {
+        throw std::runtime_error("Failed to read " + std::to_string(size) + " bytes at offset " +
+                                 std::to_string(offset) + " from " + filename_.string() +
+                                 (ret < 0 ? std::string(": ") + std::strerror(errno) : std::string()));
+      }
+      ptr += ret;
+      size -= ret;
+      offset += ret;
+    }
+  }
+
+  FEDRawDataCollection RawContainerReader::readEvent(uint64_t index,
+                                                     std::vector<unsigned int> const& skipFedIds) const {
+    auto const& event = events_.at(index);
+
+    std::vector<rawcontainer::FEDEntry> feds(event.nFeds);
+    readAt(feds.data(), feds.size() * sizeof(rawcontainer::FEDEntry), event.offset);
+
+    FEDRawDataCollection rawCollection;
+    for (auto const& fed : feds) {
+      if (fed.fedId > FEDNumbering::lastFEDId()) {
+        throw std::runtime_error("Invalid FED id " + std::to_string(fed.fedId) + " in event " + std::to_string(index) +
+                                 " in " + filename_.string());
+      }
+      if (std::find(skipFedIds.begin(), skipFedIds.end(), fed.fedId) != skipFedIds.end()) {
+        continue;
+      }
+      if (fed.offset + fed.size > event.size) {
+        throw std::runtime_error("Corrupted FED directory of event " + std::to_string(index) + " in " +
+                                 filename_.string());
+      }
+      FEDRawData& rawData = rawCollection.FEDData(fed.fedId);
+      rawData.resize(fed.size);
+      readAt(rawData.data(), fed.size, event.offset + fed.offset);
+    }
+    return rawCollection;
+  }
+}  // namespace edm
@@ -0,0 +1,95 @@
+#ifndef RawContainer_h
+#define RawContainer_h
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "DataFormats/FEDRawDataCollection.h"
+
+/*
+ * Single-file, indexed container for the raw data and the validation
+ * counts, replacing raw.bin, digicluster.bin, tracks.bin and
+ * vertices.bin. It can be produced from those with convert-data.py.
+ *
+ * All integers are little endian. The layout is
+ *   Header
+ *   EventEntry[nEvents]       at Header::eventTableOffset
+ *   ValidationEntry[nEvents]  at Header::validationOffset (if kHasValidation is set)
+ *   event records             at EventEntry::offset, 8-byte aligned
+ * where each event record is a FED directory (FEDEntry[nFeds])
+ * followed by the FED payloads. The payloads are 8-byte aligned and
+ * their offsets are relative to the beginning of the event record.
+ *
+ * The event table allows random access to any event, and the FED
+ * directory allows to read only the FEDs that are needed.
+ */
+namespace edm {
+  namespace rawcontainer {
+    constexpr char kMagic[8] = {'P', 'X', 'R', 'A', 'W', 'C', 'N', 'T'};
+    constexpr uint32_t kVersion = 1;
+
+    enum Flags : uint32_t { kHasValidation = 1 << 0 };
+
+    struct Header {
+      char magic[8];
+      uint32_t version;
+      uint32_t flags;
+      uint64_t nEvents;
+      uint64_t eventTableOffset;
+      uint64_t validationOffset;
+    };
+
+    struct EventEntry {
+      uint64_t offset;
+      uint64_t size;
+      uint32_t nFeds;
+      uint32_t reserved;
+    };
+
+    struct FEDEntry {
+      uint32_t fedId;
+      uint32_t size;
+      uint64_t offset;
+    };
+
+    struct ValidationEntry {
+      uint32_t nModules;
+      uint32_t nDigis;
+      uint32_t nClusters;
+      uint32_t nTracks;
+      uint32_t nVertices;
+    };
+
+    static_assert(sizeof(Header) == 40);
+    static_assert(sizeof(EventEntry) == 24);
+    static_assert(sizeof(FEDEntry) == 16);
+    static_assert(sizeof(ValidationEntry) == 20);
+  }  // namespace rawcontainer
+
+  class RawContainerReader {
+  public:
+    explicit RawContainerReader(std::filesystem::path const& filename);
+    ~RawContainerReader();
+    RawContainerReader(RawContainerReader const&) = delete;
+    RawContainerReader& operator=(RawContainerReader const&) = delete;
+
+    uint64_t size() const { return events_.size(); }
+    bool hasValidation() const { return not validation_.empty(); }
+
+    rawcontainer::ValidationEntry const& validation(uint64_t index) const { return validation_[index]; }
+
+    // thread safe, the FEDs in skipFedIds are not read
+    FEDRawDataCollection readEvent(uint64_t index, std::vector<unsigned int> const& skipFedIds = {}) const;
+
+  private:
+    void readAt(void* buffer, uint64_t size, uint64_t offset) const;
+
+    std::filesystem::path filename_;
+    int fd_;
+    std::vector<rawcontainer::EventEntry> events_;
+    std::vector<rawcontainer::ValidationEntry> validation_;
+  };
+}  // namespace edm
+
+#endif
@@ -1,8 +1,24 @@
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "DataFormats/FEDNumbering.h"
+#include "Framework/BlockCompression.h"
+#include "RawContainer.h"
 #include "Source.h"
 
 namespace {
@@ -20,28 +36,225 @@ namespace {
     return rawCollection;
   }
 
+  // Builds the index of one event starting at offset. The FED payloads are not copied, unless some of them
+  // are not 8-byte aligned: they are read as 64-bit words, while in the file they are only 4-byte aligned
+  // (with the layout of raw.bin, in every other event). Then all the payloads of the event are copied to arena.
+  FEDRawDataCollection::View indexRaw(unsigned char const *begin,
+                                      std::size_t size,
+                                      std::size_t &offset,
+                                      std::vector<unsigned char> &arena) {
+    auto readUInt = [&]() {
+      if (offset + sizeof(unsigned int) > size) {
+        throw std::runtime_error("Truncated raw data file");
+      }
+      unsigned int value;
+      std::memcpy(&value, begin + offset, sizeof(unsigned int));
+      offset += sizeof(unsigned int);
+      return value;
+    };
+
+    unsigned int nfeds = readUInt();
+    // fedId, offset and size of the payloads
+    std::vector<std::tuple<int, std::size_t, std::size_t>> entries;
+    entries.reserve(nfeds);
+    bool aligned = true;
+    std::size_t alignedSize = 0;
+    for (unsigned int ifed = 0; ifed < nfeds; ++ifed) {
+      unsigned int fedId = readUInt();
+      unsigned int fedSize = readUInt();
+      if (offset + fedSize > size) {
+        throw std::runtime_error("Truncated raw data file");
+      }
+      entries.emplace_back(fedId, offset, fedSize);
+      aligned = aligned and reinterpret_cast<std::uintptr_t>(begin + offset) % alignof(uint64_t) == 0;
+      alignedSize += (fedSize + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+      offset += fedSize;
+    }
+
+    std::vector<std::pair<int, FEDRawData>> feds;
+    feds.reserve(nfeds);
+    if (aligned) {
+      for (auto const &[fedId, fedOffset, fedSize] : entries) {
+        feds.emplace_back(fedId, FEDRawData(begin + fedOffset, fedSize));
+      }
+    } else {
+      // the buffer of a std::vector is aligned for any fundamental type
+      arena.resize(alignedSize);
+      std::size_t arenaOffset = 0;
+      for (auto const &[fedId, fedOffset, fedSize] : entries) {
+        std::memcpy(arena.data() + arenaOffset, begin + fedOffset, fedSize);
+        feds.emplace_back(fedId, FEDRawData(arena.data() + arenaOffset, fedSize));
+        arenaOffset += (fedSize + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+      }
+    }
+    std::sort(feds.begin(), feds.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+
+    FEDRawDataCollection::View view;
+    view.fedIds.reserve(nfeds);
+    view.data.reserve(nfeds);
+    for (auto const &fed : feds) {
+      view.fedIds.push_back(fed.first);
+      view.data.push_back(fed.second);
+    }
+    return view;
+  }
+
+  // The pixel payloads are made of 32-bit words
+  constexpr std::size_t kCompressionElementSize = 4;
+
+  // A compressed payload is stored as its size in a 64-bit word, followed by
+  // the compressed bytes, padded to a multiple of 8 bytes like the FED data
+  void decompressFED(FEDRawData const &compressed, unsigned char *output, std::size_t size) {
+    uint64_t compressedSize;
+    std::memcpy(&compressedSize, compressed.data(), sizeof(uint64_t));
+    if (compressedSize + sizeof(uint64_t) > compressed.size()) {
+      throw std::runtime_error("Corrupted compressed FED payload");
+    }
+    edm::blockCompression::decompress(reinterpret_cast<std::byte const *>(compressed.data()) + sizeof(uint64_t),
+                                      compressedSize,
+                                      reinterpret_cast<std::byte *>(output),
+                                      size,
+                                      kCompressionElementSize);
+  }
+
+  struct PackedEvent {
+    FEDRawDataCollection::View view;
+    std::vector<unsigned char> arena;
+  };
+
+  // Copies the payloads of the FEDs with data in one buffer, that the view refers to
+  PackedEvent pack(FEDRawDataCollection const &raw, bool compress) {
+    std::vector<int> fedIds;
+    std::vector<std::vector<std::byte>> compressed;
+    std::vector<std::size_t> offsets;
+    std::size_t size = 0;
+    for (int fedId = 0; fedId <= FEDNumbering::lastFEDId(); ++fedId) {
+      auto const &data = raw.FEDData(fedId);
+      if (data.size() == 0) {
+        continue;
+      }
+      fedIds.push_back(fedId);
+      offsets.push_back(size);
+      std::size_t stored = data.size();
+      if (compress) {
+        compressed.push_back(edm::blockCompression::compress(
+            reinterpret_cast<std::byte const *>(data.data()), data.size(), kCompressionElementSize));
+        auto const padded = sizeof(uint64_t) + (compressed.back().size() + 7) / 8 * 8;
+        // keep the payload as it is if the compression does not help
+        if (padded < data.size()) {
+          stored = padded;
+        } else {
+          compressed.back().clear();
+        }
+      }
+      size += stored;
+    }
+
+    PackedEvent packed;
+    packed.arena.resize(size, 0);
+    packed.view.fedIds = fedIds;
+    packed.view.data.reserve(fedIds.size());
+    for (std::size_t i = 0; i < fedIds.size(); ++i) {
+      auto const &data = raw.FEDData(fedIds[i]);
+      auto *begin = packed.arena.data() + offsets[i];
+      if (compress and not compressed[i].empty()) {
+        uint64_t compressedSize = compressed[i].size();
+        std::memcpy(begin, &compressedSize, sizeof(uint64_t));
+        std::memcpy(begin + sizeof(uint64_t), compressed[i].data(), compressedSize);
+        packed.view.data.emplace_back(begin, sizeof(uint64_t) + (compressedSize + 7) / 8 * 8);
+      } else {
+        std::memcpy(begin, data.data(), data.size());
+        packed.view.data.emplace_back(begin, data.size());
+      }
+    }
+    if (compress) {
+      packed.view.sizes.reserve(fedIds.size());
+      for (int fedId : fedIds) {
+        packed.view.sizes.push_back(raw.FEDData(fedId).size());
+      }
+      packed.view.decompress = decompressFED;
+    }
+    return packed;
+  }
 }  // namespace
 
 namespace edm {
-  Source::Source(int maxEvents, ProductRegistry &reg, std::filesystem::path const &datadir, bool validation)
-      : maxEvents_(maxEvents), numEvents_(0), rawToken_(reg.produces<FEDRawDataCollection>()), validation_(validation) {
-    std::ifstream in_raw(datadir / "raw.bin", std::ios::binary);
-    std::ifstream in_digiclusters;
-    std::ifstream in_tracks;
-    std::ifstream in_vertices;
+  struct Source::StreamedEvent {
+    FEDRawDataCollection raw;
+    unsigned int nm, nd, nc, nt, nv;
+  };
 
+  Source::Source(int maxEvents,
+                 ProductRegistry &reg,
+                 std::filesystem::path const &datadir,
+                 bool validation,
+                 Mode mode,
+                 int readAhead,
+                 bool compress)
+      : maxEvents_(maxEvents),
+        numEvents_(0),
+        numProcessed_(0),
+        rawToken_(reg.produces<FEDRawDataCollection>()),
+        validation_(validation),
+        compress_(compress) {
     if (validation_) {
       digiClusterToken_ = reg.produces<DigiClusterCount>();
       trackToken_ = reg.produces<TrackCount>();
       vertexToken_ = reg.produces<VertexCount>();
+    }
+
+    switch (mode) {
+      case Mode::kRead:
+        readRawFile(datadir / "raw.bin");
+        break;
+      case Mode::kMmap:
+        mapRawFile(datadir / "raw.bin");
+        break;
+      case Mode::kStream:
+        ring_.set_capacity(std::max(readAhead, 1));
+        reader_ = std::thread([this, datadir]() { streamEvents(datadir); });
+        return;
+      case Mode::kContainer:
+        // also reads the validation block
+        readContainer(datadir / "container.bin");
+        break;
+    }
+
+    // views_ must not be modified after this point
+    raw_.reserve(views_.size());
+    for (auto const &view : views_) {
+      raw_.emplace_back(&view);
+    }
+
+    if (validation_ and digiclusters_.empty()) {
+      readValidation(datadir);
+      assert(raw_.size() == digiclusters_.size());
+      assert(raw_.size() == tracks_.size());
+      assert(raw_.size() == vertices_.size());
+    }
+
+    if (maxEvents_ < 0) {
+      maxEvents_ = raw_.size();
+    }
+  }
 
-      in_digiclusters = std::ifstream(datadir / "digicluster.bin", std::ios::binary);
-      in_tracks = std::ifstream(datadir / "tracks.bin", std::ios::binary);
-      in_vertices = std::ifstream(datadir / "vertices.bin", std::ios::binary);
-      in_digiclusters.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
-      in_tracks.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
-      in_vertices.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+  Source::~Source() {
+    if (reader_.joinable()) {
+      // draining the ring unblocks the reader thread, that pushes at
+      // most one more event before noticing the request to stop
+      stopReading_ = true;
+      std::unique_ptr<StreamedEvent> event;
+      while (ring_.try_pop(event)) {
+      }
+      reader_.join();
+    }
+    if (mapped_) {
+      munmap(mapped_, mappedSize_);
     }
+  }
+
+  void Source::readRawFile(std::filesystem::path const &filename) {
+    std::ifstream in_raw(filename, std::ios::binary);
 
     unsigned int nfeds;
     in_raw.exceptions(std::ifstream::badbit);
@@ -49,52 +262,241 @@ namespace edm {
     while (not in_raw.eof()) {
       in_raw.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
 
-      raw_.emplace_back(readRaw(in_raw, nfeds));
-
-      if (validation_) {
-        unsigned int nm, nd, nc, nt, nv;
-        in_digiclusters.read(reinterpret_cast<char *>(&nm), sizeof(unsigned int));
-        in_digiclusters.read(reinterpret_cast<char *>(&nd), sizeof(unsigned int));
-        in_digiclusters.read(reinterpret_cast<char *>(&nc), sizeof(unsigned int));
-        in_tracks.read(reinterpret_cast<char *>(&nt), sizeof(unsigned int));
-        in_vertices.read(reinterpret_cast<char *>(&nv), sizeof(unsigned int));
-        digiclusters_.emplace_back(nm, nd, nc);
-        tracks_.emplace_back(nt);
-        vertices_.emplace_back(nv);
-      }
+      addPacked(readRaw(in_raw, nfeds));
 
       // next event
       in_raw.exceptions(std::ifstream::badbit);
       in_raw.read(reinterpret_cast<char *>(&nfeds), sizeof(unsigned int));
     }
+  }
+
+  void Source::readContainer(std::filesystem::path const &filename) {
+    RawContainerReader container(filename);
+    if (validation_ and not container.hasValidation()) {
+      throw std::runtime_error("Validation requested, but " + filename.string() + " has no validation data");
+    }
+
+    // thanks to the random access, read only the events that are going to be processed
+    std::size_t nevents = container.size();
+    if (maxEvents_ >= 0) {
+      nevents = std::min<std::size_t>(nevents, maxEvents_);
+    }
+    if (nevents == 0) {
+      throw std::runtime_error("No events in " + filename.string());
+    }
+
+    // the pilot blade FED is not unpacked by SiPixelRawToClusterCUDA
+    std::vector<unsigned int> const skipFedIds = {40};
+
+    std::vector<PackedEvent> events(nevents);
+    unsigned int nthreads = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, nevents);
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> exceptions(nthreads);
+    threads.reserve(nthreads);
+    for (unsigned int ithread = 0; ithread < nthreads; ++ithread) {
+      threads.emplace_back([&, ithread]() {
+        try {
+          for (std::size_t i = ithread; i < nevents; i += nthreads) {
+            events[i] = pack(container.readEvent(i, skipFedIds), compress_);
+          }
+        } catch (...) {
+          exceptions[ithread] = std::current_exception();
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (auto const &exception : exceptions) {
+      if (exception) {
+        std::rethrow_exception(exception);
+      }
+    }
+    views_.reserve(nevents);
+    arenas_.reserve(nevents);
+    for (auto &event : events) {
+      views_.emplace_back(std::move(event.view));
+      arenas_.emplace_back(std::move(event.arena));
+    }
 
     if (validation_) {
-      assert(raw_.size() == digiclusters_.size());
-      assert(raw_.size() == tracks_.size());
-      assert(raw_.size() == vertices_.size());
+      for (std::size_t i = 0; i < nevents; ++i) {
+        auto const &val = container.validation(i);
+        digiclusters_.emplace_back(val.nModules, val.nDigis, val.nClusters);
+        tracks_.emplace_back(val.nTracks);
+        vertices_.emplace_back(val.nVertices);
+      }
     }
+  }
 
-    if (maxEvents_ < 0) {
-      maxEvents_ = raw_.size();
+  void Source::mapRawFile(std::filesystem::path const &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open " + filename.string() + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error("Failed to stat " + filename.string() + ": " + std::strerror(errno));
+    }
+    mappedSize_ = st.st_size;
+    if (mappedSize_ > 0) {
+      mapped_ = mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapped_ == MAP_FAILED) {
+      mapped_ = nullptr;
+      throw std::runtime_error("Failed to mmap " + filename.string() + ": " + std::strerror(errno));
+    }
+    // the events are indexed once in order, and then replayed in order
+    madvise(mapped_, mappedSize_, MADV_SEQUENTIAL);
+
+    // Only the offsets are collected here, the pages are faulted in
+    // lazily by the consumers of the FED payloads. The events with
+    // misaligned payloads are copied to arenas_.
+    auto const *begin = static_cast<unsigned char const *>(mapped_);
+    std::size_t offset = 0;
+    while (offset < mappedSize_) {
+      std::vector<unsigned char> arena;
+      views_.emplace_back(indexRaw(begin, mappedSize_, offset, arena));
+      if (not arena.empty()) {
+        arenas_.emplace_back(std::move(arena));
+      }
+    }
+  }
+
+  void Source::addPacked(FEDRawDataCollection const &raw) {
+    auto packed = pack(raw, compress_);
+    views_.emplace_back(std::move(packed.view));
+    arenas_.emplace_back(std::move(packed.arena));
+  }
+
+  void Source::readValidation(std::filesystem::path const &datadir) {
+    std::ifstream in_digiclusters(datadir / "digicluster.bin", std::ios::binary);
+    std::ifstream in_tracks(datadir / "tracks.bin", std::ios::binary);
+    std::ifstream in_vertices(datadir / "vertices.bin", std::ios::binary);
+    in_digiclusters.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    in_tracks.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    in_vertices.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+
+    for (std::size_t i = 0; i < raw_.size(); ++i) {
+      unsigned int nm, nd, nc, nt, nv;
+      in_digiclusters.read(reinterpret_cast<char *>(&nm), sizeof(unsigned int));
+      in_digiclusters.read(reinterpret_cast<char *>(&nd), sizeof(unsigned int));
+      in_digiclusters.read(reinterpret_cast<char *>(&nc), sizeof(unsigned int));
+      in_tracks.read(reinterpret_cast<char *>(&nt), sizeof(unsigned int));
+      in_vertices.read(reinterpret_cast<char *>(&nv), sizeof(unsigned int));
+      digiclusters_.emplace_back(nm, nd, nc);
+      tracks_.emplace_back(nt);
+      vertices_.emplace_back(nv);
+    }
+  }
+
+  void Source::streamEvents(std::filesystem::path const &datadir) {
+    try {
+      std::ifstream in_raw(datadir / "raw.bin", std::ios::binary);
+      std::ifstream in_digiclusters;
+      std::ifstream in_tracks;
+      std::ifstream in_vertices;
+      if (validation_) {
+        in_digiclusters = std::ifstream(datadir / "digicluster.bin", std::ios::binary);
+        in_tracks = std::ifstream(datadir / "tracks.bin", std::ios::binary);
+        in_vertices = std::ifstream(datadir / "vertices.bin", std::ios::binary);
+      }
+      auto rewind = [](std::ifstream &is) {
+        is.clear();
+        is.seekg(0);
+      };
+
+      int nread = 0;
+      int nreadInFile = 0;
+      while ((maxEvents_ < 0 or nread < maxEvents_) and not stopReading_) {
+        unsigned int nfeds;
+        in_raw.exceptions(std::ifstream::badbit);
+        in_raw.read(reinterpret_cast<char *>(&nfeds), sizeof(unsigned int));
+        if (in_raw.eof()) {
+          // wrap around only if more events were requested than there are in the file
+          if (maxEvents_ < 0 or nreadInFile == 0) {
+            break;
+          }
+          rewind(in_raw);
+          if (validation_) {
+            rewind(in_digiclusters);
+            rewind(in_tracks);
+            rewind(in_vertices);
+          }
+          nreadInFile = 0;
+          continue;
+        }
+        in_raw.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+
+        auto event = std::make_unique<StreamedEvent>(StreamedEvent{readRaw(in_raw, nfeds), 0, 0, 0, 0, 0});
+        if (validation_) {
+          in_digiclusters.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+          in_tracks.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+          in_vertices.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+          in_digiclusters.read(reinterpret_cast<char *>(&event->nm), sizeof(unsigned int));
+          in_digiclusters.read(reinterpret_cast<char *>(&event->nd), sizeof(unsigned int));
+          in_digiclusters.read(reinterpret_cast<char *>(&event->nc), sizeof(unsigned int));
+          in_tracks.read(reinterpret_cast<char *>(&event->nt), sizeof(unsigned int));
+          in_vertices.read(reinterpret_cast<char *>(&event->nv), sizeof(unsigned int));
+        }
+        // blocks while the ring is full
+        ring_.push(std::move(event));
+        ++nread;
+        ++nreadInFile;
+      }
+    } catch (...) {
+      readerException_ = std::current_exception();
+    }
+
+    if (not stopReading_) {
+      ring_.push(nullptr);
     }
   }
 
-  std::unique_ptr<Event> Source::produce(int streamId, ProductRegistry const &reg) {
+  bool Source::produce(Event &event) {
     const int old = numEvents_.fetch_add(1);
     const int iev = old + 1;
-    if (old >= maxEvents_) {
-      return nullptr;
+    if (maxEvents_ >= 0 and old >= maxEvents_) {
+      return false;
     }
-    auto ev = std::make_unique<Event>(streamId, iev, reg);
+
+    if (reader_.joinable()) {
+      std::unique_ptr<StreamedEvent> streamed;
+      // blocks while the ring is empty
+      ring_.pop(streamed);
+      if (not streamed) {
+        // leave the end marker for the other streams
+        ring_.push(nullptr);
+        if (readerException_) {
+          std::rethrow_exception(readerException_);
+        }
+        return false;
+      }
+      ++numProcessed_;
+      event.setEventID(iev);
+      event.emplace(rawToken_, std::move(streamed->raw));
+      if (validation_) {
+        event.emplace(digiClusterToken_, streamed->nm, streamed->nd, streamed->nc);
+        event.emplace(trackToken_, streamed->nt);
+        event.emplace(vertexToken_, streamed->nv);
+      }
+      return true;
+    }
+
+    ++numProcessed_;
+    event.setEventID(iev);
     const int index = old % raw_.size();
 
-    ev->emplace(rawToken_, raw_[index]);
+    // this copies only the pointer to the view (and, for compressed payloads, prepares a new cache)
+    event.emplace(rawToken_, raw_[index]);
     if (validation_) {
-      ev->emplace(digiClusterToken_, digiclusters_[index]);
-      ev->emplace(trackToken_, tracks_[index]);
-      ev->emplace(vertexToken_, vertices_[index]);
+      event.emplace(digiClusterToken_, digiclusters_[index]);
+      event.emplace(trackToken_, tracks_[index]);
+      event.emplace(vertexToken_, vertices_[index]);
     }
 
-    return ev;
+    return true;
   }
 }  // namespace edm
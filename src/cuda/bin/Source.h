@@ -2,9 +2,14 @@
 #define Source_h
 
 #include <atomic>
+#include <cstddef>
+#include <exception>
 #include <filesystem>
 #include <string>
 #include <memory>
+#include <thread>
+
+#include <tbb/concurrent_queue.h>
 
 #include "Framework/Event.h"
 #include "DataFormats/FEDRawDataCollection.h"
@@ -15,16 +20,44 @@
 namespace edm {
   class Source {
   public:
-    explicit Source(int maxEvents, ProductRegistry& reg, std::filesystem::path const& datadir, bool validation);
+    enum class Mode {
+      kRead,      // read all events into memory at construction, each into a single buffer
+      kMmap,      // memory-map raw.bin, events refer to the FED payloads in the mapped pages
+      kStream,    // read events in a background thread into a ring of at most readAhead events
+      kContainer  // read the events from the indexed container.bin (see RawContainer.h) in parallel
+    };
+
+    explicit Source(int maxEvents,
+                    ProductRegistry& reg,
+                    std::filesystem::path const& datadir,
+                    bool validation,
+                    Mode mode = Mode::kRead,
+                    int readAhead = 1,
+                    bool compress = false);
+    ~Source();
+    Source(Source const&) = delete;
+    Source& operator=(Source const&) = delete;
 
+    // in Mode::kStream -1 means "until the end of the file"
     int maxEvents() const { return maxEvents_; }
 
-    // thread safe
-    std::unique_ptr<Event> produce(int streamId, ProductRegistry const& reg);
+    int processedEvents() const { return numProcessed_; }
+
+    // thread safe, fills the (cleared) Event of the calling stream,
+    // returns false when there are no more events
+    bool produce(Event& event);
 
   private:
+    void readRawFile(std::filesystem::path const& filename);
+    void readContainer(std::filesystem::path const& filename);
+    void mapRawFile(std::filesystem::path const& filename);
+    void readValidation(std::filesystem::path const& datadir);
+    void streamEvents(std::filesystem::path const& datadir);
+    void addPacked(FEDRawDataCollection const& raw);
+
     int maxEvents_;
     std::atomic<int> numEvents_;
+    std::atomic<int> numProcessed_;
     EDPutTokenT<FEDRawDataCollection> const rawToken_;
     EDPutTokenT<DigiClusterCount> digiClusterToken_;
     EDPutTokenT<TrackCount> trackToken_;
@@ -34,6 +67,23 @@ namespace edm {
     std::vector<TrackCount> tracks_;
     std::vector<VertexCount> vertices_;
     bool const validation_;
+    bool const compress_;
+
+    // for Mode::kRead and Mode::kContainer the payloads of the FEDs of each
+    // event are packed (and optionally compressed) in one buffer of arenas_,
+    // for Mode::kMmap they are in the mapped pages (or copied to arenas_ if
+    // they are misaligned); the raw_ collections refer to the views_ of the FEDs
+    std::vector<FEDRawDataCollection::View> views_;
+    std::vector<std::vector<unsigned char>> arenas_;
+    void* mapped_ = nullptr;
+    std::size_t mappedSize_ = 0;
+
+    // for Mode::kStream, a nullptr in the ring marks the end of the input
+    struct StreamedEvent;
+    tbb::concurrent_bounded_queue<std::unique_ptr<StreamedEvent>> ring_;
+    std::exception_ptr readerException_;
+    std::atomic<bool> stopReading_ = false;
+    std::thread reader_;
   };
 }  // namespace edm
 
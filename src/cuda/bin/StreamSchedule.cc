@@ -2,8 +2,12 @@
 
 #include <tbb/task.h>
 
+#include "Framework/Event.h"
+#include "Framework/EventSetupProvider.h"
 #include "Framework/FunctorTask.h"
 #include "Framework/PluginFactory.h"
+#include "Framework/TimingService.h"
+#include "Framework/Tracer.h"
 #include "Framework/WaitingTask.h"
 #include "Framework/Worker.h"
 
@@ -15,16 +19,23 @@ namespace edm {
   StreamSchedule::StreamSchedule(ProductRegistry reg,
                                  edmplugin::PluginManager& pluginManager,
                                  Source* source,
-                                 EventSetup const* eventSetup,
+                                 EventSetupProvider* eventSetupProvider,
                                  int streamId,
                                  std::vector<std::string> const& path)
-      : registry_(std::move(reg)), source_(source), eventSetup_(eventSetup), streamId_(streamId) {
+      : registry_(std::move(reg)),
+        source_(source),
+        eventSetupProvider_(eventSetupProvider),
+        moduleNames_(path),
+        streamId_(streamId) {
     path_.reserve(path.size());
     int modInd = 1;
     for (auto const& name : path) {
       pluginManager.load(name);
       registry_.beginModuleConstruction(modInd);
       path_.emplace_back(PluginFactory::create(name, registry_));
+      if (Tracer::enabled()) {
+        path_.back()->setTraceName(Tracer::intern(name));
+      }
       //std::cout << "module " << modInd << " " << path_.back().get() << std::endl;
       std::vector<Worker*> consumes;
       for (unsigned int depInd : registry_.consumedModules()) {
@@ -36,13 +47,24 @@ namespace edm {
       path_.back()->setItemsToGet(std::move(consumes));
       ++modInd;
     }
+    // all products are registered, the event ID is set by the Source
+    event_ = std::make_unique<Event>(streamId_, 0, registry_);
   }
 
   StreamSchedule::~StreamSchedule() = default;
   StreamSchedule::StreamSchedule(StreamSchedule&&) = default;
   StreamSchedule& StreamSchedule::operator=(StreamSchedule&&) = default;
 
-  void StreamSchedule::runToCompletionAsync(WaitingTaskHolder h) {
+  void StreamSchedule::setEventSetup(EventSetup eventSetup) { eventSetup_ = std::move(eventSetup); }
+
+  void StreamSchedule::enableTiming(TimingService& timing) {
+    for (std::size_t i = 0; i < path_.size(); ++i) {
+      path_[i]->setTiming(timing.record(moduleNames_[i], streamId_));
+    }
+  }
+
+  void StreamSchedule::runToCompletionAsync(WaitingTaskHolder h, std::function<void()> firstEventDone) {
+    firstEventDone_ = std::move(firstEventDone);
     auto task =
         make_functor_task(tbb::task::allocate_root(), [this, h]() mutable { processOneEventAsync(std::move(h)); });
     if (streamId_ == 0) {
@@ -53,19 +75,39 @@ namespace edm {
   }
 
   void StreamSchedule::processOneEventAsync(WaitingTaskHolder h) {
-    auto event = source_->produce(streamId_, registry_);
-    if (event) {
-      // Pass the event object ownership to the "end-of-event" task
-      // Pass a non-owning pointer to the event to preceding tasks
-      //std::cout << "Begin processing event " << event->eventID() << std::endl;
-      auto eventPtr = event.get();
+    Tracer::Clock::time_point begin;
+    if (Tracer::enabled()) {
+      begin = Tracer::Clock::now();
+    }
+    if (source_->produce(*event_)) {
+      // The products are destroyed in the "end-of-event" task, and the
+      // Event is reused for the next event of the stream
+      //std::cout << "Begin processing event " << event_->eventID() << std::endl;
+      auto eventPtr = event_.get();
+      // the products of the previous intervals of validity are kept alive by the streams still using them
+      try {
+        eventSetupProvider_->update(eventSetup_, event_->eventID());
+      } catch (...) {
+        event_->clear();
+        endStream();
+        h.doneWaiting(std::current_exception());
+        return;
+      }
       auto nextEventTask =
           make_waiting_task(tbb::task::allocate_root(),
-                            [this, h = std::move(h), ev = std::move(event)](std::exception_ptr const* iPtr) mutable {
-                              ev.reset();
+                            [this, h = std::move(h), begin](std::exception_ptr const* iPtr) mutable {
+                              if (Tracer::enabled()) {
+                                Tracer::event(streamId_, event_->eventID(), begin, Tracer::Clock::now());
+                              }
+                              event_->clear();
                               if (iPtr) {
+                                endStream();
                                 h.doneWaiting(*iPtr);
                               } else {
+                                if (firstEventDone_) {
+                                  firstEventDone_();
+                                  firstEventDone_ = nullptr;
+                                }
                                 for (auto const& worker : path_) {
                                   worker->reset();
                                 }
@@ -79,13 +121,20 @@ namespace edm {
 
       for (auto iWorker = path_.rbegin(); iWorker != path_.rend(); ++iWorker) {
         //std::cout << "calling doWorkAsync for " << iWorker->get() << " with nextEventTask " << nextEventTask << std::endl;
-        (*iWorker)->doWorkAsync(*eventPtr, *eventSetup_, nextEventTask);
+        (*iWorker)->doWorkAsync(*eventPtr, eventSetup_, nextEventTask);
       }
     } else {
+      endStream();
       h.doneWaiting(std::exception_ptr{});
     }
   }
 
+  void StreamSchedule::endStream() {
+    for (auto& w : path_) {
+      w->doEndStream();
+    }
+  }
+
   void StreamSchedule::endJob() {
     for (auto& w : path_) {
       w->doEndJob();
@@ -1,10 +1,12 @@
 #ifndef StreamSchedule_h
 #define StreamSchedule_h
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "Framework/EventSetup.h"
 #include "Framework/ProductRegistry.h"
 #include "Framework/WaitingTaskHolder.h"
 
@@ -13,18 +15,20 @@ namespace edmplugin {
 }
 
 namespace edm {
-  class EventSetup;
+  class Event;
+  class EventSetupProvider;
   class Source;
+  class TimingService;
   class Worker;
 
   // Schedule of modules per stream (concurrent event)
   class StreamSchedule {
   public:
-    // copy ProductRegistry per stream
+    // copy ProductRegistry per stream; the schedules of different streams can be constructed concurrently
     explicit StreamSchedule(ProductRegistry reg,
                             edmplugin::PluginManager& pluginManager,
                             Source* source,
-                            EventSetup const* eventSetup,
+                            EventSetupProvider* eventSetupProvider,
                             int streamId,
                             std::vector<std::string> const& path);
     ~StreamSchedule();
@@ -33,17 +37,32 @@ namespace edm {
     StreamSchedule(StreamSchedule&&);
     StreamSchedule& operator=(StreamSchedule&&);
 
-    void runToCompletionAsync(WaitingTaskHolder h);
+    // not thread safe, the products of the first intervals of validity
+    void setEventSetup(EventSetup eventSetup);
+
+    // not thread safe
+    void enableTiming(TimingService& timing);
+
+    // firstEventDone is called when the first event of the stream has been processed
+    void runToCompletionAsync(WaitingTaskHolder h, std::function<void()> firstEventDone = {});
 
     void endJob();
 
   private:
     void processOneEventAsync(WaitingTaskHolder h);
+    // the stream has no more events to process
+    void endStream();
 
     ProductRegistry registry_;
     Source* source_;
-    EventSetup const* eventSetup_;
+    EventSetupProvider* eventSetupProvider_;
+    // updated by eventSetupProvider_ for each event of the stream
+    EventSetup eventSetup_;
     std::vector<std::unique_ptr<Worker>> path_;
+    std::vector<std::string> moduleNames_;
+    // reused for all the events of the stream, one at a time
+    std::unique_ptr<Event> event_;
+    std::function<void()> firstEventDone_;
     int streamId_;
   };
 }  // namespace edm
@@ -11,6 +11,10 @@
 
 #include <cuda_runtime.h>
 
+#include "Framework/ColumnarWriter.h"
+#include "Framework/EventBatcher.h"
+#include "Framework/Tracer.h"
+
 #include "EventProcessor.h"
 
 namespace {
@@ -18,7 +22,9 @@ namespace {
     std::cout
         << name
         << ": [--numberOfThreads NT] [--numberOfStreams NS] [--maxEvents ME] [--data PATH] [--transfer] [--validation] "
-           "[--histogram] [--empty]\n\n"
+           "[--histogram] [--empty] [--mmap] [--stream] [--container] [--timing] [--timingJson FILE] "
+           "[--trace FILE] [--cpu] [--batchSize BS] [--vertexMultiBlock] [--output FILE] [--compressOutput] "
+           "[--compressRaw]\n\n"
         << "Options\n"
         << " --numberOfThreads   Number of threads to use (default 1)\n"
         << " --numberOfStreams   Number of concurrent events (default 0=numberOfThreads)\n"
@@ -28,6 +34,24 @@ namespace {
         << " --validation        Run (rudimentary) validation at the end (implies --transfer)\n"
         << " --histogram         Produce histograms at the end (implies --transfer)\n"
         << " --empty             Ignore all producers (for testing only)\n"
+        << " --mmap              Memory-map the raw data file instead of reading it in memory\n"
+        << " --stream            Read the raw data file in a background thread with bounded read-ahead\n"
+        << " --container         Read the events from the indexed container.bin (see convert-data.py)\n"
+        << " --compressRaw       Keep the FED payloads in memory compressed, and decompress them when they are used\n"
+        << "                     (default mode and --container only)\n"
+        << " --timing            Print a summary of the per-module timings at the end\n"
+        << " --timingJson        Write the per-module, per-stream timings to FILE in JSON (implies --timing)\n"
+        << " --trace             Write a timeline of the events, modules and waits to FILE in the Chrome Trace Event\n"
+        << "                     format (for https://ui.perfetto.dev or chrome://tracing)\n"
+        << " --cpu               Run the whole reconstruction on the CPU, without a GPU (--transfer has no effect,\n"
+        << "                     --histogram is not supported)\n"
+        << " --batchSize         Number of events of different streams whose raw data are unpacked and clusterized\n"
+        << "                     together (default 1, i.e. no batching)\n"
+        << " --vertexMultiBlock  Run the density vertex clustering over many blocks instead of a single fused kernel\n"
+        << "                     (for events with many tracks)\n"
+        << " --output            Write the tracks and vertices to FILE in a chunked columnar format, in a background\n"
+        << "                     thread (implies --transfer)\n"
+        << " --compressOutput    Compress the columns of the --output file\n"
         << std::endl;
   }
 }  // namespace
@@ -43,6 +67,16 @@ int main(int argc, char** argv) {
   bool validation = false;
   bool histogram = false;
   bool empty = false;
+  auto sourceMode = edm::Source::Mode::kRead;
+  bool compressRaw = false;
+  bool timing = false;
+  std::filesystem::path timingJsonFile;
+  std::filesystem::path traceFile;
+  bool cpu = false;
+  int batchSize = 1;
+  bool vertexMultiBlock = false;
+  std::filesystem::path outputFile;
+  bool compressOutput = false;
   for (auto i = args.begin() + 1, e = args.end(); i != e; ++i) {
     if (*i == "-h" or *i == "--help") {
       print_help(args.front());
@@ -69,6 +103,36 @@ int main(int argc, char** argv) {
       histogram = true;
     } else if (*i == "--empty") {
       empty = true;
+    } else if (*i == "--mmap") {
+      sourceMode = edm::Source::Mode::kMmap;
+    } else if (*i == "--stream") {
+      sourceMode = edm::Source::Mode::kStream;
+    } else if (*i == "--container") {
+      sourceMode = edm::Source::Mode::kContainer;
+    } else if (*i == "--compressRaw") {
+      compressRaw = true;
+    } else if (*i == "--timing") {
+      timing = true;
+    } else if (*i == "--timingJson") {
+      ++i;
+      timing = true;
+      timingJsonFile = *i;
+    } else if (*i == "--trace") {
+      ++i;
+      traceFile = *i;
+    } else if (*i == "--cpu") {
+      cpu = true;
+    } else if (*i == "--batchSize") {
+      ++i;
+      batchSize = std::stoi(*i);
+    } else if (*i == "--vertexMultiBlock") {
+      vertexMultiBlock = true;
+    } else if (*i == "--output") {
+      ++i;
+      transfer = true;
+      outputFile = *i;
+    } else if (*i == "--compressOutput") {
+      compressOutput = true;
     } else {
       std::cout << "Invalid parameter " << *i << std::endl << std::endl;
       print_help(args.front());
@@ -85,29 +149,73 @@ int main(int argc, char** argv) {
     std::cout << "Data directory '" << datadir << "' does not exist" << std::endl;
     return EXIT_FAILURE;
   }
-  int numberOfDevices;
-  auto status = cudaGetDeviceCount(&numberOfDevices);
-  if (cudaSuccess != status) {
-    std::cout << "Failed to initialize the CUDA runtime";
+  if (cpu) {
+    if (histogram) {
+      std::cout << "--histogram is not supported with --cpu" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Running on the CPU" << std::endl;
+  } else {
+    int numberOfDevices;
+    auto status = cudaGetDeviceCount(&numberOfDevices);
+    if (cudaSuccess != status) {
+      std::cout << "Failed to initialize the CUDA runtime";
+      return EXIT_FAILURE;
+    }
+    std::cout << "Found " << numberOfDevices << " devices" << std::endl;
+  }
+
+  if (batchSize < 1) {
+    std::cout << "Invalid batch size " << batchSize << std::endl;
     return EXIT_FAILURE;
   }
-  std::cout << "Found " << numberOfDevices << " devices" << std::endl;
+  if (batchSize > numberOfStreams) {
+    std::cout << "The batch size " << batchSize << " is larger than the number of streams " << numberOfStreams
+              << ", the batches will have at most " << numberOfStreams << " events" << std::endl;
+  }
+  // The batch size is read by the modules when they are constructed
+  edm::EventBatching::setBatchSize(batchSize);
+  // and so is the output file
+  if (not outputFile.empty()) {
+    edm::ColumnarOutput::setFileName(
+        outputFile, compressOutput ? edm::ColumnarWriter::Compression::kLZ : edm::ColumnarWriter::Compression::kNone);
+  }
+
+  // The tracer needs to be enabled before the EventProcessor is constructed
+  if (not traceFile.empty()) {
+    edm::Tracer::enable();
+  }
 
   // Initialize EventProcessor
   std::vector<std::string> edmodules;
   std::vector<std::string> esmodules;
   if (not empty) {
-    edmodules = {
-        "BeamSpotToCUDA", "SiPixelRawToClusterCUDA", "SiPixelRecHitCUDA", "CAHitNtupletCUDA", "PixelVertexProducerCUDA"};
     esmodules = {"BeamSpotESProducer",
                  "SiPixelFedCablingMapGPUWrapperESProducer",
                  "SiPixelGainCalibrationForHLTGPUESProducer",
                  "PixelCPEFastESProducer"};
+  }
+  if (not empty and cpu) {
+    // all products are already on the host, no transfers needed
+    edmodules = {"SiPixelRawToClusterCPU",
+                 "SiPixelRecHitCPU",
+                 "CAHitNtupletCPU",
+                 vertexMultiBlock ? "PixelVertexProducerCPUMultiBlock" : "PixelVertexProducerCPU"};
+    if (validation) {
+      edmodules.emplace_back("CountValidatorCPU");
+    }
+    if (not outputFile.empty()) {
+      edmodules.emplace_back("TrackVertexOutput");
+    }
+  } else if (not empty) {
+    std::string const vertexProducer =
+        vertexMultiBlock ? "PixelVertexProducerCUDAMultiBlock" : "PixelVertexProducerCUDA";
+    edmodules = {"BeamSpotToCUDA", "SiPixelRawToClusterCUDA", "SiPixelRecHitCUDA", "CAHitNtupletCUDA", vertexProducer};
     if (transfer) {
       auto capos = std::find(edmodules.begin(), edmodules.end(), "CAHitNtupletCUDA");
       assert(capos != edmodules.end());
       edmodules.insert(capos + 1, "PixelTrackSoAFromCUDA");
-      auto vertpos = std::find(edmodules.begin(), edmodules.end(), "PixelVertexProducerCUDA");
+      auto vertpos = std::find(edmodules.begin(), edmodules.end(), vertexProducer);
       assert(vertpos != edmodules.end());
       edmodules.insert(vertpos + 1, "PixelVertexSoAFromCUDA");
     }
@@ -117,16 +225,31 @@ int main(int argc, char** argv) {
     if (histogram) {
       edmodules.emplace_back("HistoValidator");
     }
+    if (not outputFile.empty()) {
+      edmodules.emplace_back("TrackVertexOutput");
+    }
   }
-  edm::EventProcessor processor(
-      maxEvents, numberOfStreams, std::move(edmodules), std::move(esmodules), datadir, validation);
+  // Initialize tasks scheduler (thread pool), used also to construct the EventProcessor
+  tbb::task_scheduler_init tsi(numberOfThreads);
+
+  auto initStart = std::chrono::high_resolution_clock::now();
+  edm::EventProcessor processor(maxEvents,
+                                numberOfStreams,
+                                std::move(edmodules),
+                                std::move(esmodules),
+                                datadir,
+                                validation,
+                                sourceMode,
+                                compressRaw);
+  auto initStop = std::chrono::high_resolution_clock::now();
   maxEvents = processor.maxEvents();
+  if (timing) {
+    processor.enableTiming(timingJsonFile);
+  }
 
-  std::cout << "Processing " << maxEvents << " events, of which " << numberOfStreams << " concurrently, with "
-            << numberOfThreads << " threads." << std::endl;
-
-  // Initialize tasks scheduler (thread pool)
-  tbb::task_scheduler_init tsi(numberOfThreads);
+  std::cout << "Processing " << (maxEvents < 0 ? std::string("all") : std::to_string(maxEvents))
+            << " events, of which " << numberOfStreams << " concurrently, with " << numberOfThreads << " threads."
+            << std::endl;
 
   // Run work
   auto start = std::chrono::high_resolution_clock::now();
@@ -145,10 +268,14 @@ int main(int argc, char** argv) {
     return EXIT_FAILURE;
   }
   auto stop = std::chrono::high_resolution_clock::now();
+  maxEvents = processor.processedEvents();
 
   // Run endJob
   try {
     processor.endJob();
+    if (not traceFile.empty()) {
+      edm::Tracer::writeChromeTrace(traceFile);
+    }
   } catch (std::runtime_error& e) {
     std::cout << "\n----------\nCaught std::runtime_error" << std::endl;
     std::cout << e.what() << std::endl;
@@ -163,8 +290,20 @@ int main(int argc, char** argv) {
   }
 
   // Work done, report timing
-  auto diff = stop - start;
-  auto time = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1e6;
+  auto seconds = [](auto diff) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1e6;
+  };
+  auto initTime = seconds(initStop - initStart);
+  if (maxEvents > 0) {
+    // the processing time below does not include the initialization
+    auto firstEventTime = seconds(processor.firstEventLatency());
+    std::cout << "Time to first event " << std::scientific << initTime + firstEventTime << " seconds (initialization "
+              << initTime << " seconds, first event " << firstEventTime << " seconds)." << std::defaultfloat
+              << std::endl;
+  } else {
+    std::cout << "Initialization " << std::scientific << initTime << " seconds." << std::defaultfloat << std::endl;
+  }
+  auto time = seconds(stop - start);
   std::cout << "Processed " << maxEvents << " events in " << std::scientific << time << " seconds, throughput "
             << std::defaultfloat << (maxEvents / time) << " events/s." << std::endl;
   return EXIT_SUCCESS;
@@ -2,6 +2,7 @@
 #include "Framework/ESProducer.h"
 #include "Framework/EventSetup.h"
 #include "Framework/ESPluginFactory.h"
+#include "Framework/IOVFiles.h"
 
 #include <fstream>
 #include <iostream>
@@ -10,16 +11,28 @@
 class BeamSpotESProducer : public edm::ESProducer {
 public:
   explicit BeamSpotESProducer(std::filesystem::path const& datadir) : data_(datadir) {}
-  void produce(edm::EventSetup& eventSetup);
+  void produce(edm::EventSetup& eventSetup) override;
+
+  // the beam spot of the following intervals of validity is read from beamspot_<first event>.bin
+  std::vector<int> iovBoundaries() const override { return edm::iovFirstEvents(data_, "beamspot"); }
+  void produceIOV(edm::EventSetup& eventSetup, edm::IOV const& iov) override;
 
 private:
+  void read(std::filesystem::path const& filename, edm::EventSetup& eventSetup) const;
+
   std::filesystem::path data_;
 };
 
-void BeamSpotESProducer::produce(edm::EventSetup& eventSetup) {
+void BeamSpotESProducer::produce(edm::EventSetup& eventSetup) { read(data_ / "beamspot.bin", eventSetup); }
+
+void BeamSpotESProducer::produceIOV(edm::EventSetup& eventSetup, edm::IOV const& iov) {
+  read(edm::iovFile(data_, "beamspot", iov.first), eventSetup);
+}
+
+void BeamSpotESProducer::read(std::filesystem::path const& filename, edm::EventSetup& eventSetup) const {
   auto bs = std::make_unique<BeamSpotCUDA::Data>();
 
-  std::ifstream in(data_ / "beamspot.bin", std::ios::binary);
+  std::ifstream in(filename, std::ios::binary);
   in.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
   in.read(reinterpret_cast<char*>(bs.get()), sizeof(BeamSpotCUDA::Data));
   eventSetup.put(std::move(bs));
@@ -0,0 +1,145 @@
+#include "CUDADataFormats/PixelTrackHeterogeneous.h"
+#include "CUDADataFormats/ZVertexHeterogeneous.h"
+#include "Framework/ColumnarWriter.h"
+#include "Framework/EventSetup.h"
+#include "Framework/Event.h"
+#include "Framework/PluginFactory.h"
+#include "Framework/EDProducer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+  // in the order of the declaration in makeWriter()
+  enum Column : unsigned int {
+    kEvent = 0,
+    kTrackN,
+    kTrackPt,
+    kTrackEta,
+    kTrackPhi,
+    kTrackTip,
+    kTrackZip,
+    kTrackChi2,
+    kTrackQuality,
+    kTrackNHits,
+    kTrackHits,
+    kTrackVertex,
+    kVertexN,
+    kVertexZ,
+    kVertexW,
+    kVertexChi2,
+    kVertexPt2,
+    kVertexNdof
+  };
+
+  std::shared_ptr<edm::ColumnarWriter> makeWriter() {
+    using Type = edm::ColumnarWriter::Type;
+    std::vector<edm::ColumnarWriter::Column> columns = {{"event", Type::kInt32},
+                                                        {"track_n", Type::kUInt32},
+                                                        {"track_pt", Type::kFloat},
+                                                        {"track_eta", Type::kFloat},
+                                                        {"track_phi", Type::kFloat},
+                                                        {"track_tip", Type::kFloat},
+                                                        {"track_zip", Type::kFloat},
+                                                        {"track_chi2", Type::kFloat},
+                                                        {"track_quality", Type::kUInt8},
+                                                        {"track_nhits", Type::kUInt8},
+                                                        {"track_hits", Type::kUInt16},
+                                                        {"track_vertex", Type::kInt16},
+                                                        {"vertex_n", Type::kUInt32},
+                                                        {"vertex_z", Type::kFloat},
+                                                        {"vertex_w", Type::kFloat},
+                                                        {"vertex_chi2", Type::kFloat},
+                                                        {"vertex_pt2", Type::kFloat},
+                                                        {"vertex_ndof", Type::kInt32}};
+    if (edm::ColumnarOutput::fileName().empty()) {
+      throw std::runtime_error("TrackVertexOutput needs an output file (see --output)");
+    }
+    return std::make_shared<edm::ColumnarWriter>(
+        edm::ColumnarOutput::fileName(), std::move(columns), edm::ColumnarOutput::compression());
+  }
+
+  // the modules of all the streams write to the same file
+  std::shared_ptr<edm::ColumnarWriter> sharedWriter() {
+    static std::mutex mutex;
+    static std::weak_ptr<edm::ColumnarWriter> writer;
+    std::scoped_lock lock(mutex);
+    auto ret = writer.lock();
+    if (not ret) {
+      ret = makeWriter();
+      writer = ret;
+    }
+    return ret;
+  }
+}  // namespace
+
+class TrackVertexOutput : public edm::EDProducer {
+public:
+  explicit TrackVertexOutput(edm::ProductRegistry& reg);
+
+private:
+  void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
+  void endJob() override;
+
+  edm::EDGetTokenT<PixelTrackHeterogeneous> trackToken_;
+  edm::EDGetTokenT<ZVertexHeterogeneous> vertexToken_;
+
+  std::shared_ptr<edm::ColumnarWriter> writer_;
+};
+
+TrackVertexOutput::TrackVertexOutput(edm::ProductRegistry& reg)
+    : trackToken_(reg.consumes<PixelTrackHeterogeneous>()),
+      vertexToken_(reg.consumes<ZVertexHeterogeneous>()),
+      writer_(sharedWriter()) {}
+
+void TrackVertexOutput::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
+  auto const& tracks = *iEvent.get(trackToken_);
+  auto const& vertices = *iEvent.get(vertexToken_);
+
+  // only the products of the event are copied here, the formatting and the I/O are left to the writer thread
+  auto record = writer_->makeRecord();
+  record.push<int32_t>(kEvent, iEvent.eventID());
+
+  // the tracks fill the first slots
+  uint32_t nTracks = 0;
+  while (nTracks < uint32_t(tracks.stride()) and tracks.nHits(nTracks) > 0) {
+    ++nTracks;
+  }
+  record.push(kTrackN, nTracks);
+  auto const nIdv = std::min({nTracks, vertices.nTracks, ZVertexSoA::MAXTRACKS});
+  for (uint32_t i = 0; i < nTracks; ++i) {
+    record.push(kTrackPt, tracks.pt(i));
+    record.push(kTrackEta, tracks.eta(i));
+    record.push(kTrackPhi, tracks.phi(i));
+    record.push(kTrackTip, tracks.tip(i));
+    record.push(kTrackZip, tracks.zip(i));
+    record.push(kTrackChi2, tracks.chi2(i));
+    record.push<uint8_t>(kTrackQuality, tracks.quality(i));
+    record.push<uint8_t>(kTrackNHits, tracks.nHits(i));
+    record.append(kTrackHits, tracks.hitIndices.begin(i), tracks.hitIndices.size(i));
+    record.push<int16_t>(kTrackVertex, i < nIdv ? vertices.idv[i] : -1);
+  }
+
+  auto const nVertices = vertices.nvFinal;
+  record.push(kVertexN, nVertices);
+  record.append(kVertexZ, vertices.zv, nVertices);
+  record.append(kVertexW, vertices.wv, nVertices);
+  record.append(kVertexChi2, vertices.chi2, nVertices);
+  record.append(kVertexPt2, vertices.ptv2, nVertices);
+  record.append(kVertexNdof, vertices.ndof, nVertices);
+
+  writer_->write(std::move(record));
+}
+
+void TrackVertexOutput::endJob() {
+  // all the streams are done
+  writer_->close();
+  std::cout << "TrackVertexOutput: wrote " << writer_->writtenEvents() << " events (" << writer_->writtenBytes()
+            << " bytes) to " << edm::ColumnarOutput::fileName() << std::endl;
+}
+
+DEFINE_FWK_MODULE(TrackVertexOutput);
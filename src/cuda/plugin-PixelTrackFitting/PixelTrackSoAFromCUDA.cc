@@ -1,14 +1,21 @@
+#include <algorithm>
+#include <memory>
+
 #include <cuda_runtime.h>
 
 #include "CUDACore/Product.h"
 #include "CUDACore/HostProduct.h"
+#include "CUDADataFormats/PixelTrackCompact.h"
 #include "CUDADataFormats/PixelTrackHeterogeneous.h"
 #include "Framework/EventSetup.h"
 #include "Framework/Event.h"
 #include "Framework/PluginFactory.h"
 #include "Framework/EDProducer.h"
+#include "Framework/RunningAverage.h"
 #include "CUDACore/ScopedContext.h"
 
+#include "packTracks.h"
+
 class PixelTrackSoAFromCUDA : public edm::EDProducerExternalWork {
 public:
   explicit PixelTrackSoAFromCUDA(edm::ProductRegistry& reg);
@@ -24,23 +31,61 @@ private:
   edm::EDPutTokenT<PixelTrackHeterogeneous> tokenSOA_;
 
   cms::cuda::host::unique_ptr<pixelTrack::TrackSoA> m_soa;
+
+  // pack the tracks on the device, and copy only the used part of the SoA
+  const bool m_compact;
+  cms::cuda::device::unique_ptr<uint8_t[]> m_buffer_d;
+  cms::cuda::host::unique_ptr<uint8_t[]> m_buffer_h;
+  // the size of the packed buffer is known only on the device: copy the expected size,
+  // and all of it in a second step of acquire() if needed
+  size_t m_copied = 0;
+  edm::RunningAverage m_bufferSize;
+
+  cms::cuda::ContextState ctxState_;
 };
 
 PixelTrackSoAFromCUDA::PixelTrackSoAFromCUDA(edm::ProductRegistry& reg)
     : tokenCUDA_(reg.consumes<cms::cuda::Product<PixelTrackHeterogeneous>>()),
-      tokenSOA_(reg.produces<PixelTrackHeterogeneous>()) {}
+      tokenSOA_(reg.produces<PixelTrackHeterogeneous>()),
+      m_compact(true),
+      m_bufferSize(pixelTrack::TrackSoACompact::maxBufferSize() / 16) {}
 
 void PixelTrackSoAFromCUDA::acquire(edm::Event const& iEvent,
                                     edm::EventSetup const& iSetup,
                                     edm::WaitingTaskWithArenaHolder waitingTaskHolder) {
   cms::cuda::Product<PixelTrackHeterogeneous> const& inputDataWrapped = iEvent.get(tokenCUDA_);
-  cms::cuda::ScopedContextAcquire ctx{inputDataWrapped, std::move(waitingTaskHolder)};
+  cms::cuda::ScopedContextAcquire ctx{inputDataWrapped, std::move(waitingTaskHolder), ctxState_};
   auto const& inputData = ctx.get(inputDataWrapped);
 
-  m_soa = inputData.toHostAsync(ctx.stream());
+  if (not m_compact) {
+    m_soa = inputData.toHostAsync(ctx.stream());
+    return;
+  }
+
+  using pixelTrack::TrackSoACompact;
+  m_buffer_d = cms::cuda::make_device_unique<uint8_t[]>(TrackSoACompact::maxBufferSize(), ctx.stream());
+  pixelTrack::packAsync(inputData.get(), m_buffer_d.get(), ctx.stream());
+
+  // a margin of 25% over the upper estimate of the recent events
+  size_t expected = m_bufferSize.upper() + m_bufferSize.upper() / 4;
+  m_copied = std::clamp(expected, TrackSoACompact::headerSize(), TrackSoACompact::maxBufferSize());
+  m_buffer_h = cms::cuda::make_host_unique<uint8_t[]>(m_copied, ctx.stream());
+  cudaCheck(cudaMemcpyAsync(m_buffer_h.get(), m_buffer_d.get(), m_copied, cudaMemcpyDeviceToHost, ctx.stream()));
+
+  // once the header is on the host, copy all of the buffer if it is larger than expected
+  ctx.pushNextTask([this](cms::cuda::ScopedContextTask ctx) {
+    auto size = pixelTrack::TrackSoACompact(m_buffer_h.get()).bufferSize();
+    if (size > m_copied) {
+      m_buffer_h = cms::cuda::make_host_unique<uint8_t[]>(size, ctx.stream());
+      cudaCheck(cudaMemcpyAsync(m_buffer_h.get(), m_buffer_d.get(), size, cudaMemcpyDeviceToHost, ctx.stream()));
+      m_copied = size;
+    }
+  });
 }
 
 void PixelTrackSoAFromCUDA::produce(edm::Event& iEvent, edm::EventSetup const& iSetup) {
+  cms::cuda::ScopedContextProduce ctx{ctxState_};
+
   /*
   auto const & tsoa = *m_soa;
   auto maxTracks = tsoa.stride();
@@ -56,10 +101,25 @@ void PixelTrackSoAFromCUDA::produce(edm::Event& iEvent, edm::EventSetup const& i
   std::cout << "found " << nt << " tracks in cpu SoA at " << &tsoa << std::endl;
   */
 
-  // DO NOT  make a copy  (actually TWO....)
-  iEvent.emplace(tokenSOA_, PixelTrackHeterogeneous(std::move(m_soa)));
+  if (not m_compact) {
+    // DO NOT  make a copy  (actually TWO....)
+    iEvent.emplace(tokenSOA_, PixelTrackHeterogeneous(std::move(m_soa)));
+
+    assert(!m_soa);
+    return;
+  }
+
+  pixelTrack::TrackSoACompact compact(m_buffer_h.get());
+  m_bufferSize.update(compact.bufferSize());
+
+  // the slots after the last track are left uninitialised, apart from the (empty) hit offsets;
+  // the SoA is owned by the event, so it is allocated for each event
+  std::unique_ptr<pixelTrack::TrackSoA> soa(new pixelTrack::TrackSoA);
+  compact.unpack(*soa);
+  iEvent.emplace(tokenSOA_, PixelTrackHeterogeneous(std::move(soa)));
 
-  assert(!m_soa);
+  m_buffer_d.reset();
+  m_buffer_h.reset();
 }
 
 DEFINE_FWK_MODULE(PixelTrackSoAFromCUDA);
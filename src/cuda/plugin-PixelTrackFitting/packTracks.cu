@@ -0,0 +1,14 @@
+#include "CUDACore/cudaCheck.h"
+
+#include "packTracks.h"
+
+namespace pixelTrack {
+  void packAsync(TrackSoA const* tracks_d, uint8_t* buffer_d, cudaStream_t stream) {
+    auto blockSize = 128;
+    auto numberOfBlocks = (TrackSoA::stride() + blockSize - 1) / blockSize;
+    countTracks<<<numberOfBlocks, blockSize, 0, stream>>>(tracks_d, buffer_d);
+    cudaCheck(cudaGetLastError());
+    packTracks<<<numberOfBlocks, blockSize, 0, stream>>>(tracks_d, buffer_d);
+    cudaCheck(cudaGetLastError());
+  }
+}  // namespace pixelTrack
@@ -0,0 +1,15 @@
+#ifndef RecoPixelVertexing_PixelTrackFitting_plugins_packTracks_h
+#define RecoPixelVertexing_PixelTrackFitting_plugins_packTracks_h
+
+#include <cstdint>
+
+#include <cuda_runtime.h>
+
+#include "CUDADataFormats/PixelTrackCompact.h"
+
+namespace pixelTrack {
+  // packs the tracks into buffer_d, that must hold at least TrackSoACompact::maxBufferSize() bytes
+  void packAsync(TrackSoA const* tracks_d, uint8_t* buffer_d, cudaStream_t stream);
+}  // namespace pixelTrack
+
+#endif  // RecoPixelVertexing_PixelTrackFitting_plugins_packTracks_h
@@ -0,0 +1,565 @@
+#ifndef RecoPixelVertexing_PixelTrackFitting_interface_BrokenLineBatch_h
+#define RecoPixelVertexing_PixelTrackFitting_interface_BrokenLineBatch_h
+
+#include <algorithm>
+#include <cmath>
+
+#include "BrokenLine.h"
+
+/*!
+  \brief Broken Line fit of a batch of W tuples with the same number of hits, for the CPU.
+
+  Each variable of the scalar fit in BrokenLine.h becomes a Lanes<W>, holding its value for
+  each tuple of the batch; the arithmetic operators loop over the lanes with a fixed trip
+  count, so that the compiler turns them into SIMD instructions. The steps of the fit, the
+  fast fit, the preparation of the data, the line and circle fits and the Cholesky inversions,
+  follow one to one the scalar ones, and give the same results.
+*/
+namespace BrokenLine {
+  namespace batch {
+
+    // number of tuples fitted together: wider batches than the SIMD registers spill, and are slower;
+    // with AVX2 alone the calls to the scalar math functions make batches of 4 slower than the scalar fit
+#if defined(__AVX512F__)
+    constexpr int batchWidth = 8;
+#else
+    constexpr int batchWidth = 2;
+#endif
+
+    template <int W>
+    struct Lanes {
+      Lanes() = default;
+      // broadcast
+      inline __attribute__((always_inline)) Lanes(double x) {
+        for (int l = 0; l < W; ++l)
+          v[l] = x;
+      }
+
+      double& operator[](int l) { return v[l]; }
+      double operator[](int l) const { return v[l]; }
+
+      inline __attribute__((always_inline)) Lanes& operator+=(Lanes const& b) {
+        for (int l = 0; l < W; ++l)
+          v[l] += b.v[l];
+        return *this;
+      }
+      inline __attribute__((always_inline)) Lanes& operator-=(Lanes const& b) {
+        for (int l = 0; l < W; ++l)
+          v[l] -= b.v[l];
+        return *this;
+      }
+      inline __attribute__((always_inline)) Lanes& operator*=(Lanes const& b) {
+        for (int l = 0; l < W; ++l)
+          v[l] *= b.v[l];
+        return *this;
+      }
+      inline __attribute__((always_inline)) Lanes& operator/=(Lanes const& b) {
+        for (int l = 0; l < W; ++l)
+          v[l] /= b.v[l];
+        return *this;
+      }
+
+      friend inline __attribute__((always_inline)) Lanes operator+(Lanes a, Lanes const& b) { return a += b; }
+      friend inline __attribute__((always_inline)) Lanes operator-(Lanes a, Lanes const& b) { return a -= b; }
+      friend inline __attribute__((always_inline)) Lanes operator*(Lanes a, Lanes const& b) { return a *= b; }
+      friend inline __attribute__((always_inline)) Lanes operator/(Lanes a, Lanes const& b) { return a /= b; }
+      friend inline __attribute__((always_inline)) Lanes operator-(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = -a.v[l];
+        return a;
+      }
+
+      // hidden friends, so that they do not hide the functions for the scalars
+      friend inline __attribute__((always_inline)) Lanes sqrt(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = std::sqrt(a.v[l]);
+        return a;
+      }
+      friend inline __attribute__((always_inline)) Lanes abs(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = std::abs(a.v[l]);
+        return a;
+      }
+      friend inline __attribute__((always_inline)) Lanes min(Lanes a, double b) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = std::min(a.v[l], b);
+        return a;
+      }
+      friend inline __attribute__((always_inline)) Lanes log(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = std::log(a.v[l]);
+        return a;
+      }
+      friend inline __attribute__((always_inline)) Lanes sin(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = std::sin(a.v[l]);
+        return a;
+      }
+      friend inline __attribute__((always_inline)) Lanes cos(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = std::cos(a.v[l]);
+        return a;
+      }
+      friend inline __attribute__((always_inline)) Lanes atan2(Lanes y, Lanes const& x) {
+        for (int l = 0; l < W; ++l)
+          y.v[l] = std::atan2(y.v[l], x.v[l]);
+        return y;
+      }
+      // 1 where a > 0, -1 elsewhere
+      friend inline __attribute__((always_inline)) Lanes sign(Lanes a) {
+        for (int l = 0; l < W; ++l)
+          a.v[l] = a.v[l] > 0 ? 1. : -1.;
+        return a;
+      }
+
+      alignas(W * sizeof(double)) double v[W];
+    };
+
+    // with the element access of the Eigen matrices, to reuse choleskyInversion
+    template <int R, int C, int W>
+    struct LaneMatrix {
+      Lanes<W>& operator()(int i, int j) { return m[i][j]; }
+      Lanes<W> const& operator()(int i, int j) const { return m[i][j]; }
+
+      Lanes<W> m[R][C];
+    };
+
+    template <int N, int W = batchWidth>
+    struct Hits {
+      Lanes<W> x[N];
+      Lanes<W> y[N];
+      Lanes<W> z[N];
+      Lanes<W> ge[6][N];  //!< xx, xy, yy, xz, yz, zz
+    };
+
+    template <int N, int W = batchWidth>
+    struct PreparedBrokenLineData {
+      Lanes<W> q;
+      Lanes<W> radii[2][N];
+      Lanes<W> s[N];
+      Lanes<W> S[N];
+      Lanes<W> Z[N];
+      Lanes<W> VarBeta[N];
+    };
+
+    template <int W = batchWidth>
+    struct karimaki_circle_fit {
+      Lanes<W> par[3];  //!< (phi, d, k)
+      LaneMatrix<3, 3, W> cov;
+      Lanes<W> q;
+      Lanes<W> chi2;
+    };
+
+    template <int W = batchWidth>
+    struct line_fit {
+      Lanes<W> par[2];  //!< (cotan(theta), Zip)
+      LaneMatrix<2, 2, W> cov;
+      Lanes<W> chi2;
+    };
+
+    template <int K, int W>
+    inline void invert(LaneMatrix<K, K, W> const& src, LaneMatrix<K, K, W>& dst) {
+      choleskyInversion::Inverter<LaneMatrix<K, K, W>, LaneMatrix<K, K, W>, K>::eval(src, dst);
+    }
+
+    // cov = Jacob * cov * Jacob^T
+    template <int K, int W>
+    inline void similarity(LaneMatrix<K, K, W> const& Jacob, LaneMatrix<K, K, W>& cov) {
+      LaneMatrix<K, K, W> tmp;
+      for (int i = 0; i < K; ++i)
+        for (int j = 0; j < K; ++j)
+          for (int l = 0; l < W; ++l) {
+            double sum = 0.;
+            for (int k = 0; k < K; ++k)
+              sum += Jacob(i, k)[l] * cov(k, j)[l];
+            tmp(i, j)[l] = sum;
+          }
+      for (int i = 0; i < K; ++i)
+        for (int j = 0; j < K; ++j)
+          for (int l = 0; l < W; ++l) {
+            double sum = 0.;
+            for (int k = 0; k < K; ++k)
+              sum += tmp(i, k)[l] * Jacob(j, k)[l];
+            cov(i, j)[l] = sum;
+          }
+    }
+
+    //! see BrokenLine::MultScatt
+    template <int W>
+    inline Lanes<W> MultScatt(Lanes<W> const& length, const double B, Lanes<W> const& R, Lanes<W> const& slope) {
+      auto pt2 = min(B * R, 20.);
+      pt2 *= pt2;
+      constexpr double XXI_0 = 0.06 / 16.;
+      constexpr double geometry_factor = 0.7;
+      constexpr double fact = geometry_factor * sqr(13.6 / 1000.);
+      auto x = abs(length) * XXI_0;
+      return fact / (pt2 * (1. + sqr(slope))) * x * sqr(1. + 0.038 * log(x));
+    }
+
+    //! see BrokenLine::TranslateKarimaki
+    template <int W>
+    inline void TranslateKarimaki(karimaki_circle_fit<W>& circle, Lanes<W> const& x0, Lanes<W> const& y0) {
+      auto const& phi = circle.par[0];
+      auto const& d = circle.par[1];
+      auto const& k = circle.par[2];
+      auto cosPhi = cos(phi);
+      auto sinPhi = sin(phi);
+      auto DP = x0 * cosPhi + y0 * sinPhi;
+      auto DO = x0 * sinPhi - y0 * cosPhi + d;
+      auto uu = 1. + k * d;
+      auto C = -k * y0 + uu * cosPhi;
+      auto BB = k * x0 + uu * sinPhi;
+      auto A = 2. * DO + k * (sqr(DO) + sqr(DP));
+      auto U = sqrt(1. + k * A);
+      auto xi = 1. / (sqr(BB) + sqr(C));
+      auto v = 1. + k * DO;
+      auto lambda = (0.5 * A) / (U * sqr(1. + U));
+      auto mu = 1. / (U * (1. + U)) + k * lambda;
+      auto zeta = sqr(DO) + sqr(DP);
+
+      LaneMatrix<3, 3, W> Jacob;
+      Jacob(0, 0) = xi * uu * v;
+      Jacob(0, 1) = -xi * sqr(k) * DP;
+      Jacob(0, 2) = xi * DP;
+      Jacob(1, 0) = 2. * mu * uu * DP;
+      Jacob(1, 1) = 2. * mu * v;
+      Jacob(1, 2) = mu * zeta - lambda * A;
+      Jacob(2, 0) = 0.;
+      Jacob(2, 1) = 0.;
+      Jacob(2, 2) = 1.;
+
+      circle.par[0] = atan2(BB, C);
+      circle.par[1] = A / (1. + U);
+
+      similarity(Jacob, circle.cov);
+    }
+
+    //! see BrokenLine::BL_Fast_fit
+    template <int N, int W>
+    inline void BL_Fast_fit(Hits<N, W> const& hits, Lanes<W> (&result)[4]) {
+      constexpr int n = N;
+      auto ax = hits.x[n / 2] - hits.x[0];
+      auto ay = hits.y[n / 2] - hits.y[0];
+      auto bx = hits.x[n - 1] - hits.x[n / 2];
+      auto by = hits.y[n - 1] - hits.y[n / 2];
+      auto cx = hits.x[0] - hits.x[n - 1];
+      auto cy = hits.y[0] - hits.y[n - 1];
+      auto a2 = sqr(ax) + sqr(ay);
+      auto b2 = sqr(bx) + sqr(by);
+      auto c2 = sqr(cx) + sqr(cy);
+
+      auto tmp = 0.5 / (cx * ay - cy * ax);
+      result[0] = hits.x[0] - (ay * c2 + cy * a2) * tmp;
+      result[1] = hits.y[0] + (ax * c2 + cx * a2) * tmp;
+      result[2] = sqrt(a2 * b2 * c2) / (2. * abs(bx * ay - by * ax));
+
+      auto dx = hits.x[0] - result[0];
+      auto dy = hits.y[0] - result[1];
+      auto ex = hits.x[n - 1] - result[0];
+      auto ey = hits.y[n - 1] - result[1];
+      result[3] = result[2] * atan2(dx * ey - dy * ex, dx * ex + dy * ey) / (hits.z[n - 1] - hits.z[0]);
+    }
+
+    //! see BrokenLine::prepareBrokenLineData
+    template <int N, int W>
+    inline void prepareBrokenLineData(Hits<N, W> const& hits,
+                                      Lanes<W> const (&fast_fit)[4],
+                                      const double B,
+                                      PreparedBrokenLineData<N, W>& results) {
+      constexpr int n = N;
+
+      auto dx = hits.x[1] - hits.x[0];
+      auto dy = hits.y[1] - hits.y[0];
+      auto ex = hits.x[n - 1] - hits.x[n - 2];
+      auto ey = hits.y[n - 1] - hits.y[n - 2];
+      results.q = -sign(dx * ey - dy * ex);
+
+      auto slope = -results.q / fast_fit[3];
+      auto R00 = 1. / sqrt(1. + sqr(slope));
+      auto R01 = slope * R00;
+
+      auto norm = sqrt(sqr(fast_fit[0]) + sqr(fast_fit[1]));
+      ex = -fast_fit[2] * fast_fit[0] / norm;
+      ey = -fast_fit[2] * fast_fit[1] / norm;
+      for (int i = 0; i < n; ++i) {
+        results.radii[0][i] = hits.x[i] - fast_fit[0];
+        results.radii[1][i] = hits.y[i] - fast_fit[1];
+        auto const& rx = results.radii[0][i];
+        auto const& ry = results.radii[1][i];
+        results.s[i] = results.q * fast_fit[2] * atan2(rx * ey - ry * ex, rx * ex + ry * ey);
+        results.S[i] = R00 * results.s[i] + R01 * hits.z[i];
+        results.Z[i] = R00 * hits.z[i] - R01 * results.s[i];
+      }
+
+      results.VarBeta[0] = results.VarBeta[n - 1] = 0.;
+      for (int i = 1; i < n - 1; ++i) {
+        results.VarBeta[i] = MultScatt(results.S[i + 1] - results.S[i], B, fast_fit[2], slope) +
+                             MultScatt(results.S[i] - results.S[i - 1], B, fast_fit[2], slope);
+      }
+    }
+
+    //! see BrokenLine::MatrixC_u
+    template <int N, int W, int K>
+    inline void MatrixC_u(Lanes<W> const (&w)[N],
+                          Lanes<W> const (&S)[N],
+                          Lanes<W> const (&VarBeta)[N],
+                          LaneMatrix<K, K, W>& C_U) {
+      constexpr int n = N;
+      LaneMatrix<N, N, W> C;
+      for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+          C(i, j) = 0.;
+      for (int i = 0; i < n; ++i) {
+        C(i, i) = w[i];
+        if (i > 1)
+          C(i, i) += 1. / (VarBeta[i - 1] * sqr(S[i] - S[i - 1]));
+        if (i > 0 && i < n - 1)
+          C(i, i) += (1. / VarBeta[i]) * sqr((S[i + 1] - S[i - 1]) / ((S[i + 1] - S[i]) * (S[i] - S[i - 1])));
+        if (i < n - 2)
+          C(i, i) += 1. / (VarBeta[i + 1] * sqr(S[i + 1] - S[i]));
+
+        if (i > 0 && i < n - 1)
+          C(i, i + 1) = 1. / (VarBeta[i] * (S[i + 1] - S[i])) *
+                        (-(S[i + 1] - S[i - 1]) / ((S[i + 1] - S[i]) * (S[i] - S[i - 1])));
+        if (i < n - 2)
+          C(i, i + 1) += 1. / (VarBeta[i + 1] * (S[i + 1] - S[i])) *
+                         (-(S[i + 2] - S[i]) / ((S[i + 2] - S[i + 1]) * (S[i + 1] - S[i])));
+
+        if (i < n - 2)
+          C(i, i + 2) = 1. / (VarBeta[i + 1] * (S[i + 2] - S[i + 1]) * (S[i + 1] - S[i]));
+
+        C(i, i) *= 0.5;
+      }
+      for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+          C_U(i, j) = C(i, j) + C(j, i);
+    }
+
+    //! see BrokenLine::BL_Line_fit
+    template <int N, int W>
+    inline void BL_Line_fit(Hits<N, W> const& hits,
+                            Lanes<W> const (&fast_fit)[4],
+                            const double B,
+                            PreparedBrokenLineData<N, W> const& data,
+                            line_fit<W>& line_results) {
+      constexpr int n = N;
+
+      auto const& S = data.S;
+      auto const& Z = data.Z;
+
+      auto slope = -data.q / fast_fit[3];
+      auto R00 = 1. / sqrt(1. + sqr(slope));
+      auto R01 = slope * R00;
+      // second row of the rotation matrix
+      auto R10 = -R01;
+      auto R11 = R00;
+
+      Lanes<W> w[N];
+      Lanes<W> r_u[N];
+      for (int i = 0; i < n; ++i) {
+        // (R * JacobXYZtosZ * V * JacobXYZtosZ^T * R^T)(1, 1), with the only non-zero elements of the jacobian
+        auto tmp = 1. / sqrt(sqr(data.radii[0][i]) + sqr(data.radii[1][i]));
+        auto j0 = data.radii[1][i] * tmp;
+        auto j1 = -data.radii[0][i] * tmp;
+        auto m00 = sqr(j0) * hits.ge[0][i] + 2. * j0 * j1 * hits.ge[1][i] + sqr(j1) * hits.ge[2][i];
+        auto m01 = j0 * hits.ge[3][i] + j1 * hits.ge[4][i];
+        auto const& m11 = hits.ge[5][i];
+        w[i] = 1. / (sqr(R10) * m00 + 2. * R10 * R11 * m01 + sqr(R11) * m11);
+        r_u[i] = w[i] * Z[i];
+      }
+
+      LaneMatrix<N, N, W> C_U;
+      MatrixC_u(w, S, data.VarBeta, C_U);
+      LaneMatrix<N, N, W> I;
+      invert(C_U, I);
+
+      Lanes<W> u[N];
+      for (int i = 0; i < n; ++i) {
+        u[i] = I(i, 0) * r_u[0];
+        for (int j = 1; j < n; ++j)
+          u[i] += I(i, j) * r_u[j];
+      }
+
+      // line parameters in the system in which the first hit is the origin and with axis along SZ
+      line_results.par[0] = (u[1] - u[0]) / (S[1] - S[0]);
+      line_results.par[1] = u[0];
+      auto idiff = 1. / (S[1] - S[0]);
+      line_results.cov(0, 0) =
+          (I(0, 0) - 2. * I(0, 1) + I(1, 1)) * sqr(idiff) + MultScatt(S[1] - S[0], B, fast_fit[2], slope);
+      line_results.cov(0, 1) = line_results.cov(1, 0) = (I(0, 1) - I(0, 0)) * idiff;
+      line_results.cov(1, 1) = I(0, 0);
+
+      // translate to the original SZ system
+      LaneMatrix<2, 2, W> Jacob;
+      Jacob(0, 0) = 1.;
+      Jacob(0, 1) = 0.;
+      Jacob(1, 0) = -S[0];
+      Jacob(1, 1) = 1.;
+      line_results.par[1] += -line_results.par[0] * S[0];
+      similarity(Jacob, line_results.cov);
+
+      // rotate to the original sz system
+      auto tmp = R00 - line_results.par[0] * R01;
+      Jacob(1, 1) = 1. / tmp;
+      Jacob(0, 0) = Jacob(1, 1) * Jacob(1, 1);
+      Jacob(0, 1) = 0.;
+      Jacob(1, 0) = line_results.par[1] * R01 * Jacob(0, 0);
+      line_results.par[1] = line_results.par[1] * Jacob(1, 1);
+      line_results.par[0] = (R01 + line_results.par[0] * R00) * Jacob(1, 1);
+      similarity(Jacob, line_results.cov);
+
+      // compute chi2
+      line_results.chi2 = 0.;
+      for (int i = 0; i < n; ++i) {
+        line_results.chi2 += w[i] * sqr(Z[i] - u[i]);
+        if (i > 0 && i < n - 1)
+          line_results.chi2 += sqr(u[i - 1] / (S[i] - S[i - 1]) -
+                                   u[i] * (S[i + 1] - S[i - 1]) / ((S[i + 1] - S[i]) * (S[i] - S[i - 1])) +
+                                   u[i + 1] / (S[i + 1] - S[i])) /
+                               data.VarBeta[i];
+      }
+    }
+
+    //! see BrokenLine::BL_Circle_fit
+    template <int N, int W>
+    inline void BL_Circle_fit(Hits<N, W> const& hits,
+                              Lanes<W> const (&fast_fit)[4],
+                              const double B,
+                              PreparedBrokenLineData<N, W>& data,
+                              karimaki_circle_fit<W>& circle_results) {
+      constexpr int n = N;
+
+      circle_results.q = data.q;
+      auto& radii = data.radii;
+      auto const& s = data.s;
+      auto const& S = data.S;
+      auto& Z = data.Z;
+      auto& VarBeta = data.VarBeta;
+      auto slope = -circle_results.q / fast_fit[3];
+      for (int i = 0; i < n; ++i) {
+        VarBeta[i] *= 1. + sqr(slope);  // the kink angles are projected!
+      }
+
+      Lanes<W> w[N];
+      Lanes<W> r_u[N + 1];
+      for (int i = 0; i < n; ++i) {
+        Z[i] = sqrt(sqr(radii[0][i]) + sqr(radii[1][i])) - fast_fit[2];
+        // (RR * V * RR^T)(1, 1), with the rotation matrix point by point
+        auto pointSlope = -radii[0][i] / radii[1][i];
+        auto c = 1. / sqrt(1. + sqr(pointSlope));
+        auto sn = pointSlope * c;
+        w[i] = 1. / (sqr(sn) * hits.ge[0][i] - 2. * sn * c * hits.ge[1][i] + sqr(c) * hits.ge[2][i]);
+        r_u[i] = w[i] * Z[i];
+      }
+      r_u[n] = 0.;
+
+      LaneMatrix<N + 1, N + 1, W> C_U;
+      MatrixC_u(w, s, VarBeta, C_U);
+      C_U(n, n) = 0.;
+      //add the border to the C_u matrix
+      for (int i = 0; i < n; ++i) {
+        C_U(i, n) = 0.;
+        if (i > 0 && i < n - 1) {
+          C_U(i, n) += -(s[i + 1] - s[i - 1]) * (s[i + 1] - s[i - 1]) /
+                       (2. * VarBeta[i] * (s[i + 1] - s[i]) * (s[i] - s[i - 1]));
+        }
+        if (i > 1) {
+          C_U(i, n) += (s[i] - s[i - 2]) / (2. * VarBeta[i - 1] * (s[i] - s[i - 1]));
+        }
+        if (i < n - 2) {
+          C_U(i, n) += (s[i + 2] - s[i]) / (2. * VarBeta[i + 1] * (s[i + 1] - s[i]));
+        }
+        C_U(n, i) = C_U(i, n);
+        if (i > 0 && i < n - 1)
+          C_U(n, n) += sqr(s[i + 1] - s[i - 1]) / (4. * VarBeta[i]);
+      }
+
+      LaneMatrix<N + 1, N + 1, W> I;
+      invert(C_U, I);
+
+      Lanes<W> u[N + 1];
+      for (int i = 0; i <= n; ++i) {
+        u[i] = I(i, 0) * r_u[0];
+        for (int j = 1; j <= n; ++j)
+          u[i] += I(i, j) * r_u[j];
+      }
+
+      // compute (phi, d_ca, k) in the system in which the midpoint of the first two corrected hits is the origin...
+      for (int i = 0; i < 2; ++i) {
+        auto norm = sqrt(sqr(radii[0][i]) + sqr(radii[1][i]));
+        radii[0][i] /= norm;
+        radii[1][i] /= norm;
+      }
+
+      auto dx = hits.x[0] + (-Z[0] + u[0]) * radii[0][0];
+      auto dy = hits.y[0] + (-Z[0] + u[0]) * radii[1][0];
+      auto ex = hits.x[1] + (-Z[1] + u[1]) * radii[0][1];
+      auto ey = hits.y[1] + (-Z[1] + u[1]) * radii[1][1];
+      auto eMinusd0 = ex - dx;
+      auto eMinusd1 = ey - dy;
+      auto tmp1 = sqr(eMinusd0) + sqr(eMinusd1);
+
+      auto const& q = circle_results.q;
+      circle_results.par[0] = atan2(eMinusd1, eMinusd0);
+      circle_results.par[1] = -q * (fast_fit[2] - sqrt(sqr(fast_fit[2]) - 0.25 * tmp1));
+      circle_results.par[2] = q * (1. / fast_fit[2] + u[n]);
+
+      LaneMatrix<3, 3, W> Jacob;
+      Jacob(0, 0) = (radii[1][0] * eMinusd0 - eMinusd1 * radii[0][0]) / tmp1;
+      Jacob(0, 1) = (radii[1][1] * eMinusd0 - eMinusd1 * radii[0][1]) / tmp1;
+      Jacob(0, 2) = 0.;
+      // the scalar fit computes these with the integer (q / 2), that is 0
+      Jacob(1, 0) = 0.;
+      Jacob(1, 1) = 0.;
+      Jacob(1, 2) = 0.;
+      Jacob(2, 0) = 0.;
+      Jacob(2, 1) = 0.;
+      Jacob(2, 2) = q;
+
+      constexpr int index[3] = {0, 1, n};
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+          circle_results.cov(i, j) = I(index[i], index[j]);
+      similarity(Jacob, circle_results.cov);
+
+      //...Translate in the system in which the first corrected hit is the origin, adding the m.s. correction...
+
+      TranslateKarimaki(circle_results, 0.5 * eMinusd0, 0.5 * eMinusd1);
+      circle_results.cov(0, 0) += (1. + sqr(slope)) * MultScatt(S[1] - S[0], B, fast_fit[2], slope);
+
+      //...And translate back to the original system
+
+      TranslateKarimaki(circle_results, dx, dy);
+
+      // compute chi2
+      circle_results.chi2 = 0.;
+      for (int i = 0; i < n; ++i) {
+        circle_results.chi2 += w[i] * sqr(Z[i] - u[i]);
+        if (i > 0 && i < n - 1)
+          circle_results.chi2 += sqr(u[i - 1] / (s[i] - s[i - 1]) -
+                                     u[i] * (s[i + 1] - s[i - 1]) / ((s[i + 1] - s[i]) * (s[i] - s[i - 1])) +
+                                     u[i + 1] / (s[i + 1] - s[i]) + (s[i + 1] - s[i - 1]) * u[n] / 2.) /
+                                 VarBeta[i];
+      }
+    }
+
+    /*!
+      \brief Fast fit, line and circle fits of a batch of tuples, as in kernelBLFastFit and kernelBLFit.
+    */
+    template <int N, int W>
+    inline void BL_Fit(Hits<N, W> const& hits,
+                       const double B,
+                       karimaki_circle_fit<W>& circle,
+                       line_fit<W>& line,
+                       Lanes<W> (&fast_fit)[4]) {
+      PreparedBrokenLineData<N, W> data;
+      BL_Fast_fit(hits, fast_fit);
+      prepareBrokenLineData(hits, fast_fit, B, data);
+      BL_Line_fit(hits, fast_fit, B, data, line);
+      BL_Circle_fit(hits, fast_fit, B, data, circle);
+    }
+
+  }  // namespace batch
+}  // namespace BrokenLine
+
+#endif  // RecoPixelVertexing_PixelTrackFitting_interface_BrokenLineBatch_h
@@ -0,0 +1,78 @@
+#ifndef RecoPixelVertexing_PixelTrackFitting_plugins_BrokenLineFitOnCPU_h
+#define RecoPixelVertexing_PixelTrackFitting_plugins_BrokenLineFitOnCPU_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "BrokenLineBatch.h"
+#include "BrokenLineFitOnGPU.h"
+
+// Fit the tuples with nHits hits in batches of BrokenLine::batch::batchWidth, one per SIMD lane;
+// same as kernelBLFastFit and kernelBLFit, without the intermediate buffers
+template <int N>
+void kernelBLFitBatch(Tuples const* __restrict__ foundNtuplets,
+                      CAConstants::TupleMultiplicity const* __restrict__ tupleMultiplicity,
+                      HitsOnGPU const* __restrict__ hhp,
+                      double B,
+                      OutputSoA* results,
+                      uint32_t nHits) {
+  constexpr int W = BrokenLine::batch::batchWidth;
+  assert(N <= nHits);
+
+  auto nTuples = tupleMultiplicity->size(nHits);
+  for (uint32_t first = 0; first < nTuples; first += W) {
+    int nLanes = std::min<uint32_t>(W, nTuples - first);
+
+    BrokenLine::batch::Hits<N, W> hits;
+    for (int l = 0; l < W; ++l) {
+      // the lanes after the last tuple repeat the first one, and are not stored
+      auto tkid = *(tupleMultiplicity->begin(nHits) + first + (l < nLanes ? l : 0));
+      assert(tkid < foundNtuplets->nbins());
+      assert(foundNtuplets->size(tkid) == nHits);
+      auto const* hitId = foundNtuplets->begin(tkid);
+      for (int i = 0; i < N; ++i) {
+        auto hit = hitId[i];
+        float ge[6];
+        hhp->cpeParams()
+            .detParams(hhp->detectorIndex(hit))
+            .frame.toGlobal(hhp->xerrLocal(hit), 0, hhp->yerrLocal(hit), ge);
+        hits.x[i][l] = hhp->xGlobal(hit);
+        hits.y[i][l] = hhp->yGlobal(hit);
+        hits.z[i][l] = hhp->zGlobal(hit);
+        for (int k = 0; k < 6; ++k)
+          hits.ge[k][i][l] = ge[k];
+      }
+    }
+
+    BrokenLine::batch::karimaki_circle_fit<W> circle;
+    BrokenLine::batch::line_fit<W> line;
+    BrokenLine::batch::Lanes<W> fast_fit[4];
+    BrokenLine::batch::BL_Fit(hits, B, circle, line, fast_fit);
+
+    for (int l = 0; l < nLanes; ++l) {
+      // no NaN here....
+      assert(fast_fit[0][l] == fast_fit[0][l]);
+      assert(fast_fit[1][l] == fast_fit[1][l]);
+      assert(fast_fit[2][l] == fast_fit[2][l]);
+      assert(fast_fit[3][l] == fast_fit[3][l]);
+
+      auto tkid = *(tupleMultiplicity->begin(nHits) + first + l);
+      Rfit::Vector3d circlePar(circle.par[0][l], circle.par[1][l], circle.par[2][l]);
+      Rfit::Matrix3d circleCov;
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+          circleCov(i, j) = circle.cov(i, j)[l];
+      Rfit::Vector2d linePar(line.par[0][l], line.par[1][l]);
+      Rfit::Matrix2d lineCov;
+      lineCov << line.cov(0, 0)[l], line.cov(0, 1)[l], line.cov(1, 0)[l], line.cov(1, 1)[l];
+
+      results->stateAtBS.copyFromCircle(circlePar, circleCov, linePar, lineCov, 1.f / float(B), tkid);
+      results->pt(tkid) = float(B) / float(std::abs(circlePar(2)));
+      results->eta(tkid) = asinhf(linePar(0));
+      results->chi2(tkid) = (circle.chi2[l] + line.chi2[l]) / (2 * N - 5);
+    }
+  }
+}
+
+#endif  // RecoPixelVertexing_PixelTrackFitting_plugins_BrokenLineFitOnCPU_h
@@ -12,33 +12,72 @@
 #include "CUDADataFormats/PixelTrackHeterogeneous.h"
 #include "CUDADataFormats/TrackingRecHit2DCUDA.h"
 
-class CAHitNtupletCUDA : public edm::EDProducer {
+class CAHitNtupletCUDA : public edm::EDProducerExternalWork {
 public:
-  explicit CAHitNtupletCUDA(edm::ProductRegistry& reg);
+  explicit CAHitNtupletCUDA(edm::ProductRegistry& reg) : CAHitNtupletCUDA(reg, true) {}
+  CAHitNtupletCUDA(edm::ProductRegistry& reg, bool onGPU);
   ~CAHitNtupletCUDA() override = default;
 
 private:
+  void acquire(const edm::Event& iEvent,
+               const edm::EventSetup& iSetup,
+               edm::WaitingTaskWithArenaHolder waitingTaskHolder) override;
   void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
 
+  bool m_OnGPU;
+
+  cms::cuda::ContextState ctxState_;
+
   edm::EDGetTokenT<cms::cuda::Product<TrackingRecHit2DGPU>> tokenHitGPU_;
   edm::EDPutTokenT<cms::cuda::Product<PixelTrackHeterogeneous>> tokenTrackGPU_;
+  edm::EDGetTokenT<TrackingRecHit2DCPU> tokenHitCPU_;
+  edm::EDPutTokenT<PixelTrackHeterogeneous> tokenTrackCPU_;
 
   CAHitNtupletGeneratorOnGPU gpuAlgo_;
 };
 
-CAHitNtupletCUDA::CAHitNtupletCUDA(edm::ProductRegistry& reg)
-    : tokenHitGPU_{reg.consumes<cms::cuda::Product<TrackingRecHit2DGPU>>()},
-      tokenTrackGPU_{reg.produces<cms::cuda::Product<PixelTrackHeterogeneous>>()},
-      gpuAlgo_(reg) {}
+CAHitNtupletCUDA::CAHitNtupletCUDA(edm::ProductRegistry& reg, bool onGPU) : m_OnGPU(onGPU), gpuAlgo_(reg, onGPU) {
+  if (m_OnGPU) {
+    tokenHitGPU_ = reg.consumes<cms::cuda::Product<TrackingRecHit2DGPU>>();
+    tokenTrackGPU_ = reg.produces<cms::cuda::Product<PixelTrackHeterogeneous>>();
+  } else {
+    tokenHitCPU_ = reg.consumes<TrackingRecHit2DCPU>();
+    tokenTrackCPU_ = reg.produces<PixelTrackHeterogeneous>();
+  }
+}
+
+// on the GPU the doublets are built in acquire(), so that produce() knows if their workspace overflowed
+// without synchronizing the stream
+void CAHitNtupletCUDA::acquire(const edm::Event& iEvent,
+                               const edm::EventSetup& es,
+                               edm::WaitingTaskWithArenaHolder waitingTaskHolder) {
+  if (not m_OnGPU)
+    return;
+
+  auto const& phits = iEvent.get(tokenHitGPU_);
+  cms::cuda::ScopedContextAcquire ctx{phits, std::move(waitingTaskHolder), ctxState_};
+  gpuAlgo_.buildDoubletsAsync(ctx.get(phits), ctx.stream());
+}
 
 void CAHitNtupletCUDA::produce(edm::Event& iEvent, const edm::EventSetup& es) {
   auto bf = 0.0114256972711507;  // 1/fieldInGeV
 
-  auto const& phits = iEvent.get(tokenHitGPU_);
-  cms::cuda::ScopedContextProduce ctx{phits};
-  auto const& hits = ctx.get(phits);
+  if (m_OnGPU) {
+    cms::cuda::ScopedContextProduce ctx{ctxState_};
+    auto const& hits = ctx.get(iEvent, tokenHitGPU_);
 
-  ctx.emplace(iEvent, tokenTrackGPU_, gpuAlgo_.makeTuplesAsync(hits, bf, ctx.stream()));
+    ctx.emplace(iEvent, tokenTrackGPU_, gpuAlgo_.makeTuplesAsync(hits, bf, ctx.stream()));
+  } else {
+    auto const& hits = iEvent.get(tokenHitCPU_);
+    iEvent.emplace(tokenTrackCPU_, gpuAlgo_.makeTuples(hits, bf));
+  }
 }
 
+// consumes the TrackingRecHit2DCPU of the CPU workflow
+class CAHitNtupletCPU : public CAHitNtupletCUDA {
+public:
+  explicit CAHitNtupletCPU(edm::ProductRegistry& reg) : CAHitNtupletCUDA(reg, false) {}
+};
+
 DEFINE_FWK_MODULE(CAHitNtupletCUDA);
+DEFINE_FWK_MODULE(CAHitNtupletCPU);
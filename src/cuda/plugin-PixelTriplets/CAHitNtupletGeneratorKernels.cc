@@ -7,7 +7,10 @@ void CAHitNtupletGeneratorKernelsCPU::printCounters(Counters const *counters) {
 
 template <>
 void CAHitNtupletGeneratorKernelsCPU::fillHitDetIndices(HitsView const *hv, TkSoA *tracks_d, cudaStream_t) {
-  kernel_fillHitDetIndices(&tracks_d->hitIndices, hv, &tracks_d->detIndices);
+  cudaCompat::launch<kernel_fillHitDetIndices>(cudaCompat::cpuGridSize(),
+                                               &tracks_d->hitIndices,
+                                               hv,
+                                               &tracks_d->detIndices);
 }
 
 template <>
@@ -24,15 +27,17 @@ void CAHitNtupletGeneratorKernelsCPU::buildDoublets(HitsOnCPU const &hh, cudaStr
   device_isOuterHitOfCell_.reset(
       (GPUCACell::OuterHitOfCell *)malloc(std::max(1U, nhits) * sizeof(GPUCACell::OuterHitOfCell)));
   assert(device_isOuterHitOfCell_.get());
-  gpuPixelDoublets::initDoublets(device_isOuterHitOfCell_.get(),
-                                 nhits,
-                                 device_theCellNeighbors_,
-                                 device_theCellNeighborsContainer_.get(),
-                                 device_theCellTracks_,
-                                 device_theCellTracksContainer_.get());
-
-  // device_theCells_ = Traits:: template make_unique<GPUCACell[]>(cs, m_params.maxNumberOfDoublets_, stream);
-  device_theCells_.reset((GPUCACell *)malloc(sizeof(GPUCACell) * m_params.maxNumberOfDoublets_));
+  cudaCompat::launch<gpuPixelDoublets::initDoublets>(cudaCompat::cpuGridSize(),
+                                                     device_isOuterHitOfCell_.get(),
+                                                     nhits,
+                                                     device_theCellNeighbors_,
+                                                     device_theCellNeighborsContainer_.get(),
+                                                     device_theCellTracks_,
+                                                     device_theCellTracksContainer_.get());
+
+  // device_theCells_ = Traits:: template make_unique<GPUCACell[]>(cs, m_maxNumberOfDoublets, stream);
+  device_theCells_.reset((GPUCACell *)malloc(sizeof(GPUCACell) * m_maxNumberOfDoublets));
+  *device_nCells_ = 0;
   if (0 == nhits)
     return;  // protect against empty events
 
@@ -45,18 +50,24 @@ void CAHitNtupletGeneratorKernelsCPU::buildDoublets(HitsOnCPU const &hh, cudaStr
   }
 
   assert(nActualPairs <= gpuPixelDoublets::nPairs);
-  gpuPixelDoublets::getDoubletsFromHisto(device_theCells_.get(),
-                                         device_nCells_,
-                                         device_theCellNeighbors_,
-                                         device_theCellTracks_,
-                                         hh.view(),
-                                         device_isOuterHitOfCell_.get(),
-                                         nActualPairs,
-                                         m_params.idealConditions_,
-                                         m_params.doClusterCut_,
-                                         m_params.doZ0Cut_,
-                                         m_params.doPtCut_,
-                                         m_params.maxNumberOfDoublets_);
+  cudaCompat::launch<gpuPixelDoublets::getDoubletsFromHisto>(dim3{1, cudaCompat::cpuGridSize(), 1},
+                                                             device_theCells_.get(),
+                                                             device_nCells_,
+                                                             device_theCellNeighbors_,
+                                                             device_theCellTracks_,
+                                                             hh.view(),
+                                                             device_isOuterHitOfCell_.get(),
+                                                             nActualPairs,
+                                                             m_params.idealConditions_,
+                                                             m_params.doClusterCut_,
+                                                             m_params.doZ0Cut_,
+                                                             m_params.doPtCut_,
+                                                             m_maxNumberOfDoublets);
+}
+
+template <>
+void CAHitNtupletGeneratorKernelsCPU::copyNDoublets(uint32_t *nDoublets_h, cudaStream_t) const {
+  *nDoublets_h = *device_nCells_;
 }
 
 template <>
@@ -72,6 +83,10 @@ void CAHitNtupletGeneratorKernelsCPU::launchKernels(HitsOnCPU const &hh, TkSoA *
   auto nhits = hh.nHits();
   assert(nhits <= pixelGPUConstants::maxNumberOfHits);
 
+  // the kernels run with one thread per block, see cudaCompat::launch
+  auto const blocks = cudaCompat::cpuGridSize();
+  dim3 const blocks2D{1, blocks, 1};
+
   // std::cout << "N hits " << nhits << std::endl;
   // if (nhits<2) std::cout << "too few hits " << nhits << std::endl;
 
@@ -79,60 +94,75 @@ void CAHitNtupletGeneratorKernelsCPU::launchKernels(HitsOnCPU const &hh, TkSoA *
   // applying conbinatoric cleaning such as fishbone at this stage is too expensive
   //
 
-  kernel_connect(device_hitTuple_apc_,
-                 device_hitToTuple_apc_,  // needed only to be reset, ready for next kernel
-                 hh.view(),
-                 device_theCells_.get(),
-                 device_nCells_,
-                 device_theCellNeighbors_,
-                 device_isOuterHitOfCell_.get(),
-                 m_params.hardCurvCut_,
-                 m_params.ptmin_,
-                 m_params.CAThetaCutBarrel_,
-                 m_params.CAThetaCutForward_,
-                 m_params.dcaCutInnerTriplet_,
-                 m_params.dcaCutOuterTriplet_);
+  cudaCompat::launch<kernel_connect>(blocks2D,
+                                     device_hitTuple_apc_,
+                                     device_hitToTuple_apc_,  // needed only to be reset, ready for next kernel
+                                     hh.view(),
+                                     device_theCells_.get(),
+                                     device_nCells_,
+                                     device_theCellNeighbors_,
+                                     device_isOuterHitOfCell_.get(),
+                                     m_params.hardCurvCut_,
+                                     m_params.ptmin_,
+                                     m_params.CAThetaCutBarrel_,
+                                     m_params.CAThetaCutForward_,
+                                     m_params.dcaCutInnerTriplet_,
+                                     m_params.dcaCutOuterTriplet_);
 
   if (nhits > 1 && m_params.earlyFishbone_) {
-    fishbone(hh.view(), device_theCells_.get(), device_nCells_, device_isOuterHitOfCell_.get(), nhits, false);
+    cudaCompat::launch<fishbone>(blocks2D,
+                                 hh.view(),
+                                 device_theCells_.get(),
+                                 device_nCells_,
+                                 device_isOuterHitOfCell_.get(),
+                                 nhits,
+                                 false);
   }
 
-  kernel_find_ntuplets(hh.view(),
-                       device_theCells_.get(),
-                       device_nCells_,
-                       device_theCellTracks_,
-                       tuples_d,
-                       device_hitTuple_apc_,
-                       quality_d,
-                       m_params.minHitsPerNtuplet_);
+  cudaCompat::launch<kernel_find_ntuplets>(blocks,
+                                           hh.view(),
+                                           device_theCells_.get(),
+                                           device_nCells_,
+                                           device_theCellTracks_,
+                                           tuples_d,
+                                           device_hitTuple_apc_,
+                                           quality_d,
+                                           m_params.minHitsPerNtuplet_);
   if (m_params.doStats_)
-    kernel_mark_used(hh.view(), device_theCells_.get(), device_nCells_);
+    cudaCompat::launch<kernel_mark_used>(blocks, hh.view(), device_theCells_.get(), device_nCells_);
 
   cms::cuda::finalizeBulk(device_hitTuple_apc_, tuples_d);
 
   // remove duplicates (tracks that share a doublet)
-  kernel_earlyDuplicateRemover(device_theCells_.get(), device_nCells_, tuples_d, quality_d);
+  cudaCompat::launch<kernel_earlyDuplicateRemover>(blocks, device_theCells_.get(), device_nCells_, tuples_d, quality_d);
 
-  kernel_countMultiplicity(tuples_d, quality_d, device_tupleMultiplicity_.get());
+  cudaCompat::launch<kernel_countMultiplicity>(blocks, tuples_d, quality_d, device_tupleMultiplicity_.get());
   cms::cuda::launchFinalize(device_tupleMultiplicity_.get(), device_tmws_, cudaStream);
-  kernel_fillMultiplicity(tuples_d, quality_d, device_tupleMultiplicity_.get());
+  cudaCompat::launch<kernel_fillMultiplicity>(blocks, tuples_d, quality_d, device_tupleMultiplicity_.get());
 
   if (nhits > 1 && m_params.lateFishbone_) {
-    fishbone(hh.view(), device_theCells_.get(), device_nCells_, device_isOuterHitOfCell_.get(), nhits, true);
+    cudaCompat::launch<fishbone>(blocks2D,
+                                 hh.view(),
+                                 device_theCells_.get(),
+                                 device_nCells_,
+                                 device_isOuterHitOfCell_.get(),
+                                 nhits,
+                                 true);
   }
 
   if (m_params.doStats_) {
-    kernel_checkOverflows(tuples_d,
-                          device_tupleMultiplicity_.get(),
-                          device_hitTuple_apc_,
-                          device_theCells_.get(),
-                          device_nCells_,
-                          device_theCellNeighbors_,
-                          device_theCellTracks_,
-                          device_isOuterHitOfCell_.get(),
-                          nhits,
-                          m_params.maxNumberOfDoublets_,
-                          counters_);
+    cudaCompat::launch<kernel_checkOverflows>(blocks,
+                                              tuples_d,
+                                              device_tupleMultiplicity_.get(),
+                                              device_hitTuple_apc_,
+                                              device_theCells_.get(),
+                                              device_nCells_,
+                                              device_theCellNeighbors_,
+                                              device_theCellTracks_,
+                                              device_isOuterHitOfCell_.get(),
+                                              nhits,
+                                              m_maxNumberOfDoublets,
+                                              counters_);
   }
 }
 
@@ -141,29 +171,32 @@ void CAHitNtupletGeneratorKernelsCPU::classifyTuples(HitsOnCPU const &hh, TkSoA
   auto const *tuples_d = &tracks_d->hitIndices;
   auto *quality_d = (Quality *)(&tracks_d->m_quality);
 
+  // the kernels run with one thread per block, see cudaCompat::launch
+  auto const blocks = cudaCompat::cpuGridSize();
+
   // classify tracks based on kinematics
-  kernel_classifyTracks(tuples_d, tracks_d, m_params.cuts_, quality_d);
+  cudaCompat::launch<kernel_classifyTracks>(blocks, tuples_d, tracks_d, m_params.cuts_, quality_d);
 
   if (m_params.lateFishbone_) {
     // apply fishbone cleaning to good tracks
-    kernel_fishboneCleaner(device_theCells_.get(), device_nCells_, quality_d);
+    cudaCompat::launch<kernel_fishboneCleaner>(blocks, device_theCells_.get(), device_nCells_, quality_d);
   }
 
   // remove duplicates (tracks that share a doublet)
-  kernel_fastDuplicateRemover(device_theCells_.get(), device_nCells_, tuples_d, tracks_d);
+  cudaCompat::launch<kernel_fastDuplicateRemover>(blocks, device_theCells_.get(), device_nCells_, tuples_d, tracks_d);
 
   // fill hit->track "map"
-  kernel_countHitInTracks(tuples_d, quality_d, device_hitToTuple_.get());
+  cudaCompat::launch<kernel_countHitInTracks>(blocks, tuples_d, quality_d, device_hitToTuple_.get());
   cms::cuda::launchFinalize(device_hitToTuple_.get(), device_tmws_, cudaStream);
-  kernel_fillHitInTracks(tuples_d, quality_d, device_hitToTuple_.get());
+  cudaCompat::launch<kernel_fillHitInTracks>(blocks, tuples_d, quality_d, device_hitToTuple_.get());
 
   // remove duplicates (tracks that share a hit)
-  kernel_tripletCleaner(hh.view(), tuples_d, tracks_d, quality_d, device_hitToTuple_.get());
+  cudaCompat::launch<kernel_tripletCleaner>(blocks, hh.view(), tuples_d, tracks_d, quality_d, device_hitToTuple_.get());
 
   if (m_params.doStats_) {
     // counters (add flag???)
-    kernel_doStatsForHitInTracks(device_hitToTuple_.get(), counters_);
-    kernel_doStatsForTracks(tuples_d, quality_d, counters_);
+    cudaCompat::launch<kernel_doStatsForHitInTracks>(blocks, device_hitToTuple_.get(), counters_);
+    cudaCompat::launch<kernel_doStatsForTracks>(blocks, tuples_d, quality_d, counters_);
   }
 
 #ifdef DUMP_GPU_TK_TUPLES
@@ -159,11 +159,20 @@ public:
   using TkSoA = pixelTrack::TrackSoA;
   using HitContainer = pixelTrack::HitContainer;
 
-  CAHitNtupletGeneratorKernels(Params const& params) : m_params(params) {}
+  // the doublet workspace is sized for maxNumberOfDoublets, at most m_params.maxNumberOfDoublets_
+  CAHitNtupletGeneratorKernels(Params const& params, uint32_t maxNumberOfDoublets)
+      : m_params(params), m_maxNumberOfDoublets(maxNumberOfDoublets) {}
   ~CAHitNtupletGeneratorKernels() = default;
 
   TupleMultiplicity const* tupleMultiplicity() const { return device_tupleMultiplicity_.get(); }
 
+  uint32_t maxNumberOfDoublets() const { return m_maxNumberOfDoublets; }
+  // the doublets are built again by the next buildDoublets()
+  void setMaxNumberOfDoublets(uint32_t maxNumberOfDoublets) { m_maxNumberOfDoublets = maxNumberOfDoublets; }
+  // copies the number of doublets found by buildDoublets() to nDoublets_h, asynchronously on the GPU (where
+  // nDoublets_h must be pinned); equal to maxNumberOfDoublets() if the workspace overflowed
+  void copyNDoublets(uint32_t* nDoublets_h, cudaStream_t stream) const;
+
   void launchKernels(HitsOnCPU const& hh, TkSoA* tuples_d, cudaStream_t cudaStream);
 
   void classifyTuples(HitsOnCPU const& hh, TkSoA* tuples_d, cudaStream_t cudaStream);
@@ -200,6 +209,8 @@ private:
   unique_ptr<AtomicPairCounter::c_type[]> device_storage_;
   // params
   Params const& m_params;
+  // capacity of the doublet workspace in this event
+  uint32_t m_maxNumberOfDoublets;
 };
 
 using CAHitNtupletGeneratorKernelsGPU = CAHitNtupletGeneratorKernels<cudaCompat::GPUTraits>;
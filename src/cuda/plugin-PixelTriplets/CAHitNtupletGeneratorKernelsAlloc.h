@@ -37,15 +37,7 @@ void CAHitNtupletGeneratorKernelsCPU::allocateOnGPU(cudaStream_t stream) {
   assert(device_tmws_ + std::max(TupleMultiplicity::wsSize(), HitToTuple::wsSize()) <=
          (uint8_t*)(device_storage_.get() + storageSize));
 
-  if
-#ifndef __CUDACC__
-      constexpr
-#endif
-      (std::is_same<Traits, cudaCompat::GPUTraits>::value) {
-    cudaCheck(cudaMemsetAsync(device_nCells_, 0, sizeof(uint32_t), stream));
-  } else {
-    *device_nCells_ = 0;
-  }
+  // device_nCells_ is zeroed by buildDoublets()
   cms::cuda::launchZero(device_tupleMultiplicity_.get(), stream);
   cms::cuda::launchZero(device_hitToTuple_.get(), stream);  // we may wish to keep it in the edm...
 }
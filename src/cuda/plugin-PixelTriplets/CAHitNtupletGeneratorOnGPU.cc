@@ -2,11 +2,15 @@
 // Original Author: Felice Pantaleo, CERN
 //
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <functional>
+#include <iostream>
 #include <vector>
 
+#include "CUDACore/cudaCompat.h"
+#include "CUDADataFormats/gpuClusteringConstants.h"
 #include "Framework/Event.h"
 
 #include "CAHitNtupletGeneratorOnGPU.h"
@@ -18,6 +22,11 @@ namespace {
     return x * x;
   }
 
+  // the doublet workspace is sized for the upper estimate of the recent history plus this margin (in %)...
+  constexpr uint32_t doubletMargin = 25;
+  // ...and never below this many doublets
+  constexpr uint32_t minNumberOfDoublets = 4 * 1024;
+
   cAHitNtupletGenerator::QualityCuts makeQualityCuts() {
     auto coeff = std::vector<double>{0.68177776, 0.74609577, -0.08035491, 0.00315399};  // chi2Coeff
     return cAHitNtupletGenerator::QualityCuts{// polynomial coefficients for the pT-dependent chi2 cut
@@ -42,8 +51,8 @@ namespace {
 }  // namespace
 
 using namespace std;
-CAHitNtupletGeneratorOnGPU::CAHitNtupletGeneratorOnGPU(edm::ProductRegistry& reg)
-    : m_params(true,              // onGPU
+CAHitNtupletGeneratorOnGPU::CAHitNtupletGeneratorOnGPU(edm::ProductRegistry& reg, bool onGPU)
+    : m_params(onGPU,             // onGPU
                3,                 // minHitsPerNtuplet,
                458752,            // maxNumberOfDoublets
                false,             //useRiemannFit
@@ -62,7 +71,9 @@ CAHitNtupletGeneratorOnGPU::CAHitNtupletGeneratorOnGPU(edm::ProductRegistry& reg
                0.0328407224959,   // hardCurvCut
                0.15000000596,     // dcaCutInnerTriplet
                0.25,              // dcaCutOuterTriplet
-               makeQualityCuts()) {
+               makeQualityCuts()),
+      // start from the ratio of the maximum number of doublets to the maximum number of hits
+      m_doubletsPerHundredHits(100ULL * m_params.maxNumberOfDoublets_ / pixelGPUConstants::maxNumberOfHits) {
 #ifdef DUMP_GPU_TK_TUPLES
   printf("TK: %s %s % %s %s %s %s %s %s %s %s %s %s %s %s %s\n",
          "tid",
@@ -107,21 +118,59 @@ CAHitNtupletGeneratorOnGPU::~CAHitNtupletGeneratorOnGPU() {
   }
 }
 
+uint32_t CAHitNtupletGeneratorOnGPU::maxNumberOfDoublets(uint32_t nHits) const {
+  uint64_t capacity = uint64_t(nHits) * m_doubletsPerHundredHits.upper() * (100 + doubletMargin) / (100 * 100);
+  return std::min<uint64_t>(std::max<uint64_t>(capacity, minNumberOfDoublets), m_params.maxNumberOfDoublets_);
+}
+
+template <typename Kernels, typename Hits>
+void CAHitNtupletGeneratorOnGPU::checkDoublets(Kernels& kernels,
+                                               Hits const& hh,
+                                               uint32_t nDoublets,
+                                               cudaStream_t stream) const {
+  auto nHits = hh.nHits();
+  if (0 == nHits)
+    return;
+
+  // the number of doublets saturates at the capacity of the workspace when it overflows
+  if (nDoublets >= kernels.maxNumberOfDoublets() and kernels.maxNumberOfDoublets() < m_params.maxNumberOfDoublets_) {
+#ifdef NTUPLE_DEBUG
+    std::cout << "doublet workspace of " << kernels.maxNumberOfDoublets() << " overflowed for " << nHits
+              << " hits, building the doublets again" << std::endl;
+#endif
+    kernels.setMaxNumberOfDoublets(m_params.maxNumberOfDoublets_);
+    kernels.buildDoublets(hh, stream);
+  }
+  // after an overflow this underestimates the doublets of the event, but still grows the workspace of the
+  // following events
+  m_doubletsPerHundredHits.update(100ULL * nDoublets / nHits);
+}
+
+void CAHitNtupletGeneratorOnGPU::buildDoubletsAsync(TrackingRecHit2DCUDA const& hits_d, cudaStream_t stream) {
+  m_kernelsGPU = std::make_unique<CAHitNtupletGeneratorKernelsGPU>(m_params, maxNumberOfDoublets(hits_d.nHits()));
+  m_kernelsGPU->counters_ = m_counters;
+  m_kernelsGPU->allocateOnGPU(stream);
+  m_kernelsGPU->buildDoublets(hits_d, stream);
+
+  m_nDoublets_h = cms::cuda::make_host_unique<uint32_t>(stream);
+  m_kernelsGPU->copyNDoublets(m_nDoublets_h.get(), stream);
+}
+
 PixelTrackHeterogeneous CAHitNtupletGeneratorOnGPU::makeTuplesAsync(TrackingRecHit2DCUDA const& hits_d,
                                                                     float bfield,
-                                                                    cudaStream_t stream) const {
+                                                                    cudaStream_t stream) {
+  assert(m_kernelsGPU);
+  auto& kernels = *m_kernelsGPU;
+  // the copy of the number of doublets has completed before produce()
+  checkDoublets(kernels, hits_d, *m_nDoublets_h, stream);
+
   PixelTrackHeterogeneous tracks(cms::cuda::make_device_unique<pixelTrack::TrackSoA>(stream));
 
   auto* soa = tracks.get();
 
-  CAHitNtupletGeneratorKernelsGPU kernels(m_params);
-  kernels.counters_ = m_counters;
   HelixFitOnGPU fitter(bfield, m_params.fit5as4_);
-
-  kernels.allocateOnGPU(stream);
   fitter.allocateOnGPU(&(soa->hitIndices), kernels.tupleMultiplicity(), soa);
 
-  kernels.buildDoublets(hits_d, stream);
   kernels.launchKernels(hits_d, soa, stream);
   kernels.fillHitDetIndices(hits_d.view(), soa, stream);  // in principle needed only if Hits not "available"
   if (m_params.useRiemannFit_) {
@@ -131,20 +180,30 @@ PixelTrackHeterogeneous CAHitNtupletGeneratorOnGPU::makeTuplesAsync(TrackingRecH
   }
   kernels.classifyTuples(hits_d, soa, stream);
 
+  // the device memory is freed in the order of the stream, after the kernels above
+  m_kernelsGPU.reset();
+  m_nDoublets_h.reset();
+
   return tracks;
 }
 
 PixelTrackHeterogeneous CAHitNtupletGeneratorOnGPU::makeTuples(TrackingRecHit2DCPU const& hits_d, float bfield) const {
+  // the kernels called directly (e.g. finalizeBulk and the fits) run over a grid of one block
+  cudaCompat::resetGrid();
+
   PixelTrackHeterogeneous tracks(std::make_unique<pixelTrack::TrackSoA>());
 
   auto* soa = tracks.get();
   assert(soa);
 
-  CAHitNtupletGeneratorKernelsCPU kernels(m_params);
+  CAHitNtupletGeneratorKernelsCPU kernels(m_params, maxNumberOfDoublets(hits_d.nHits()));
   kernels.counters_ = m_counters;
   kernels.allocateOnGPU(nullptr);
 
   kernels.buildDoublets(hits_d, nullptr);
+  uint32_t nDoublets;
+  kernels.copyNDoublets(&nDoublets, nullptr);
+  checkDoublets(kernels, hits_d, nDoublets, nullptr);
   kernels.launchKernels(hits_d, soa, nullptr);
   kernels.fillHitDetIndices(hits_d.view(), soa, nullptr);  // in principle needed only if Hits not "available"
 
@@ -155,10 +214,14 @@ PixelTrackHeterogeneous CAHitNtupletGeneratorOnGPU::makeTuples(TrackingRecHit2DC
   HelixFitOnGPU fitter(bfield, m_params.fit5as4_);
   fitter.allocateOnGPU(&(soa->hitIndices), kernels.tupleMultiplicity(), soa);
 
-  if (m_params.useRiemannFit_) {
-    fitter.launchRiemannKernelsOnCPU(hits_d.view(), hits_d.nHits(), CAConstants::maxNumberOfQuadruplets());
-  } else {
-    fitter.launchBrokenLineKernelsOnCPU(hits_d.view(), hits_d.nHits(), CAConstants::maxNumberOfQuadruplets());
+  // the tuple multiplicity is in host memory: fit only the tuples found in this event
+  auto nTuples = kernels.tupleMultiplicity()->size();
+  if (nTuples > 0) {
+    if (m_params.useRiemannFit_) {
+      fitter.launchRiemannKernelsOnCPU(hits_d.view(), hits_d.nHits(), nTuples, m_fitWorkspace);
+    } else {
+      fitter.launchBrokenLineKernelsOnCPU(hits_d.view());
+    }
   }
 
   kernels.classifyTuples(hits_d, soa, nullptr);
@@ -1,11 +1,15 @@
 #ifndef RecoPixelVertexing_PixelTriplets_plugins_CAHitNtupletGeneratorOnGPU_h
 #define RecoPixelVertexing_PixelTriplets_plugins_CAHitNtupletGeneratorOnGPU_h
 
+#include <memory>
+
 #include <cuda_runtime.h>
 #include "CUDADataFormats/TrackingRecHit2DCUDA.h"
 #include "CUDADataFormats/PixelTrackHeterogeneous.h"
 
 #include "CUDACore/GPUSimpleVector.h"
+#include "CUDACore/host_unique_ptr.h"
+#include "Framework/RunningAverage.h"
 
 #include "CAHitNtupletGeneratorKernels.h"
 #include "HelixFitOnGPU.h"
@@ -35,11 +39,15 @@ public:
   using Counters = cAHitNtupletGenerator::Counters;
 
 public:
-  CAHitNtupletGeneratorOnGPU(edm::ProductRegistry& reg);
+  CAHitNtupletGeneratorOnGPU(edm::ProductRegistry& reg, bool onGPU);
 
   ~CAHitNtupletGeneratorOnGPU();
 
-  PixelTrackHeterogeneous makeTuplesAsync(TrackingRecHit2DGPU const& hits_d, float bfield, cudaStream_t stream) const;
+  // The GPU workflow is split between the acquire() and the produce() of the module: buildDoubletsAsync()
+  // builds the doublets and copies their number to the host, then makeTuplesAsync() checks it, once the copy
+  // is done, and builds the tuples of the same event.
+  void buildDoubletsAsync(TrackingRecHit2DGPU const& hits_d, cudaStream_t stream);
+  PixelTrackHeterogeneous makeTuplesAsync(TrackingRecHit2DGPU const& hits_d, float bfield, cudaStream_t stream);
 
   PixelTrackHeterogeneous makeTuples(TrackingRecHit2DCPU const& hits_d, float bfield) const;
 
@@ -50,9 +58,27 @@ private:
 
   void launchKernels(HitsOnCPU const& hh, bool useRiemannFit, cudaStream_t cudaStream) const;
 
+  // capacity of the doublet workspace for an event with nHits hits
+  uint32_t maxNumberOfDoublets(uint32_t nHits) const;
+
+  // given the number of doublets built, builds them again with the full capacity if the workspace overflowed,
+  // and updates the average
+  template <typename Kernels, typename Hits>
+  void checkDoublets(Kernels& kernels, Hits const& hh, uint32_t nDoublets, cudaStream_t stream) const;
+
   Params m_params;
 
   Counters* m_counters = nullptr;
+
+  // scratch buffers of the Riemann fit on the CPU, reused across the events of the stream
+  mutable HelixFitWorkspaceCPU m_fitWorkspace;
+
+  // doublets per 100 hits in the recent events of the stream
+  mutable edm::RunningAverage m_doubletsPerHundredHits;
+
+  // doublets of the event between buildDoubletsAsync() and makeTuplesAsync()
+  std::unique_ptr<CAHitNtupletGeneratorKernelsGPU> m_kernelsGPU;
+  cms::cuda::host::unique_ptr<uint32_t> m_nDoublets_h;
 };
 
 #endif  // RecoPixelVertexing_PixelTriplets_plugins_CAHitNtupletGeneratorOnGPU_h
@@ -14,3 +14,17 @@ void HelixFitOnGPU::allocateOnGPU(Tuples const *tuples,
 }
 
 void HelixFitOnGPU::deallocateOnGPU() {}
+
+void HelixFitWorkspaceCPU::allocate(uint32_t maxHitsInFit) {
+  constexpr auto stride = Rfit::stride();
+  // no need to zero the memory, each fit writes its inputs before reading them
+  if (maxHitsInFit > maxHitsInFit_) {
+    hits_.reset(new double[stride * sizeof(Rfit::Matrix3xNd<1>) / sizeof(double) * maxHitsInFit]);
+    hitsErrors_.reset(new float[stride * sizeof(Rfit::Matrix6xNf<1>) / sizeof(float) * maxHitsInFit]);
+    maxHitsInFit_ = maxHitsInFit;
+  }
+  if (not fastFitResults_) {
+    fastFitResults_.reset(new double[stride * sizeof(Rfit::Vector4d) / sizeof(double)]);
+    circleFitResults_.reset(new Rfit::circle_fit[stride]);
+  }
+}
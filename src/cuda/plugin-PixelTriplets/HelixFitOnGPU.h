@@ -1,6 +1,8 @@
 #ifndef RecoPixelVertexing_PixelTrackFitting_plugins_HelixFitOnGPU_h
 #define RecoPixelVertexing_PixelTrackFitting_plugins_HelixFitOnGPU_h
 
+#include <memory>
+
 #include "CUDADataFormats/PixelTrackHeterogeneous.h"
 #include "CUDADataFormats/TrackingRecHit2DCUDA.h"
 
@@ -31,6 +33,27 @@ namespace Rfit {
 
 }  // namespace Rfit
 
+// Scratch buffers of the Riemann fit on the CPU, laid out with the stride of the maps
+// above. They are allocated at the first use and then reused across events, so
+// a workspace must not be shared by concurrent events (e.g. one per stream).
+class HelixFitWorkspaceCPU {
+public:
+  // make room for fits of up to maxHitsInFit hits
+  void allocate(uint32_t maxHitsInFit);
+
+  double *hits() { return hits_.get(); }
+  float *hitsErrors() { return hitsErrors_.get(); }
+  double *fastFitResults() { return fastFitResults_.get(); }
+  Rfit::circle_fit *circleFitResults() { return circleFitResults_.get(); }
+
+private:
+  uint32_t maxHitsInFit_ = 0;
+  std::unique_ptr<double[]> hits_;
+  std::unique_ptr<float[]> hitsErrors_;
+  std::unique_ptr<double[]> fastFitResults_;
+  std::unique_ptr<Rfit::circle_fit[]> circleFitResults_;
+};
+
 class HelixFitOnGPU {
 public:
   using HitsView = TrackingRecHit2DSOAView;
@@ -47,8 +70,12 @@ public:
   void launchRiemannKernels(HitsView const *hv, uint32_t nhits, uint32_t maxNumberOfTuples, cudaStream_t cudaStream);
   void launchBrokenLineKernels(HitsView const *hv, uint32_t nhits, uint32_t maxNumberOfTuples, cudaStream_t cudaStream);
 
-  void launchRiemannKernelsOnCPU(HitsView const *hv, uint32_t nhits, uint32_t maxNumberOfTuples);
-  void launchBrokenLineKernelsOnCPU(HitsView const *hv, uint32_t nhits, uint32_t maxNumberOfTuples);
+  void launchRiemannKernelsOnCPU(HitsView const *hv,
+                                 uint32_t nhits,
+                                 uint32_t maxNumberOfTuples,
+                                 HelixFitWorkspaceCPU &workspace);
+  // fits all the tuples of the tuple multiplicity, in batches
+  void launchBrokenLineKernelsOnCPU(HitsView const *hv);
 
   void allocateOnGPU(Tuples const *tuples, TupleMultiplicity const *tupleMultiplicity, OutputSoA *outputSoA);
   void deallocateOnGPU();
@@ -12,7 +12,8 @@
 
 class PixelVertexProducerCUDA : public edm::EDProducer {
 public:
-  explicit PixelVertexProducerCUDA(edm::ProductRegistry& reg);
+  explicit PixelVertexProducerCUDA(edm::ProductRegistry& reg) : PixelVertexProducerCUDA(reg, true, false) {}
+  PixelVertexProducerCUDA(edm::ProductRegistry& reg, bool onGPU, bool multiBlock);
   ~PixelVertexProducerCUDA() override = default;
 
 private:
@@ -31,12 +32,13 @@ private:
   const float m_ptMin;
 };
 
-PixelVertexProducerCUDA::PixelVertexProducerCUDA(edm::ProductRegistry& reg)
-    : m_OnGPU(true),
+PixelVertexProducerCUDA::PixelVertexProducerCUDA(edm::ProductRegistry& reg, bool onGPU, bool multiBlock)
+    : m_OnGPU(onGPU),
       m_gpuAlgo(true,   // oneKernel
                 true,   // useDensity
                 false,  // useDBSCAN
                 false,  // useIterative
+                multiBlock,
                 2,      // minT
                 0.07,   // eps
                 0.01,   // errmax
@@ -87,4 +89,25 @@ void PixelVertexProducerCUDA::produce(edm::Event& iEvent, const edm::EventSetup&
   }
 }
 
+// consumes the PixelTrackHeterogeneous of the CPU workflow
+class PixelVertexProducerCPU : public PixelVertexProducerCUDA {
+public:
+  explicit PixelVertexProducerCPU(edm::ProductRegistry& reg) : PixelVertexProducerCUDA(reg, false, false) {}
+};
+
+// run the density clustering over many blocks instead of the single fused kernel, for the events
+// with more tracks than a single block handles well
+class PixelVertexProducerCUDAMultiBlock : public PixelVertexProducerCUDA {
+public:
+  explicit PixelVertexProducerCUDAMultiBlock(edm::ProductRegistry& reg) : PixelVertexProducerCUDA(reg, true, true) {}
+};
+
+class PixelVertexProducerCPUMultiBlock : public PixelVertexProducerCUDA {
+public:
+  explicit PixelVertexProducerCPUMultiBlock(edm::ProductRegistry& reg) : PixelVertexProducerCUDA(reg, false, true) {}
+};
+
 DEFINE_FWK_MODULE(PixelVertexProducerCUDA);
+DEFINE_FWK_MODULE(PixelVertexProducerCPU);
+DEFINE_FWK_MODULE(PixelVertexProducerCUDAMultiBlock);
+DEFINE_FWK_MODULE(PixelVertexProducerCPUMultiBlock);
@@ -1,7 +1,11 @@
+#include <algorithm>
+#include <memory>
+
 #include <cuda_runtime.h>
 
 #include "CUDACore/Product.h"
 #include "CUDACore/HostProduct.h"
+#include "CUDADataFormats/ZVertexCompact.h"
 #include "CUDADataFormats/ZVertexHeterogeneous.h"
 #include "Framework/EventSetup.h"
 #include "Framework/Event.h"
@@ -10,6 +14,8 @@
 #include "Framework/RunningAverage.h"
 #include "CUDACore/ScopedContext.h"
 
+#include "packVertices.h"
+
 class PixelVertexSoAFromCUDA : public edm::EDProducerExternalWork {
 public:
   explicit PixelVertexSoAFromCUDA(edm::ProductRegistry& reg);
@@ -25,25 +31,76 @@ private:
   edm::EDPutTokenT<ZVertexHeterogeneous> tokenSOA_;
 
   cms::cuda::host::unique_ptr<ZVertexSoA> m_soa;
+
+  // pack the vertices on the device, and copy only the used part of the SoA
+  const bool m_compact;
+  cms::cuda::device::unique_ptr<uint8_t[]> m_buffer_d;
+  cms::cuda::host::unique_ptr<uint8_t[]> m_buffer_h;
+  // the size of the packed buffer is known only on the device: copy the expected size,
+  // and all of it in a second step of acquire() if needed
+  size_t m_copied = 0;
+  edm::RunningAverage m_bufferSize;
+
+  cms::cuda::ContextState ctxState_;
 };
 
 PixelVertexSoAFromCUDA::PixelVertexSoAFromCUDA(edm::ProductRegistry& reg)
     : tokenCUDA_(reg.consumes<cms::cuda::Product<ZVertexHeterogeneous>>()),
-      tokenSOA_(reg.produces<ZVertexHeterogeneous>()) {}
+      tokenSOA_(reg.produces<ZVertexHeterogeneous>()),
+      m_compact(true),
+      m_bufferSize(ZVertexCompact::maxBufferSize() / 4) {}
 
 void PixelVertexSoAFromCUDA::acquire(edm::Event const& iEvent,
                                      edm::EventSetup const& iSetup,
                                      edm::WaitingTaskWithArenaHolder waitingTaskHolder) {
   auto const& inputDataWrapped = iEvent.get(tokenCUDA_);
-  cms::cuda::ScopedContextAcquire ctx{inputDataWrapped, std::move(waitingTaskHolder)};
+  cms::cuda::ScopedContextAcquire ctx{inputDataWrapped, std::move(waitingTaskHolder), ctxState_};
   auto const& inputData = ctx.get(inputDataWrapped);
 
-  m_soa = inputData.toHostAsync(ctx.stream());
+  if (not m_compact) {
+    m_soa = inputData.toHostAsync(ctx.stream());
+    return;
+  }
+
+  m_buffer_d = cms::cuda::make_device_unique<uint8_t[]>(ZVertexCompact::maxBufferSize(), ctx.stream());
+  gpuVertexFinder::packAsync(inputData.get(), m_buffer_d.get(), ctx.stream());
+
+  // a margin of 25% over the upper estimate of the recent events
+  size_t expected = m_bufferSize.upper() + m_bufferSize.upper() / 4;
+  m_copied = std::clamp(expected, ZVertexCompact::headerSize(), ZVertexCompact::maxBufferSize());
+  m_buffer_h = cms::cuda::make_host_unique<uint8_t[]>(m_copied, ctx.stream());
+  cudaCheck(cudaMemcpyAsync(m_buffer_h.get(), m_buffer_d.get(), m_copied, cudaMemcpyDeviceToHost, ctx.stream()));
+
+  // once the header is on the host, copy all of the buffer if it is larger than expected
+  ctx.pushNextTask([this](cms::cuda::ScopedContextTask ctx) {
+    auto size = ZVertexCompact(m_buffer_h.get()).bufferSize();
+    if (size > m_copied) {
+      m_buffer_h = cms::cuda::make_host_unique<uint8_t[]>(size, ctx.stream());
+      cudaCheck(cudaMemcpyAsync(m_buffer_h.get(), m_buffer_d.get(), size, cudaMemcpyDeviceToHost, ctx.stream()));
+      m_copied = size;
+    }
+  });
 }
 
 void PixelVertexSoAFromCUDA::produce(edm::Event& iEvent, edm::EventSetup const& iSetup) {
-  // No copies....
-  iEvent.emplace(tokenSOA_, ZVertexHeterogeneous(std::move(m_soa)));
+  cms::cuda::ScopedContextProduce ctx{ctxState_};
+
+  if (not m_compact) {
+    // No copies....
+    iEvent.emplace(tokenSOA_, ZVertexHeterogeneous(std::move(m_soa)));
+    return;
+  }
+
+  ZVertexCompact compact(m_buffer_h.get());
+  m_bufferSize.update(compact.bufferSize());
+
+  // the SoA is owned by the event, so it is allocated for each event
+  std::unique_ptr<ZVertexSoA> soa(new ZVertexSoA);
+  compact.unpack(*soa);
+  iEvent.emplace(tokenSOA_, ZVertexHeterogeneous(std::move(soa)));
+
+  m_buffer_d.reset();
+  m_buffer_h.reset();
 }
 
 DEFINE_FWK_MODULE(PixelVertexSoAFromCUDA);
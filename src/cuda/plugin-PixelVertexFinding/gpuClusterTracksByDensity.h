@@ -6,7 +6,9 @@
 #include <cstdint>
 
 #include "CUDACore/HistoContainer.h"
+#include "CUDACore/cudaCheck.h"
 #include "CUDACore/cuda_assert.h"
+#include "CUDACore/prefixScan.h"
 
 #include "gpuVertexFinder.h"
 
@@ -229,6 +231,256 @@ namespace gpuVertexFinder {
     clusterTracksByDensity(pdata, pws, minT, eps, errmax, chi2max);
   }
 
+  // The same algorithm, split in kernels with grid-stride loops over the tracks, for the
+  // events with more tracks than a single block can handle. The tracks are binned in the
+  // finer z histogram of the WorkSpace, in global memory; the chains that link each track
+  // to its closest denser neighbour, that may be handled by different blocks, are followed
+  // up to the density peaks between the kernels.
+
+  __global__ void clusterTracksByDensityBinTracks(gpuVertexFinder::ZVertices* pdata, gpuVertexFinder::WorkSpace* pws) {
+    auto& __restrict__ ws = *pws;
+    auto nt = ws.ntrks;
+    int32_t* __restrict__ nn = pdata->ndof;
+
+    using Hist = WorkSpace::ZHist;
+    assert(nt <= Hist::capacity());
+
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      int iz = int(std::floor(ws.zt[i] / WorkSpace::zBinSize)) + int(Hist::nbins() / 2);
+      iz = std::min(std::max(iz, 0), int(Hist::nbins() - 1));
+      ws.izb[i] = iz;
+      ws.zhist.countDirect(ws.izb[i]);
+      ws.iv[i] = i;
+      nn[i] = 0;
+    }
+  }
+
+  // to be launched with a single block
+  __global__ void clusterTracksByDensityFinalizeHist(gpuVertexFinder::WorkSpace* pws) {
+    __shared__ WorkSpace::ZHist::Counter hws[32];
+    pws->zhist.finalize(hws);
+  }
+
+  __global__ void clusterTracksByDensityFillHist(gpuVertexFinder::WorkSpace* pws) {
+    auto& __restrict__ ws = *pws;
+    auto nt = ws.ntrks;
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      ws.zhist.fillDirect(ws.izb[i], uint16_t(i));
+    }
+  }
+
+  // number of bins on each side of a track that contain all the tracks closer than eps
+  __device__ __forceinline__ int clusterTracksByDensityWindow(float eps) {
+    return 1 + int(eps / WorkSpace::zBinSize);
+  }
+
+  __global__ void clusterTracksByDensityCountNeighbours(gpuVertexFinder::ZVertices* pdata,
+                                                        gpuVertexFinder::WorkSpace* pws,
+                                                        float eps,     // max absolute distance to cluster
+                                                        float errmax,  // max error to be "seed"
+                                                        float chi2max  // max normalized distance to cluster
+  ) {
+    auto er2mx = errmax * errmax;
+
+    auto const& __restrict__ ws = *pws;
+    auto nt = ws.ntrks;
+    float const* __restrict__ zt = ws.zt;
+    float const* __restrict__ ezt2 = ws.ezt2;
+    int32_t* __restrict__ nn = pdata->ndof;
+    auto window = clusterTracksByDensityWindow(eps);
+
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      if (ezt2[i] > er2mx)
+        continue;
+      auto loop = [&](uint32_t j) {
+        if (i == j)
+          return;
+        auto dist = std::abs(zt[i] - zt[j]);
+        if (dist > eps)
+          return;
+        if (dist * dist > chi2max * (ezt2[i] + ezt2[j]))
+          return;
+        nn[i]++;
+      };
+
+      forEachInBins(ws.zhist, ws.izb[i], window, loop);
+    }
+  }
+
+  __global__ void clusterTracksByDensityFindClosest(gpuVertexFinder::ZVertices* pdata,
+                                                    gpuVertexFinder::WorkSpace* pws,
+                                                    float eps,     // max absolute distance to cluster
+                                                    float chi2max  // max normalized distance to cluster
+  ) {
+    auto& __restrict__ ws = *pws;
+    auto nt = ws.ntrks;
+    float const* __restrict__ zt = ws.zt;
+    float const* __restrict__ ezt2 = ws.ezt2;
+    int32_t const* __restrict__ nn = pdata->ndof;
+    int32_t* __restrict__ iv = ws.iv;
+    auto window = clusterTracksByDensityWindow(eps);
+
+    // find closest above me .... (we ignore the possibility of two j at same distance from i)
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      float mdist = eps;
+      auto loop = [&](uint32_t j) {
+        if (nn[j] < nn[i])
+          return;
+        if (nn[j] == nn[i] && zt[j] >= zt[i])
+          return;  // if equal use natural order...
+        auto dist = std::abs(zt[i] - zt[j]);
+        if (dist > mdist)
+          return;
+        if (dist * dist > chi2max * (ezt2[i] + ezt2[j]))
+          return;  // (break natural order???)
+        mdist = dist;
+        iv[i] = j;  // assign to cluster (better be unique??)
+      };
+      forEachInBins(ws.zhist, ws.izb[i], window, loop);
+    }
+  }
+
+  // consolidate graph (percolate index of seed): the tracks along a chain are updated concurrently,
+  // but every value read is on the way to the same peak, that does not change
+  __global__ void clusterTracksByDensityFollowChains(gpuVertexFinder::WorkSpace* pws) {
+    auto nt = pws->ntrks;
+    int32_t* __restrict__ iv = pws->iv;
+
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      auto m = iv[i];
+      while (m != iv[m])
+        m = iv[m];
+      iv[i] = m;
+    }
+  }
+
+  // find the number of different clusters, identified by a tracks with clus[i] == i and density larger than threshold;
+  // mark these tracks with a negative id.
+  // To be launched with a single block: the tracks are taken in chunks of blockDim.x, and the seeds of each chunk are
+  // numbered with a prefix scan, so that the vertices are numbered in the order of the tracks, as in the single-block
+  // version, whatever the number of blocks of the other kernels.
+  __global__ void clusterTracksByDensityNumberSeeds(gpuVertexFinder::ZVertices* pdata,
+                                                    gpuVertexFinder::WorkSpace* pws,
+                                                    int minT  // min number of neighbours to be "seed"
+  ) {
+    auto& __restrict__ ws = *pws;
+    auto nt = ws.ntrks;
+    int32_t const* __restrict__ nn = pdata->ndof;
+    int32_t* __restrict__ iv = ws.iv;
+
+    assert(1 == gridDim.x);
+    assert(blockDim.x <= 1024);
+    __shared__ uint32_t nseeds[1024];
+    __shared__ uint32_t psws[32];
+
+    for (uint32_t begin = 0; begin < nt; begin += blockDim.x) {
+      auto i = begin + threadIdx.x;
+      bool seed = false;
+      if (i < nt and iv[i] == int(i)) {
+        if (nn[i] >= minT) {
+          seed = true;
+        } else {  // noise
+          iv[i] = -9998;
+        }
+      }
+      nseeds[threadIdx.x] = seed ? 1 : 0;
+      __syncthreads();
+      uint32_t size = std::min(uint32_t(blockDim.x), nt - begin);
+      blockPrefixScan(nseeds, size, psws);
+      __syncthreads();
+      if (seed) {
+        // -(old + 1), where old is the number of the seeds before this one
+        iv[i] = -int(ws.nvIntermediate + nseeds[threadIdx.x]);
+      }
+      __syncthreads();
+      if (0 == threadIdx.x)
+        ws.nvIntermediate += nseeds[size - 1];
+      __syncthreads();
+    }
+  }
+
+  // propagate the negative id to all the tracks in the cluster.
+  __global__ void clusterTracksByDensityPropagateSeeds(gpuVertexFinder::WorkSpace* pws) {
+    auto nt = pws->ntrks;
+    int32_t* __restrict__ iv = pws->iv;
+
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      if (iv[i] >= 0) {
+        // mark each track in a cluster with the same id as the first one
+        iv[i] = iv[iv[i]];
+      }
+    }
+  }
+
+  // adjust the cluster id to be a positive value starting from 0
+  __global__ void clusterTracksByDensityRenumber(gpuVertexFinder::ZVertices* pdata, gpuVertexFinder::WorkSpace* pws) {
+    auto nt = pws->ntrks;
+    int32_t* __restrict__ iv = pws->iv;
+
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (auto i = first; i < nt; i += gridDim.x * blockDim.x) {
+      iv[i] = -iv[i] - 1;
+    }
+
+    if (0 == first) {
+      assert(pws->nvIntermediate < ZVertices::MAXVTX);
+      pdata->nvFinal = pws->nvIntermediate;
+    }
+  }
+
+  inline void clusterTracksByDensityMultiBlock(gpuVertexFinder::ZVertices* pdata,
+                                               gpuVertexFinder::WorkSpace* pws,
+                                               int minT,       // min number of neighbours to be "seed"
+                                               float eps,      // max absolute distance to cluster
+                                               float errmax,   // max error to be "seed"
+                                               float chi2max,  // max normalized distance to cluster
+                                               cudaStream_t stream
+#ifndef __CUDACC__
+                                               = cudaStreamDefault
+#endif
+  ) {
+    cms::cuda::launchZero(&pws->zhist, stream);
+#ifdef __CUDACC__
+    auto blockSize = 128;
+    auto numberOfBlocks = (WorkSpace::MAXTRACKS + blockSize - 1) / blockSize;
+    clusterTracksByDensityBinTracks<<<numberOfBlocks, blockSize, 0, stream>>>(pdata, pws);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityFinalizeHist<<<1, 1024, 0, stream>>>(pws);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityFillHist<<<numberOfBlocks, blockSize, 0, stream>>>(pws);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityCountNeighbours<<<numberOfBlocks, blockSize, 0, stream>>>(pdata, pws, eps, errmax, chi2max);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityFindClosest<<<numberOfBlocks, blockSize, 0, stream>>>(pdata, pws, eps, chi2max);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityFollowChains<<<numberOfBlocks, blockSize, 0, stream>>>(pws);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityNumberSeeds<<<1, 1024, 0, stream>>>(pdata, pws, minT);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityPropagateSeeds<<<numberOfBlocks, blockSize, 0, stream>>>(pws);
+    cudaCheck(cudaGetLastError());
+    clusterTracksByDensityRenumber<<<numberOfBlocks, blockSize, 0, stream>>>(pdata, pws);
+    cudaCheck(cudaGetLastError());
+#else
+    auto numberOfBlocks = cudaCompat::cpuGridSize();
+    cudaCompat::launch<clusterTracksByDensityBinTracks>(numberOfBlocks, pdata, pws);
+    cudaCompat::launch<clusterTracksByDensityFinalizeHist>(1, pws);
+    cudaCompat::launch<clusterTracksByDensityFillHist>(numberOfBlocks, pws);
+    cudaCompat::launch<clusterTracksByDensityCountNeighbours>(numberOfBlocks, pdata, pws, eps, errmax, chi2max);
+    cudaCompat::launch<clusterTracksByDensityFindClosest>(numberOfBlocks, pdata, pws, eps, chi2max);
+    cudaCompat::launch<clusterTracksByDensityFollowChains>(numberOfBlocks, pws);
+    cudaCompat::launch<clusterTracksByDensityNumberSeeds>(1, pdata, pws, minT);
+    cudaCompat::launch<clusterTracksByDensityPropagateSeeds>(numberOfBlocks, pws);
+    cudaCompat::launch<clusterTracksByDensityRenumber>(numberOfBlocks, pdata, pws);
+#endif
+  }
+
 }  // namespace gpuVertexFinder
 
 #endif  // RecoPixelVertexing_PixelVertexFinding_src_gpuClusterTracksByDensity_h
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "CUDACore/HistoContainer.h"
 #include "CUDADataFormats/ZVertexHeterogeneous.h"
 
 namespace gpuVertexFinder {
@@ -24,6 +25,14 @@ namespace gpuVertexFinder {
     uint8_t izt[MAXTRACKS];    // interized z-position of input tracks
     int32_t iv[MAXTRACKS];     // vertex index for each associated track
 
+    // z histogram of the tracks used by the multi-block density clustering,
+    // with bins of 0.5 mm covering |z| < 12.8 cm (outer tracks go to the first and last bins)
+    using ZHist = HistoContainer<uint16_t, 512, MAXTRACKS, 9, uint16_t>;
+    static constexpr float zBinSize = 0.05f;
+
+    uint16_t izb[MAXTRACKS];  // bin of the input tracks in zhist
+    ZHist zhist;
+
     uint32_t nvIntermediate;  // the number of vertices after splitting pruning etc.
 
     __host__ __device__ void init() {
@@ -47,15 +56,17 @@ namespace gpuVertexFinder {
              bool useDensity,
              bool useDBSCAN,
              bool useIterative,
-             int iminT,      // min number of neighbours to be "core"
-             float ieps,     // max absolute distance to cluster
-             float ierrmax,  // max error to be "seed"
-             float ichi2max  // max normalized distance to cluster
+             bool multiBlock,  // run the density clustering over many blocks
+             int iminT,        // min number of neighbours to be "core"
+             float ieps,       // max absolute distance to cluster
+             float ierrmax,    // max error to be "seed"
+             float ichi2max    // max normalized distance to cluster
              )
-        : oneKernel_(oneKernel && !(useDBSCAN || useIterative)),
+        : oneKernel_(oneKernel && !(useDBSCAN || useIterative || (useDensity && multiBlock))),
           useDensity_(useDensity),
           useDBSCAN_(useDBSCAN),
           useIterative_(useIterative),
+          multiBlock_(useDensity && multiBlock),
           minT(iminT),
           eps(ieps),
           errmax(ierrmax),
@@ -71,6 +82,7 @@ namespace gpuVertexFinder {
     const bool useDensity_;
     const bool useDBSCAN_;
     const bool useIterative_;
+    const bool multiBlock_;
 
     int minT;       // min number of neighbours to be "core"
     float eps;      // max absolute distance to cluster
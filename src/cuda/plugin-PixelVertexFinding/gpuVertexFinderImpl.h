@@ -19,8 +19,12 @@ namespace gpuVertexFinder {
     auto first = blockIdx.x * blockDim.x + threadIdx.x;
     for (int idx = first, nt = TkSoA::stride(); idx < nt; idx += gridDim.x * blockDim.x) {
       auto nHits = tracks.nHits(idx);
-      if (nHits == 0)
+      if (nHits == 0) {
+        // the first empty slot is the number of tracks
+        if (idx == 0 or tracks.nHits(idx - 1) > 0)
+          soa->nTracks = idx;
         break;  // this is a guard: maybe we need to move to nTracks...
+      }
 
       // initialize soa...
       soa->idv[idx] = -1;
@@ -111,7 +115,7 @@ namespace gpuVertexFinder {
 #else
     cudaCompat::resetGrid();
     init(soa, ws_d.get());
-    loadTracks(tksoa, soa, ws_d.get(), ptMin);
+    cudaCompat::launch<loadTracks>(cudaCompat::cpuGridSize(), tksoa, soa, ws_d.get(), ptMin);
 #endif
 
 #ifdef __CUDACC__
@@ -128,7 +132,9 @@ namespace gpuVertexFinder {
       vertexFinderKernel2<<<1, 1024 - 256, 0, stream>>>(soa, ws_d.get());
 #endif
     } else {  // five kernels
-      if (useDensity_) {
+      if (multiBlock_) {
+        clusterTracksByDensityMultiBlock(soa, ws_d.get(), minT, eps, errmax, chi2max, stream);
+      } else if (useDensity_) {
         clusterTracksByDensityKernel<<<1, 1024 - 256, 0, stream>>>(soa, ws_d.get(), minT, eps, errmax, chi2max);
       } else if (useDBSCAN_) {
         clusterTracksDBSCAN<<<1, 1024 - 256, 0, stream>>>(soa, ws_d.get(), minT, eps, errmax, chi2max);
@@ -147,7 +153,9 @@ namespace gpuVertexFinder {
     }
     cudaCheck(cudaGetLastError());
 #else  // __CUDACC__
-    if (useDensity_) {
+    if (multiBlock_) {
+      clusterTracksByDensityMultiBlock(soa, ws_d.get(), minT, eps, errmax, chi2max);
+    } else if (useDensity_) {
       clusterTracksByDensity(soa, ws_d.get(), minT, eps, errmax, chi2max);
     } else if (useDBSCAN_) {
       clusterTracksDBSCAN(soa, ws_d.get(), minT, eps, errmax, chi2max);
@@ -157,10 +165,7 @@ namespace gpuVertexFinder {
     // std::cout << "found " << (*ws_d).nvIntermediate << " vertices " << std::endl;
     fitVertices(soa, ws_d.get(), 50.);
     // one block per vertex!
-    blockIdx.x = 0;
-    gridDim.x = 1;
-    splitVertices(soa, ws_d.get(), 9.f);
-    resetGrid();
+    cudaCompat::launch<splitVertices>(1024, soa, ws_d.get(), 9.f);
     fitVertices(soa, ws_d.get(), 5000.);
     sortByPt2(soa, ws_d.get());
 #endif
@@ -0,0 +1,12 @@
+#include "CUDACore/cudaCheck.h"
+
+#include "packVertices.h"
+
+namespace gpuVertexFinder {
+  void packAsync(ZVertexSoA const* vertices_d, uint8_t* buffer_d, cudaStream_t stream) {
+    auto blockSize = 128;
+    auto numberOfBlocks = (ZVertexSoA::MAXTRACKS + blockSize - 1) / blockSize;
+    packVertices<<<numberOfBlocks, blockSize, 0, stream>>>(vertices_d, buffer_d);
+    cudaCheck(cudaGetLastError());
+  }
+}  // namespace gpuVertexFinder
@@ -0,0 +1,15 @@
+#ifndef RecoPixelVertexing_PixelVertexFinding_plugins_packVertices_h
+#define RecoPixelVertexing_PixelVertexFinding_plugins_packVertices_h
+
+#include <cstdint>
+
+#include <cuda_runtime.h>
+
+#include "CUDADataFormats/ZVertexCompact.h"
+
+namespace gpuVertexFinder {
+  // packs the vertices into buffer_d, that must hold at least ZVertexCompact::maxBufferSize() bytes
+  void packAsync(ZVertexSoA const* vertices_d, uint8_t* buffer_d, cudaStream_t stream);
+}  // namespace gpuVertexFinder
+
+#endif  // RecoPixelVertexing_PixelVertexFinding_plugins_packVertices_h
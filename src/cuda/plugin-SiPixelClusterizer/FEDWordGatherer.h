@@ -0,0 +1,196 @@
+#ifndef FEDWordGatherer_h
+#define FEDWordGatherer_h
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include "DataFormats/FEDRawDataCollection.h"
+#include "DataFormats/PixelErrors.h"
+
+#include "ErrorChecker.h"
+
+// Collects the words of the pixel FEDs of an event, and the fedId of each
+// pair of words, in the flat arrays read by the raw-to-digi kernels.
+//
+// In the first step, scan(), the CRC, the headers and the trailers of the
+// FEDs are checked concurrently, and a prefix sum of the numbers of words
+// gives the offset of each FED. In the second step, copy(), the words of
+// the FEDs are copied concurrently. With nonTemporal the copies use
+// streaming stores, that suit the write-combined pinned memory that is
+// transferred to the device.
+//
+// The parallel loops run in an isolated region, so that the calling thread
+// does not pick up unrelated tasks while waiting for them: those could be
+// the modules of other events, which may need a lock that the caller holds.
+//
+// Same results, including the order of the errors, as the serial loop of
+// PixelDataFormatter::interpretRawData(). Not thread safe, one per stream.
+class FEDWordGatherer {
+public:
+  explicit FEDWordGatherer(bool nonTemporal = false) : nonTemporal_(nonTemporal) {}
+
+  // returns the number of words of the event; the errors are appended to errors
+  unsigned int scan(FEDRawDataCollection const& buffers,
+                    std::vector<unsigned int> const& fedIds,
+                    bool& errorsInEvent,
+                    PixelFormatterErrors& errors) {
+    feds_.clear();
+    for (unsigned int fedId : fedIds) {
+      if (fedId == 40)
+        continue;  // skip pilot blade data
+      assert(fedId >= 1200);
+      feds_.push_back({fedId, nullptr, 0, 0, false, {}});
+    }
+
+    // accessing the FEDs may also decompress them
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, feds_.size(), 4),
+                        [&](tbb::blocked_range<std::size_t> const& range) {
+                          for (auto i = range.begin(); i != range.end(); ++i) {
+                            check(buffers, feds_[i]);
+                          }
+                        });
+    });
+
+    unsigned int nWords = 0;
+    for (auto& fed : feds_) {
+      fed.offset = nWords;
+      nWords += fed.nWords;
+      errorsInEvent = errorsInEvent or fed.errorsInFed;
+      for (auto& [detId, detErrors] : fed.errors) {
+        auto& eventErrors = errors[detId];
+        eventErrors.insert(eventErrors.end(), detErrors.begin(), detErrors.end());
+      }
+    }
+    return nWords;
+  }
+
+  // number of FEDs of the last scan(), including the empty ones
+  unsigned int fedCounter() const { return feds_.size(); }
+
+  // copies the words of the FEDs of the last scan() to word, and the fedId
+  // (minus 1200) of each pair of words to fedId
+  void copy(uint32_t* word, unsigned char* fedId) const {
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, feds_.size()),
+                        [&](tbb::blocked_range<std::size_t> const& range) {
+                          for (auto i = range.begin(); i != range.end(); ++i) {
+                            auto const& fed = feds_[i];
+                            if (fed.nWords == 0)
+                              continue;
+                            if (nonTemporal_) {
+                              streamCopy(word + fed.offset, fed.words, fed.nWords);
+                              streamFill(fedId + fed.offset / 2, fed.fedId - 1200, fed.nWords / 2);
+                            } else {
+                              std::memcpy(word + fed.offset, fed.words, sizeof(uint32_t) * fed.nWords);
+                              std::memset(fedId + fed.offset / 2, fed.fedId - 1200, fed.nWords / 2);
+                            }
+                          }
+#if defined(__SSE2__)
+                          if (nonTemporal_) {
+                            _mm_sfence();
+                          }
+#endif
+                        });
+    });
+  }
+
+private:
+  struct FED {
+    unsigned int fedId;
+    uint32_t const* words;
+    unsigned int nWords;
+    unsigned int offset;
+    bool errorsInFed;
+    PixelFormatterErrors errors;
+  };
+
+  static void check(FEDRawDataCollection const& buffers, FED& fed) {
+    ErrorChecker errorcheck;
+    int fedId = fed.fedId;
+
+    // get event data for this fed
+    const FEDRawData& rawData = buffers.FEDData(fedId);
+
+    int nWords = rawData.size() / sizeof(uint64_t);
+    if (nWords == 0) {
+      return;
+    }
+
+    // check CRC bit
+    const uint64_t* trailer = reinterpret_cast<const uint64_t*>(rawData.data()) + (nWords - 1);
+    if (not errorcheck.checkCRC(fed.errorsInFed, fedId, trailer, fed.errors)) {
+      return;
+    }
+
+    // check headers
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(rawData.data());
+    header--;
+    bool moreHeaders = true;
+    while (moreHeaders) {
+      header++;
+      bool headerStatus = errorcheck.checkHeader(fed.errorsInFed, fedId, header, fed.errors);
+      moreHeaders = headerStatus;
+    }
+
+    // check trailers
+    bool moreTrailers = true;
+    trailer++;
+    while (moreTrailers) {
+      trailer--;
+      bool trailerStatus = errorcheck.checkTrailer(fed.errorsInFed, fedId, nWords, trailer, fed.errors);
+      moreTrailers = trailerStatus;
+    }
+
+    const uint32_t* bw = (const uint32_t*)(header + 1);
+    const uint32_t* ew = (const uint32_t*)(trailer);
+
+    assert(0 == (ew - bw) % 2);
+    fed.words = bw;
+    fed.nWords = ew - bw;
+  }
+
+  // the stores to the 16-byte blocks that are not entirely within the
+  // destination are not streamed, so that concurrent copies to adjacent
+  // ranges do not overlap
+  static void streamCopy(uint32_t* dst, uint32_t const* src, std::size_t n) {
+#if defined(__SSE2__)
+    for (; n > 0 and reinterpret_cast<std::uintptr_t>(dst) % 16 != 0; --n) {
+      *dst++ = *src++;
+    }
+    for (; n >= 4; n -= 4, dst += 4, src += 4) {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<__m128i const*>(src)));
+    }
+#endif
+    std::memcpy(dst, src, sizeof(uint32_t) * n);
+  }
+
+  static void streamFill(unsigned char* dst, unsigned char value, std::size_t n) {
+#if defined(__SSE2__)
+    for (; n > 0 and reinterpret_cast<std::uintptr_t>(dst) % 16 != 0; --n) {
+      *dst++ = value;
+    }
+    auto const block = _mm_set1_epi8(value);
+    for (; n >= 16; n -= 16, dst += 16) {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst), block);
+    }
+#endif
+    std::memset(dst, value, n);
+  }
+
+  bool const nonTemporal_;
+  std::vector<FED> feds_;
+};
+
+#endif
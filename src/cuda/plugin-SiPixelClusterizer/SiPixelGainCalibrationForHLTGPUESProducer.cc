@@ -3,30 +3,95 @@
 #include "Framework/ESProducer.h"
 #include "Framework/EventSetup.h"
 #include "Framework/ESPluginFactory.h"
+#include "Framework/IOVFiles.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <memory>
 
 class SiPixelGainCalibrationForHLTGPUESProducer : public edm::ESProducer {
 public:
-  explicit SiPixelGainCalibrationForHLTGPUESProducer(std::filesystem::path const& datadir) : data_(datadir) {}
-  void produce(edm::EventSetup& eventSetup);
+  explicit SiPixelGainCalibrationForHLTGPUESProducer(std::filesystem::path const& datadir)
+      : data_(datadir), boundaries_(edm::iovFirstEvents(datadir, "gain")) {}
+  void produce(edm::EventSetup& eventSetup) override;
+
+  // gain_<first event>.bin patches the gain data of the previous interval of validity
+  std::vector<int> iovBoundaries() const override { return boundaries_; }
+  void produceIOV(edm::EventSetup& eventSetup, edm::IOV const& iov) override;
 
 private:
+  void read(SiPixelGainForHLTonGPU& gain, std::vector<char>& gainData) const;
+  std::vector<SiPixelGainCalibrationForHLTGPU::Patch> readPatches(int firstEvent) const;
+  void put(edm::EventSetup& eventSetup, std::shared_ptr<SiPixelGainCalibrationForHLTGPU const> gains, int firstEvent);
+
   std::filesystem::path data_;
+  std::vector<int> boundaries_;
+  // the latest version, patched for the next interval of validity if it is still in use
+  std::weak_ptr<SiPixelGainCalibrationForHLTGPU const> latest_;
+  int latestFirstEvent_ = 0;
 };
 
 void SiPixelGainCalibrationForHLTGPUESProducer::produce(edm::EventSetup& eventSetup) {
+  SiPixelGainForHLTonGPU gain;
+  std::vector<char> gainData;
+  read(gain, gainData);
+  put(eventSetup, std::make_shared<SiPixelGainCalibrationForHLTGPU>(gain, std::move(gainData)), 0);
+}
+
+void SiPixelGainCalibrationForHLTGPUESProducer::produceIOV(edm::EventSetup& eventSetup, edm::IOV const& iov) {
+  auto index = std::lower_bound(boundaries_.begin(), boundaries_.end(), iov.first) - boundaries_.begin();
+  int previousFirstEvent = index == 0 ? 0 : boundaries_[index - 1];
+
+  auto latest = latest_.lock();
+  if (latest and latestFirstEvent_ == previousFirstEvent) {
+    put(eventSetup, SiPixelGainCalibrationForHLTGPU::update(latest, readPatches(iov.first)), iov.first);
+    return;
+  }
+
+  // the previous version is not in use any more, apply all the patches up to this interval of validity
+  SiPixelGainForHLTonGPU gain;
+  std::vector<char> gainData;
+  read(gain, gainData);
+  for (auto i = 0; i <= index; ++i) {
+    SiPixelGainCalibrationForHLTGPU::apply(readPatches(boundaries_[i]), gainData);
+  }
+  put(eventSetup, std::make_shared<SiPixelGainCalibrationForHLTGPU>(gain, std::move(gainData)), iov.first);
+}
+
+void SiPixelGainCalibrationForHLTGPUESProducer::read(SiPixelGainForHLTonGPU& gain, std::vector<char>& gainData) const {
   std::ifstream in(data_ / "gain.bin", std::ios::binary);
   in.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
-  SiPixelGainForHLTonGPU gain;
   in.read(reinterpret_cast<char*>(&gain), sizeof(SiPixelGainForHLTonGPU));
   unsigned int nbytes;
   in.read(reinterpret_cast<char*>(&nbytes), sizeof(unsigned int));
-  std::vector<char> gainData(nbytes);
+  gainData.resize(nbytes);
   in.read(gainData.data(), nbytes);
-  eventSetup.put(std::make_unique<SiPixelGainCalibrationForHLTGPU>(gain, std::move(gainData)));
+}
+
+// a sequence of (offset, number of bytes, bytes)
+std::vector<SiPixelGainCalibrationForHLTGPU::Patch> SiPixelGainCalibrationForHLTGPUESProducer::readPatches(
+    int firstEvent) const {
+  std::ifstream in(edm::iovFile(data_, "gain", firstEvent), std::ios::binary);
+  in.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+  std::vector<SiPixelGainCalibrationForHLTGPU::Patch> patches;
+  while (in.peek() != std::ifstream::traits_type::eof()) {
+    auto& patch = patches.emplace_back();
+    unsigned int nbytes;
+    in.read(reinterpret_cast<char*>(&patch.offset), sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(&nbytes), sizeof(unsigned int));
+    patch.bytes.resize(nbytes);
+    in.read(patch.bytes.data(), nbytes);
+  }
+  return patches;
+}
+
+void SiPixelGainCalibrationForHLTGPUESProducer::put(edm::EventSetup& eventSetup,
+                                                    std::shared_ptr<SiPixelGainCalibrationForHLTGPU const> gains,
+                                                    int firstEvent) {
+  latest_ = gains;
+  latestFirstEvent_ = firstEvent;
+  eventSetup.put(std::move(gains));
 }
 
 DEFINE_FWK_EVENTSETUP_MODULE(SiPixelGainCalibrationForHLTGPUESProducer);
@@ -0,0 +1,187 @@
+#include "CUDADataFormats/SiPixelClustersCPU.h"
+#include "CUDADataFormats/SiPixelDigisCPU.h"
+#include "CondFormats/SiPixelGainCalibrationForHLTGPU.h"
+#include "CondFormats/SiPixelFedCablingMapGPU.h"
+#include "CondFormats/SiPixelFedCablingMapGPUWrapper.h"
+#include "CondFormats/SiPixelFedIds.h"
+#include "DataFormats/PixelErrors.h"
+#include "DataFormats/FEDNumbering.h"
+#include "DataFormats/FEDRawData.h"
+#include "DataFormats/FEDRawDataCollection.h"
+#include "Framework/EventSetup.h"
+#include "Framework/Event.h"
+#include "Framework/PluginFactory.h"
+#include "Framework/EDProducer.h"
+#include "Framework/EventBatcher.h"
+
+#include "FEDWordGatherer.h"
+#include "SiPixelRawToClusterGPUKernel.h"
+
+#include <cassert>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class SiPixelRawToClusterCPU : public edm::EDProducerExternalWork {
+public:
+  explicit SiPixelRawToClusterCPU(edm::ProductRegistry& reg);
+  ~SiPixelRawToClusterCPU() override = default;
+
+private:
+  void acquire(const edm::Event& iEvent,
+               const edm::EventSetup& iSetup,
+               edm::WaitingTaskWithArenaHolder waitingTaskHolder) override;
+  void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
+  void endStream() override;
+
+  // One event waiting to be unpacked and clusterized with a batch of events
+  // of other streams, see edm::EventBatching
+  struct BatchEntry {
+    SiPixelRawToClusterCPU* module;
+    const SiPixelFedCablingMapGPU* cablingMap;
+    const unsigned char* modToUnp;
+    const SiPixelGainForHLTonGPU* gains;
+    edm::WaitingTaskWithArenaHolder holder;  // released when the event has been processed
+  };
+  using Batcher = edm::EventBatcher<BatchEntry>;
+
+  // shared by the instances of all streams
+  static Batcher& batcher();
+  static void processBatch(std::vector<BatchEntry>& batch);
+
+  edm::EDGetTokenT<FEDRawDataCollection> rawGetToken_;
+  edm::EDPutTokenT<SiPixelDigisCPU> digiPutToken_;
+  edm::EDPutTokenT<SiPixelClustersCPU> clusterPutToken_;
+
+  pixelgpudetails::SiPixelRawToClusterGPUKernel algo_;
+
+  FEDWordGatherer gatherer_;
+  // the 32-bit words of all FEDs, and the fedId (offset by 1200) of each pair of words
+  std::vector<uint32_t> words_;
+  std::vector<uint8_t> wordFedIds_;
+
+  std::optional<std::pair<SiPixelDigisCPU, SiPixelClustersCPU>> products_;
+
+  const bool includeErrors_;
+  const bool useQuality_;
+  const bool batching_;
+};
+
+SiPixelRawToClusterCPU::SiPixelRawToClusterCPU(edm::ProductRegistry& reg)
+    : rawGetToken_(reg.consumes<FEDRawDataCollection>()),
+      digiPutToken_(reg.produces<SiPixelDigisCPU>()),
+      clusterPutToken_(reg.produces<SiPixelClustersCPU>()),
+      includeErrors_(true),
+      useQuality_(true),
+      batching_(edm::EventBatching::batchSize() > 1) {
+  words_.reserve(pixelgpudetails::MAX_FED * pixelgpudetails::MAX_WORD);
+  wordFedIds_.reserve(pixelgpudetails::MAX_FED * pixelgpudetails::MAX_WORD / 2);
+  if (batching_) {
+    batcher().addStream();
+  }
+}
+
+SiPixelRawToClusterCPU::Batcher& SiPixelRawToClusterCPU::batcher() {
+  static Batcher batcher{edm::EventBatching::batchSize()};
+  return batcher;
+}
+
+void SiPixelRawToClusterCPU::acquire(const edm::Event& iEvent,
+                                     const edm::EventSetup& iSetup,
+                                     edm::WaitingTaskWithArenaHolder waitingTaskHolder) {
+  auto const& hMap = iSetup.get<SiPixelFedCablingMapGPUWrapper>();
+  if (hMap.hasQuality() != useQuality_) {
+    throw std::runtime_error("UseQuality of the module (" + std::to_string(useQuality_) +
+                             ") differs the one from SiPixelFedCablingMapGPUWrapper. Please fix your configuration.");
+  }
+  auto const& hgains = iSetup.get<SiPixelGainCalibrationForHLTGPU>();
+
+  auto const& fedIds_ = iSetup.get<SiPixelFedIds>().fedIds();
+
+  const auto& buffers = iEvent.get(rawGetToken_);
+
+  PixelFormatterErrors errors;
+  bool errorsInEvent = false;
+
+  auto const nWords = gatherer_.scan(buffers, fedIds_, errorsInEvent, errors);
+  words_.resize(nWords);
+  wordFedIds_.resize(nWords / 2);
+  gatherer_.copy(words_.data(), wordFedIds_.data());
+
+  if (batching_) {
+    auto batch = batcher().add(BatchEntry{
+        this, hMap.getCPUProduct(), hMap.getModToUnpAll(), hgains.getCPUProduct(), std::move(waitingTaskHolder)});
+    processBatch(batch);
+    return;
+  }
+
+  products_ = algo_.makeClusters(hMap.getCPUProduct(),
+                                 hMap.getModToUnpAll(),
+                                 hgains.getCPUProduct(),
+                                 words_.data(),
+                                 wordFedIds_.data(),
+                                 words_.size(),
+                                 useQuality_,
+                                 includeErrors_,
+                                 false);  // debug
+}
+
+void SiPixelRawToClusterCPU::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
+  iEvent.emplace(digiPutToken_, std::move(products_->first));
+  iEvent.emplace(clusterPutToken_, std::move(products_->second));
+  products_.reset();
+}
+
+void SiPixelRawToClusterCPU::endStream() {
+  if (batching_) {
+    auto batch = batcher().removeStream();
+    processBatch(batch);
+  }
+}
+
+void SiPixelRawToClusterCPU::processBatch(std::vector<BatchEntry>& batch) {
+  if (batch.empty()) {
+    return;
+  }
+
+  // the events of a batch that are in different intervals of validity of the ES products
+  // (e.g. of the gains) are processed in separate groups, each with its own products
+  auto sameESProducts = [](BatchEntry const& a, BatchEntry const& b) {
+    return a.cablingMap == b.cablingMap and a.modToUnp == b.modToUnp and a.gains == b.gains;
+  };
+
+  std::exception_ptr exception;
+  try {
+    edm::forEachGroup(batch, sameESProducts, [](auto begin, auto end) {
+      std::vector<pixelgpudetails::SiPixelRawToClusterGPUKernel::BatchInput> events;
+      events.reserve(end - begin);
+      for (auto entry = begin; entry != end; ++entry) {
+        auto const& module = *entry->module;
+        events.push_back(
+            {module.words_.data(), module.wordFedIds_.data(), static_cast<uint32_t>(module.words_.size())});
+      }
+      auto const& last = *(end - 1);
+      auto products = pixelgpudetails::SiPixelRawToClusterGPUKernel::makeClustersBatch(events,
+                                                                                        last.cablingMap,
+                                                                                        last.modToUnp,
+                                                                                        last.gains,
+                                                                                        last.module->useQuality_,
+                                                                                        last.module->includeErrors_,
+                                                                                        false);  // debug
+      for (std::size_t i = 0; i < products.size(); ++i) {
+        begin[i].module->products_ = std::move(products[i]);
+      }
+    });
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  for (auto& entry : batch) {
+    entry.holder.doneWaiting(exception);
+  }
+}
+
+// define as framework plugin
+DEFINE_FWK_MODULE(SiPixelRawToClusterCPU);
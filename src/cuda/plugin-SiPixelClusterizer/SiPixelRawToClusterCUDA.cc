@@ -1,3 +1,4 @@
+#include "CUDACore/EventCache.h"
 #include "CUDACore/Product.h"
 #include "CUDADataFormats/SiPixelClustersCUDA.h"
 #include "CUDADataFormats/SiPixelDigisCUDA.h"
@@ -13,11 +14,17 @@
 #include "Framework/Event.h"
 #include "Framework/PluginFactory.h"
 #include "Framework/EDProducer.h"
+#include "Framework/EventBatcher.h"
 #include "CUDACore/ScopedContext.h"
+#include "CUDACore/ScopedSetDevice.h"
+#include "CUDACore/SharedEventPtr.h"
+#include "CUDACore/cudaCheck.h"
+#include "CUDACore/deviceCount.h"
 
-#include "ErrorChecker.h"
+#include "FEDWordGatherer.h"
 #include "SiPixelRawToClusterGPUKernel.h"
 
+#include <exception>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,6 +39,24 @@ private:
                const edm::EventSetup& iSetup,
                edm::WaitingTaskWithArenaHolder waitingTaskHolder) override;
   void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
+  void endStream() override;
+
+  // One event waiting to be unpacked and clusterized with a batch of events
+  // of other streams, see edm::EventBatching
+  struct BatchEntry {
+    SiPixelRawToClusterCUDA* module;
+    const SiPixelFedCablingMapGPU* cablingMap;
+    const unsigned char* modToUnp;
+    const SiPixelGainForHLTonGPU* gains;
+    int device;
+    cudaStream_t stream;
+    edm::WaitingTaskWithArenaHolder holder;  // released when the event has been processed
+  };
+  using Batcher = edm::EventBatcher<BatchEntry>;
+
+  // shared by the instances of all streams
+  static Batcher& batcher();
+  static void processBatch(std::vector<BatchEntry>& batch);
 
   cms::cuda::ContextState ctxState_;
 
@@ -42,10 +67,18 @@ private:
 
   pixelgpudetails::SiPixelRawToClusterGPUKernel gpuAlgo_;
   std::unique_ptr<pixelgpudetails::SiPixelRawToClusterGPUKernel::WordFedAppender> wordFedAppender_;
+  // the FED words are written to write-combined pinned memory
+  FEDWordGatherer gatherer_{true};
   PixelFormatterErrors errors_;
 
+  // recorded when the FED words of the event are on the device
+  cms::cuda::SharedEventPtr readyEvent_;
+  // recorded when the kernels of a batch processed by this instance are done
+  cms::cuda::SharedEventPtr doneEvent_;
+
   const bool includeErrors_;
   const bool useQuality_;
+  const bool batching_;
 };
 
 SiPixelRawToClusterCUDA::SiPixelRawToClusterCUDA(edm::ProductRegistry& reg)
@@ -53,17 +86,39 @@ SiPixelRawToClusterCUDA::SiPixelRawToClusterCUDA(edm::ProductRegistry& reg)
       digiPutToken_(reg.produces<cms::cuda::Product<SiPixelDigisCUDA>>()),
       clusterPutToken_(reg.produces<cms::cuda::Product<SiPixelClustersCUDA>>()),
       includeErrors_(true),
-      useQuality_(true) {
+      useQuality_(true),
+      batching_(edm::EventBatching::batchSize() > 1) {
   if (includeErrors_) {
     digiErrorPutToken_ = reg.produces<cms::cuda::Product<SiPixelDigiErrorsCUDA>>();
   }
 
   wordFedAppender_ = std::make_unique<pixelgpudetails::SiPixelRawToClusterGPUKernel::WordFedAppender>();
+
+  if (batching_) {
+    // the events of a batch share the CUDA stream of one of them, and the ES products when they are in the
+    // same intervals of validity
+    if (cms::cuda::deviceCount() > 1) {
+      throw std::runtime_error("Batching the events in SiPixelRawToClusterCUDA is supported only with one GPU");
+    }
+    readyEvent_ = cms::cuda::getEventCache().get();
+    doneEvent_ = cms::cuda::getEventCache().get();
+    batcher().addStream();
+  }
+}
+
+SiPixelRawToClusterCUDA::Batcher& SiPixelRawToClusterCUDA::batcher() {
+  static Batcher batcher{edm::EventBatching::batchSize()};
+  return batcher;
 }
 
 void SiPixelRawToClusterCUDA::acquire(const edm::Event& iEvent,
                                       const edm::EventSetup& iSetup,
                                       edm::WaitingTaskWithArenaHolder waitingTaskHolder) {
+  // with batching produce() must wait also for the processing of the batch
+  edm::WaitingTaskWithArenaHolder batchHolder;
+  if (batching_) {
+    batchHolder = waitingTaskHolder;
+  }
   cms::cuda::ScopedContextAcquire ctx{iEvent.streamID(), std::move(waitingTaskHolder), ctxState_};
 
   auto const& hgpuMap = iSetup.get<SiPixelFedCablingMapGPUWrapper>();
@@ -86,64 +141,21 @@ void SiPixelRawToClusterCUDA::acquire(const edm::Event& iEvent,
   errors_.clear();
 
   // GPU specific: Data extraction for RawToDigi GPU
-  unsigned int wordCounterGPU = 0;
-  unsigned int fedCounter = 0;
   bool errorsInEvent = false;
 
-  // In CPU algorithm this loop is part of PixelDataFormatter::interpretRawData()
-  ErrorChecker errorcheck;
-  for (int fedId : fedIds_) {
-    if (fedId == 40)
-      continue;  // skip pilot blade data
-
-    // for GPU
-    // first 150 index stores the fedId and next 150 will store the
-    // start index of word in that fed
-    assert(fedId >= 1200);
-    fedCounter++;
-
-    // get event data for this fed
-    const FEDRawData& rawData = buffers.FEDData(fedId);
-
-    // GPU specific
-    int nWords = rawData.size() / sizeof(uint64_t);
-    if (nWords == 0) {
-      continue;
-    }
-
-    // check CRC bit
-    const uint64_t* trailer = reinterpret_cast<const uint64_t*>(rawData.data()) + (nWords - 1);
-    if (not errorcheck.checkCRC(errorsInEvent, fedId, trailer, errors_)) {
-      continue;
-    }
-
-    // check headers
-    const uint64_t* header = reinterpret_cast<const uint64_t*>(rawData.data());
-    header--;
-    bool moreHeaders = true;
-    while (moreHeaders) {
-      header++;
-      bool headerStatus = errorcheck.checkHeader(errorsInEvent, fedId, header, errors_);
-      moreHeaders = headerStatus;
-    }
-
-    // check trailers
-    bool moreTrailers = true;
-    trailer++;
-    while (moreTrailers) {
-      trailer--;
-      bool trailerStatus = errorcheck.checkTrailer(errorsInEvent, fedId, nWords, trailer, errors_);
-      moreTrailers = trailerStatus;
-    }
-
-    const uint32_t* bw = (const uint32_t*)(header + 1);
-    const uint32_t* ew = (const uint32_t*)(trailer);
-
-    assert(0 == (ew - bw) % 2);
-    wordFedAppender_->initializeWordFed(fedId, wordCounterGPU, bw, (ew - bw));
-    wordCounterGPU += (ew - bw);
-
-  }  // end of for loop
+  // In CPU algorithm this is part of PixelDataFormatter::interpretRawData()
+  unsigned int wordCounterGPU = gatherer_.scan(buffers, fedIds_, errorsInEvent, errors_);
+  unsigned int fedCounter = gatherer_.fedCounter();
+  gatherer_.copy(wordFedAppender_->word(), wordFedAppender_->fedId());
+
+  if (batching_) {
+    gpuAlgo_.prepareBatchAsync(*wordFedAppender_, std::move(errors_), wordCounterGPU, includeErrors_, ctx.stream());
+    cudaCheck(cudaEventRecord(readyEvent_.get(), ctx.stream()));
+    auto batch = batcher().add(BatchEntry{
+        this, gpuMap, gpuModulesToUnpack, gpuGains, ctx.device(), ctx.stream(), std::move(batchHolder)});
+    processBatch(batch);
+    return;
+  }
 
   gpuAlgo_.makeClustersAsync(gpuMap,
                              gpuModulesToUnpack,
@@ -169,5 +181,64 @@ void SiPixelRawToClusterCUDA::produce(edm::Event& iEvent, const edm::EventSetup&
   }
 }
 
+void SiPixelRawToClusterCUDA::endStream() {
+  if (batching_) {
+    auto batch = batcher().removeStream();
+    processBatch(batch);
+  }
+}
+
+void SiPixelRawToClusterCUDA::processBatch(std::vector<BatchEntry>& batch) {
+  if (batch.empty()) {
+    return;
+  }
+
+  // the events of a batch that are in different intervals of validity of the ES products
+  // (e.g. of the gains) are processed in separate groups, each with its own products
+  auto sameESProducts = [](BatchEntry const& a, BatchEntry const& b) {
+    return a.cablingMap == b.cablingMap and a.modToUnp == b.modToUnp and a.gains == b.gains;
+  };
+
+  std::exception_ptr exception;
+  try {
+    edm::forEachGroup(batch, sameESProducts, [](auto begin, auto end) {
+      // the kernels run in the CUDA stream of the last event of the group
+      auto const& last = *(end - 1);
+      cms::cuda::ScopedSetDevice setDevice{last.device};
+      std::vector<pixelgpudetails::SiPixelRawToClusterGPUKernel*> algos;
+      algos.reserve(end - begin);
+      for (auto entry = begin; entry != end; ++entry) {
+        cudaCheck(cudaStreamWaitEvent(last.stream, entry->module->readyEvent_.get(), 0));
+        algos.push_back(&entry->module->gpuAlgo_);
+      }
+      auto const& module = *last.module;
+      pixelgpudetails::SiPixelRawToClusterGPUKernel::makeClustersBatchAsync(algos,
+                                                                            last.cablingMap,
+                                                                            last.modToUnp,
+                                                                            last.gains,
+                                                                            module.useQuality_,
+                                                                            module.includeErrors_,
+                                                                            false,  // debug
+                                                                            last.stream);
+      cudaCheck(cudaEventRecord(module.doneEvent_.get(), last.stream));
+      for (auto entry = begin; entry != end; ++entry) {
+        cudaCheck(cudaStreamWaitEvent(entry->stream, module.doneEvent_.get(), 0));
+        entry->module->gpuAlgo_.finishBatchAsync(module.includeErrors_, entry->stream);
+      }
+    });
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  // produce() of each event runs once its own CUDA stream has done the work above
+  for (auto& entry : batch) {
+    if (exception) {
+      entry.holder.doneWaiting(exception);
+    } else {
+      cms::cuda::impl::ScopedContextHolderHelper{std::move(entry.holder)}.enqueueCallback(entry.device, entry.stream);
+    }
+  }
+}
+
 // define as framework plugin
 DEFINE_FWK_MODULE(SiPixelRawToClusterCUDA);
@@ -0,0 +1,185 @@
+// C++ includes
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+// CMSSW includes
+#include "CUDADataFormats/gpuClusteringConstants.h"
+#include "CUDACore/cudaCompat.h"
+#include "CUDACore/GPUSimpleVector.h"
+
+#include "CondFormats/SiPixelFedCablingMapGPU.h"
+
+#include "gpuCalibPixel.h"
+#include "gpuClusterChargeCut.h"
+#include "gpuClustering.h"
+
+// local includes
+#include "SiPixelRawToClusterGPUKernel.h"
+#include "SiPixelRawToClusterGPUKernelImpl.h"
+
+namespace pixelgpudetails {
+
+  // Same sequence of kernels as makeClustersAsync(), the multi-block ones
+  // run over a TBB-parallel grid, the others on the calling thread
+  std::pair<SiPixelDigisCPU, SiPixelClustersCPU> SiPixelRawToClusterGPUKernel::makeClusters(
+      const SiPixelFedCablingMapGPU *cablingMap,
+      const unsigned char *modToUnp,
+      const SiPixelGainForHLTonGPU *gains,
+      const uint32_t *word,
+      const uint8_t *fedId,
+      const uint32_t wordCounter,
+      bool useQualityInfo,
+      bool includeErrors,
+      bool debug) const {
+    cudaCompat::resetGrid();
+
+    SiPixelDigisCPU digis(wordCounter);
+    SiPixelClustersCPU clusters(gpuClustering::MaxNumModules);
+
+    // the errors are needed to skip the same pixels as on the GPU, but there
+    // is no consumer for them in the CPU workflow
+    std::unique_ptr<PixelErrorCompact[]> errorData;
+    GPU::SimpleVector<PixelErrorCompact> errors;
+    if (includeErrors) {
+      errorData = std::make_unique<PixelErrorCompact[]>(std::max(1U, wordCounter));
+      errors.construct(std::max(1U, wordCounter), errorData.get());
+    }
+
+    if (wordCounter)  // protect in case of empty event....
+    {
+      assert(0 == wordCounter % 2);
+      cudaCompat::launch<RawToDigi_kernel>(cudaCompat::cpuGridSize(),
+                                           cablingMap,
+                                           modToUnp,
+                                           wordCounter,
+                                           word,
+                                           fedId,
+                                           digis.xx(),
+                                           digis.yy(),
+                                           digis.adc(),
+                                           digis.pdigi(),
+                                           digis.rawIdArr(),
+                                           digis.moduleInd(),
+                                           includeErrors ? &errors : nullptr,
+                                           useQualityInfo,
+                                           includeErrors,
+                                           debug);
+    }
+    // End of Raw2Digi and passing data for clustering
+
+    {
+      // clusterizer ...
+      using namespace gpuClustering;
+      cudaCompat::launch<gpuCalibPixel::calibDigis>(cudaCompat::cpuGridSize(),
+                                                    digis.moduleInd(),
+                                                    digis.c_xx(),
+                                                    digis.c_yy(),
+                                                    digis.adc(),
+                                                    gains,
+                                                    wordCounter,
+                                                    clusters.moduleStart(),
+                                                    clusters.clusInModule(),
+                                                    clusters.clusModuleStart());
+
+      // a single block keeps the order of the modules reproducible
+      countModules(digis.c_moduleInd(), clusters.moduleStart(), digis.clus(), wordCounter);
+
+      // one module per block
+      cudaCompat::launch<findClus>(MaxNumModules,
+                                   digis.c_moduleInd(),
+                                   digis.c_xx(),
+                                   digis.c_yy(),
+                                   clusters.c_moduleStart(),
+                                   clusters.clusInModule(),
+                                   clusters.moduleId(),
+                                   digis.clus(),
+                                   wordCounter);
+
+      // apply charge cut
+      cudaCompat::launch<clusterChargeCut>(MaxNumModules,
+                                           digis.moduleInd(),
+                                           digis.c_adc(),
+                                           clusters.c_moduleStart(),
+                                           clusters.clusInModule(),
+                                           clusters.c_moduleId(),
+                                           digis.clus(),
+                                           wordCounter);
+
+      // MUST be ONE block
+      fillHitsModuleStart(clusters.c_clusInModule(), clusters.clusModuleStart());
+    }  // end clusterizer scope
+
+    // last element holds the number of all clusters
+    digis.setNModulesDigis(clusters.moduleStart()[0], wordCounter);
+    clusters.setNClusters(clusters.clusModuleStart()[gpuClustering::MaxNumModules]);
+    return std::make_pair(std::move(digis), std::move(clusters));
+  }
+
+  // Same sequence of kernels as makeClustersBatchAsync(), the blocks of all
+  // the events of the batch run over one TBB-parallel grid
+  std::vector<std::pair<SiPixelDigisCPU, SiPixelClustersCPU>> SiPixelRawToClusterGPUKernel::makeClustersBatch(
+      std::vector<BatchInput> const &events,
+      const SiPixelFedCablingMapGPU *cablingMap,
+      const unsigned char *modToUnp,
+      const SiPixelGainForHLTonGPU *gains,
+      bool useQualityInfo,
+      bool includeErrors,
+      bool debug) {
+    cudaCompat::resetGrid();
+
+    const uint32_t nEvents = events.size();
+    std::vector<std::pair<SiPixelDigisCPU, SiPixelClustersCPU>> products;
+    products.reserve(nEvents);
+
+    // see makeClusters() for the errors
+    std::vector<std::unique_ptr<PixelErrorCompact[]>> errorData(nEvents);
+    std::vector<GPU::SimpleVector<PixelErrorCompact>> errors(nEvents);
+
+    std::vector<RawToClusterBatchEvent> batch;
+    batch.reserve(nEvents);
+    for (uint32_t i = 0; i < nEvents; ++i) {
+      auto const &event = events[i];
+      assert(0 == event.wordCounter % 2);
+      auto &[digis, clusters] =
+          products.emplace_back(SiPixelDigisCPU(event.wordCounter), SiPixelClustersCPU(gpuClustering::MaxNumModules));
+      if (includeErrors) {
+        errorData[i] = std::make_unique<PixelErrorCompact[]>(std::max(1U, event.wordCounter));
+        errors[i].construct(std::max(1U, event.wordCounter), errorData[i].get());
+      }
+      batch.push_back(makeBatchEvent(
+          event.word, event.fedId, event.wordCounter, digis, clusters, includeErrors ? &errors[i] : nullptr));
+    }
+
+    {
+      using namespace gpuClustering;
+      cudaCompat::launch<rawToDigiBatch>(dim3{cudaCompat::cpuGridSize(), nEvents, 1},
+                                         cablingMap,
+                                         modToUnp,
+                                         batch.data(),
+                                         useQualityInfo,
+                                         includeErrors,
+                                         debug);
+      cudaCompat::launch<calibDigisBatch>(dim3{cudaCompat::cpuGridSize(), nEvents, 1}, gains, batch.data());
+
+      // a single block per event keeps the order of the modules reproducible
+      cudaCompat::launch<countModulesBatch>(dim3{1, nEvents, 1}, batch.data());
+
+      // one module of one event per block
+      cudaCompat::launch<findClusBatch>(dim3{MaxNumModules, nEvents, 1}, batch.data());
+      cudaCompat::launch<clusterChargeCutBatch>(dim3{MaxNumModules, nEvents, 1}, batch.data());
+
+      // MUST be ONE block per event
+      cudaCompat::launch<fillHitsModuleStartBatch>(dim3{1, nEvents, 1}, batch.data());
+    }
+
+    for (uint32_t i = 0; i < nEvents; ++i) {
+      auto &[digis, clusters] = products[i];
+      // last element holds the number of all clusters
+      digis.setNModulesDigis(clusters.moduleStart()[0], events[i].wordCounter);
+      clusters.setNClusters(clusters.clusModuleStart()[gpuClustering::MaxNumModules]);
+    }
+    return products;
+  }
+}  // namespace pixelgpudetails
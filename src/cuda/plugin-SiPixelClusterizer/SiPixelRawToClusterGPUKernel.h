@@ -2,12 +2,16 @@
 #define RecoLocalTracker_SiPixelClusterizer_plugins_SiPixelRawToClusterGPUKernel_h
 
 #include <algorithm>
+#include <vector>
 #include <cuda_runtime.h>
 
 #include "CUDADataFormats/SiPixelDigisCUDA.h"
 #include "CUDADataFormats/SiPixelDigiErrorsCUDA.h"
 #include "CUDADataFormats/SiPixelClustersCUDA.h"
+#include "CUDADataFormats/SiPixelClustersCPU.h"
+#include "CUDADataFormats/SiPixelDigisCPU.h"
 #include "CUDACore/GPUSimpleVector.h"
+#include "CUDACore/device_unique_ptr.h"
 #include "CUDACore/host_unique_ptr.h"
 #include "CUDACore/host_noncached_unique_ptr.h"
 #include "DataFormats/PixelErrors.h"
@@ -142,6 +146,28 @@ namespace pixelgpudetails {
     return (row << thePacking.column_width) | col;
   }
 
+  // Input and output arrays of one event of a batch, see
+  // SiPixelRawToClusterGPUKernel::makeClustersBatchAsync()
+  struct RawToClusterBatchEvent {
+    const uint32_t* word;
+    const uint8_t* fedId;
+    uint32_t wordCounter;
+
+    uint16_t* xx;
+    uint16_t* yy;
+    uint16_t* adc;
+    uint32_t* pdigi;
+    uint32_t* rawIdArr;
+    uint16_t* moduleInd;
+    int32_t* clus;
+    GPU::SimpleVector<PixelErrorCompact>* err;  // nullptr if the errors are not included
+
+    uint32_t* moduleStart;
+    uint32_t* clusInModule;
+    uint32_t* moduleId;
+    uint32_t* clusModuleStart;
+  };
+
   class SiPixelRawToClusterGPUKernel {
   public:
     class WordFedAppender {
@@ -149,7 +175,9 @@ namespace pixelgpudetails {
       WordFedAppender();
       ~WordFedAppender() = default;
 
-      void initializeWordFed(int fedId, unsigned int wordCounterGPU, const uint32_t* src, unsigned int length);
+      // filled by FEDWordGatherer::copy()
+      unsigned int* word() { return word_.get(); }
+      unsigned char* fedId() { return fedId_.get(); }
 
       const unsigned int* word() const { return word_.get(); }
       const unsigned char* fedId() const { return fedId_.get(); }
@@ -179,6 +207,65 @@ namespace pixelgpudetails {
                            bool debug,
                            cudaStream_t stream);
 
+    // CPU version of makeClustersAsync(), the FED words and the fedId of
+    // each pair of words are already in host memory
+    std::pair<SiPixelDigisCPU, SiPixelClustersCPU> makeClusters(const SiPixelFedCablingMapGPU* cablingMap,
+                                                                const unsigned char* modToUnp,
+                                                                const SiPixelGainForHLTonGPU* gains,
+                                                                const uint32_t* word,
+                                                                const uint8_t* fedId,
+                                                                const uint32_t wordCounter,
+                                                                bool useQualityInfo,
+                                                                bool includeErrors,
+                                                                bool debug) const;
+
+    // Batched version of makeClustersAsync(), that unpacks and clusterizes
+    // the events of several SiPixelRawToClusterGPUKernel in a single pass,
+    // in three steps:
+    // - prepareBatchAsync() allocates the products of one event and copies
+    //   its FED words to the device, in the CUDA stream of that event
+    // - makeClustersBatchAsync() runs the kernels for all the events of the
+    //   batch in one CUDA stream, that must wait for the work queued by
+    //   prepareBatchAsync() in the stream of each event
+    // - finishBatchAsync() copies the numbers of modules and clusters to the
+    //   host in the CUDA stream of one event, that must wait for the work
+    //   queued by makeClustersBatchAsync()
+    // after which getResults() and getErrors() can be used as usual.
+    void prepareBatchAsync(const WordFedAppender& wordFed,
+                           PixelFormatterErrors&& errors,
+                           const uint32_t wordCounter,
+                           bool includeErrors,
+                           cudaStream_t stream);
+
+    static void makeClustersBatchAsync(std::vector<SiPixelRawToClusterGPUKernel*> const& batch,
+                                       const SiPixelFedCablingMapGPU* cablingMap,
+                                       const unsigned char* modToUnp,
+                                       const SiPixelGainForHLTonGPU* gains,
+                                       bool useQualityInfo,
+                                       bool includeErrors,
+                                       bool debug,
+                                       cudaStream_t stream);
+
+    void finishBatchAsync(bool includeErrors, cudaStream_t stream);
+
+    // FED words of one event of a batch in host memory, see makeClusters()
+    struct BatchInput {
+      const uint32_t* word;
+      const uint8_t* fedId;
+      uint32_t wordCounter;
+    };
+
+    // CPU version of makeClustersBatchAsync(), returns the products of each
+    // event in the order of the input
+    static std::vector<std::pair<SiPixelDigisCPU, SiPixelClustersCPU>> makeClustersBatch(
+        std::vector<BatchInput> const& events,
+        const SiPixelFedCablingMapGPU* cablingMap,
+        const unsigned char* modToUnp,
+        const SiPixelGainForHLTonGPU* gains,
+        bool useQualityInfo,
+        bool includeErrors,
+        bool debug);
+
     std::pair<SiPixelDigisCUDA, SiPixelClustersCUDA> getResults() {
       digis_d.setNModulesDigis(nModules_Clusters_h[0], nDigis);
       clusters_d.setNClusters(nModules_Clusters_h[1]);
@@ -202,6 +289,10 @@ namespace pixelgpudetails {
     SiPixelDigisCUDA digis_d;
     SiPixelClustersCUDA clusters_d;
     SiPixelDigiErrorsCUDA digiErrors_d;
+
+    // FED words on the device, kept by prepareBatchAsync() until finishBatchAsync()
+    cms::cuda::device::unique_ptr<uint32_t[]> word_d;
+    cms::cuda::device::unique_ptr<uint8_t[]> fedId_d;
   };
 
   // see RecoLocalTracker/SiPixelClusterizer
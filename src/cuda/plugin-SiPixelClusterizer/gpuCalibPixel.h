@@ -18,22 +18,23 @@ namespace gpuCalibPixel {
   constexpr float VCaltoElectronOffset = -60;      // L2-4: -60 +- 130
   constexpr float VCaltoElectronOffset_L1 = -670;  // L1:   -670 +- 220
 
-  __global__ void calibDigis(uint16_t* id,
-                             uint16_t const* __restrict__ x,
-                             uint16_t const* __restrict__ y,
-                             uint16_t* adc,
-                             SiPixelGainForHLTonGPU const* __restrict__ ped,
-                             int numElements,
-                             uint32_t* __restrict__ moduleStart,        // just to zero first
-                             uint32_t* __restrict__ nClustersInModule,  // just to zero them
-                             uint32_t* __restrict__ clusModuleStart     // just to zero first
+  // body of calibDigis, also run for each event of a batch (see SiPixelRawToClusterGPUKernelImpl.h)
+  __device__ __forceinline__ void calibDigisImpl(uint16_t* id,
+                                                 uint16_t const* __restrict__ x,
+                                                 uint16_t const* __restrict__ y,
+                                                 uint16_t* adc,
+                                                 SiPixelGainForHLTonGPU const* __restrict__ ped,
+                                                 int numElements,
+                                                 uint32_t* __restrict__ moduleStart,        // just to zero first
+                                                 uint32_t* __restrict__ nClustersInModule,  // just to zero them
+                                                 uint32_t* __restrict__ clusModuleStart     // just to zero first
   ) {
     int first = blockDim.x * blockIdx.x + threadIdx.x;
 
     // zero for next kernels...
     if (0 == first)
       clusModuleStart[0] = moduleStart[0] = 0;
-    for (int i = first; i < gpuClustering::MaxNumModules; i += gridDim.x * blockDim.x) {
+    for (int i = first; i < int(gpuClustering::MaxNumModules); i += gridDim.x * blockDim.x) {
       nClustersInModule[i] = 0;
     }
 
@@ -62,6 +63,19 @@ namespace gpuCalibPixel {
       }
     }
   }
+
+  __global__ void calibDigis(uint16_t* id,
+                             uint16_t const* __restrict__ x,
+                             uint16_t const* __restrict__ y,
+                             uint16_t* adc,
+                             SiPixelGainForHLTonGPU const* __restrict__ ped,
+                             int numElements,
+                             uint32_t* __restrict__ moduleStart,        // just to zero first
+                             uint32_t* __restrict__ nClustersInModule,  // just to zero them
+                             uint32_t* __restrict__ clusModuleStart     // just to zero first
+  ) {
+    calibDigisImpl(id, x, y, adc, ped, numElements, moduleStart, nClustersInModule, clusModuleStart);
+  }
 }  // namespace gpuCalibPixel
 
 #endif  // RecoLocalTracker_SiPixelClusterizer_plugins_gpuCalibPixel_h
@@ -11,7 +11,8 @@
 
 namespace gpuClustering {
 
-  __global__ void clusterChargeCut(
+  // body of clusterChargeCut, also run for each event of a batch (see SiPixelRawToClusterGPUKernelImpl.h)
+  __device__ __forceinline__ void clusterChargeCutImpl(
       uint16_t* __restrict__ id,                 // module id of each pixel (modified if bad cluster)
       uint16_t const* __restrict__ adc,          //  charge of each pixel
       uint32_t const* __restrict__ moduleStart,  // index of the first pixel of each module
@@ -120,6 +121,17 @@ namespace gpuClustering {
     //done
   }
 
+  __global__ void clusterChargeCut(
+      uint16_t* __restrict__ id,                 // module id of each pixel (modified if bad cluster)
+      uint16_t const* __restrict__ adc,          //  charge of each pixel
+      uint32_t const* __restrict__ moduleStart,  // index of the first pixel of each module
+      uint32_t* __restrict__ nClustersInModule,  // modified: number of clusters found in each module
+      uint32_t const* __restrict__ moduleId,     // module id of each module
+      int32_t* __restrict__ clusterId,           // modified: cluster id of each pixel
+      uint32_t numElements) {
+    clusterChargeCutImpl(id, adc, moduleStart, nClustersInModule, moduleId, clusterId, numElements);
+  }
+
 }  // namespace gpuClustering
 
 #endif  // RecoLocalTracker_SiPixelClusterizer_plugins_gpuClusterChargeCut_h
@@ -16,10 +16,12 @@ namespace gpuClustering {
   __device__ uint32_t gMaxHit = 0;
 #endif
 
-  __global__ void countModules(uint16_t const* __restrict__ id,
-                               uint32_t* __restrict__ moduleStart,
-                               int32_t* __restrict__ clusterId,
-                               int numElements) {
+  // The bodies of the kernels are device functions, so that they can be
+  // run also for each event of a batch (see SiPixelRawToClusterGPUKernelImpl.h)
+  __device__ __forceinline__ void countModulesImpl(uint16_t const* __restrict__ id,
+                                                   uint32_t* __restrict__ moduleStart,
+                                                   int32_t* __restrict__ clusterId,
+                                                   int numElements) {
     int first = blockDim.x * blockIdx.x + threadIdx.x;
     for (int i = first; i < numElements; i += gridDim.x * blockDim.x) {
       clusterId[i] = i;
@@ -36,70 +38,81 @@ namespace gpuClustering {
     }
   }
 
-  __global__
-      //  __launch_bounds__(256,4)
-      void
-      findClus(uint16_t const* __restrict__ id,           // module id of each pixel
-               uint16_t const* __restrict__ x,            // local coordinates of each pixel
-               uint16_t const* __restrict__ y,            //
-               uint32_t const* __restrict__ moduleStart,  // index of the first pixel of each module
-               uint32_t* __restrict__ nClustersInModule,  // output: number of clusters found in each module
-               uint32_t* __restrict__ moduleId,           // output: module id of each module
-               int32_t* __restrict__ clusterId,           // output: cluster id of each pixel
-               int numElements) {
-    if (blockIdx.x >= moduleStart[0])
-      return;
-
-    auto firstPixel = moduleStart[1 + blockIdx.x];
-    auto thisModuleId = id[firstPixel];
-    assert(thisModuleId < MaxNumModules);
+  __global__ void countModules(uint16_t const* __restrict__ id,
+                               uint32_t* __restrict__ moduleStart,
+                               int32_t* __restrict__ clusterId,
+                               int numElements) {
+    countModulesImpl(id, moduleStart, clusterId, numElements);
+  }
 
-#ifdef GPU_DEBUG
-    if (thisModuleId % 100 == 1)
-      if (threadIdx.x == 0)
-        printf("start clusterizer for module %d in block %d\n", thisModuleId, blockIdx.x);
-#endif
+  // Modules with up to maxPixInTinyModule pixels are clusterized by a single
+  // thread with a direct union-find, cheaper than filling the histogram.
+  // Modules with up to maxPixInModule pixels are clusterized with one
+  // histogram of the columns, larger ones are split in tiles of columns that
+  // fit in the histogram.
+  constexpr uint32_t maxPixInTinyModule = 32;
+  constexpr uint32_t maxPixInModule = 4000;
+  // the index of the pixels in the histogram is 16 bit
+  constexpr uint32_t maxPixInHotModule = 0xffff;
+  constexpr int maxTilesInModule = 32;
 
-    auto first = firstPixel + threadIdx.x;
+  //init hist  (ymax=416 < 512 : 9bits)
+  using ClusterHist = HistoContainer<uint16_t, phase1PixelTopology::numColsInModule + 2, maxPixInModule, 9, uint16_t>;
 
-    // find the index of the first pixel not belonging to this module (or invalid)
-    __shared__ int msize;
-    msize = numElements;
-    __syncthreads();
-
-    // skip threads not associated to an existing pixel
-    for (int i = first; i < numElements; i += blockDim.x) {
+  // Direct union-find over the pixels [firstPixel, msize) of a module, for a
+  // single thread: each pixel ends up with the index of the lowest pixel of
+  // its cluster as clusterId, as after the label propagation.
+  __device__ __forceinline__ void findClusInTinyModule(uint16_t const* __restrict__ id,
+                                                       uint16_t const* __restrict__ x,
+                                                       uint16_t const* __restrict__ y,
+                                                       int32_t* __restrict__ clusterId,
+                                                       int firstPixel,
+                                                       int msize) {
+    for (int i = firstPixel; i < msize; ++i) {
       if (id[i] == InvId)  // skip invalid pixels
         continue;
-      if (id[i] != thisModuleId) {  // find the first pixel in a different module
-        atomicMin(&msize, i);
-        break;
+      for (int j = firstPixel; j < i; ++j) {
+        if (id[j] == InvId)
+          continue;
+        if (std::abs(int(x[i]) - int(x[j])) > 1 or std::abs(int(y[i]) - int(y[j])) > 1)
+          continue;
+        int ri = i;
+        while (ri != clusterId[ri])
+          ri = clusterId[ri];
+        int rj = j;
+        while (rj != clusterId[rj])
+          rj = clusterId[rj];
+        // the lower root becomes the root of both trees
+        if (ri < rj)
+          clusterId[rj] = ri;
+        else if (rj < ri)
+          clusterId[ri] = rj;
       }
     }
-
-    //init hist  (ymax=416 < 512 : 9bits)
-    constexpr uint32_t maxPixInModule = 4000;
-    constexpr auto nbins = phase1PixelTopology::numColsInModule + 2;  //2+2;
-    using Hist = HistoContainer<uint16_t, nbins, maxPixInModule, 9, uint16_t>;
-    __shared__ Hist hist;
-    __shared__ typename Hist::Counter ws[32];
-    for (auto j = threadIdx.x; j < Hist::totbins(); j += blockDim.x) {
-      hist.off[j] = 0;
-    }
-    __syncthreads();
-
-    assert((msize == numElements) or ((msize < numElements) and (id[msize] != thisModuleId)));
-
-    // limit to maxPixInModule  (FIXME if recurrent (and not limited to simulation with low threshold) one will need to implement something cleverer)
-    if (0 == threadIdx.x) {
-      if (msize - firstPixel > maxPixInModule) {
-        printf("too many pixels in module %d: %d > %d\n", thisModuleId, msize - firstPixel, maxPixInModule);
-        msize = maxPixInModule + firstPixel;
-      }
+    // each pixel has a lower index than its children, so one forward pass is enough to point all of them to the root
+    for (int i = firstPixel; i < msize; ++i) {
+      if (id[i] == InvId)  // skip invalid pixels
+        continue;
+      clusterId[i] = clusterId[clusterId[i]];
     }
+  }
 
-    __syncthreads();
-    assert(msize - firstPixel <= maxPixInModule);
+  // Label propagation over the pixels [firstPixel, msize) of a module that
+  // are in the columns [firstBin, lastBin] of the histogram, for the whole
+  // block. Returns true if any clusterId has been changed.
+  __device__ __forceinline__ bool findClusInColumns(uint16_t const* __restrict__ id,
+                                                    uint16_t const* __restrict__ x,
+                                                    uint16_t const* __restrict__ y,
+                                                    int32_t* __restrict__ clusterId,
+                                                    uint16_t thisModuleId,
+                                                    int firstPixel,
+                                                    int msize,
+                                                    uint32_t firstBin,
+                                                    uint32_t lastBin,
+                                                    ClusterHist& hist,
+                                                    ClusterHist::Counter* ws) {
+    using Hist = ClusterHist;
+    int first = firstPixel + threadIdx.x;
 
 #ifdef GPU_DEBUG
     __shared__ uint32_t totGood;
@@ -107,10 +120,17 @@ namespace gpuClustering {
     __syncthreads();
 #endif
 
+    for (auto j = threadIdx.x; j < Hist::totbins(); j += blockDim.x) {
+      hist.off[j] = 0;
+    }
+    __syncthreads();
+
     // fill histo
     for (int i = first; i < msize; i += blockDim.x) {
       if (id[i] == InvId)  // skip invalid pixels
         continue;
+      if (Hist::bin(y[i]) < firstBin or Hist::bin(y[i]) > lastBin)  // skip the other tiles
+        continue;
       hist.count(y[i]);
 #ifdef GPU_DEBUG
       atomicAdd(&totGood, 1);
@@ -131,6 +151,8 @@ namespace gpuClustering {
     for (int i = first; i < msize; i += blockDim.x) {
       if (id[i] == InvId)  // skip invalid pixels
         continue;
+      if (Hist::bin(y[i]) < firstBin or Hist::bin(y[i]) > lastBin)  // skip the other tiles
+        continue;
       hist.fill(y[i], i - firstPixel);
     }
 
@@ -247,6 +269,131 @@ namespace gpuClustering {
     }
 #endif
 
+    return nloops > 1;
+  }
+
+  __device__ __forceinline__ void findClusImpl(
+      uint16_t const* __restrict__ id,           // module id of each pixel
+      uint16_t const* __restrict__ x,            // local coordinates of each pixel
+      uint16_t const* __restrict__ y,            //
+      uint32_t const* __restrict__ moduleStart,  // index of the first pixel of each module
+      uint32_t* __restrict__ nClustersInModule,  // output: number of clusters found in each module
+      uint32_t* __restrict__ moduleId,           // output: module id of each module
+      int32_t* __restrict__ clusterId,           // output: cluster id of each pixel
+      int numElements) {
+    if (blockIdx.x >= moduleStart[0])
+      return;
+
+    auto firstPixel = moduleStart[1 + blockIdx.x];
+    auto thisModuleId = id[firstPixel];
+    assert(thisModuleId < MaxNumModules);
+
+#ifdef GPU_DEBUG
+    if (thisModuleId % 100 == 1)
+      if (threadIdx.x == 0)
+        printf("start clusterizer for module %d in block %d\n", thisModuleId, blockIdx.x);
+#endif
+
+    auto first = firstPixel + threadIdx.x;
+
+    // find the index of the first pixel not belonging to this module (or invalid)
+    __shared__ int msize;
+    msize = numElements;
+    __syncthreads();
+
+    // skip threads not associated to an existing pixel
+    for (int i = first; i < numElements; i += blockDim.x) {
+      if (id[i] == InvId)  // skip invalid pixels
+        continue;
+      if (id[i] != thisModuleId) {  // find the first pixel in a different module
+        atomicMin(&msize, i);
+        break;
+      }
+    }
+    __syncthreads();
+
+    assert((msize == numElements) or ((msize < numElements) and (id[msize] != thisModuleId)));
+
+    // limit to maxPixInHotModule, much more than a real module can have
+    if (0 == threadIdx.x) {
+      if (msize - firstPixel > maxPixInHotModule) {
+        printf("too many pixels in module %d: %d > %d\n", thisModuleId, msize - firstPixel, maxPixInHotModule);
+        msize = maxPixInHotModule + firstPixel;
+      }
+    }
+
+    __syncthreads();
+    assert(msize - firstPixel <= maxPixInHotModule);
+
+    // dispatch on the number of pixels, the same for the whole block
+    if (msize - firstPixel <= maxPixInTinyModule) {
+      if (0 == threadIdx.x) {
+        findClusInTinyModule(id, x, y, clusterId, firstPixel, msize);
+      }
+      __syncthreads();
+    } else {
+      __shared__ ClusterHist hist;
+      __shared__ ClusterHist::Counter ws[32];
+      if (msize - firstPixel <= maxPixInModule) {
+        findClusInColumns(
+            id, x, y, clusterId, thisModuleId, firstPixel, msize, 0, ClusterHist::nbins() - 1, hist, ws);
+      } else {
+        // Split the module in tiles of consecutive columns that fit in the
+        // histogram; consecutive tiles share one column, so that each pair
+        // of neighbouring pixels is in at least one tile
+        __shared__ uint16_t tileFirstBin[maxTilesInModule];
+        __shared__ uint16_t tileLastBin[maxTilesInModule];
+        __shared__ int nTiles;
+        for (auto j = threadIdx.x; j < ClusterHist::totbins(); j += blockDim.x) {
+          hist.off[j] = 0;
+        }
+        __syncthreads();
+        for (int i = first; i < msize; i += blockDim.x) {
+          if (id[i] == InvId)  // skip invalid pixels
+            continue;
+          hist.count(y[i]);
+        }
+        __syncthreads();
+        if (0 == threadIdx.x) {
+          nTiles = 0;
+          uint32_t firstBin = 0;
+          while (true) {
+            // at least two columns per tile, to make progress
+            uint32_t lastBin = firstBin + 1;
+            uint32_t n = hist.off[firstBin] + hist.off[lastBin];
+            while (lastBin + 1 < ClusterHist::nbins() and n + hist.off[lastBin + 1] <= maxPixInModule) {
+              ++lastBin;
+              n += hist.off[lastBin];
+            }
+            assert(n <= maxPixInModule);
+            assert(nTiles < maxTilesInModule);
+            tileFirstBin[nTiles] = firstBin;
+            tileLastBin[nTiles] = lastBin;
+            ++nTiles;
+            if (lastBin + 1 == ClusterHist::nbins())
+              break;
+            firstBin = lastBin;
+          }
+#ifdef GPU_DEBUG
+          printf("split module %d with %d pixels in %d tiles\n", thisModuleId, msize - firstPixel, nTiles);
+#endif
+        }
+        __syncthreads();
+
+        // the ids propagate across the tiles in both directions, so iterate
+        // over all the tiles until none of them changes any more
+        bool more = true;
+        while (__syncthreads_or(more)) {
+          more = false;
+          for (int t = 0; t < nTiles; ++t) {
+            if (findClusInColumns(
+                    id, x, y, clusterId, thisModuleId, firstPixel, msize, tileFirstBin[t], tileLastBin[t], hist, ws))
+              more = true;
+          }
+        }
+      }
+    }
+
     __shared__ unsigned int foundClusters;
     foundClusters = 0;
     __syncthreads();
@@ -301,6 +448,20 @@ namespace gpuClustering {
     }
   }
 
+  __global__
+      //  __launch_bounds__(256,4)
+      void
+      findClus(uint16_t const* __restrict__ id,           // module id of each pixel
+               uint16_t const* __restrict__ x,            // local coordinates of each pixel
+               uint16_t const* __restrict__ y,            //
+               uint32_t const* __restrict__ moduleStart,  // index of the first pixel of each module
+               uint32_t* __restrict__ nClustersInModule,  // output: number of clusters found in each module
+               uint32_t* __restrict__ moduleId,           // output: module id of each module
+               int32_t* __restrict__ clusterId,           // output: cluster id of each pixel
+               int numElements) {
+    findClusImpl(id, x, y, moduleStart, nClustersInModule, moduleId, clusterId, numElements);
+  }
+
 }  // namespace gpuClustering
 
 #endif  // RecoLocalTracker_SiPixelClusterizer_plugins_gpuClustering_h
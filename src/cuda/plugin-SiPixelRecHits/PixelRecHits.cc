@@ -0,0 +1,42 @@
+// C++ headers
+#include <algorithm>
+#include <numeric>
+
+// CMSSW headers
+#include "CUDACore/cudaCompat.h"
+#include "plugin-SiPixelClusterizer/SiPixelRawToClusterGPUKernel.h"  // !
+#include "plugin-SiPixelClusterizer/gpuClusteringConstants.h"        // !
+
+#include "PixelRecHits.h"
+#include "gpuPixelRecHits.h"
+
+namespace pixelgpudetails {
+
+  TrackingRecHit2DCPU PixelRecHitGPUKernel::makeHits(SiPixelDigisCPU const& digis,
+                                                     SiPixelClustersCPU const& clusters,
+                                                     BeamSpotCUDA::Data const& bs,
+                                                     pixelCPEforGPU::ParamsOnGPU const* cpeParams) const {
+    cudaCompat::resetGrid();
+
+    auto nHits = clusters.nClusters();
+    TrackingRecHit2DCPU hits(nHits, cpeParams, clusters.clusModuleStart(), nullptr);
+
+    int blocks = digis.nModules();  // active modules (with digis)
+
+#ifdef GPU_DEBUG
+    std::cout << "launching getHits kernel for " << blocks << " blocks" << std::endl;
+#endif
+    if (blocks)  // protect from empty events
+      cudaCompat::launch<gpuPixelRecHits::getHits>(
+          blocks, cpeParams, &bs, digis.view(), digis.nDigis(), clusters.view(), hits.view());
+
+    if (nHits) {
+      gpuPixelRecHits::setHitsLayerStart(clusters.clusModuleStart(), cpeParams, hits.hitsLayerStart());
+      // the CPU version does not need the workspace
+      cms::cuda::fillManyFromVector(hits.phiBinner(), nullptr, 10, hits.iphi(), hits.hitsLayerStart(), nHits, 256);
+    }
+
+    return hits;
+  }
+
+}  // namespace pixelgpudetails
@@ -6,7 +6,9 @@
 #include <cuda_runtime.h>
 
 #include "CUDADataFormats/BeamSpotCUDA.h"
+#include "CUDADataFormats/SiPixelClustersCPU.h"
 #include "CUDADataFormats/SiPixelClustersCUDA.h"
+#include "CUDADataFormats/SiPixelDigisCPU.h"
 #include "CUDADataFormats/SiPixelDigisCUDA.h"
 #include "CUDADataFormats/TrackingRecHit2DCUDA.h"
 
@@ -27,6 +29,12 @@ namespace pixelgpudetails {
                                        BeamSpotCUDA const& bs_d,
                                        pixelCPEforGPU::ParamsOnGPU const* cpeParams,
                                        cudaStream_t stream) const;
+
+    // CPU version of makeHitsAsync()
+    TrackingRecHit2DCPU makeHits(SiPixelDigisCPU const& digis,
+                                 SiPixelClustersCPU const& clusters,
+                                 BeamSpotCUDA::Data const& bs,
+                                 pixelCPEforGPU::ParamsOnGPU const* cpeParams) const;
   };
 }  // namespace pixelgpudetails
 
@@ -0,0 +1,52 @@
+#include <iostream>
+
+#include "CUDADataFormats/BeamSpotCUDA.h"
+#include "CUDADataFormats/SiPixelClustersCPU.h"
+#include "CUDADataFormats/SiPixelDigisCPU.h"
+#include "CUDADataFormats/TrackingRecHit2DCUDA.h"
+#include "Framework/EventSetup.h"
+#include "Framework/Event.h"
+#include "Framework/PluginFactory.h"
+#include "Framework/EDProducer.h"
+#include "CondFormats/PixelCPEFast.h"
+
+#include "PixelRecHits.h"
+
+class SiPixelRecHitCPU : public edm::EDProducer {
+public:
+  explicit SiPixelRecHitCPU(edm::ProductRegistry& reg);
+  ~SiPixelRecHitCPU() override = default;
+
+private:
+  void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
+
+  edm::EDGetTokenT<SiPixelClustersCPU> token_;
+  edm::EDGetTokenT<SiPixelDigisCPU> tokenDigi_;
+
+  edm::EDPutTokenT<TrackingRecHit2DCPU> tokenHit_;
+
+  pixelgpudetails::PixelRecHitGPUKernel algo_;
+};
+
+SiPixelRecHitCPU::SiPixelRecHitCPU(edm::ProductRegistry& reg)
+    : token_(reg.consumes<SiPixelClustersCPU>()),
+      tokenDigi_(reg.consumes<SiPixelDigisCPU>()),
+      tokenHit_(reg.produces<TrackingRecHit2DCPU>()) {}
+
+void SiPixelRecHitCPU::produce(edm::Event& iEvent, const edm::EventSetup& es) {
+  PixelCPEFast const& fcpe = es.get<PixelCPEFast>();
+  // the beam spot is taken directly from the EventSetup, there is no need for BeamSpotToCUDA
+  auto const& bs = es.get<BeamSpotCUDA::Data>();
+
+  auto const& clusters = iEvent.get(token_);
+  auto const& digis = iEvent.get(tokenDigi_);
+
+  auto nHits = clusters.nClusters();
+  if (nHits >= TrackingRecHit2DSOAView::maxHits()) {
+    std::cout << "Clusters/Hits Overflow " << nHits << " >= " << TrackingRecHit2DSOAView::maxHits() << std::endl;
+  }
+
+  iEvent.emplace(tokenHit_, algo_.makeHits(digis, clusters, bs, &fcpe.getCPUProduct()));
+}
+
+DEFINE_FWK_MODULE(SiPixelRecHitCPU);
@@ -214,6 +214,20 @@ namespace gpuPixelRecHits {
     }  // end loop on batches
   }
 
+  __global__ void setHitsLayerStart(uint32_t const* __restrict__ hitsModuleStart,
+                                    pixelCPEforGPU::ParamsOnGPU const* cpeParams,
+                                    uint32_t* hitsLayerStart) {
+    assert(0 == hitsModuleStart[0]);
+
+    auto first = blockIdx.x * blockDim.x + threadIdx.x;
+    for (int i = first, nt = 11; i < nt; i += gridDim.x * blockDim.x) {
+      hitsLayerStart[i] = hitsModuleStart[cpeParams->layerGeometry().layerStart[i]];
+#ifdef GPU_DEBUG
+      printf("LayerStart %d %d: %d\n", i, cpeParams->layerGeometry().layerStart[i], hitsLayerStart[i]);
+#endif
+    }
+  }
+
 }  // namespace gpuPixelRecHits
 
 #endif  // RecoLocalTracker_SiPixelRecHits_plugins_gpuPixelRecHits_h
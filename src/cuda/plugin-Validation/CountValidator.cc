@@ -1,7 +1,9 @@
 #include "CUDACore/Product.h"
 #include "CUDACore/ScopedContext.h"
 #include "CUDADataFormats/PixelTrackHeterogeneous.h"
+#include "CUDADataFormats/SiPixelClustersCPU.h"
 #include "CUDADataFormats/SiPixelClustersCUDA.h"
+#include "CUDADataFormats/SiPixelDigisCPU.h"
 #include "CUDADataFormats/SiPixelDigisCUDA.h"
 #include "CUDADataFormats/ZVertexHeterogeneous.h"
 #include "DataFormats/DigiClusterCount.h"
@@ -28,7 +30,8 @@ namespace {
 
 class CountValidator : public edm::EDProducer {
 public:
-  explicit CountValidator(edm::ProductRegistry& reg);
+  explicit CountValidator(edm::ProductRegistry& reg) : CountValidator(reg, true) {}
+  CountValidator(edm::ProductRegistry& reg, bool onGPU);
 
 private:
   void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
@@ -38,20 +41,31 @@ private:
   edm::EDGetTokenT<TrackCount> trackCountToken_;
   edm::EDGetTokenT<VertexCount> vertexCountToken_;
 
+  bool m_OnGPU;
+
   edm::EDGetTokenT<cms::cuda::Product<SiPixelDigisCUDA>> digiToken_;
   edm::EDGetTokenT<cms::cuda::Product<SiPixelClustersCUDA>> clusterToken_;
+  edm::EDGetTokenT<SiPixelDigisCPU> digiCPUToken_;
+  edm::EDGetTokenT<SiPixelClustersCPU> clusterCPUToken_;
   edm::EDGetTokenT<PixelTrackHeterogeneous> trackToken_;
   edm::EDGetTokenT<ZVertexHeterogeneous> vertexToken_;
 };
 
-CountValidator::CountValidator(edm::ProductRegistry& reg)
+CountValidator::CountValidator(edm::ProductRegistry& reg, bool onGPU)
     : digiClusterCountToken_(reg.consumes<DigiClusterCount>()),
       trackCountToken_(reg.consumes<TrackCount>()),
       vertexCountToken_(reg.consumes<VertexCount>()),
-      digiToken_(reg.consumes<cms::cuda::Product<SiPixelDigisCUDA>>()),
-      clusterToken_(reg.consumes<cms::cuda::Product<SiPixelClustersCUDA>>()),
+      m_OnGPU(onGPU),
       trackToken_(reg.consumes<PixelTrackHeterogeneous>()),
-      vertexToken_(reg.consumes<ZVertexHeterogeneous>()) {}
+      vertexToken_(reg.consumes<ZVertexHeterogeneous>()) {
+  if (m_OnGPU) {
+    digiToken_ = reg.consumes<cms::cuda::Product<SiPixelDigisCUDA>>();
+    clusterToken_ = reg.consumes<cms::cuda::Product<SiPixelClustersCUDA>>();
+  } else {
+    digiCPUToken_ = reg.consumes<SiPixelDigisCPU>();
+    clusterCPUToken_ = reg.consumes<SiPixelClustersCPU>();
+  }
+}
 
 void CountValidator::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
   constexpr float trackTolerance = 0.012f;  // in 200 runs of 1k events all events are withing this tolerance
@@ -63,23 +77,28 @@ void CountValidator::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
   ss << "Event " << iEvent.eventID() << " ";
 
   {
-    auto const& pdigis = iEvent.get(digiToken_);
-    cms::cuda::ScopedContextProduce ctx{pdigis};
     auto const& count = iEvent.get(digiClusterCountToken_);
-    auto const& digis = ctx.get(iEvent, digiToken_);
-    auto const& clusters = ctx.get(iEvent, clusterToken_);
-
-    if (digis.nModules() != count.nModules()) {
-      ss << "\n N(modules) is " << digis.nModules() << " expected " << count.nModules();
-      ok = false;
-    }
-    if (digis.nDigis() != count.nDigis()) {
-      ss << "\n N(digis) is " << digis.nDigis() << " expected " << count.nDigis();
-      ok = false;
-    }
-    if (clusters.nClusters() != count.nClusters()) {
-      ss << "\n N(clusters) is " << clusters.nClusters() << " expected " << count.nClusters();
-      ok = false;
+    auto check = [&](auto const& digis, auto const& clusters) {
+      if (digis.nModules() != count.nModules()) {
+        ss << "\n N(modules) is " << digis.nModules() << " expected " << count.nModules();
+        ok = false;
+      }
+      if (digis.nDigis() != count.nDigis()) {
+        ss << "\n N(digis) is " << digis.nDigis() << " expected " << count.nDigis();
+        ok = false;
+      }
+      if (clusters.nClusters() != count.nClusters()) {
+        ss << "\n N(clusters) is " << clusters.nClusters() << " expected " << count.nClusters();
+        ok = false;
+      }
+    };
+
+    if (m_OnGPU) {
+      auto const& pdigis = iEvent.get(digiToken_);
+      cms::cuda::ScopedContextProduce ctx{pdigis};
+      check(ctx.get(iEvent, digiToken_), ctx.get(iEvent, clusterToken_));
+    } else {
+      check(iEvent.get(digiCPUToken_), iEvent.get(clusterCPUToken_));
     }
   }
 
@@ -146,4 +165,11 @@ void CountValidator::endJob() {
   }
 }
 
+// consumes the digis and clusters of the CPU workflow
+class CountValidatorCPU : public CountValidator {
+public:
+  explicit CountValidatorCPU(edm::ProductRegistry& reg) : CountValidator(reg, false) {}
+};
+
 DEFINE_FWK_MODULE(CountValidator);
+DEFINE_FWK_MODULE(CountValidatorCPU);
@@ -10,9 +10,9 @@
 #include "Framework/PluginFactory.h"
 #include "Framework/EDProducer.h"
 
-#include "SimpleAtomicHisto.h"
+#include "ShardedHisto.h"
 
-#include <map>
+#include <cassert>
 #include <fstream>
 
 class HistoValidator : public edm::EDProducerExternalWork {
@@ -43,50 +43,92 @@ private:
   cms::cuda::host::unique_ptr<int32_t[]> h_charge;
   cms::cuda::host::unique_ptr<int16_t[]> h_size;
 
-  static std::map<std::string, SimpleAtomicHisto> histos;
+  // the histograms are filled through the shard of this stream, and summed in endJob()
+  enum Histo : unsigned int {
+    kDigiN,
+    kDigiAdc,
+    kModuleN,
+    kClusterN,
+    kClusterPerModuleN,
+    kHitN,
+    kHitLx,
+    kHitLy,
+    kHitLex,
+    kHitLey,
+    kHitGx,
+    kHitGy,
+    kHitGz,
+    kHitGr,
+    kHitCharge,
+    kHitSizex,
+    kHitSizey,
+    kTrackN,
+    kTrackNhits,
+    kTrackChi2,
+    kTrackPt,
+    kTrackEta,
+    kTrackPhi,
+    kTrackTip,
+    kTrackTipZoom,
+    kTrackZip,
+    kTrackZipZoom,
+    kTrackQuality,
+    kVertexN,
+    kVertexZ,
+    kVertexChi2,
+    kVertexNdof,
+    kVertexPt2,
+    kNumberOfHistos
+  };
+  static ShardedHisto histos;
+  ShardedHisto::Shard& shard_;
 };
 
-std::map<std::string, SimpleAtomicHisto> HistoValidator::histos = {
-    {"digi_n", SimpleAtomicHisto(100, 0, 1e5)},
-    {"digi_adc", SimpleAtomicHisto(250, 0, 5e4)},
-    {"module_n", SimpleAtomicHisto(100, 1500, 2000)},
-    {"cluster_n", SimpleAtomicHisto(200, 5000, 25000)},
-    {"cluster_per_module_n", SimpleAtomicHisto(110, 0, 110)},
-    {"hit_n", SimpleAtomicHisto(200, 5000, 25000)},
-    {"hit_lx", SimpleAtomicHisto(200, -1, 1)},
-    {"hit_ly", SimpleAtomicHisto(800, -4, 4)},
-    {"hit_lex", SimpleAtomicHisto(100, 0, 5e-5)},
-    {"hit_ley", SimpleAtomicHisto(100, 0, 1e-4)},
-    {"hit_gx", SimpleAtomicHisto(200, -20, 20)},
-    {"hit_gy", SimpleAtomicHisto(200, -20, 20)},
-    {"hit_gz", SimpleAtomicHisto(600, -60, 60)},
-    {"hit_gr", SimpleAtomicHisto(200, 0, 20)},
-    {"hit_charge", SimpleAtomicHisto(400, 0, 4e6)},
-    {"hit_sizex", SimpleAtomicHisto(800, 0, 800)},
-    {"hit_sizey", SimpleAtomicHisto(800, 0, 800)},
-    {"track_n", SimpleAtomicHisto(150, 0, 15000)},
-    {"track_nhits", SimpleAtomicHisto(3, 3, 6)},
-    {"track_chi2", SimpleAtomicHisto(100, 0, 40)},
-    {"track_pt", SimpleAtomicHisto(400, 0, 400)},
-    {"track_eta", SimpleAtomicHisto(100, -3, 3)},
-    {"track_phi", SimpleAtomicHisto(100, -3.15, 3.15)},
-    {"track_tip", SimpleAtomicHisto(100, -1, 1)},
-    {"track_tip_zoom", SimpleAtomicHisto(100, -0.05, 0.05)},
-    {"track_zip", SimpleAtomicHisto(100, -15, 15)},
-    {"track_zip_zoom", SimpleAtomicHisto(100, -0.1, 0.1)},
-    {"track_quality", SimpleAtomicHisto(6, 0, 6)},
-    {"vertex_n", SimpleAtomicHisto(60, 0, 60)},
-    {"vertex_z", SimpleAtomicHisto(100, -15, 15)},
-    {"vertex_chi2", SimpleAtomicHisto(100, 0, 40)},
-    {"vertex_ndof", SimpleAtomicHisto(170, 0, 170)},
-    {"vertex_pt2", SimpleAtomicHisto(100, 0, 4000)}};
+// in the order of the Histo enumeration
+ShardedHisto HistoValidator::histos({
+    {"digi_n", 100, 0, 1e5},
+    {"digi_adc", 250, 0, 5e4},
+    {"module_n", 100, 1500, 2000},
+    {"cluster_n", 200, 5000, 25000},
+    {"cluster_per_module_n", 110, 0, 110},
+    {"hit_n", 200, 5000, 25000},
+    {"hit_lx", 200, -1, 1},
+    {"hit_ly", 800, -4, 4},
+    {"hit_lex", 100, 0, 5e-5},
+    {"hit_ley", 100, 0, 1e-4},
+    {"hit_gx", 200, -20, 20},
+    {"hit_gy", 200, -20, 20},
+    {"hit_gz", 600, -60, 60},
+    {"hit_gr", 200, 0, 20},
+    {"hit_charge", 400, 0, 4e6},
+    {"hit_sizex", 800, 0, 800},
+    {"hit_sizey", 800, 0, 800},
+    {"track_n", 150, 0, 15000},
+    {"track_nhits", 3, 3, 6},
+    {"track_chi2", 100, 0, 40},
+    {"track_pt", 400, 0, 400},
+    {"track_eta", 100, -3, 3},
+    {"track_phi", 100, -3.15, 3.15},
+    {"track_tip", 100, -1, 1},
+    {"track_tip_zoom", 100, -0.05, 0.05},
+    {"track_zip", 100, -15, 15},
+    {"track_zip_zoom", 100, -0.1, 0.1},
+    {"track_quality", 6, 0, 6},
+    {"vertex_n", 60, 0, 60},
+    {"vertex_z", 100, -15, 15},
+    {"vertex_chi2", 100, 0, 40},
+    {"vertex_ndof", 170, 0, 170},
+    {"vertex_pt2", 100, 0, 4000}});
 
 HistoValidator::HistoValidator(edm::ProductRegistry& reg)
     : digiToken_(reg.consumes<cms::cuda::Product<SiPixelDigisCUDA>>()),
       clusterToken_(reg.consumes<cms::cuda::Product<SiPixelClustersCUDA>>()),
       hitToken_(reg.consumes<cms::cuda::Product<TrackingRecHit2DCUDA>>()),
       trackToken_(reg.consumes<PixelTrackHeterogeneous>()),
-      vertexToken_(reg.consumes<ZVertexHeterogeneous>()) {}
+      vertexToken_(reg.consumes<ZVertexHeterogeneous>()),
+      shard_(histos.makeShard()) {
+  assert(histos.size() == kNumberOfHistos);
+}
 
 void HistoValidator::acquire(const edm::Event& iEvent,
                              const edm::EventSetup& iSetup,
@@ -114,33 +156,27 @@ void HistoValidator::acquire(const edm::Event& iEvent,
 }
 
 void HistoValidator::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
-  histos["digi_n"].fill(nDigis);
-  for (uint32_t i = 0; i < nDigis; ++i) {
-    histos["digi_adc"].fill(h_adc[i]);
-  }
+  shard_.fill(kDigiN, nDigis);
+  shard_.fill(kDigiAdc, h_adc.get(), nDigis);
   h_adc.reset();
-  histos["module_n"].fill(nModules);
+  shard_.fill(kModuleN, nModules);
 
-  histos["cluster_n"].fill(nClusters);
-  for (uint32_t i = 0; i < nModules; ++i) {
-    histos["cluster_per_module_n"].fill(h_clusInModule[i]);
-  }
+  shard_.fill(kClusterN, nClusters);
+  shard_.fill(kClusterPerModuleN, h_clusInModule.get(), nModules);
   h_clusInModule.reset();
 
-  histos["hit_n"].fill(nHits);
-  for (uint32_t i = 0; i < nHits; ++i) {
-    histos["hit_lx"].fill(h_localCoord[i]);
-    histos["hit_ly"].fill(h_localCoord[i + nHits]);
-    histos["hit_lex"].fill(h_localCoord[i + 2 * nHits]);
-    histos["hit_ley"].fill(h_localCoord[i + 3 * nHits]);
-    histos["hit_gx"].fill(h_globalCoord[i]);
-    histos["hit_gy"].fill(h_globalCoord[i + nHits]);
-    histos["hit_gz"].fill(h_globalCoord[i + 2 * nHits]);
-    histos["hit_gr"].fill(h_globalCoord[i + 3 * nHits]);
-    histos["hit_charge"].fill(h_charge[i]);
-    histos["hit_sizex"].fill(h_size[i]);
-    histos["hit_sizey"].fill(h_size[i + nHits]);
-  }
+  shard_.fill(kHitN, nHits);
+  shard_.fill(kHitLx, h_localCoord.get(), nHits);
+  shard_.fill(kHitLy, h_localCoord.get() + nHits, nHits);
+  shard_.fill(kHitLex, h_localCoord.get() + 2 * nHits, nHits);
+  shard_.fill(kHitLey, h_localCoord.get() + 3 * nHits, nHits);
+  shard_.fill(kHitGx, h_globalCoord.get(), nHits);
+  shard_.fill(kHitGy, h_globalCoord.get() + nHits, nHits);
+  shard_.fill(kHitGz, h_globalCoord.get() + 2 * nHits, nHits);
+  shard_.fill(kHitGr, h_globalCoord.get() + 3 * nHits, nHits);
+  shard_.fill(kHitCharge, h_charge.get(), nHits);
+  shard_.fill(kHitSizex, h_size.get(), nHits);
+  shard_.fill(kHitSizey, h_size.get() + nHits, nHits);
   h_localCoord.reset();
   h_globalCoord.reset();
   h_charge.reset();
@@ -153,40 +189,38 @@ void HistoValidator::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
     for (int i = 0; i < tracks->stride(); ++i) {
       if (tracks->nHits(i) > 0) {
         ++nTracks;
-        histos["track_nhits"].fill(tracks->nHits(i));
-        histos["track_chi2"].fill(tracks->chi2(i));
-        histos["track_pt"].fill(tracks->pt(i));
-        histos["track_eta"].fill(tracks->eta(i));
-        histos["track_phi"].fill(tracks->phi(i));
-        histos["track_tip"].fill(tracks->tip(i));
-        histos["track_tip_zoom"].fill(tracks->tip(i));
-        histos["track_zip"].fill(tracks->zip(i));
-        histos["track_zip_zoom"].fill(tracks->zip(i));
-        histos["track_quality"].fill(tracks->quality(i));
+        shard_.fill(kTrackNhits, tracks->nHits(i));
+        shard_.fill(kTrackChi2, tracks->chi2(i));
+        shard_.fill(kTrackPt, tracks->pt(i));
+        shard_.fill(kTrackEta, tracks->eta(i));
+        shard_.fill(kTrackPhi, tracks->phi(i));
+        shard_.fill(kTrackTip, tracks->tip(i));
+        shard_.fill(kTrackTipZoom, tracks->tip(i));
+        shard_.fill(kTrackZip, tracks->zip(i));
+        shard_.fill(kTrackZipZoom, tracks->zip(i));
+        shard_.fill(kTrackQuality, tracks->quality(i));
       }
     }
 
-    histos["track_n"].fill(nTracks);
+    shard_.fill(kTrackN, nTracks);
   }
 
   {
     auto const& vertices = iEvent.get(vertexToken_);
 
-    histos["vertex_n"].fill(vertices->nvFinal);
-    for (uint32_t i = 0; i < vertices->nvFinal; ++i) {
-      histos["vertex_z"].fill(vertices->zv[i]);
-      histos["vertex_chi2"].fill(vertices->chi2[i]);
-      histos["vertex_ndof"].fill(vertices->ndof[i]);
-      histos["vertex_pt2"].fill(vertices->ptv2[i]);
-    }
+    auto const nVertices = vertices->nvFinal;
+    shard_.fill(kVertexN, nVertices);
+    shard_.fill(kVertexZ, vertices->zv, nVertices);
+    shard_.fill(kVertexChi2, vertices->chi2, nVertices);
+    shard_.fill(kVertexNdof, vertices->ndof, nVertices);
+    shard_.fill(kVertexPt2, vertices->ptv2, nVertices);
   }
 }
 
 void HistoValidator::endJob() {
+  // endJob() is called only for the modules of the first stream, after all the events
   std::ofstream out("histograms_cuda.txt");
-  for (auto const& elem : histos) {
-    out << elem.first << " " << elem.second << "\n";
-  }
+  histos.dump(out);
 }
 
 DEFINE_FWK_MODULE(HistoValidator);
@@ -0,0 +1,137 @@
+#ifndef ShardedHisto_h
+#define ShardedHisto_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A set of histograms identified by their index, filled through Shards
+// that are owned by a single thread (or edm stream) each, so that filling
+// needs neither atomics nor a look up by name. The Shards are summed at the
+// end, and the result is printed in the same format as SimpleAtomicHisto.
+//
+// The binning is that of SimpleAtomicHisto, with the underflow in the first
+// bin and the overflow (and NaN) in the last one.
+class ShardedHisto {
+public:
+  struct Spec {
+    std::string name;
+    int nbins;
+    float min;
+    float max;
+  };
+
+  class Shard {
+  public:
+    // not thread safe
+    void fill(unsigned int id, float value) {
+      auto const& h = histos_[id];
+      ++data_[h.offset + h.bin(value)];
+    }
+
+    // fills the histogram id with the n values; not thread safe
+    template <typename T>
+    void fill(unsigned int id, T const* values, std::size_t n) {
+      auto const& h = histos_[id];
+      int32_t* data = data_.data() + h.offset;
+      // the bins of a block of values are computed first, in a loop that the
+      // compiler can vectorise, and then they are incremented
+      constexpr std::size_t blockSize = 256;
+      int32_t bins[blockSize];
+      for (std::size_t begin = 0; begin < n; begin += blockSize) {
+        auto const size = std::min(blockSize, n - begin);
+        for (std::size_t i = 0; i < size; ++i) {
+          bins[i] = h.bin(static_cast<float>(values[begin + i]));
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+          ++data[bins[i]];
+        }
+      }
+    }
+
+  private:
+    friend class ShardedHisto;
+
+    struct Histo {
+      uint32_t offset;
+      int32_t nbins;
+      float min;
+      float max;
+
+      int32_t bin(float value) const {
+        // same arithmetic as SimpleAtomicHisto, without branches; the clamp
+        // handles the rounding near the maximum
+        float x = (value - min) / (max - min) * static_cast<float>(nbins);
+        x = std::min(std::max(0.f, x), static_cast<float>(nbins - 1));
+        int32_t i = static_cast<int32_t>(x) + 1;
+        i = value < max ? i : nbins + 1;
+        return value < min ? 0 : i;
+      }
+    };
+
+    explicit Shard(std::vector<Spec> const& specs) {
+      uint32_t size = 0;
+      histos_.reserve(specs.size());
+      for (auto const& spec : specs) {
+        histos_.push_back({size, spec.nbins, spec.min, spec.max});
+        size += spec.nbins + 2;
+      }
+      data_.resize(size, 0);
+    }
+
+    std::vector<Histo> histos_;
+    std::vector<int32_t> data_;
+  };
+
+  explicit ShardedHisto(std::vector<Spec> specs) : specs_(std::move(specs)) {}
+
+  std::size_t size() const { return specs_.size(); }
+
+  // thread safe; the Shard is owned by the ShardedHisto, and lives as long as it
+  Shard& makeShard() {
+    std::scoped_lock lock(mutex_);
+    shards_.push_back(std::unique_ptr<Shard>(new Shard(specs_)));
+    return *shards_.back();
+  }
+
+  // sums the Shards, that must not be filled concurrently, and prints the
+  // histograms ordered by name, one per line
+  void dump(std::ostream& os) const {
+    std::scoped_lock lock(mutex_);
+    Shard sum(specs_);
+    for (auto const& shard : shards_) {
+      for (std::size_t i = 0; i < sum.data_.size(); ++i) {
+        sum.data_[i] += shard->data_[i];
+      }
+    }
+
+    std::vector<unsigned int> order(specs_.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+      return specs_[a].name < specs_[b].name;
+    });
+    for (auto id : order) {
+      auto const& spec = specs_[id];
+      auto const* data = sum.data_.data() + sum.histos_[id].offset;
+      os << spec.name << " " << spec.nbins + 2 << " " << spec.min << " " << spec.max;
+      for (int i = 0; i < spec.nbins + 2; ++i) {
+        os << " " << data[i];
+      }
+      os << "\n";
+    }
+  }
+
+private:
+  std::vector<Spec> const specs_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+#endif
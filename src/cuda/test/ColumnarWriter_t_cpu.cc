@@ -0,0 +1,153 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Framework/BlockCompression.h"
+#include "Framework/ColumnarWriter.h"
+
+namespace {
+  void testRoundTrip(std::vector<std::byte> const& data, std::size_t elementSize) {
+    auto compressed = edm::blockCompression::compress(data.data(), data.size(), elementSize);
+    std::vector<std::byte> decompressed(data.size());
+    edm::blockCompression::decompress(
+        compressed.data(), compressed.size(), decompressed.data(), decompressed.size(), elementSize);
+    assert(data == decompressed);
+  }
+
+  template <typename T>
+  std::vector<std::byte> toBytes(std::vector<T> const& values) {
+    std::vector<std::byte> bytes(values.size() * sizeof(T));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+  }
+}  // namespace
+
+int main() {
+  std::mt19937 engine(42);
+
+  // block compression
+  {
+    testRoundTrip({}, 1);
+    testRoundTrip({std::byte{1}, std::byte{2}, std::byte{3}}, 4);
+
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<std::byte> random(100000);
+    for (auto& b : random)
+      b = std::byte(byte(engine));
+    testRoundTrip(random, 1);
+    testRoundTrip(random, 4);
+
+    std::vector<std::byte> repetitive(100003);
+    for (std::size_t i = 0; i < repetitive.size(); ++i)
+      repetitive[i] = std::byte(i % 7);
+    testRoundTrip(repetitive, 1);
+    testRoundTrip(repetitive, 2);
+
+    std::normal_distribution<float> gauss(0.f, 10.f);
+    std::vector<float> floats(50000);
+    for (auto& f : floats)
+      f = gauss(engine);
+    auto bytes = toBytes(floats);
+    testRoundTrip(bytes, 4);
+
+    std::vector<uint16_t> indices(50000);
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      indices[i] = i / 3;
+    bytes = toBytes(indices);
+    auto compressed = edm::blockCompression::compress(bytes.data(), bytes.size(), 2);
+    std::cout << "compressed " << bytes.size() << " bytes of indices to " << compressed.size() << std::endl;
+    assert(compressed.size() < bytes.size() / 4);
+    testRoundTrip(bytes, 2);
+
+    // corrupted data are detected
+    compressed.resize(compressed.size() / 2);
+    bool thrown = false;
+    try {
+      std::vector<std::byte> out(bytes.size());
+      edm::blockCompression::decompress(compressed.data(), compressed.size(), out.data(), out.size(), 2);
+    } catch (std::runtime_error const&) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+
+  // writer and reader
+  auto const fileName = std::filesystem::temp_directory_path() / "ColumnarWriter_t_cpu.pxcol";
+  for (auto compression : {edm::ColumnarWriter::Compression::kNone, edm::ColumnarWriter::Compression::kLZ}) {
+    constexpr int nThreads = 4;
+    constexpr int nEventsPerThread = 250;
+    std::size_t writtenBytes;
+    {
+      edm::ColumnarWriter writer(fileName,
+                                 {{"event", edm::ColumnarWriter::Type::kInt32},
+                                  {"n", edm::ColumnarWriter::Type::kUInt16},
+                                  {"value", edm::ColumnarWriter::Type::kFloat}},
+                                 compression,
+                                 64,
+                                 4);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&writer, t]() {
+          for (int i = 0; i < nEventsPerThread; ++i) {
+            int32_t event = t * nEventsPerThread + i;
+            auto record = writer.makeRecord();
+            record.push(0, event);
+            uint16_t n = event % 10;
+            record.push(1, n);
+            for (uint16_t j = 0; j < n; ++j)
+              record.push(2, 0.5f * event + j);
+            writer.write(std::move(record));
+          }
+        });
+      }
+      for (auto& thread : threads)
+        thread.join();
+      writer.close();
+      writer.close();
+      assert(writer.writtenEvents() == nThreads * nEventsPerThread);
+      writtenBytes = writer.writtenBytes();
+    }
+    std::cout << "wrote " << nThreads * nEventsPerThread << " events in " << writtenBytes << " bytes with compression "
+              << static_cast<int>(compression) << std::endl;
+
+    edm::ColumnarReader reader(fileName);
+    assert(reader.columns().size() == 3);
+    assert(reader.columns()[2].name == "value");
+    assert(reader.columns()[2].type == edm::ColumnarWriter::Type::kFloat);
+    std::vector<bool> seen(nThreads * nEventsPerThread, false);
+    uint32_t nEvents;
+    std::map<std::string, std::vector<std::byte>> columns;
+    while (reader.readChunk(nEvents, columns)) {
+      assert(nEvents > 0 and nEvents <= 64);
+      auto const* events = reinterpret_cast<int32_t const*>(columns["event"].data());
+      auto const* ns = reinterpret_cast<uint16_t const*>(columns["n"].data());
+      auto const* values = reinterpret_cast<float const*>(columns["value"].data());
+      assert(columns["event"].size() == nEvents * sizeof(int32_t));
+      assert(columns["n"].size() == nEvents * sizeof(uint16_t));
+      std::size_t offset = 0;
+      for (uint32_t i = 0; i < nEvents; ++i) {
+        auto const event = events[i];
+        assert(not seen[event]);
+        seen[event] = true;
+        assert(ns[i] == event % 10);
+        for (uint16_t j = 0; j < ns[i]; ++j, ++offset)
+          assert(values[offset] == 0.5f * event + j);
+      }
+      assert(columns["value"].size() == offset * sizeof(float));
+    }
+    for (bool s : seen)
+      assert(s);
+  }
+  std::filesystem::remove(fileName);
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
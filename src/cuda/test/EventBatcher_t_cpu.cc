@@ -0,0 +1,72 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "Framework/EventBatcher.h"
+
+int main() {
+  // 3 streams, batches of up to 2 events
+  edm::EventBatcher<int> batcher(2);
+  batcher.addStream();
+  batcher.addStream();
+  batcher.addStream();
+
+  assert(batcher.add(1).empty());
+  auto batch = batcher.add(2);
+  assert((batch == std::vector<int>{1, 2}));
+
+  assert(batcher.add(3).empty());
+  assert(batcher.add(4).size() == 2);
+
+  // one stream is done, the pending event of another stream is processed
+  // alone once the last running stream is done too
+  assert(batcher.add(5).empty());
+  assert(batcher.removeStream().empty());
+  batch = batcher.removeStream();
+  assert((batch == std::vector<int>{5}));
+
+  // with a single stream every event is a batch by itself
+  assert(batcher.add(6).size() == 1);
+  assert(batcher.removeStream().empty());
+
+  // batches larger than the number of streams are completed by one event per stream
+  edm::EventBatcher<int> large(8);
+  large.addStream();
+  large.addStream();
+  assert(large.add(1).empty());
+  assert(large.add(2).size() == 2);
+
+  // a batch that crosses the boundary between two intervals of validity is
+  // processed in two groups, each with the ES products of its own events
+  struct Entry {
+    int event;
+    int const* gains;
+  };
+  int const gainsIOV1 = 1;
+  int const gainsIOV2 = 2;
+  edm::EventBatcher<Entry> iovs(4);
+  for (int i = 0; i < 4; ++i) {
+    iovs.addStream();
+  }
+  assert(iovs.add({8, &gainsIOV1}).empty());
+  assert(iovs.add({9, &gainsIOV1}).empty());
+  assert(iovs.add({10, &gainsIOV2}).empty());
+  auto iovBatch = iovs.add({11, &gainsIOV2});
+  assert(iovBatch.size() == 4);
+  std::vector<std::vector<int>> groups;
+  edm::forEachGroup(
+      iovBatch,
+      [](Entry const& a, Entry const& b) { return a.gains == b.gains; },
+      [&](auto begin, auto end) {
+        std::vector<int> group;
+        for (auto entry = begin; entry != end; ++entry) {
+          assert(entry->gains == (end - 1)->gains);
+          group.push_back(entry->event);
+        }
+        groups.push_back(group);
+      });
+  assert((groups == std::vector<std::vector<int>>{{8, 9}, {10, 11}}));
+
+  std::cout << "EventBatcher test passed" << std::endl;
+  return 0;
+}
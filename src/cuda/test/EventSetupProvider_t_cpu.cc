@@ -0,0 +1,146 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Framework/ESProducer.h"
+#include "Framework/EventSetup.h"
+#include "Framework/EventSetupProvider.h"
+
+namespace {
+  int nAlive = 0;
+
+  struct Conditions {
+    explicit Conditions(int v) : firstEvent(v) { ++nAlive; }
+    ~Conditions() { --nAlive; }
+    int firstEvent;
+  };
+
+  // conditions with intervals of validity starting at the events 1, 10 and 20
+  class ConditionsESProducer : public edm::ESProducer {
+  public:
+    void produce(edm::EventSetup& eventSetup) override { eventSetup.put(std::make_unique<Conditions>(1)); }
+    std::vector<int> iovBoundaries() const override { return {10, 20}; }
+    void produceIOV(edm::EventSetup& eventSetup, edm::IOV const& iov) override {
+      eventSetup.put(std::make_unique<Conditions>(iov.first));
+    }
+  };
+
+  // constant for the whole job
+  class GeometryESProducer : public edm::ESProducer {
+  public:
+    void produce(edm::EventSetup& eventSetup) override { eventSetup.put(std::make_unique<double>(3.14)); }
+  };
+
+  // does not produce the same products in all the intervals of validity
+  class BrokenESProducer : public edm::ESProducer {
+  public:
+    void produce(edm::EventSetup& eventSetup) override { eventSetup.put(std::make_unique<float>(1.f)); }
+    std::vector<int> iovBoundaries() const override { return {5}; }
+    void produceIOV(edm::EventSetup& eventSetup, edm::IOV const& iov) override {}
+  };
+}  // namespace
+
+int main() {
+  {
+    edm::EventSetupProvider provider;
+    edm::EventSetup eventSetup;
+    provider.add("ConditionsESProducer", std::make_unique<ConditionsESProducer>(), eventSetup);
+    provider.add("GeometryESProducer", std::make_unique<GeometryESProducer>(), eventSetup);
+
+    // two streams
+    auto stream1 = eventSetup;
+    auto stream2 = eventSetup;
+    eventSetup = edm::EventSetup();
+    auto const* geometry = &stream1.get<double>();
+
+    provider.update(stream1, 1);
+    provider.update(stream2, 2);
+    assert(stream1.get<Conditions>().firstEvent == 1);
+    assert(&stream1.get<Conditions>() == &stream2.get<Conditions>());
+    assert(provider.reloads() == 0);
+
+    // the first stream enters the second interval of validity, while the second one still uses the first
+    provider.update(stream1, 11);
+    assert(stream1.get<Conditions>().firstEvent == 10);
+    assert(stream2.get<Conditions>().firstEvent == 1);
+    assert(&stream1.get<double>() == geometry);
+    assert(nAlive == 2);
+    assert(provider.reloads() == 1);
+
+    // the second stream reuses the products of the first one, and the previous ones are deleted
+    provider.update(stream2, 12);
+    assert(&stream1.get<Conditions>() == &stream2.get<Conditions>());
+    assert(nAlive == 1);
+    assert(provider.reloads() == 1);
+
+    // an interval of validity that nobody uses any more is produced again
+    provider.update(stream1, 25);
+    provider.update(stream2, 26);
+    assert(stream2.get<Conditions>().firstEvent == 20);
+    assert(nAlive == 1);
+    assert(provider.reloads() == 2);
+    provider.update(stream1, 15);
+    assert(stream1.get<Conditions>().firstEvent == 10);
+    assert(nAlive == 2);
+    assert(provider.reloads() == 3);
+    assert(&stream1.get<double>() == geometry);
+  }
+  assert(nAlive == 0);
+
+  {
+    edm::EventSetupProvider provider;
+    edm::EventSetup eventSetup;
+    provider.add("BrokenESProducer", std::make_unique<BrokenESProducer>(), eventSetup);
+    bool thrown = false;
+    try {
+      provider.update(eventSetup, 5);
+    } catch (std::runtime_error const& e) {
+      std::cout << "Caught expected exception: " << e.what() << std::endl;
+      thrown = true;
+    }
+    assert(thrown);
+  }
+
+  {
+    // the producers run concurrently, the products are put in the order of the names
+    edm::EventSetupProvider provider;
+    edm::EventSetup eventSetup;
+    std::vector<std::string> names = {"GeometryESProducer", "ConditionsESProducer"};
+    provider.add(
+        names,
+        [](std::string const& name) -> std::unique_ptr<edm::ESProducer> {
+          if (name == "ConditionsESProducer") {
+            return std::make_unique<ConditionsESProducer>();
+          }
+          return std::make_unique<GeometryESProducer>();
+        },
+        eventSetup);
+    assert(eventSetup.get<Conditions>().firstEvent == 1);
+    assert(eventSetup.get<double>() == 3.14);
+    assert(nAlive == 1);
+
+    provider.update(eventSetup, 10);
+    assert(eventSetup.get<Conditions>().firstEvent == 10);
+    assert(provider.reloads() == 1);
+
+    // a product of the same type as a product of a previous producer
+    bool thrown = false;
+    try {
+      provider.add(
+          {"GeometryESProducer"},
+          [](std::string const&) { return std::make_unique<GeometryESProducer>(); },
+          eventSetup);
+    } catch (std::runtime_error const& e) {
+      std::cout << "Caught expected exception: " << e.what() << std::endl;
+      thrown = true;
+    }
+    assert(thrown);
+  }
+  assert(nAlive == 0);
+
+  std::cout << "EventSetupProvider test passed" << std::endl;
+  return 0;
+}
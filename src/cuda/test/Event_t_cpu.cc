@@ -0,0 +1,87 @@
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "Framework/Event.h"
+#include "Framework/ProductRegistry.h"
+
+namespace {
+  std::atomic<long> nAllocations = 0;
+
+  int nAlive = 0;
+
+  struct Counted {
+    explicit Counted(int v) : value(v) { ++nAlive; }
+    ~Counted() { --nAlive; }
+    int value;
+  };
+
+  // larger than the default chunk of the EventArena, to force it to grow
+  struct Large {
+    explicit Large(double v) { data.fill(v); }
+    std::array<double, 1024> data;
+  };
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++nAllocations;
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main() {
+  edm::ProductRegistry reg;
+  auto intToken = reg.produces<int>();
+  auto countedToken = reg.produces<Counted>();
+  auto largeToken = reg.produces<Large>();
+  auto intGetToken = reg.consumes<int>();
+  auto countedGetToken = reg.consumes<Counted>();
+  auto largeGetToken = reg.consumes<Large>();
+
+  edm::Event event(0, 0, reg);
+
+  constexpr int warmup = 2;
+  constexpr int nEvents = 100;
+  long steadyAllocations = 0;
+  for (int i = 1; i <= nEvents; ++i) {
+    auto before = nAllocations.load();
+
+    event.setEventID(i);
+    event.emplace(intToken, i);
+    event.emplace(countedToken, 2 * i);
+    event.emplace(largeToken, 3. * i);
+    // replacing a product destroys the previous one
+    event.emplace(countedToken, 4 * i);
+    assert(nAlive == 1);
+
+    assert(event.eventID() == i);
+    assert(event.get(intGetToken) == i);
+    assert(event.get(countedGetToken).value == 4 * i);
+    assert(event.get(largeGetToken).data.front() == 3. * i);
+    assert(event.get(largeGetToken).data.back() == 3. * i);
+
+    event.clear();
+    assert(nAlive == 0);
+
+    if (i > warmup) {
+      steadyAllocations += nAllocations.load() - before;
+    }
+  }
+
+  std::cout << "EventArena capacity " << event.arena().capacity() << " bytes in "
+            << event.arena().chunkAllocations() << " chunk allocations, " << steadyAllocations
+            << " allocations after the first " << warmup << " events" << std::endl;
+  assert(steadyAllocations == 0);
+  assert(event.arena().capacity() >= sizeof(Large));
+
+  return 0;
+}
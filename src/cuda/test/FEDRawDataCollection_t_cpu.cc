@@ -0,0 +1,85 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "DataFormats/FEDRawDataCollection.h"
+
+namespace {
+  std::atomic<int> nDecompressed = 0;
+
+  // a trivial "compression": the bytes are stored inverted
+  void invert(FEDRawData const& compressed, unsigned char* output, std::size_t size) {
+    assert(compressed.size() == size - 8);
+    for (std::size_t i = 0; i < size; ++i) {
+      output[i] = i < compressed.size() ? ~compressed.data()[i] : 0;
+    }
+    ++nDecompressed;
+  }
+}  // namespace
+
+int main() {
+  std::vector<unsigned char> arena(64 + 24, 0);
+  for (std::size_t i = 0; i < 64; ++i) {
+    arena[i] = i;
+  }
+  for (std::size_t i = 64; i < arena.size(); ++i) {
+    arena[i] = ~static_cast<unsigned char>(i);
+  }
+
+  // an uncompressed view, FEDs 1200 and 1201
+  FEDRawDataCollection::View view;
+  view.fedIds = {1200, 1201};
+  view.data = {FEDRawData(arena.data(), 32), FEDRawData(arena.data() + 32, 32)};
+  FEDRawDataCollection const raw(&view);
+  assert(raw.FEDData(1200).data() == arena.data());
+  assert(raw.FEDData(1201).size() == 32);
+  assert(raw.FEDData(1202).size() == 0);
+
+  // FED 1201 is stored as it is, FED 1205 "compressed"
+  FEDRawDataCollection::View compressed;
+  compressed.fedIds = {1201, 1205};
+  compressed.data = {FEDRawData(arena.data(), 64), FEDRawData(arena.data() + 64, 24)};
+  compressed.sizes = {64, 32};
+  compressed.decompress = invert;
+
+  FEDRawDataCollection const original(&compressed);
+  assert(original.FEDData(1201).data() == arena.data());
+  assert(original.FEDData(1203).size() == 0);
+  assert(nDecompressed == 0);
+
+  for (int copy = 0; copy < 2; ++copy) {
+    // each copy decompresses the FEDs once, also when they are accessed concurrently
+    FEDRawDataCollection event(original);
+    auto const& cevent = event;
+    std::vector<std::thread> threads;
+    std::atomic<int> nGood = 0;
+    for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&cevent, &nGood]() {
+        auto const& data = cevent.FEDData(1205);
+        bool good = data.size() == 32;
+        for (std::size_t i = 0; i < 24; ++i) {
+          good = good and data.data()[i] == 64 + i;
+        }
+        if (good) {
+          ++nGood;
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    assert(nGood == 8);
+    assert(nDecompressed == copy + 1);
+
+    FEDRawDataCollection const moved(std::move(event));
+    assert(moved.FEDData(1205).size() == 32);
+    assert(nDecompressed == copy + 1);
+  }
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DataFormats/FEDHeader.h"
+#include "DataFormats/FEDRawDataCollection.h"
+#include "DataFormats/FEDTrailer.h"
+#include "DataFormats/PixelErrors.h"
+#include "plugin-SiPixelClusterizer/FEDWordGatherer.h"
+// the ErrorChecker is built in the plugin, that the tests do not link
+#include "plugin-SiPixelClusterizer/ErrorChecker.cc"
+
+namespace {
+  struct Reference {
+    std::vector<uint32_t> words;
+    std::vector<unsigned char> fedIds;
+    unsigned int fedCounter = 0;
+    bool errorsInEvent = false;
+    PixelFormatterErrors errors;
+  };
+
+  // the serial loop of PixelDataFormatter::interpretRawData()
+  Reference interpretRawData(FEDRawDataCollection const& buffers, std::vector<unsigned int> const& fedIds) {
+    Reference ref;
+    ErrorChecker errorcheck;
+    for (int fedId : fedIds) {
+      if (fedId == 40)
+        continue;
+      ++ref.fedCounter;
+      FEDRawData const& rawData = buffers.FEDData(fedId);
+      int nWords = rawData.size() / sizeof(uint64_t);
+      if (nWords == 0)
+        continue;
+      uint64_t const* trailer = reinterpret_cast<uint64_t const*>(rawData.data()) + (nWords - 1);
+      if (not errorcheck.checkCRC(ref.errorsInEvent, fedId, trailer, ref.errors))
+        continue;
+      uint64_t const* header = reinterpret_cast<uint64_t const*>(rawData.data());
+      header--;
+      bool moreHeaders = true;
+      while (moreHeaders) {
+        header++;
+        moreHeaders = errorcheck.checkHeader(ref.errorsInEvent, fedId, header, ref.errors);
+      }
+      bool moreTrailers = true;
+      trailer++;
+      while (moreTrailers) {
+        trailer--;
+        moreTrailers = errorcheck.checkTrailer(ref.errorsInEvent, fedId, nWords, trailer, ref.errors);
+      }
+      uint32_t const* bw = reinterpret_cast<uint32_t const*>(header + 1);
+      uint32_t const* ew = reinterpret_cast<uint32_t const*>(trailer);
+      ref.words.insert(ref.words.end(), bw, ew);
+      ref.fedIds.insert(ref.fedIds.end(), (ew - bw) / 2, fedId - 1200);
+    }
+    return ref;
+  }
+
+  bool sameErrors(PixelFormatterErrors const& a, PixelFormatterErrors const& b) {
+    if (a.size() != b.size())
+      return false;
+    for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib) {
+      if (ia->first != ib->first or ia->second.size() != ib->second.size())
+        return false;
+      for (std::size_t i = 0; i < ia->second.size(); ++i) {
+        auto const& ea = ia->second[i];
+        auto const& eb = ib->second[i];
+        if (ea.getWord64() != eb.getWord64() or ea.getType() != eb.getType() or ea.getFedId() != eb.getFedId())
+          return false;
+      }
+    }
+    return true;
+  }
+
+  // fills the FED with nHeaders headers, nPayload 32-bit words and a trailer
+  void fillFED(FEDRawData& fed, unsigned int fedId, int nHeaders, int nPayload, std::mt19937& engine) {
+    int const size = nHeaders + nPayload / 2 + 1;
+    fed.resize(sizeof(uint64_t) * size);
+    for (int h = 0; h < nHeaders; ++h) {
+      FEDHeader::set(fed.data() + sizeof(uint64_t) * h, 1, 2, 3, fedId, 0, h + 1 < nHeaders);
+    }
+    auto* payload = reinterpret_cast<uint32_t*>(fed.data() + sizeof(uint64_t) * nHeaders);
+    for (int i = 0; i < nPayload; ++i) {
+      payload[i] = engine();
+    }
+    FEDTrailer::set(fed.data() + sizeof(uint64_t) * (size - 1), size, 0, 0, 0, false);
+  }
+
+  // copies the words to destinations with every alignment, and checks that
+  // nothing is written outside of them
+  void checkCopy(FEDWordGatherer const& gatherer, Reference const& ref) {
+    constexpr uint32_t guardWord = 0xdeadbeef;
+    constexpr unsigned char guardFedId = 0xa5;
+    constexpr std::size_t guard = 16;
+    for (std::size_t shift = 0; shift < 16; ++shift) {
+      std::vector<uint32_t> words(ref.words.size() + shift % 4 + guard, guardWord);
+      std::vector<unsigned char> fedIds(ref.fedIds.size() + shift + guard, guardFedId);
+      gatherer.copy(words.data() + shift % 4, fedIds.data() + shift);
+      assert(std::all_of(words.begin(), words.begin() + shift % 4, [](auto w) { return w == guardWord; }));
+      assert(std::equal(ref.words.begin(), ref.words.end(), words.begin() + shift % 4));
+      assert(std::all_of(words.end() - guard, words.end(), [](auto w) { return w == guardWord; }));
+      assert(std::all_of(fedIds.begin(), fedIds.begin() + shift, [](auto f) { return f == guardFedId; }));
+      assert(std::equal(ref.fedIds.begin(), ref.fedIds.end(), fedIds.begin() + shift));
+      assert(std::all_of(fedIds.end() - guard, fedIds.end(), [](auto f) { return f == guardFedId; }));
+    }
+  }
+
+  void check(FEDRawDataCollection const& buffers, std::vector<unsigned int> const& fedIds) {
+    auto const ref = interpretRawData(buffers, fedIds);
+    for (bool nonTemporal : {false, true}) {
+      FEDWordGatherer gatherer(nonTemporal);
+      // the errors are appended to the ones already there
+      PixelFormatterErrors errors;
+      errors[1].emplace_back(uint64_t(42), 39, 1299);
+      auto expected = errors;
+      for (auto const& [detId, detErrors] : ref.errors) {
+        expected[detId].insert(expected[detId].end(), detErrors.begin(), detErrors.end());
+      }
+      bool errorsInEvent = false;
+      auto nWords = gatherer.scan(buffers, fedIds, errorsInEvent, errors);
+      assert(nWords == ref.words.size());
+      assert(gatherer.fedCounter() == ref.fedCounter);
+      assert(errorsInEvent == ref.errorsInEvent);
+      assert(sameErrors(errors, expected));
+      checkCopy(gatherer, ref);
+    }
+  }
+}  // namespace
+
+int main() {
+  std::mt19937 engine(42);
+
+  // FEDs with short runs of words, including none, and more than one header
+  {
+    FEDRawDataCollection raw;
+    std::vector<unsigned int> fedIds{40};
+    for (unsigned int fedId = 1200; fedId < 1240; ++fedId) {
+      fedIds.push_back(fedId);
+      if (fedId % 5 == 0)
+        continue;  // empty FED
+      fillFED(raw.FEDData(fedId), fedId, fedId % 3 == 0 ? 2 : 1, 2 * (fedId % 9), engine);
+    }
+    FEDRawDataCollection const& buffers = raw;
+    check(buffers, fedIds);
+  }
+
+  // FEDs of realistic size, with a wrong source id in a header, a CRC error, and a wrong length
+  {
+    FEDRawDataCollection raw;
+    std::vector<unsigned int> fedIds;
+    for (unsigned int fedId = 1200; fedId < 1300; ++fedId) {
+      fedIds.push_back(fedId);
+      if (fedId % 7 == 0)
+        continue;
+      auto& fed = raw.FEDData(fedId);
+      fillFED(fed, fedId, 1, 2 * (engine() % 500), engine);
+      auto* trailer = fed.data() + fed.size() - sizeof(uint64_t);
+      if (fedId == 1210) {
+        FEDHeader::set(fed.data(), 1, 2, 3, 1211, 0, false);
+      } else if (fedId == 1220) {
+        trailer[0] |= 0x4;  // CRC bit
+      } else if (fedId == 1230) {
+        FEDTrailer::set(trailer, fed.size() / sizeof(uint64_t) + 1, 0, 0, 0, false);
+      }
+    }
+    FEDRawDataCollection const& buffers = raw;
+    auto const ref = interpretRawData(buffers, fedIds);
+    assert(ref.errorsInEvent);
+    assert(ref.fedIds.size() * 2 == ref.words.size());
+    check(buffers, fedIds);
+  }
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "CUDACore/cudaCompat.h"
+#include "CUDADataFormats/PixelTrackCompact.h"
+#include "CUDADataFormats/ZVertexCompact.h"
+
+int main() {
+  using pixelTrack::TrackSoA;
+  using pixelTrack::TrackSoACompact;
+
+  // tracks with 3, 4 and 5 hits, followed by empty slots
+  constexpr uint32_t nTracks = 1000;
+  auto tracks = std::make_unique<TrackSoA>();
+  uint32_t nHits = 0;
+  for (uint32_t i = 0; i < nTracks; ++i) {
+    tracks->hitIndices.off[i] = nHits;
+    tracks->detIndices.off[i] = nHits;
+    for (uint32_t j = 0; j < 3 + i % 3; ++j, ++nHits) {
+      tracks->hitIndices.bins[nHits] = i + j;
+      tracks->detIndices.bins[nHits] = 2 * (i + j);
+    }
+    tracks->quality(i) = trackQuality::Quality(i % 6);
+    tracks->chi2(i) = 0.5f * i;
+    tracks->pt(i) = 1.f + i;
+    tracks->eta(i) = -0.001f * i;
+    for (int k = 0; k < 5; ++k)
+      tracks->stateAtBS.state(i)(k) = (k % 2 ? -1.f : 1.f) * (i + k);
+    for (int k = 0; k < 15; ++k)
+      tracks->stateAtBS.covariance(i)(k) = i * 100 + k;
+  }
+  for (uint32_t i = nTracks; i < TrackSoA::HitContainer::totbins(); ++i) {
+    tracks->hitIndices.off[i] = nHits;
+    tracks->detIndices.off[i] = nHits;
+  }
+
+  constexpr auto S = TrackSoA::stride();
+  std::vector<uint8_t> buffer(TrackSoACompact::maxBufferSize());
+  cudaCompat::launch<pixelTrack::countTracks<S>>(cudaCompat::cpuGridSize(), tracks.get(), buffer.data());
+  cudaCompat::launch<pixelTrack::packTracks<S>>(cudaCompat::cpuGridSize(), tracks.get(), buffer.data());
+
+  TrackSoACompact compact(buffer.data());
+  std::cout << "packed " << compact.nTracks() << " tracks with " << compact.nHits() << " hits in "
+            << compact.bufferSize() << " bytes, instead of " << sizeof(TrackSoA) << std::endl;
+  assert(nTracks == compact.nTracks());
+  assert(nHits == compact.nHits());
+  assert(compact.bufferSize() < sizeof(TrackSoA));
+  for (uint32_t i = 0; i < nTracks; ++i) {
+    assert(tracks->nHits(i) == compact.nHits(i));
+    assert(tracks->quality(i) == compact.quality(i));
+    assert(tracks->phi(i) == compact.phi(i));
+    assert(tracks->zip(i) == compact.zip(i));
+    assert(tracks->charge(i) == compact.charge(i));
+    assert(tracks->hitIndices.begin(i)[0] == compact.hitsBegin(i)[0]);
+    assert(tracks->detIndices.begin(i)[0] == compact.detsBegin(i)[0]);
+  }
+
+  auto unpacked = std::make_unique<TrackSoA>();
+  compact.unpack(*unpacked);
+  assert(nTracks == unpacked->m_nTracks);
+  for (int32_t i = 0; i < TrackSoA::stride(); ++i) {
+    assert(tracks->nHits(i) == unpacked->nHits(i));
+    if (tracks->nHits(i) == 0)
+      continue;
+    assert(tracks->quality(i) == unpacked->quality(i));
+    assert(tracks->chi2(i) == unpacked->chi2(i));
+    assert(tracks->pt(i) == unpacked->pt(i));
+    assert(tracks->eta(i) == unpacked->eta(i));
+    for (int k = 0; k < 5; ++k)
+      assert(tracks->stateAtBS.state(i)(k) == unpacked->stateAtBS.state(i)(k));
+    for (int k = 0; k < 15; ++k)
+      assert(tracks->stateAtBS.covariance(i)(k) == unpacked->stateAtBS.covariance(i)(k));
+    for (auto h = tracks->hitIndices.begin(i), u = unpacked->hitIndices.begin(i); h != tracks->hitIndices.end(i);
+         ++h, ++u)
+      assert(*h == *u);
+    for (auto h = tracks->detIndices.begin(i), u = unpacked->detIndices.begin(i); h != tracks->detIndices.end(i);
+         ++h, ++u)
+      assert(*h == *u);
+  }
+
+  // no tracks at all
+  for (uint32_t i = 0; i < TrackSoA::HitContainer::totbins(); ++i) {
+    tracks->hitIndices.off[i] = 0;
+  }
+  cudaCompat::launch<pixelTrack::countTracks<S>>(cudaCompat::cpuGridSize(), tracks.get(), buffer.data());
+  assert(0 == compact.nTracks());
+  assert(0 == compact.nHits());
+
+  // vertices
+  auto vertices = std::make_unique<ZVertexSoA>();
+  vertices->init();
+  vertices->nvFinal = 20;
+  vertices->nTracks = 300;
+  for (uint32_t i = 0; i < vertices->nvFinal; ++i) {
+    vertices->zv[i] = 0.1f * i;
+    vertices->wv[i] = 1.f + i;
+    vertices->chi2[i] = 2.f * i;
+    vertices->ptv2[i] = 10.f * i;
+    vertices->ndof[i] = i;
+    vertices->sortInd[i] = vertices->nvFinal - 1 - i;
+  }
+  for (uint32_t i = 0; i < vertices->nTracks; ++i) {
+    vertices->idv[i] = i % 21 - 1;
+  }
+
+  std::vector<uint8_t> vbuffer(ZVertexCompact::maxBufferSize());
+  cudaCompat::launch<gpuVertexFinder::packVertices>(cudaCompat::cpuGridSize(), vertices.get(), vbuffer.data());
+  ZVertexCompact vcompact(vbuffer.data());
+  std::cout << "packed " << vcompact.nvFinal() << " vertices and " << vcompact.nTracks() << " tracks in "
+            << vcompact.bufferSize() << " bytes, instead of " << sizeof(ZVertexSoA) << std::endl;
+  assert(vcompact.bufferSize() == ZVertexCompact::bufferSize(20, 300));
+
+  auto vunpacked = std::make_unique<ZVertexSoA>();
+  vcompact.unpack(*vunpacked);
+  assert(vertices->nvFinal == vunpacked->nvFinal);
+  assert(vertices->nTracks == vunpacked->nTracks);
+  for (uint32_t i = 0; i < vertices->nvFinal; ++i) {
+    assert(vertices->zv[i] == vunpacked->zv[i]);
+    assert(vertices->wv[i] == vunpacked->wv[i]);
+    assert(vertices->chi2[i] == vunpacked->chi2[i]);
+    assert(vertices->ptv2[i] == vunpacked->ptv2[i]);
+    assert(vertices->ndof[i] == vunpacked->ndof[i]);
+    assert(vertices->sortInd[i] == vunpacked->sortInd[i]);
+  }
+  for (uint32_t i = 0; i < vertices->nTracks; ++i) {
+    assert(vertices->idv[i] == vunpacked->idv[i]);
+  }
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "plugin-Validation/ShardedHisto.h"
+#include "plugin-Validation/SimpleAtomicHisto.h"
+
+int main() {
+  // the same binning as SimpleAtomicHisto, including the edges
+  {
+    ShardedHisto histos({{"b", 10, 0, 1}, {"a", 3, 3, 6}});
+    auto& shard = histos.makeShard();
+    for (float v : {-0.1f, 1.1f, 0.f, 0.1f, 0.0999f, 0.2f, 0.9f, 0.9999999f, 1.f}) {
+      shard.fill(0, v);
+    }
+    // NaN goes to the overflow
+    shard.fill(0, std::numeric_limits<float>::quiet_NaN());
+    shard.fill(1, uint8_t(4));
+
+    std::stringstream ss;
+    histos.dump(ss);
+    assert(ss.str() == "a 5 3 6 0 0 1 0 0\nb 12 0 1 1 2 1 1 0 0 0 0 0 0 2 3\n");
+  }
+
+  // the shards filled by several threads with arrays of values are summed
+  {
+    constexpr int nThreads = 4;
+    constexpr int nValues = 100000;
+    ShardedHisto histos({{"adc", 250, 0, 5e4}, {"x", 200, -1, 1}});
+    SimpleAtomicHisto refAdc(250, 0, 5e4);
+    SimpleAtomicHisto refX(200, -1, 1);
+
+    std::vector<std::vector<uint16_t>> adcs(nThreads);
+    std::vector<std::vector<float>> xs(nThreads);
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<int> adc(0, 65535);
+    std::normal_distribution<float> x(0.f, 0.5f);
+    for (int t = 0; t < nThreads; ++t) {
+      for (int i = 0; i < nValues + t; ++i) {
+        adcs[t].push_back(adc(engine));
+        xs[t].push_back(x(engine));
+        refAdc.fill(adcs[t].back());
+        refX.fill(xs[t].back());
+      }
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+      threads.emplace_back([&histos, &adcs, &xs, t]() {
+        auto& shard = histos.makeShard();
+        shard.fill(0, adcs[t].data(), adcs[t].size());
+        shard.fill(1, xs[t].data(), xs[t].size());
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+
+    std::stringstream ss;
+    histos.dump(ss);
+    std::stringstream sref;
+    sref << "adc " << refAdc << "\nx " << refX << "\n";
+    assert(ss.str() == sref.str());
+  }
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
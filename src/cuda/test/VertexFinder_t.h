@@ -1,6 +1,8 @@
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -15,6 +17,9 @@
 #else
 #include "plugin-PixelVertexFinding/gpuClusterTracksByDensity.h"
 #define CLUSTERIZE clusterTracksByDensityKernel
+#ifndef ONE_KERNEL
+#define MULTI_BLOCK
+#endif
 #endif
 #include "plugin-PixelVertexFinding/gpuFitVertices.h"
 #include "plugin-PixelVertexFinding/gpuSortByPt2.h"
@@ -111,6 +116,19 @@ __global__ void print(ZVertices const* pdata, WorkSpace const* pws) {
   printf("nt,nv %d %d,%d\n", ws.ntrks, data.nvFinal, ws.nvIntermediate);
 }
 
+#ifdef MULTI_BLOCK
+// checks that the multi-block density clustering finds the same clusters as the single-block one,
+// with the vertices in the same order
+void checkMultiBlock(ZVertices const& data, WorkSpace const& ws, ZVertices const& dataMB, WorkSpace const& wsMB) {
+  assert(data.nvFinal == dataMB.nvFinal);
+  for (auto i = 0U; i < ws.ntrks; ++i) {
+    assert(data.ndof[i] == dataMB.ndof[i]);
+    assert(ws.iv[i] == wsMB.iv[i]);
+  }
+  std::cout << "multi-block clustering: same " << dataMB.nvFinal << " vertices" << std::endl;
+}
+#endif
+
 int main() {
 #ifdef __CUDACC__
   auto onGPU_d = cms::cuda::make_device_unique<ZVertices[]>(1, nullptr);
@@ -118,6 +136,15 @@ int main() {
 #else
   auto onGPU_d = std::make_unique<ZVertices>();
   auto ws_d = std::make_unique<WorkSpace>();
+#endif
+#ifdef MULTI_BLOCK
+#ifdef __CUDACC__
+  auto onGPUMB_d = cms::cuda::make_device_unique<ZVertices[]>(1, nullptr);
+  auto wsMB_d = cms::cuda::make_device_unique<WorkSpace[]>(1, nullptr);
+#else
+  auto onGPUMB_d = std::make_unique<ZVertices>();
+  auto wsMB_d = std::make_unique<WorkSpace>();
+#endif
 #endif
 
   Event ev;
@@ -165,6 +192,17 @@ int main() {
         par = {{0.7f * eps, 0.01f, 9.0f}};
 
       uint32_t nv = 0;
+#ifdef MULTI_BLOCK
+      // same input for the multi-block clustering
+#ifdef __CUDACC__
+      cudaCheck(cudaMemcpy(onGPUMB_d.get(), onGPU_d.get(), sizeof(ZVertices), cudaMemcpyDeviceToDevice));
+      cudaCheck(cudaMemcpy(wsMB_d.get(), ws_d.get(), sizeof(WorkSpace), cudaMemcpyDeviceToDevice));
+#else
+      *onGPUMB_d = *onGPU_d;
+      *wsMB_d = *ws_d;
+#endif
+#endif
+
 #ifdef __CUDACC__
       print<<<1, 1, 0, 0>>>(onGPU_d.get(), ws_d.get());
       cudaCheck(cudaGetLastError());
@@ -180,6 +218,21 @@ int main() {
       cudaCheck(cudaGetLastError());
       cudaDeviceSynchronize();
 
+#ifdef MULTI_BLOCK
+      clusterTracksByDensityMultiBlock(onGPUMB_d.get(), wsMB_d.get(), kk, par[0], par[1], par[2], 0);
+      {
+        auto data = std::make_unique<ZVertices>();
+        auto ws = std::make_unique<WorkSpace>();
+        auto dataMB = std::make_unique<ZVertices>();
+        auto wsMB = std::make_unique<WorkSpace>();
+        cudaCheck(cudaMemcpy(data.get(), onGPU_d.get(), sizeof(ZVertices), cudaMemcpyDeviceToHost));
+        cudaCheck(cudaMemcpy(ws.get(), ws_d.get(), sizeof(WorkSpace), cudaMemcpyDeviceToHost));
+        cudaCheck(cudaMemcpy(dataMB.get(), onGPUMB_d.get(), sizeof(ZVertices), cudaMemcpyDeviceToHost));
+        cudaCheck(cudaMemcpy(wsMB.get(), wsMB_d.get(), sizeof(WorkSpace), cudaMemcpyDeviceToHost));
+        checkMultiBlock(*data, *ws, *dataMB, *wsMB);
+      }
+#endif
+
       cms::cuda::launch(fitVerticesKernel, {1, 1024 - 256}, onGPU_d.get(), ws_d.get(), 50.f);
       cudaCheck(cudaGetLastError());
       cudaCheck(cudaMemcpy(&nv, LOC_ONGPU(nvFinal), sizeof(uint32_t), cudaMemcpyDeviceToHost));
@@ -188,6 +241,10 @@ int main() {
       print(onGPU_d.get(), ws_d.get());
       CLUSTERIZE(onGPU_d.get(), ws_d.get(), kk, par[0], par[1], par[2]);
       print(onGPU_d.get(), ws_d.get());
+#ifdef MULTI_BLOCK
+      clusterTracksByDensityMultiBlock(onGPUMB_d.get(), wsMB_d.get(), kk, par[0], par[1], par[2]);
+      checkMultiBlock(*onGPU_d, *ws_d, *onGPUMB_d, *wsMB_d);
+#endif
       fitVertices(onGPU_d.get(), ws_d.get(), 50.f);
       nv = onGPU_d->nvFinal;
 #endif
@@ -265,10 +322,8 @@ int main() {
       cms::cuda::launch(splitVerticesKernel, {1024, 64}, onGPU_d.get(), ws_d.get(), 9.f);
       cudaCheck(cudaMemcpy(&nv, LOC_WS(nvIntermediate), sizeof(uint32_t), cudaMemcpyDeviceToHost));
 #else
-      gridDim.x = 1;
-      assert(blockIdx.x == 0);
-      splitVertices(onGPU_d.get(), ws_d.get(), 9.f);
-      resetGrid();
+      // one vertex per block!!!
+      cudaCompat::launch<splitVertices>(1024, onGPU_d.get(), ws_d.get(), 9.f);
       nv = ws_d->nvIntermediate;
 #endif
       std::cout << "after split " << nv << std::endl;
@@ -0,0 +1,81 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include "CUDACore/cudaCompat.h"
+
+__global__ void count(uint32_t const* __restrict__ data,
+                      uint32_t n,
+                      uint32_t* __restrict__ hist,
+                      uint32_t* __restrict__ nBlocks,
+                      float* __restrict__ sum,
+                      uint32_t* __restrict__ minmax) {
+  if (0 == threadIdx.x)
+    atomicAdd(nBlocks, 1);
+  auto first = blockIdx.x * blockDim.x + threadIdx.x;
+  for (auto i = first; i < n; i += gridDim.x * blockDim.x) {
+    atomicAdd(&hist[data[i] % 16], 1);
+    atomicAdd(sum, 1.f);
+    atomicMin(&minmax[0], data[i]);
+    atomicMax(&minmax[1], data[i]);
+  }
+}
+
+__global__ void fill2D(uint32_t* __restrict__ cells, uint32_t nx, uint32_t ny) {
+  for (auto y = blockIdx.y; y < ny; y += gridDim.y)
+    for (auto x = blockIdx.x; x < nx; x += gridDim.x)
+      atomicInc(&cells[y * nx + x], 2);
+}
+
+int main() {
+  // force several threads, also on a single core machine
+  tbb::task_arena arena(4);
+  arena.execute([] {
+    constexpr uint32_t n = 1000000;
+    std::vector<uint32_t> data(n);
+    for (uint32_t i = 0; i < n; ++i)
+      data[i] = (i * 7919) % 100003 + 1;
+
+    for (uint32_t blocks : {1, 7, 128, 4096}) {
+      std::vector<uint32_t> hist(16, 0);
+      uint32_t nBlocks = 0;
+      float sum = 0;
+      uint32_t minmax[2] = {0xffffffff, 0};
+      cudaCompat::launch<count>(blocks, data.data(), n, hist.data(), &nBlocks, &sum, minmax);
+
+      uint32_t total = 0;
+      for (auto h : hist)
+        total += h;
+      assert(total == n);
+      assert(nBlocks == blocks);
+      assert(sum == float(n));
+      assert(minmax[0] == 1);
+      assert(minmax[1] == 100003);
+      // the grid of the caller is restored
+      assert(gridDim.x == 1 and blockIdx.x == 0);
+      std::cout << "launch with " << blocks << " blocks OK" << std::endl;
+    }
+
+    std::vector<uint32_t> cells(13 * 17, 0);
+    for (int i = 0; i < 3; ++i)
+      cudaCompat::launch<fill2D>(dim3{3, 5, 1}, cells.data(), 13u, 17u);
+    for (auto c : cells)
+      assert(c == 2);
+    std::cout << "launch with 2D grid OK" << std::endl;
+
+    // the TBB workers that ran the blocks do not keep the grid of the launch
+    std::atomic<int> stale = 0;
+    tbb::parallel_for(tbb::blocked_range<int>(0, 1000, 1), [&](tbb::blocked_range<int> const&) {
+      if (gridDim.x != 1 or gridDim.y != 1 or gridDim.z != 1 or blockIdx.x != 0 or blockIdx.y != 0)
+        ++stale;
+    });
+    assert(stale == 0);
+    std::cout << "grid of the workers restored OK" << std::endl;
+  });
+  return 0;
+}
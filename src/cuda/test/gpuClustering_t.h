@@ -224,6 +224,31 @@ int main(void) {
         }
       }
     }
+    if (4 == kn) {
+      // hot module, too many pixels for a single histogram
+      int id = 1900;
+      // a column every other one, the last ones first
+      for (int yy = 414; yy >= 0; yy -= 2) {
+        if (yy > 206)
+          ++ncl;
+        for (int x = 1; x < 160; ++x) {
+          h_id[n] = id;
+          h_x[n] = x;
+          h_y[n] = yy;
+          h_adc[n] = 1000;
+          ++n;
+        }
+      }
+      // joins the first columns in a single cluster
+      ++ncl;
+      for (int yy = 0; yy <= 206; ++yy) {
+        h_id[n] = id;
+        h_x[n] = 0;
+        h_y[n] = yy;
+        h_adc[n] = 1000;
+        ++n;
+      }
+    }
   };  // end lambda
   for (auto kkk = 0; kkk < 5; ++kkk) {
     n = 0;
@@ -300,18 +325,16 @@ int main(void) {
     h_moduleStart[0] = nModules;
     countModules(h_id.get(), h_moduleStart.get(), h_clus.get(), n);
     memset(h_clusInModule.get(), 0, MaxNumModules * sizeof(uint32_t));
-    gridDim.x = MaxNumModules;  //not needed in the kernel for this specific case;
-    assert(blockIdx.x == 0);
-    for (; blockIdx.x < gridDim.x; ++blockIdx.x)
-      findClus(h_id.get(),
-               h_x.get(),
-               h_y.get(),
-               h_moduleStart.get(),
-               h_clusInModule.get(),
-               h_moduleId.get(),
-               h_clus.get(),
-               n);
-    resetGrid();
+    // one module per block
+    cudaCompat::launch<findClus>(MaxNumModules,
+                                 h_id.get(),
+                                 h_x.get(),
+                                 h_y.get(),
+                                 h_moduleStart.get(),
+                                 h_clusInModule.get(),
+                                 h_moduleId.get(),
+                                 h_clus.get(),
+                                 n);
 
     nModules = h_moduleStart[0];
     auto nclus = h_clusInModule.get();
@@ -326,12 +349,14 @@ int main(void) {
     if (ncl != std::accumulate(nclus, nclus + MaxNumModules, 0))
       std::cout << "ERROR!!!!! wrong number of cluster found" << std::endl;
 
-    gridDim.x = MaxNumModules;  // no needed in the kernel for in this specific case
-    assert(blockIdx.x == 0);
-    for (; blockIdx.x < gridDim.x; ++blockIdx.x)
-      clusterChargeCut(
-          h_id.get(), h_adc.get(), h_moduleStart.get(), h_clusInModule.get(), h_moduleId.get(), h_clus.get(), n);
-    resetGrid();
+    cudaCompat::launch<clusterChargeCut>(MaxNumModules,
+                                         h_id.get(),
+                                         h_adc.get(),
+                                         h_moduleStart.get(),
+                                         h_clusInModule.get(),
+                                         h_moduleId.get(),
+                                         h_clus.get(),
+                                         n);
 
 #endif
 
@@ -0,0 +1,293 @@
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "CUDACore/cudaCompat.h"
+#include "CUDADataFormats/TrackingRecHit2DHeterogeneous.h"
+#include "plugin-PixelTriplets/BrokenLineBatch.h"
+#include "plugin-PixelTriplets/BrokenLineFitOnCPU.h"
+
+// compares the batched Broken Line fit with the scalar one on simulated
+// tracks, and measures the time of both; then compares kernelBLFitBatch
+// with kernelBLFastFit and kernelBLFit on tuples of hits
+
+namespace {
+  constexpr double B = 0.0113921;
+  constexpr int W = BrokenLine::batch::batchWidth;
+  constexpr int nTracks = 100 * 1024;
+
+  template <int N>
+  struct Track {
+    Rfit::Matrix3xNd<N> hits;
+    Eigen::Matrix<float, 6, N> hits_ge;
+  };
+
+  struct Result {
+    Rfit::Vector3d circlePar;
+    Rfit::Matrix3d circleCov;
+    double circleChi2;
+    Rfit::Vector2d linePar;
+    Rfit::Matrix2d lineCov;
+    double lineChi2;
+  };
+
+  // helices from the beam line, crossing the barrel layers
+  template <int N>
+  std::vector<Track<N>> generate(int n = nTracks) {
+    constexpr double radius[5] = {3., 7., 11., 16., 20.};
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> pt(0.5, 10.);
+    std::uniform_real_distribution<> psi(-M_PI, M_PI);
+    std::uniform_real_distribution<> cotTheta(-2., 2.);
+    std::normal_distribution<> noise(0., 0.001);
+
+    std::vector<Track<N>> tracks(n);
+    for (auto& track : tracks) {
+      double R = pt(gen) / B;
+      double charge = gen() % 2 ? 1. : -1.;
+      double phi = psi(gen);
+      double cot = cotTheta(gen);
+      for (int i = 0; i < N; ++i) {
+        double r = radius[i];
+        // intersection of the circle of radius r around the origin and of the helix, centered at distance R
+        double along = r * r / (2. * R);
+        double across = charge * std::sqrt(r * r - along * along);
+        double s = 2. * R * std::asin(r / (2. * R));
+        track.hits(0, i) = along * std::cos(phi) - across * std::sin(phi) + noise(gen);
+        track.hits(1, i) = along * std::sin(phi) + across * std::cos(phi) + noise(gen);
+        track.hits(2, i) = cot * s + 2. * noise(gen);
+        track.hits_ge.col(i) << 7.14652e-06, -5.60077e-06, 6.10348e-06, 0, 0, 5.184e-05;
+      }
+    }
+    return tracks;
+  }
+
+  template <int N>
+  void fitScalar(std::vector<Track<N>> const& tracks, std::vector<Result>& results) {
+    for (int t = 0; t < nTracks; ++t) {
+      Rfit::Vector4d fast_fit;
+      BrokenLine::BL_Fast_fit(tracks[t].hits, fast_fit);
+      BrokenLine::PreparedBrokenLineData<N> data;
+      BrokenLine::karimaki_circle_fit circle;
+      Rfit::line_fit line;
+      BrokenLine::prepareBrokenLineData(tracks[t].hits, fast_fit, B, data);
+      BrokenLine::BL_Line_fit(tracks[t].hits_ge, fast_fit, B, data, line);
+      BrokenLine::BL_Circle_fit(tracks[t].hits, tracks[t].hits_ge, fast_fit, B, data, circle);
+      results[t] = {circle.par, circle.cov, circle.chi2, line.par, line.cov, line.chi2};
+    }
+  }
+
+  template <int N>
+  void fitBatch(std::vector<Track<N>> const& tracks, std::vector<Result>& results) {
+    for (int first = 0; first < nTracks; first += W) {
+      BrokenLine::batch::Hits<N, W> hits;
+      for (int l = 0; l < W; ++l) {
+        auto const& track = tracks[first + l];
+        for (int i = 0; i < N; ++i) {
+          hits.x[i][l] = track.hits(0, i);
+          hits.y[i][l] = track.hits(1, i);
+          hits.z[i][l] = track.hits(2, i);
+          for (int k = 0; k < 6; ++k)
+            hits.ge[k][i][l] = track.hits_ge(k, i);
+        }
+      }
+      BrokenLine::batch::karimaki_circle_fit<W> circle;
+      BrokenLine::batch::line_fit<W> line;
+      BrokenLine::batch::Lanes<W> fast_fit[4];
+      BrokenLine::batch::BL_Fit(hits, B, circle, line, fast_fit);
+      for (int l = 0; l < W; ++l) {
+        auto& result = results[first + l];
+        for (int i = 0; i < 3; ++i) {
+          result.circlePar(i) = circle.par[i][l];
+          for (int j = 0; j < 3; ++j)
+            result.circleCov(i, j) = circle.cov(i, j)[l];
+        }
+        result.circleChi2 = circle.chi2[l];
+        for (int i = 0; i < 2; ++i) {
+          result.linePar(i) = line.par[i][l];
+          for (int j = 0; j < 2; ++j)
+            result.lineCov(i, j) = line.cov(i, j)[l];
+        }
+        result.lineChi2 = line.chi2[l];
+      }
+    }
+  }
+
+  bool isClose(double a, double b) {
+    constexpr double epsilon = 1e-6;
+    return std::abs(a - b) <= epsilon * std::max(std::abs(a), std::abs(b)) + 1e-12;
+  }
+
+  template <typename M>
+  bool isClose(M const& a, M const& b) {
+    for (int i = 0; i < a.rows(); ++i)
+      for (int j = 0; j < a.cols(); ++j)
+        if (not isClose(a(i, j), b(i, j)))
+          return false;
+    return true;
+  }
+
+  template <int N>
+  void testFit() {
+    static_assert(nTracks % W == 0);
+    auto tracks = generate<N>();
+    std::vector<Result> scalar(nTracks);
+    std::vector<Result> batch(nTracks);
+
+    auto start = std::chrono::steady_clock::now();
+    fitScalar(tracks, scalar);
+    auto middle = std::chrono::steady_clock::now();
+    fitBatch(tracks, batch);
+    auto stop = std::chrono::steady_clock::now();
+
+    int nDifferent = 0;
+    for (int t = 0; t < nTracks; ++t) {
+      auto const& a = scalar[t];
+      auto const& b = batch[t];
+      if (not(isClose(a.circlePar, b.circlePar) and isClose(a.circleCov, b.circleCov) and
+              isClose(a.circleChi2, b.circleChi2) and isClose(a.linePar, b.linePar) and
+              isClose(a.lineCov, b.lineCov) and isClose(a.lineChi2, b.lineChi2))) {
+        if (nDifferent < 5) {
+          std::cout << "track " << t << " differs:\n"
+                    << a.circlePar.transpose() << " | " << b.circlePar.transpose() << '\n'
+                    << a.linePar.transpose() << " | " << b.linePar.transpose() << std::endl;
+        }
+        ++nDifferent;
+      }
+    }
+
+    using ms = std::chrono::duration<double, std::milli>;
+    auto scalarTime = ms(middle - start).count();
+    auto batchTime = ms(stop - middle).count();
+    std::cout << nTracks << " fits of " << N << " hits: scalar " << scalarTime << " ms, batches of " << W << ' '
+              << batchTime << " ms, speedup " << scalarTime / batchTime << ", " << nDifferent << " different results"
+              << std::endl;
+    assert(0 == nDifferent);
+  }
+
+  bool isCloseFloat(float a, float b) {
+    constexpr float epsilon = 1e-5f;
+    return std::abs(a - b) <= epsilon * std::max(std::abs(a), std::abs(b)) + 1e-12f;
+  }
+
+  // fits the tuples with nHits hits (using their first N hits) with kernelBLFitBatch, and with kernelBLFastFit and
+  // kernelBLFit, and returns the number of tuples with different results
+  template <int N>
+  int compareKernels(Tuples const* tuples,
+                     CAConstants::TupleMultiplicity const* tupleMultiplicity,
+                     HitsOnGPU const* hits,
+                     uint32_t nTuples,
+                     uint32_t nHits) {
+    auto const maxFits = Rfit::maxNumberOfConcurrentFits();
+    std::vector<double> phits(maxFits * 3 * N);
+    std::vector<float> phits_ge(maxFits * 6 * N);
+    std::vector<double> pfast_fit(maxFits * 4);
+    auto scalar = std::make_unique<OutputSoA>();
+    auto batch = std::make_unique<OutputSoA>();
+    for (uint32_t t = 0; t < nTuples; ++t) {
+      scalar->pt(t) = -1.f;
+      batch->pt(t) = -1.f;
+    }
+
+    cudaCompat::resetGrid();
+    kernelBLFastFit<N>(tuples, tupleMultiplicity, hits, phits.data(), phits_ge.data(), pfast_fit.data(), nHits, 0);
+    kernelBLFit<N>(tupleMultiplicity, B, scalar.get(), phits.data(), phits_ge.data(), pfast_fit.data(), nHits, 0);
+    kernelBLFitBatch<N>(tuples, tupleMultiplicity, hits, B, batch.get(), nHits);
+
+    int nDifferent = 0;
+    for (uint32_t t = 0; t < nTuples; ++t) {
+      if (tuples->size(t) != nHits) {
+        // the lanes after the last tuple of a partial batch must not be stored
+        assert(batch->pt(t) == -1.f);
+        continue;
+      }
+      assert(scalar->pt(t) != -1.f);
+      bool same = isCloseFloat(scalar->pt(t), batch->pt(t)) and isCloseFloat(scalar->eta(t), batch->eta(t)) and
+                  isCloseFloat(scalar->chi2(t), batch->chi2(t));
+      for (int i = 0; i < 5; ++i)
+        same = same and isCloseFloat(scalar->stateAtBS.state(t)(i), batch->stateAtBS.state(t)(i));
+      for (int i = 0; i < 15; ++i)
+        same = same and isCloseFloat(scalar->stateAtBS.covariance(t)(i), batch->stateAtBS.covariance(t)(i));
+      if (not same)
+        ++nDifferent;
+    }
+    std::cout << tupleMultiplicity->size(nHits) << " tuples of " << nHits << " hits fitted with " << N
+              << " hits in batches of " << W << ", " << nDifferent << " different results" << std::endl;
+    return nDifferent;
+  }
+
+  // tuples of 3, 4 and 5 hits on the barrel layers, whose numbers are not multiples of the batch width
+  void testKernels() {
+    constexpr std::array<uint32_t, 3> nTuples = {{5 * W + 1, 3 * W - 1, W - 1}};
+    auto const nTotal = nTuples[0] + nTuples[1] + nTuples[2];
+    auto const nHitsTotal = 3 * nTuples[0] + 4 * nTuples[1] + 5 * nTuples[2];
+    auto tracks = generate<5>(nTotal);
+
+    // one module per hit, with the local x along phi and the local y along z
+    std::vector<pixelCPEforGPU::DetParams> detParams(nHitsTotal);
+    pixelCPEforGPU::ParamsOnGPU params{nullptr, detParams.data(), nullptr, nullptr};
+    TrackingRecHit2DCPU hits(nHitsTotal, &params, nullptr, nullptr);
+    auto* view = hits.view();
+
+    auto tuples = std::make_unique<Tuples>();
+    tuples->zero();
+    AtomicPairCounter apc(0);
+    auto tupleMultiplicity = std::make_unique<CAConstants::TupleMultiplicity>();
+    tupleMultiplicity->zero();
+
+    uint32_t hit = 0;
+    uint32_t tkid = 0;
+    for (uint32_t nHits = 3; nHits <= 5; ++nHits) {
+      for (uint32_t t = 0; t < nTuples[nHits - 3]; ++t, ++tkid) {
+        std::array<CAConstants::hindex_type, 5> hitIds;
+        for (uint32_t i = 0; i < nHits; ++i, ++hit) {
+          float x = tracks[tkid].hits(0, i);
+          float y = tracks[tkid].hits(1, i);
+          float z = tracks[tkid].hits(2, i);
+          float c = x / std::sqrt(x * x + y * y);
+          float s = y / std::sqrt(x * x + y * y);
+          detParams[hit].frame = pixelCPEforGPU::Frame(x, y, z, pixelCPEforGPU::Rotation(-s, c, 0, 0, 0, 1, c, s, 0));
+          view->xGlobal(hit) = x;
+          view->yGlobal(hit) = y;
+          view->zGlobal(hit) = z;
+          view->xerrLocal(hit) = 20e-4f * 20e-4f;
+          view->yerrLocal(hit) = 30e-4f * 30e-4f;
+          view->detectorIndex(hit) = hit;
+          hitIds[i] = hit;
+        }
+        tuples->bulkFill(apc, hitIds.data(), nHits);
+        tupleMultiplicity->countDirect(nHits);
+      }
+    }
+    tuples->bulkFinalize(apc);
+    tupleMultiplicity->finalize();
+    for (tkid = 0; tkid < nTotal; ++tkid) {
+      tupleMultiplicity->fillDirect(tuples->size(tkid), tkid);
+    }
+
+    // as in launchBrokenLineKernelsOnCPU(), with the pentuplets fitted both with 4 and 5 hits
+    int nDifferent = 0;
+    nDifferent += compareKernels<3>(tuples.get(), tupleMultiplicity.get(), view, nTotal, 3);
+    nDifferent += compareKernels<4>(tuples.get(), tupleMultiplicity.get(), view, nTotal, 4);
+    nDifferent += compareKernels<4>(tuples.get(), tupleMultiplicity.get(), view, nTotal, 5);
+    nDifferent += compareKernels<5>(tuples.get(), tupleMultiplicity.get(), view, nTotal, 5);
+    assert(0 == nDifferent);
+  }
+}  // namespace
+
+int main() {
+  testFit<3>();
+  testFit<4>();
+  testFit<5>();
+
+  testKernels();
+
+  return 0;
+}
@@ -7,6 +7,8 @@
  *  The raw data is owned as a binary buffer. It is required that the 
  *  lenght of the data is a multiple of the S-Link64 word lenght (8 byte).
  *  The FED data should include the standard FED header and trailer.
+ *  Alternatively the object can be a read-only, non-owning view of a
+ *  buffer held elsewhere (e.g. a memory-mapped input file).
  *
  *  \author G. Bruno - CERN, EP Division
  *  \author S. Argiro - CERN and INFN - 
@@ -29,6 +31,10 @@ public:
   /// word (8 bytes)
   FEDRawData(size_t newsize);
 
+  /// Ctor for a non-owning, read-only view of size bytes at data.
+  /// The buffer must outlive this object and all its copies.
+  FEDRawData(const unsigned char *data, size_t size);
+
   /// Copy constructor
   FEDRawData(const FEDRawData &);
 
@@ -39,17 +45,24 @@ public:
   const unsigned char *data() const;
 
   /// Return a pointer to the beginning of the data buffer
+  /// (throws for a non-owning view)
   unsigned char *data();
 
   /// Lenght of the data buffer in bytes
-  size_t size() const { return data_.size(); }
+  size_t size() const { return view_ ? viewSize_ : data_.size(); }
+
+  /// True if the object does not own the data buffer
+  bool isView() const { return view_ != nullptr; }
 
   /// Resize to the specified size in bytes. It is required that
   /// the size is a multiple of the size of a FED word (8 bytes)
+  /// (throws for a non-owning view)
   void resize(size_t newsize);
 
 private:
   Data data_;
+  const unsigned char *view_ = nullptr;
+  size_t viewSize_ = 0;
 };
 
 #endif
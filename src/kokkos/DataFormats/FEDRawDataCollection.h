@@ -6,31 +6,49 @@
  *  
  *  Reference: DaqPrototype/DaqPersistentData/interface/DaqFEDOpaqueData.h
  *
+ *  The collection either owns one FEDRawData per possible FED id, or
+ *  refers to a sparse, read-only View of the FEDs present in the event
+ *  that is owned (together with the payloads) by someone else.
+ *
  *  \author N. Amapane - S. Argiro'
  */
 
 #include "DataFormats/FEDRawData.h"
 
+#include <utility>
 #include <vector>
 
 class FEDRawDataCollection {
 public:
+  /// Sparse set of FEDs, sorted by FED id
+  struct View {
+    std::vector<int> fedIds;
+    std::vector<FEDRawData> data;
+  };
+
   FEDRawDataCollection();
 
+  /// Non-owning collection, the view must outlive this object and all its copies
+  explicit FEDRawDataCollection(const View* view);
+
   virtual ~FEDRawDataCollection();
 
   /// retrieve data for fed @param fedid
   const FEDRawData& FEDData(int fedid) const;
 
-  /// retrieve data for fed @param fedid
+  /// retrieve data for fed @param fedid (throws for a non-owning collection)
   FEDRawData& FEDData(int fedid);
 
   FEDRawDataCollection(const FEDRawDataCollection&);
 
-  void swap(FEDRawDataCollection& other) { data_.swap(other.data_); }
+  void swap(FEDRawDataCollection& other) {
+    data_.swap(other.data_);
+    std::swap(view_, other.view_);
+  }
 
 private:
   std::vector<FEDRawData> data_;  ///< the raw data
+  const View* view_ = nullptr;    ///< the raw data, if not owned
 };
 
 inline void swap(FEDRawDataCollection& a, FEDRawDataCollection& b) { a.swap(b); }
@@ -0,0 +1,36 @@
+#ifndef KokkosCore_ExecSpaceLock_h
+#define KokkosCore_ExecSpaceLock_h
+
+#include <mutex>
+
+#include <Kokkos_Core.hpp>
+
+namespace cms {
+  namespace kokkos {
+    // The host execution spaces have a single instance per process, which
+    // can run only one parallel dispatch at a time, while the framework
+    // processes several events concurrently on the TBB threads. The modules
+    // hold this lock while they run work on such an execution space, so that
+    // the concurrent events take turns on it (e.g. on the thread pool of the
+    // Threads backend). For the device execution spaces it does nothing.
+    std::mutex& serialMutex();
+    std::mutex& threadsMutex();
+
+    template <typename ExecSpace>
+    std::unique_lock<std::mutex> lockExecSpace(ExecSpace const&) {
+      return std::unique_lock<std::mutex>();
+    }
+
+    inline std::unique_lock<std::mutex> lockExecSpace(Kokkos::Serial const&) {
+      return std::unique_lock<std::mutex>(serialMutex());
+    }
+
+#ifdef KOKKOS_ENABLE_THREADS
+    inline std::unique_lock<std::mutex> lockExecSpace(Kokkos::Threads const&) {
+      return std::unique_lock<std::mutex>(threadsMutex());
+    }
+#endif
+  }  // namespace kokkos
+}  // namespace cms
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "AtomicPairCounter.h"
 #include "kokkos_assert.h"
+#include "kokkosConfig.h"
 
 namespace cms {
   namespace kokkos {
@@ -104,7 +105,7 @@ namespace cms {
       launchZero(h, execSpace);
       auto nblocks = (totSize + nthreads - 1) / nthreads;
       using TeamPolicy = Kokkos::TeamPolicy<ExecSpace>;
-#ifndef KOKKOS_BACKEND_SERIAL
+#ifndef KOKKOS_HOST_BACKEND
       TeamPolicy tp(execSpace, nblocks, nthreads);
 #else
       TeamPolicy tp(execSpace, nblocks * nthreads, 1);
@@ -0,0 +1,90 @@
+#ifndef KokkosCore_MemoryPool_h
+#define KokkosCore_MemoryPool_h
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+namespace cms {
+  namespace kokkos {
+    // Caching allocator for the blocks of memory of a Kokkos memory space.
+    //
+    // The sizes of the blocks are rounded up to powers of 2, and the blocks
+    // that are freed are kept for the next allocations of the same size
+    // until Kokkos::finalize(). The modules use the default instance of the
+    // execution spaces, whose work runs in order, so a block can be reused
+    // as soon as it is freed, even if some work using it is still queued.
+    //
+    // All the functions are thread safe.
+    template <typename MemorySpace>
+    class MemoryPool {
+    public:
+      // the block is returned to the pool when the last copy is destroyed
+      using Block = std::shared_ptr<void>;
+
+      MemoryPool(MemoryPool const&) = delete;
+      MemoryPool& operator=(MemoryPool const&) = delete;
+
+      static MemoryPool& instance();
+
+      Block allocate(std::size_t bytes);
+
+      // blocks currently allocated from the memory space, and their total size
+      std::size_t allocatedBlocks() const;
+      std::size_t allocatedBytes() const;
+      // total size of the blocks waiting to be reused
+      std::size_t cachedBytes() const;
+
+    private:
+      MemoryPool() = default;
+
+      static int bin(std::size_t bytes);
+      void free(void* ptr, int bin, unsigned int generation);
+      // gives the cached blocks back to the memory space
+      void release();
+      // run by Kokkos::finalize()
+      void finalize();
+
+      static constexpr int minBin = 8;  // 256 bytes
+      static constexpr int maxBin = 8 * sizeof(std::size_t) - 1;
+
+      mutable std::mutex mutex_;
+      std::vector<std::vector<void*>> cached_ = std::vector<std::vector<void*>>(maxBin + 1);
+      std::size_t allocatedBlocks_ = 0;
+      std::size_t allocatedBytes_ = 0;
+      std::size_t cachedBytes_ = 0;
+      // the blocks freed after Kokkos::finalize() are not returned to the memory space
+      unsigned int generation_ = 0;
+      bool finalizeHook_ = false;
+    };
+
+    extern template class MemoryPool<Kokkos::HostSpace>;
+#ifdef KOKKOS_ENABLE_CUDA
+    extern template class MemoryPool<Kokkos::CudaSpace>;
+#endif
+
+    // Owner of the blocks of the MemoryPool under the Views of an object,
+    // e.g. a product or the workspace of an algorithm. The Views are
+    // unmanaged, and are valid until the PooledViews is destroyed, when the
+    // blocks are returned to the pool. Unlike with the Kokkos::View
+    // constructor, the elements are not initialized.
+    class PooledViews {
+    public:
+      template <typename DataType, typename Space, typename... Extents>
+      Kokkos::View<DataType, Space, Kokkos::MemoryUnmanaged> make(Extents... extents) {
+        using View = Kokkos::View<DataType, Space, Kokkos::MemoryUnmanaged>;
+        auto bytes = View::required_allocation_size(extents...);
+        blocks_.push_back(MemoryPool<typename View::memory_space>::instance().allocate(bytes));
+        return View(static_cast<typename View::pointer_type>(blocks_.back().get()), extents...);
+      }
+
+    private:
+      std::vector<std::shared_ptr<void>> blocks_;
+    };
+  }  // namespace kokkos
+}  // namespace cms
+
+#endif
@@ -7,11 +7,20 @@
 #ifdef KOKKOS_BACKEND_SERIAL
 using KokkosExecSpace = Kokkos::Serial;
 #define KOKKOS_NAMESPACE kokkos_serial
+#elif defined KOKKOS_BACKEND_THREADS
+using KokkosExecSpace = Kokkos::Threads;
+#define KOKKOS_NAMESPACE kokkos_threads
 #elif defined KOKKOS_BACKEND_CUDA
 using KokkosExecSpace = Kokkos::Cuda;
 #define KOKKOS_NAMESPACE kokkos_cuda
 #endif
 
+// the host backends run each team with a single thread, and distribute the
+// teams of the league over their threads
+#if defined KOKKOS_BACKEND_SERIAL || defined KOKKOS_BACKEND_THREADS
+#define KOKKOS_HOST_BACKEND
+#endif
+
 // this is meant mostly for unit tests
 template <typename ExecSpace>
 struct KokkosBackend;
@@ -19,6 +28,12 @@ template <>
 struct KokkosBackend<Kokkos::Serial> {
   static constexpr auto value = kokkos_common::InitializeScopeGuard::Backend::SERIAL;
 };
+#ifdef KOKKOS_ENABLE_THREADS
+template <>
+struct KokkosBackend<Kokkos::Threads> {
+  static constexpr auto value = kokkos_common::InitializeScopeGuard::Backend::THREADS;
+};
+#endif
 template <>
 struct KokkosBackend<Kokkos::Cuda> {
   static constexpr auto value = kokkos_common::InitializeScopeGuard::Backend::CUDA;
@@ -9,9 +9,11 @@
 namespace kokkos_common {
   class InitializeScopeGuard {
   public:
-    enum class Backend { SERIAL, CUDA };
+    enum class Backend { SERIAL, THREADS, CUDA };
 
-    InitializeScopeGuard(std::vector<Backend> const& backends);
+    // numberOfThreads is the size of the thread pool of the THREADS
+    // backend, 0 for the number of hardware threads
+    InitializeScopeGuard(std::vector<Backend> const& backends, int numberOfThreads = 0);
     ~InitializeScopeGuard();
 
   private:
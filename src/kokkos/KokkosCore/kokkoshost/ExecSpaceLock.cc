@@ -0,0 +1,15 @@
+#include "KokkosCore/ExecSpaceLock.h"
+
+namespace cms {
+  namespace kokkos {
+    std::mutex& serialMutex() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    std::mutex& threadsMutex() {
+      static std::mutex mutex;
+      return mutex;
+    }
+  }  // namespace kokkos
+}  // namespace cms
@@ -0,0 +1,115 @@
+#include <new>
+
+#include "KokkosCore/MemoryPool.h"
+
+namespace cms {
+  namespace kokkos {
+    template <typename MemorySpace>
+    MemoryPool<MemorySpace>& MemoryPool<MemorySpace>::instance() {
+      // a single pool per memory space for all the plugins
+      static MemoryPool pool;
+      return pool;
+    }
+
+    template <typename MemorySpace>
+    typename MemoryPool<MemorySpace>::Block MemoryPool<MemorySpace>::allocate(std::size_t bytes) {
+      int const b = bin(bytes);
+      std::size_t const size = std::size_t(1) << b;
+      void* ptr = nullptr;
+      unsigned int generation;
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (not finalizeHook_) {
+          Kokkos::push_finalize_hook([this]() { finalize(); });
+          finalizeHook_ = true;
+        }
+        generation = generation_;
+        if (not cached_[b].empty()) {
+          ptr = cached_[b].back();
+          cached_[b].pop_back();
+          cachedBytes_ -= size;
+        }
+      }
+
+      if (ptr == nullptr) {
+        try {
+          ptr = MemorySpace().allocate(size);
+        } catch (std::bad_alloc const&) {
+          // give the cached blocks back to the memory space, and try again
+          release();
+          ptr = MemorySpace().allocate(size);
+        }
+        std::lock_guard<std::mutex> guard(mutex_);
+        ++allocatedBlocks_;
+        allocatedBytes_ += size;
+      }
+      return Block(ptr, [this, b, generation](void* p) { free(p, b, generation); });
+    }
+
+    template <typename MemorySpace>
+    std::size_t MemoryPool<MemorySpace>::allocatedBlocks() const {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return allocatedBlocks_;
+    }
+
+    template <typename MemorySpace>
+    std::size_t MemoryPool<MemorySpace>::allocatedBytes() const {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return allocatedBytes_;
+    }
+
+    template <typename MemorySpace>
+    std::size_t MemoryPool<MemorySpace>::cachedBytes() const {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return cachedBytes_;
+    }
+
+    template <typename MemorySpace>
+    int MemoryPool<MemorySpace>::bin(std::size_t bytes) {
+      int b = minBin;
+      while (b < maxBin and (std::size_t(1) << b) < bytes) {
+        ++b;
+      }
+      return b;
+    }
+
+    template <typename MemorySpace>
+    void MemoryPool<MemorySpace>::free(void* ptr, int b, unsigned int generation) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (generation != generation_) {
+        // allocated before Kokkos::finalize(), the memory space may not be usable any more
+        return;
+      }
+      cached_[b].push_back(ptr);
+      cachedBytes_ += std::size_t(1) << b;
+    }
+
+    template <typename MemorySpace>
+    void MemoryPool<MemorySpace>::release() {
+      std::lock_guard<std::mutex> guard(mutex_);
+      for (int b = minBin; b <= maxBin; ++b) {
+        std::size_t const size = std::size_t(1) << b;
+        for (void* ptr : cached_[b]) {
+          MemorySpace().deallocate(ptr, size);
+          --allocatedBlocks_;
+          allocatedBytes_ -= size;
+        }
+        cached_[b].clear();
+      }
+      cachedBytes_ = 0;
+    }
+
+    template <typename MemorySpace>
+    void MemoryPool<MemorySpace>::finalize() {
+      release();
+      std::lock_guard<std::mutex> guard(mutex_);
+      ++generation_;
+      finalizeHook_ = false;
+    }
+
+    template class MemoryPool<Kokkos::HostSpace>;
+#ifdef KOKKOS_ENABLE_CUDA
+    template class MemoryPool<Kokkos::CudaSpace>;
+#endif
+  }  // namespace kokkos
+}  // namespace cms
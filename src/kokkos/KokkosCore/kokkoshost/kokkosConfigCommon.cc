@@ -1,5 +1,8 @@
 #include "KokkosCore/kokkosConfigCommon.h"
 
+#include <stdexcept>
+#include <thread>
+
 #include <Kokkos_Core.hpp>
 
 namespace kokkos_common {
@@ -10,6 +13,20 @@ namespace kokkos_common {
       if (std::find(backends.begin(), backends.end(), Backend::SERIAL) != backends.end()) {
         Kokkos::Serial::impl_initialize();
       }
+      if (std::find(backends.begin(), backends.end(), Backend::THREADS) != backends.end()) {
+#ifdef KOKKOS_ENABLE_THREADS
+        Kokkos::Threads::impl_initialize(args.num_threads);
+#else
+        throw std::runtime_error("Kokkos was built without the Threads backend");
+#endif
+      }
+#ifdef KOKKOS_ENABLE_THREADS
+      else if (not backends.empty()) {
+        // Threads may be the default host execution space (e.g. of the host mirrors of the CUDA Views), so it is
+        // initialized, with a single thread, also when the modules do not use it
+        Kokkos::Threads::impl_initialize(1);
+      }
+#endif
       if (std::find(backends.begin(), backends.end(), Backend::CUDA) != backends.end()) {
         // CUDA execution space requires a host execution space as well
         Kokkos::Serial::impl_initialize();
@@ -21,9 +38,9 @@ namespace kokkos_common {
     ~Impl() { Kokkos::finalize(); }
   };
 
-  InitializeScopeGuard::InitializeScopeGuard(std::vector<Backend> const& backends) {
-    // for now pass in the default arguments
+  InitializeScopeGuard::InitializeScopeGuard(std::vector<Backend> const& backends, int numberOfThreads) {
     Kokkos::InitArguments arguments;
+    arguments.num_threads = numberOfThreads > 0 ? numberOfThreads : int(std::thread::hardware_concurrency());
     pimpl_ = std::make_unique<Impl>(backends, arguments);
   }
 
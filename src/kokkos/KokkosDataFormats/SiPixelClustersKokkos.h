@@ -1,6 +1,7 @@
 #ifndef CUDADataFormats_SiPixelCluster_interface_SiPixelClustersCUDA_h
 #define CUDADataFormats_SiPixelCluster_interface_SiPixelClustersCUDA_h
 
+#include "KokkosCore/MemoryPool.h"
 #include "KokkosCore/kokkosConfig.h"
 
 template <typename MemorySpace>
@@ -8,10 +9,10 @@ class SiPixelClustersKokkos {
 public:
   SiPixelClustersKokkos() = default;
   explicit SiPixelClustersKokkos(size_t maxClusters)
-      : moduleStart_d{"moduleStart_d", maxClusters + 1},
-        clusInModule_d{"clusInModule_d", maxClusters},
-        moduleId_d{"moduleId_d", maxClusters},
-        clusModuleStart_d{"clusModuleStart_d", maxClusters + 1} {}
+      : moduleStart_d{views_.make<uint32_t *, MemorySpace>(maxClusters + 1)},
+        clusInModule_d{views_.make<uint32_t *, MemorySpace>(maxClusters)},
+        moduleId_d{views_.make<uint32_t *, MemorySpace>(maxClusters)},
+        clusModuleStart_d{views_.make<uint32_t *, MemorySpace>(maxClusters + 1)} {}
   ~SiPixelClustersKokkos() = default;
 
   SiPixelClustersKokkos(const SiPixelClustersKokkos &) = delete;
@@ -59,6 +60,9 @@ public:
   DeviceConstView view() const { return DeviceConstView{moduleStart_d, clusInModule_d, moduleId_d, clusModuleStart_d}; }
 
 private:
+  // owns the memory of the Views below
+  cms::kokkos::PooledViews views_;
+
   Kokkos::View<uint32_t *, MemorySpace> moduleStart_d;   // index of the first pixel of each module
   Kokkos::View<uint32_t *, MemorySpace> clusInModule_d;  // number of clusters found in each module
   Kokkos::View<uint32_t *, MemorySpace> moduleId_d;      // module id of each module
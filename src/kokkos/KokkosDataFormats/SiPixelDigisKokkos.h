@@ -1,6 +1,7 @@
 #ifndef CUDADataFormats_SiPixelDigi_interface_SiPixelDigisCUDA_h
 #define CUDADataFormats_SiPixelDigi_interface_SiPixelDigisCUDA_h
 
+#include "KokkosCore/MemoryPool.h"
 #include "KokkosCore/kokkosConfig.h"
 
 template <typename MemorySpace>
@@ -8,13 +9,13 @@ class SiPixelDigisKokkos {
 public:
   SiPixelDigisKokkos() = default;
   explicit SiPixelDigisKokkos(size_t maxFedWords)
-      : xx_d{"xx_d", maxFedWords},
-        yy_d{"yy_d", maxFedWords},
-        adc_d{"adc_d", maxFedWords},
-        moduleInd_d{"moduleInd_d", maxFedWords},
-        clus_d{"clus_d", maxFedWords},
-        pdigi_d{"pdigi_d", maxFedWords},
-        rawIdArr_d{"rawIdArr_d", maxFedWords} {}
+      : xx_d{views_.make<uint16_t*, MemorySpace>(maxFedWords)},
+        yy_d{views_.make<uint16_t*, MemorySpace>(maxFedWords)},
+        adc_d{views_.make<uint16_t*, MemorySpace>(maxFedWords)},
+        moduleInd_d{views_.make<uint16_t*, MemorySpace>(maxFedWords)},
+        clus_d{views_.make<int32_t*, MemorySpace>(maxFedWords)},
+        pdigi_d{views_.make<uint32_t*, MemorySpace>(maxFedWords)},
+        rawIdArr_d{views_.make<uint32_t*, MemorySpace>(maxFedWords)} {}
   ~SiPixelDigisKokkos() = default;
 
   SiPixelDigisKokkos(const SiPixelDigisKokkos&) = delete;
@@ -87,6 +88,9 @@ public:
   DeviceConstView view() const { return DeviceConstView{xx_d, yy_d, adc_d, moduleInd_d, clus_d}; }
 
 private:
+  // owns the memory of the Views below
+  cms::kokkos::PooledViews views_;
+
   // These are consumed by downstream device code
   Kokkos::View<uint16_t*, MemorySpace> xx_d;         // local coordinates of each pixel
   Kokkos::View<uint16_t*, MemorySpace> yy_d;         //
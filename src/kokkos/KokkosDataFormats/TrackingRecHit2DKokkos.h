@@ -1,6 +1,7 @@
 #ifndef CUDADataFormats_TrackingRecHit_interface_TrackingRecHit2DHeterogeneous_h
 #define CUDADataFormats_TrackingRecHit_interface_TrackingRecHit2DHeterogeneous_h
 
+#include "KokkosCore/MemoryPool.h"
 #include "KokkosDataFormats/TrackingRecHit2DSOAView.h"
 
 template <typename MemorySpace>
@@ -64,6 +65,9 @@ public:
 #endif
 
 private:
+  // owns the memory of the Views below, except m_hitsModuleStart
+  cms::kokkos::PooledViews m_views;
+
   // local coord
   Kokkos::View<float*, MemorySpace> m_xl;
   Kokkos::View<float*, MemorySpace> m_yl;
@@ -103,24 +107,24 @@ TrackingRecHit2DKokkos<MemorySpace>::TrackingRecHit2DKokkos(
     Kokkos::View<uint32_t const*, MemorySpace> hitsModuleStart,
     ExecSpace const& execSpace)
     : m_nHits(nHits),
-      m_xl("m_xl", nHits),
-      m_yl("m_yl", nHits),
-      m_xerr("m_xerr", nHits),
-      m_yerr("m_yerr", nHits),
-      m_xg("m_xg", nHits),
-      m_yg("m_yg", nHits),
-      m_zg("m_zg", nHits),
-      m_rg("m_rg", nHits),
-      m_iphi("m_iphi", nHits),
-      m_charge("m_charge", nHits),
-      m_xsize("m_xsize", nHits),
-      m_ysize("m_ysize", nHits),
-      m_detInd("m_detInd", nHits),
-      m_AverageGeometryStore("m_AverageGeometryStore"),
-      m_view("m_view"),
+      m_xl(m_views.make<float*, MemorySpace>(nHits)),
+      m_yl(m_views.make<float*, MemorySpace>(nHits)),
+      m_xerr(m_views.make<float*, MemorySpace>(nHits)),
+      m_yerr(m_views.make<float*, MemorySpace>(nHits)),
+      m_xg(m_views.make<float*, MemorySpace>(nHits)),
+      m_yg(m_views.make<float*, MemorySpace>(nHits)),
+      m_zg(m_views.make<float*, MemorySpace>(nHits)),
+      m_rg(m_views.make<float*, MemorySpace>(nHits)),
+      m_iphi(m_views.make<int16_t*, MemorySpace>(nHits)),
+      m_charge(m_views.make<int32_t*, MemorySpace>(nHits)),
+      m_xsize(m_views.make<int16_t*, MemorySpace>(nHits)),
+      m_ysize(m_views.make<int16_t*, MemorySpace>(nHits)),
+      m_detInd(m_views.make<uint16_t*, MemorySpace>(nHits)),
+      m_AverageGeometryStore(m_views.make<TrackingRecHit2DSOAView::AverageGeometry, MemorySpace>()),
+      m_view(m_views.make<TrackingRecHit2DSOAView, MemorySpace>()),
       m_hitsModuleStart(std::move(hitsModuleStart)),
-      m_hist("m_hist"),
-      m_hitsLayerStart("m_hitsLayerStart", nHits) {
+      m_hist(m_views.make<Hist, MemorySpace>()),
+      m_hitsLayerStart(m_views.make<uint32_t*, MemorySpace>(phase1PixelTopology::numberOfLayers + 1)) {
   // should I deal with no hits case?
 
   // the hits are actually accessed in order only in building
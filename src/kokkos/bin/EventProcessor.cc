@@ -11,8 +11,9 @@ namespace edm {
                                  std::vector<std::string> const& path,
                                  std::vector<std::string> const& esproducers,
                                  std::filesystem::path const& datadir,
-                                 bool validation)
-      : source_(maxEvents, registry_, datadir, validation) {
+                                 bool validation,
+                                 Source::Mode sourceMode)
+      : source_(maxEvents, registry_, datadir, validation, sourceMode) {
     for (auto const& name : esproducers) {
       pluginManager_.load(name);
       auto esp = ESPluginFactory::create(name, datadir);
@@ -2,6 +2,7 @@
 #define Source_h
 
 #include <atomic>
+#include <cstddef>
 #include <filesystem>
 #include <string>
 #include <memory>
@@ -15,7 +16,19 @@
 namespace edm {
   class Source {
   public:
-    explicit Source(int maxEvents, ProductRegistry& reg, std::filesystem::path const& datadir, bool validation);
+    enum class Mode {
+      kRead,  // read all events into memory at construction
+      kMmap   // memory-map raw.bin, events refer to the FED payloads in the mapped pages
+    };
+
+    explicit Source(int maxEvents,
+                    ProductRegistry& reg,
+                    std::filesystem::path const& datadir,
+                    bool validation,
+                    Mode mode = Mode::kRead);
+    ~Source();
+    Source(Source const&) = delete;
+    Source& operator=(Source const&) = delete;
 
     int maxEvents() const { return maxEvents_; }
 
@@ -23,6 +36,10 @@ namespace edm {
     std::unique_ptr<Event> produce(int streamId, ProductRegistry const& reg);
 
   private:
+    void readRawFile(std::filesystem::path const& filename);
+    void mapRawFile(std::filesystem::path const& filename);
+    void readValidation(std::filesystem::path const& datadir);
+
     int maxEvents_;
     std::atomic<int> numEvents_;
     EDPutTokenT<FEDRawDataCollection> const rawToken_;
@@ -34,6 +51,13 @@ namespace edm {
     std::vector<TrackCount> tracks_;
     std::vector<VertexCount> vertices_;
     bool const validation_;
+
+    // for Mode::kMmap, the views_ of the FEDs of each event refer to the
+    // mapped pages, or to a copy in arenas_ if the payloads are misaligned
+    std::vector<FEDRawDataCollection::View> views_;
+    std::vector<std::vector<unsigned char>> arenas_;
+    void* mapped_ = nullptr;
+    std::size_t mappedSize_ = 0;
   };
 }  // namespace edm
 
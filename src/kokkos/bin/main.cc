@@ -17,18 +17,22 @@ namespace {
   void print_help(std::string const& name) {
     std::cout
         << name
-        << ": [--serial] [--cuda] [--numberOfThreads NT] [--numberOfStreams NS] [--maxEvents ME] [--data PATH] "
-           "[--transfer] [--validation] [--histogram]\n\n"
+        << ": [--serial] [--threads] [--cuda] [--numberOfThreads NT] [--numberOfStreams NS] "
+           "[--numberOfKokkosThreads NKT] [--maxEvents ME] [--data PATH] [--transfer] [--validation] [--histogram] "
+           "[--mmap]\n\n"
         << "Options\n"
         << " --serial            Use CPU Serial backend\n"
+        << " --threads           Use CPU Threads backend\n"
         << " --cuda              Use CUDA backend\n"
         << " --numberOfThreads   Number of threads to use (default 1)\n"
         << " --numberOfStreams   Number of concurrent events (default 0=numberOfThreads)\n"
+        << " --numberOfKokkosThreads Number of threads of the Kokkos Threads backend (default 0=numberOfThreads)\n"
         << " --maxEvents         Number of events to process (default -1 for all events in the input file)\n"
         << " --data              Path to the 'data' directory (default 'data' in the directory of the executable)\n"
         << " --transfer          Transfer results from GPU to CPU (default is to leave them on GPU)\n"
         << " --histogram         Produce histograms at the end (implies --transfer)\n"
         << " --validation        Run (rudimentary) validation at the end (implies --transfer)\n"
+        << " --mmap              Memory-map the raw data file instead of reading it in memory\n"
         << std::endl;
   }
 }  // namespace
@@ -40,17 +44,21 @@ int main(int argc, char** argv) {
   std::vector<Backend> backends;
   int numberOfThreads = 1;
   int numberOfStreams = 0;
+  int numberOfKokkosThreads = 0;
   int maxEvents = -1;
   std::filesystem::path datadir;
   bool transfer = false;
   bool validation = false;
   bool histogram = false;
+  auto sourceMode = edm::Source::Mode::kRead;
   for (auto i = args.begin() + 1, e = args.end(); i != e; ++i) {
     if (*i == "-h" or *i == "--help") {
       print_help(args.front());
       return EXIT_SUCCESS;
     } else if (*i == "--serial") {
       backends.emplace_back(Backend::SERIAL);
+    } else if (*i == "--threads") {
+      backends.emplace_back(Backend::THREADS);
     } else if (*i == "--cuda") {
       backends.emplace_back(Backend::CUDA);
     } else if (*i == "--numberOfThreads") {
@@ -59,6 +67,9 @@ int main(int argc, char** argv) {
     } else if (*i == "--numberOfStreams") {
       ++i;
       numberOfStreams = std::stoi(*i);
+    } else if (*i == "--numberOfKokkosThreads") {
+      ++i;
+      numberOfKokkosThreads = std::stoi(*i);
     } else if (*i == "--maxEvents") {
       ++i;
       maxEvents = std::stoi(*i);
@@ -73,6 +84,8 @@ int main(int argc, char** argv) {
     } else if (*i == "--histogram") {
       transfer = true;
       histogram = true;
+    } else if (*i == "--mmap") {
+      sourceMode = edm::Source::Mode::kMmap;
     } else {
       std::cout << "Invalid parameter " << *i << std::endl << std::endl;
       print_help(args.front());
@@ -82,6 +95,9 @@ int main(int argc, char** argv) {
   if (numberOfStreams == 0) {
     numberOfStreams = numberOfThreads;
   }
+  if (numberOfKokkosThreads == 0) {
+    numberOfKokkosThreads = numberOfThreads;
+  }
   if (datadir.empty()) {
     datadir = std::filesystem::path(args[0]).parent_path() / "data";
   }
@@ -91,7 +107,7 @@ int main(int argc, char** argv) {
   }
 
   // Initialize Kokkos
-  kokkos_common::InitializeScopeGuard kokkosGuard(backends);
+  kokkos_common::InitializeScopeGuard kokkosGuard(backends, numberOfKokkosThreads);
 
   // Initialize EventProcessor
   std::vector<std::string> edmodules;
@@ -122,14 +138,19 @@ int main(int argc, char** argv) {
       }
     };
     addModules("kokkos_serial::", Backend::SERIAL);
+    addModules("kokkos_threads::", Backend::THREADS);
     addModules("kokkos_cuda::", Backend::CUDA);
   }
   edm::EventProcessor processor(
-      maxEvents, numberOfStreams, std::move(edmodules), std::move(esmodules), datadir, validation);
+      maxEvents, numberOfStreams, std::move(edmodules), std::move(esmodules), datadir, validation, sourceMode);
   maxEvents = processor.maxEvents();
 
   std::cout << "Processing " << maxEvents << " events, of which " << numberOfStreams << " concurrently, with "
-            << numberOfThreads << " threads." << std::endl;
+            << numberOfThreads << " threads";
+  if (std::find(backends.begin(), backends.end(), Backend::THREADS) != backends.end()) {
+    std::cout << " and " << numberOfKokkosThreads << " Kokkos threads";
+  }
+  std::cout << "." << std::endl;
 
   // Initialize tasks scheduler (thread pool)
   tbb::task_scheduler_init tsi(numberOfThreads);
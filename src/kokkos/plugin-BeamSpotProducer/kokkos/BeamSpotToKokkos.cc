@@ -1,5 +1,6 @@
 #include "KokkosDataFormats/BeamSpotKokkos.h"
 
+#include "KokkosCore/ExecSpaceLock.h"
 #include "Framework/EDProducer.h"
 #include "Framework/Event.h"
 #include "Framework/EventSetup.h"
@@ -23,6 +24,7 @@ namespace KOKKOS_NAMESPACE {
       : bsPutToken_{reg.produces<BeamSpotKokkos<KokkosExecSpace>>()} {}
 
   void BeamSpotToKokkos::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto const& bsRaw = iSetup.get<BeamSpotPOD>();
     BeamSpotKokkos<KokkosExecSpace> bs{&bsRaw, KokkosExecSpace()};
 
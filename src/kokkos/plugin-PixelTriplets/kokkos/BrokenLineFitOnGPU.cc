@@ -1,16 +1,19 @@
 #include "BrokenLineFitOnGPU.h"
+#include "KokkosCore/MemoryPool.h"
 
 namespace KOKKOS_NAMESPACE {
   void HelixFitOnGPU::launchBrokenLineKernels(HitsView const* hv,
                                               uint32_t hitsInFit,
                                               uint32_t maxNumberOfTuples,
                                               KokkosExecSpace const& execSpace) {
-    //  Fit internals
-    Kokkos::View<double*, KokkosExecSpace> hitsGPU("hitsGPU", maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix3xNd<4>));
-    Kokkos::View<float*, KokkosExecSpace> hits_geGPU("hits_geGPU",
-                                                     maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix6x4f));
-    Kokkos::View<double*, KokkosExecSpace> fast_fit_resultsGPU("fast_fit_resultsGPU",
-                                                               maxNumberOfConcurrentFits_ * sizeof(Rfit::Vector4d));
+    //  Fit internals, returned to the pool after the kernels have been queued
+    cms::kokkos::PooledViews views;
+    Kokkos::View<double*, KokkosExecSpace> hitsGPU =
+        views.make<double*, KokkosExecSpace>(maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix3xNd<4>));
+    Kokkos::View<float*, KokkosExecSpace> hits_geGPU =
+        views.make<float*, KokkosExecSpace>(maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix6x4f));
+    Kokkos::View<double*, KokkosExecSpace> fast_fit_resultsGPU =
+        views.make<double*, KokkosExecSpace>(maxNumberOfConcurrentFits_ * sizeof(Rfit::Vector4d));
 
     // avoid capturing this by the lambdas
     auto const bField = bField_;
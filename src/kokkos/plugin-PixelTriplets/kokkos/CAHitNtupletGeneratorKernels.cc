@@ -45,7 +45,7 @@ namespace KOKKOS_NAMESPACE {
     assert(teamSize > 0 && 0 == teamSize % 16);
     teamSize *= stride;
 
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
     Kokkos::TeamPolicy<KokkosExecSpace> policy{execSpace, leagueSize, 1};
     // unit stride loop for serial execution
     stride = 1;
@@ -97,7 +97,7 @@ namespace KOKKOS_NAMESPACE {
       int stride = 16;
       int blockSize = teamSize / stride;
       int leagueSize = (nhits + blockSize - 1) / blockSize;
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
       Kokkos::TeamPolicy<KokkosExecSpace> policy{execSpace, leagueSize, 1};
       // unit stride loop for serial execution
       stride = 1;
@@ -175,7 +175,7 @@ namespace KOKKOS_NAMESPACE {
       int stride = 16;
       int blockSize = teamSize / stride;
       int leagueSize = (nhits + blockSize - 1) / blockSize;
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
       Kokkos::TeamPolicy<KokkosExecSpace> policy{execSpace, leagueSize, 1};
       // unit stride loop for serial execution
       stride = 1;
@@ -191,7 +191,7 @@ namespace KOKKOS_NAMESPACE {
     if (m_params.doStats_) {
       teamSize = 128;
       leagueSize = (std::max(nhits, m_params.maxNumberOfDoublets_) + teamSize - 1) / teamSize;
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
       policy = Kokkos::TeamPolicy<KokkosExecSpace>(execSpace, leagueSize, 1);
 #else
       policy = Kokkos::TeamPolicy<KokkosExecSpace>(execSpace, leagueSize, teamSize);
@@ -231,8 +231,7 @@ namespace KOKKOS_NAMESPACE {
 #endif
 
     // in principle we can use "nhits" to heuristically dimension the workspace...
-    device_isOuterHitOfCell_ =
-        Kokkos::View<GPUCACell::OuterHitOfCell *, KokkosExecSpace>("device_isOuterHitOfCell_", std::max(1U, nhits));
+    device_isOuterHitOfCell_ = views_.make<GPUCACell::OuterHitOfCell *, KokkosExecSpace>(std::max(1U, nhits));
 
     {
       auto isOuterHitOfCell = device_isOuterHitOfCell_;
@@ -243,7 +242,7 @@ namespace KOKKOS_NAMESPACE {
           });
     }
 
-    device_theCells_ = Kokkos::View<GPUCACell *, KokkosExecSpace>("device_theCells_", m_params.maxNumberOfDoublets_);
+    device_theCells_ = views_.make<GPUCACell *, KokkosExecSpace>(m_params.maxNumberOfDoublets_);
 
 #ifdef GPU_DEBUG
     execSpace.fence();
@@ -261,12 +260,13 @@ namespace KOKKOS_NAMESPACE {
     }
 
     assert(nActualPairs <= gpuPixelDoublets::nPairs);
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
+    // one single-thread team per host thread, the kernel loops over the doublets with a grid stride
     int stride = 1;
     Kokkos::TeamPolicy<KokkosExecSpace,
                        Kokkos::LaunchBounds<gpuPixelDoublets::getDoubletsFromHistoMaxBlockSize,
                                             gpuPixelDoublets::getDoubletsFromHistoMinBlocksPerMP>>
-        tempPolicy{execSpace, 1, Kokkos::AUTO()};
+        tempPolicy{execSpace, execSpace.concurrency(), 1};
 #else
     int stride = 4;
     int teamSize = gpuPixelDoublets::getDoubletsFromHistoMaxBlockSize / stride;
@@ -418,15 +418,15 @@ namespace KOKKOS_NAMESPACE {
     // ALLOCATIONS FOR THE INTERMEDIATE RESULTS (STAYS ON WORKER)
     //////////////////////////////////////////////////////////
 
-    device_hitToTuple_ = Kokkos::View<HitToTuple, KokkosExecSpace>("device_hitToTuple_");
+    device_hitToTuple_ = views_.make<HitToTuple, KokkosExecSpace>();
 
-    device_tupleMultiplicity_ = Kokkos::View<TupleMultiplicity, KokkosExecSpace>("device_tupleMultiplicity_");
+    device_tupleMultiplicity_ = views_.make<TupleMultiplicity, KokkosExecSpace>();
 
-    device_hitTuple_apc_ = Kokkos::View<AtomicPairCounter, KokkosExecSpace>("device_hitTuple_apc_");
-    device_hitToTuple_apc_ = Kokkos::View<AtomicPairCounter, KokkosExecSpace>("device_hitToTuple_apc_");
-    device_nCells_ = Kokkos::View<uint32_t, KokkosExecSpace>("device_nCells_");
-    device_tmws_ = Kokkos::View<uint8_t *, KokkosExecSpace>(
-        "device_tmws_", std::max(TupleMultiplicity::wsSize(), HitToTuple::wsSize()));
+    // reset by kernel_connect
+    device_hitTuple_apc_ = views_.make<AtomicPairCounter, KokkosExecSpace>();
+    device_hitToTuple_apc_ = views_.make<AtomicPairCounter, KokkosExecSpace>();
+    device_nCells_ = views_.make<uint32_t, KokkosExecSpace>();
+    device_tmws_ = views_.make<uint8_t *, KokkosExecSpace>(std::max(TupleMultiplicity::wsSize(), HitToTuple::wsSize()));
 
     Kokkos::deep_copy(execSpace, device_nCells_, 0);
 
@@ -1,6 +1,7 @@
 #ifndef RecoPixelVertexing_PixelTriplets_plugins_CAHitNtupletGeneratorKernels_h
 #define RecoPixelVertexing_PixelTriplets_plugins_CAHitNtupletGeneratorKernels_h
 
+#include "KokkosCore/MemoryPool.h"
 #include "KokkosDataFormats/PixelTrackKokkos.h"
 #include "../GPUCACell.h"
 
@@ -182,6 +183,9 @@ namespace KOKKOS_NAMESPACE {
     Counters* counters_ = nullptr;
 
   private:
+    // owns the memory of the workspace, until the end of the event
+    cms::kokkos::PooledViews views_;
+
     Kokkos::View<CAConstants::CellNeighborsVector, KokkosExecSpace> device_theCellNeighbors_;  // not used at the moment
     Kokkos::View<CAConstants::CellTracksVector, KokkosExecSpace> device_theCellTracks_;        // not used at the moment
 
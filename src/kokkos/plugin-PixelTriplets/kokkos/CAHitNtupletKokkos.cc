@@ -7,6 +7,7 @@
 #include "KokkosDataFormats/PixelTrackKokkos.h"
 #include "KokkosDataFormats/TrackingRecHit2DKokkos.h"
 
+#include "KokkosCore/ExecSpaceLock.h"
 #include "KokkosCore/kokkosConfig.h"
 
 namespace KOKKOS_NAMESPACE {
@@ -30,6 +31,7 @@ namespace KOKKOS_NAMESPACE {
         gpuAlgo_(reg) {}
 
   void CAHitNtupletKokkos::produce(edm::Event& iEvent, const edm::EventSetup& es) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto bf = 0.0114256972711507;  // 1/fieldInGeV
 
     auto const& hits = iEvent.get(tokenHitGPU_);
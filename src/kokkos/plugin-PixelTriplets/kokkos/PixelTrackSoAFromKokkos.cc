@@ -1,3 +1,4 @@
+#include "KokkosCore/ExecSpaceLock.h"
 #include "KokkosCore/kokkosConfig.h"
 #include "KokkosDataFormats/PixelTrackKokkos.h"
 #include "Framework/EventSetup.h"
@@ -49,6 +50,7 @@ namespace KOKKOS_NAMESPACE {
 #endif
 
   void PixelTrackSoAFromKokkos::produce(edm::Event& iEvent, edm::EventSetup const& iSetup) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto const& inputData = iEvent.get(tokenKokkos_);
 
     /*
@@ -1,19 +1,21 @@
 #include "RiemannFitOnGPU.h"
+#include "KokkosCore/MemoryPool.h"
 
 namespace KOKKOS_NAMESPACE {
   void HelixFitOnGPU::launchRiemannKernels(HitsView const *hv,
                                            uint32_t nhits,
                                            uint32_t maxNumberOfTuples,
                                            KokkosExecSpace const &execSpace) {
-    //  Fit internals
-    Kokkos::View<double *, KokkosExecSpace> hitsGPU("hitsGPU",
-                                                    maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix3xNd<4>));
-    Kokkos::View<float *, KokkosExecSpace> hits_geGPU("hits_geGPU",
-                                                      maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix6x4f));
-    Kokkos::View<double *, KokkosExecSpace> fast_fit_resultsGPU("fast_fit_resultsGPU",
-                                                                maxNumberOfConcurrentFits_ * sizeof(Rfit::Vector4d));
-    Kokkos::View<Rfit::circle_fit *, KokkosExecSpace> circle_fit_resultsGPU("circle_fit_resultsGPU",
-                                                                            maxNumberOfConcurrentFits_);
+    //  Fit internals, returned to the pool after the kernels have been queued
+    cms::kokkos::PooledViews views;
+    Kokkos::View<double *, KokkosExecSpace> hitsGPU =
+        views.make<double *, KokkosExecSpace>(maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix3xNd<4>));
+    Kokkos::View<float *, KokkosExecSpace> hits_geGPU =
+        views.make<float *, KokkosExecSpace>(maxNumberOfConcurrentFits_ * sizeof(Rfit::Matrix6x4f));
+    Kokkos::View<double *, KokkosExecSpace> fast_fit_resultsGPU =
+        views.make<double *, KokkosExecSpace>(maxNumberOfConcurrentFits_ * sizeof(Rfit::Vector4d));
+    Kokkos::View<Rfit::circle_fit *, KokkosExecSpace> circle_fit_resultsGPU =
+        views.make<Rfit::circle_fit *, KokkosExecSpace>(maxNumberOfConcurrentFits_);
 
     // avoid capturing this by the lambdas
     auto const bField = bField_;
@@ -1,4 +1,5 @@
 #include "DataFormats/ZVertexSoA.h"
+#include "KokkosCore/ExecSpaceLock.h"
 #include "KokkosCore/kokkosConfig.h"
 #include "KokkosDataFormats/PixelTrackKokkos.h"
 #include "Framework/EventSetup.h"
@@ -43,6 +44,7 @@ namespace KOKKOS_NAMESPACE {
   {}
 
   void PixelVertexProducerKokkos::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto const& tracks = iEvent.get(tokenTrack_);
 
     iEvent.emplace(tokenVertex_, m_gpuAlgo.make(tracks, m_ptMin, KokkosExecSpace()));
@@ -1,3 +1,4 @@
+#include "KokkosCore/ExecSpaceLock.h"
 #include "KokkosCore/kokkosConfig.h"
 #include "DataFormats/ZVertexSoA.h"
 #include "Framework/EventSetup.h"
@@ -50,6 +51,7 @@ namespace KOKKOS_NAMESPACE {
 #endif
 
   void PixelVertexSoAFromKokkos::produce(edm::Event& iEvent, edm::EventSetup const& iSetup) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto const& inputData = iEvent.get(tokenKokkos_);
     VerticesHostSpace outputData("vertices");
     Kokkos::deep_copy(KokkosExecSpace(), outputData, inputData);
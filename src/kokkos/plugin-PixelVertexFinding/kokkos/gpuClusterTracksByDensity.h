@@ -3,6 +3,7 @@
 
 #include "KokkosCore/kokkos_assert.h"
 #include "KokkosCore/HistoContainer.h"
+#include "KokkosCore/MemoryPool.h"
 
 #include "gpuVertexFinder.h"
 #include "gpuClusterFillHist.h"
@@ -216,7 +217,9 @@ namespace KOKKOS_NAMESPACE {
       auto leagueSize = policy.league_size();
 
       using Hist = HistoContainer<uint8_t, 256, 16000, 8, uint16_t>;
-      Kokkos::View<Hist*, ExecSpace> vhist("vhist", leagueSize);
+      // the offsets are reset by clusterFillHist
+      cms::kokkos::PooledViews views;
+      Kokkos::View<Hist*, ExecSpace> vhist = views.make<Hist*, ExecSpace>(leagueSize);
 
       Kokkos::parallel_for(
           policy, KOKKOS_LAMBDA(const member_type& team_member) {
@@ -1,3 +1,5 @@
+#include "KokkosCore/MemoryPool.h"
+
 #include "gpuVertexFinder.h"
 #include "gpuClusterTracksByDensity.h"
 #include "gpuClusterTracksDBSCAN.h"
@@ -108,7 +110,9 @@ namespace KOKKOS_NAMESPACE {
       // std::cout << "producing Vertices on GPU" << std::endl;
       Kokkos::View<ZVertexSoA, KokkosExecSpace> vertices_d("vertices");
       auto vertices_h = Kokkos::create_mirror_view(vertices_d);
-      Kokkos::View<WorkSpace, KokkosExecSpace> workspace_d("workspace");
+      // returned to the pool after the kernels have been queued
+      cms::kokkos::PooledViews views;
+      Kokkos::View<WorkSpace, KokkosExecSpace> workspace_d = views.make<WorkSpace, KokkosExecSpace>();
 
       using TeamPolicy = Kokkos::TeamPolicy<KokkosExecSpace>;
       using MemberType = Kokkos::TeamPolicy<KokkosExecSpace>::member_type;
@@ -124,7 +128,7 @@ namespace KOKKOS_NAMESPACE {
           Kokkos::RangePolicy<KokkosExecSpace>(execSpace, 0, TkSoA::stride()),
           KOKKOS_LAMBDA(const size_t i) { loadTracks(tksoa, vertices_d, workspace_d, ptMin, i); });
 
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
       auto policy = TeamPolicy(execSpace, 1, 1).set_scratch_size(0, Kokkos::PerTeam(8192 * 4));
 #else
       auto policy = TeamPolicy(execSpace, 1, 1024 - 256).set_scratch_size(0, Kokkos::PerTeam(8192 * 4));
@@ -162,7 +166,7 @@ namespace KOKKOS_NAMESPACE {
             });
         // one block per vertex...
         Kokkos::parallel_for(
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
             TeamPolicy(execSpace, 1024, 1).set_scratch_size(0, Kokkos::PerTeam(8192 * 4)),
 #else
             TeamPolicy(execSpace, 1024, 128).set_scratch_size(0, Kokkos::PerTeam(8192 * 4)),
@@ -33,15 +33,8 @@ namespace KOKKOS_NAMESPACE {
     constexpr uint32_t MAX_FED_WORDS = ::pixelgpudetails::MAX_FED * ::pixelgpudetails::MAX_WORD;
 
     SiPixelRawToClusterGPUKernel::WordFedAppender::WordFedAppender()
-        : word_("word", MAX_FED_WORDS), fedId_("fedId", MAX_FED_WORDS) {}
-
-    void SiPixelRawToClusterGPUKernel::WordFedAppender::initializeWordFed(int fedId,
-                                                                          unsigned int wordCounterGPU,
-                                                                          const uint32_t *src,
-                                                                          unsigned int length) {
-      std::memcpy(word_.data() + wordCounterGPU, src, sizeof(uint32_t) * length);
-      std::memset(fedId_.data() + wordCounterGPU / 2, fedId - 1200, length / 2);
-    }
+        : word_(views_.make<unsigned int *, Kokkos::HostSpace>(MAX_FED_WORDS)),
+          fedId_(views_.make<unsigned char *, Kokkos::HostSpace>(MAX_FED_WORDS)) {}
 
     ////////////////////
     KOKKOS_INLINE_FUNCTION uint32_t getLink(uint32_t ww) {
@@ -582,13 +575,14 @@ namespace KOKKOS_NAMESPACE {
         assert(0 == wordCounter % 2);
         // wordCounter is the total no of words in each event to be trasfered on device
 
-        // TODO: can not deep_copy Views of different size
-        //Kokkos::View<unsigned int *, KokkosExecSpace> word_d("word_d", wordCounter);
-        //Kokkos::View<unsigned char *, KokkosExecSpace> fedId_d("fedId_d", wordCounter);
-        Kokkos::View<unsigned int *, KokkosExecSpace> word_d("word_d", MAX_FED_WORDS);
-        Kokkos::View<unsigned char *, KokkosExecSpace> fedId_d("fedId_d", MAX_FED_WORDS);
-        Kokkos::deep_copy(execSpace, word_d, wordFed.word());
-        Kokkos::deep_copy(execSpace, fedId_d, wordFed.fedId());
+        // the blocks go back to the pool at the end of the scope, after the kernels using them have been queued
+        cms::kokkos::PooledViews views;
+        Kokkos::View<unsigned int *, KokkosExecSpace> word_d = views.make<unsigned int *, KokkosExecSpace>(wordCounter);
+        Kokkos::View<unsigned char *, KokkosExecSpace> fedId_d =
+            views.make<unsigned char *, KokkosExecSpace>(wordCounter);
+        // only the first wordCounter words have been filled
+        Kokkos::deep_copy(execSpace, word_d, Kokkos::subview(wordFed.word(), std::make_pair(0u, wordCounter)));
+        Kokkos::deep_copy(execSpace, fedId_d, Kokkos::subview(wordFed.fedId(), std::make_pair(0u, wordCounter)));
 
         {
           // need Kokkos::Views as local variables to pass to the lambda
@@ -681,7 +675,7 @@ namespace KOKKOS_NAMESPACE {
         Kokkos::deep_copy(
             execSpace, Kokkos::subview(nModules_Clusters_h, 0), Kokkos::subview(clusters_d.moduleStart(), 0));
 
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
         const uint32_t threadsPerBlock = 1;
 #else
         const uint32_t threadsPerBlock = 256;
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 
+#include "KokkosCore/MemoryPool.h"
 #include "KokkosCore/kokkosConfig.h"
 
 #include "KokkosDataFormats/SiPixelDigisKokkos.h"
@@ -148,12 +149,16 @@ namespace KOKKOS_NAMESPACE {
         WordFedAppender();
         ~WordFedAppender() = default;
 
-        void initializeWordFed(int fedId, unsigned int wordCounterGPU, const uint32_t* src, unsigned int length);
+        // filled by FEDWordGatherer::copy()
+        unsigned int* wordData() { return word_.data(); }
+        unsigned char* fedIdData() { return fedId_.data(); }
 
         Kokkos::View<unsigned int const*, KokkosExecSpace>::HostMirror word() const { return word_; }
         Kokkos::View<unsigned char const*, KokkosExecSpace>::HostMirror fedId() const { return fedId_; }
 
       private:
+        // recycled from event to event, only the first words are set and copied
+        cms::kokkos::PooledViews views_;
         Kokkos::View<unsigned int*, KokkosExecSpace>::HostMirror word_;
         Kokkos::View<unsigned char*, KokkosExecSpace>::HostMirror fedId_;
       };
@@ -38,6 +38,11 @@ namespace KOKKOS_NAMESPACE {
         nClustersInModule[index] = 0;
       }
 
+      // the range covers at least all the modules
+      if (index >= size_t(numElements)) {
+        return;
+      }
+
       if (InvId == id[index]) {
         return;
       }
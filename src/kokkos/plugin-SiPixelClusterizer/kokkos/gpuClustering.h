@@ -6,6 +6,8 @@
 
 #include "Geometry/phase1PixelTopology.h"
 #include "KokkosCore/HistoContainer.h"
+#include "KokkosCore/MemoryPool.h"
+#include "KokkosCore/kokkosConfig.h"
 #include "KokkosDataFormats/gpuClusteringConstants.h"
 
 #include "cuda.h"
@@ -22,6 +24,9 @@ namespace KOKKOS_NAMESPACE {
                                              Kokkos::View<int32_t*, KokkosExecSpace> clusterId,
                                              int numElements,
                                              const size_t index) {
+      // the range covers at least all the modules
+      if (index >= size_t(numElements))
+        return;
       clusterId[index] = index;
       if (::gpuClustering::InvId == id[index])
         return;
@@ -61,8 +66,10 @@ namespace gpuClustering {
     constexpr auto nbins = phase1PixelTopology::numColsInModule + 2;  //2+2;
     using Hist = HistoContainer<uint16_t, nbins, maxPixInModule, 9, uint16_t>;
 
-    Kokkos::View<Hist*, ExecSpace> d_hist("d_hist", league_size);
-    Kokkos::View<int*, ExecSpace> d_msize("d_msize", league_size);
+    // returned to the pool at the end of the function, after the kernels using them have been queued
+    cms::kokkos::PooledViews views;
+    Kokkos::View<Hist*, ExecSpace> d_hist = views.make<Hist*, ExecSpace>(league_size);
+    Kokkos::View<int*, ExecSpace> d_msize = views.make<int*, ExecSpace>(league_size);
 
     int loop_count = Hist::totbins();
     Kokkos::parallel_for(
@@ -73,6 +80,9 @@ namespace gpuClustering {
 
     Kokkos::parallel_for(
         "findClus_msize", team_policy(execSpace, league_size, team_size), KOKKOS_LAMBDA(const member_type& teamMember) {
+          if (uint32_t(teamMember.league_rank()) >= moduleStart(0))
+            return;
+
           int firstPixel = moduleStart(1 + teamMember.league_rank());
           auto thisModuleId = id(firstPixel);
           assert(thisModuleId < ::gpuClustering::MaxNumModules);
@@ -140,7 +150,7 @@ namespace gpuClustering {
 
           const uint32_t hist_size = d_hist(teamMember.league_rank()).size();
 
-#ifndef KOKKOS_BACKEND_SERIAL
+#ifndef KOKKOS_HOST_BACKEND
           const uint32_t maxiter = 16;
 #else
           const uint32_t maxiter = hist_size;
@@ -41,7 +41,7 @@ namespace KOKKOS_NAMESPACE {
 
       if (digis_d.nModules() > 0) {  // protect from empty events
                                      // one team for each active module (with digis)
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
         TeamPolicy policy(execSpace, digis_d.nModules(), 1);  // TODO: see if can use Kokkos::AUTO()
 #else
         TeamPolicy policy(execSpace, digis_d.nModules(), 128);  // TODO: see if can use Kokkos::AUTO()
@@ -10,6 +10,7 @@
 
 #include "PixelRecHits.h"  // TODO : spit product from kernel
 
+#include "KokkosCore/ExecSpaceLock.h"
 #include "KokkosCore/kokkosConfig.h"
 
 namespace KOKKOS_NAMESPACE {
@@ -38,6 +39,7 @@ namespace KOKKOS_NAMESPACE {
         tokenHit_(reg.produces<TrackingRecHit2DKokkos<KokkosExecSpace>>()) {}
 
   void SiPixelRecHitKokkos::produce(edm::Event& iEvent, const edm::EventSetup& es) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto const& fcpe = es.get<PixelCPEFast<KokkosExecSpace>>();
 
     auto const& bs = iEvent.get(tBeamSpot);
@@ -1,3 +1,4 @@
+#include "KokkosCore/ExecSpaceLock.h"
 #include "KokkosCore/kokkosConfig.h"
 #include "KokkosDataFormats/PixelTrackKokkos.h"
 #include "KokkosDataFormats/SiPixelClustersKokkos.h"
@@ -59,6 +60,7 @@ namespace KOKKOS_NAMESPACE {
         vertexToken_(reg.consumes<Kokkos::View<ZVertexSoA, KokkosExecSpace>::HostMirror>()) {}
 
   void CountValidator::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     // values from cuda program
     constexpr float trackTolerance = 0.012f;  // in 200 runs of 1k events all events are withing this tolerance
     constexpr int vertexTolerance = 1;
@@ -3,6 +3,7 @@
 #include "KokkosDataFormats/SiPixelDigisKokkos.h"
 #include "KokkosDataFormats/TrackingRecHit2DKokkos.h"
 #include "DataFormats/ZVertexSoA.h"
+#include "KokkosCore/ExecSpaceLock.h"
 #include "Framework/EventSetup.h"
 #include "Framework/Event.h"
 #include "Framework/PluginFactory.h"
@@ -79,6 +80,7 @@ namespace KOKKOS_NAMESPACE {
         vertexToken_(reg.consumes<Kokkos::View<ZVertexSoA, KokkosExecSpace>::HostMirror>()) {}
 
   void HistoValidator::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
+    auto lock = cms::kokkos::lockExecSpace(KokkosExecSpace());
     auto const& digis = iEvent.get(digiToken_);
     auto const& clusters = iEvent.get(clusterToken_);
     auto const& hits = iEvent.get(hitToken_);
@@ -172,6 +174,8 @@ namespace KOKKOS_NAMESPACE {
   void HistoValidator::endJob() {
 #ifdef KOKKOS_BACKEND_SERIAL
     std::ofstream out("histograms_kokkos_serial.txt");
+#elif defined KOKKOS_BACKEND_THREADS
+    std::ofstream out("histograms_kokkos_threads.txt");
 #elif defined KOKKOS_BACKEND_CUDA
     std::ofstream out("histograms_kokkos_cuda.txt");
 #else
@@ -0,0 +1,71 @@
+#include "KokkosCore/kokkosConfigCommon.h"
+#include "KokkosCore/kokkosConfig.h"
+
+#include <cassert>
+#include <iostream>
+
+#include "KokkosCore/MemoryPool.h"
+
+struct Counters {
+  uint32_t n;
+  uint32_t m;
+};
+
+void test() {
+  using Pool = cms::kokkos::MemoryPool<KokkosExecSpace::memory_space>;
+  auto& pool = Pool::instance();
+  assert(0 == pool.allocatedBlocks());
+
+  constexpr uint32_t N = 1000;
+  int* first = nullptr;
+  {
+    cms::kokkos::PooledViews views;
+    Kokkos::View<int*, KokkosExecSpace> v_d = views.make<int*, KokkosExecSpace>(N);
+    Kokkos::View<Counters, KokkosExecSpace> c_d = views.make<Counters, KokkosExecSpace>();
+    first = v_d.data();
+    assert(2 == pool.allocatedBlocks());
+    assert(0 == pool.cachedBytes());
+
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<KokkosExecSpace>(KokkosExecSpace(), 0, N), KOKKOS_LAMBDA(const size_t i) {
+          v_d(i) = i;
+          if (0 == i) {
+            c_d().n = N;
+            c_d().m = 2 * N;
+          }
+        });
+
+    auto v_h = Kokkos::create_mirror_view(v_d);
+    auto c_h = Kokkos::create_mirror_view(c_d);
+    Kokkos::deep_copy(KokkosExecSpace(), v_h, v_d);
+    Kokkos::deep_copy(KokkosExecSpace(), c_h, c_d);
+    KokkosExecSpace().fence();
+    for (uint32_t i = 0; i < N; ++i)
+      assert(int(i) == v_h(i));
+    assert(N == c_h().n and 2 * N == c_h().m);
+  }
+  // the blocks are rounded up to powers of 2, at least 256 bytes
+  std::cout << "cached " << pool.cachedBytes() << " bytes" << std::endl;
+  assert(4096 + 256 == pool.cachedBytes());
+
+  {
+    // a smaller View in the same bin reuses the same block
+    cms::kokkos::PooledViews views;
+    Kokkos::View<int*, KokkosExecSpace> v_d = views.make<int*, KokkosExecSpace>(N / 2 + 100);
+    assert(first == v_d.data());
+    assert(256 == pool.cachedBytes());
+
+    // moving the owner does not free the blocks
+    auto moved = std::move(views);
+    assert(256 == pool.cachedBytes());
+  }
+  assert(2 == pool.allocatedBlocks());
+  assert(4096 + 256 == pool.cachedBytes());
+  std::cout << pool.allocatedBlocks() << " blocks, " << pool.allocatedBytes() << " bytes" << std::endl;
+}
+
+int main() {
+  kokkos_common::InitializeScopeGuard kokkosGuard({KokkosBackend<KokkosExecSpace>::value});
+  test();
+  return 0;
+}
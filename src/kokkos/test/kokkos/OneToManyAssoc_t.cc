@@ -34,7 +34,7 @@ void countMultiLocal(Kokkos::View<uint16_t**, ExecSpace> const tk,
   auto nThreads = 256;
   auto nBlocks = (4 * n + nThreads - 1) / nThreads;
 
-#ifndef KOKKOS_BACKEND_SERIAL
+#ifndef KOKKOS_HOST_BACKEND
   TeamPolicy policy(execSpace, nBlocks, nThreads);
 #else
   TeamPolicy policy(execSpace, nBlocks * nThreads, 1);
@@ -273,7 +273,7 @@ void test() {
         });
     KokkosExecSpace().fence();
 
-#ifdef KOKKOS_BACKEND_SERIAL
+#ifdef KOKKOS_HOST_BACKEND
     uint32_t threadsPerModule = 1;
 #else
     uint32_t threadsPerModule = (kkk == 5) ? 512 : ((kkk == 3) ? 128 : 256);
@@ -7,11 +7,31 @@
 #include "DataFormats/FEDRawDataCollection.h"
 #include "DataFormats/FEDNumbering.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 FEDRawDataCollection::FEDRawDataCollection() : data_(FEDNumbering::lastFEDId() + 1) {}
 
-FEDRawDataCollection::FEDRawDataCollection(const FEDRawDataCollection& in) : data_(in.data_) {}
+FEDRawDataCollection::FEDRawDataCollection(const View* view) : view_(view) {}
+
+FEDRawDataCollection::FEDRawDataCollection(const FEDRawDataCollection& in) : data_(in.data_), view_(in.view_) {}
 FEDRawDataCollection::~FEDRawDataCollection() {}
 
-const FEDRawData& FEDRawDataCollection::FEDData(int fedid) const { return data_[fedid]; }
+const FEDRawData& FEDRawDataCollection::FEDData(int fedid) const {
+  if (view_) {
+    static const FEDRawData empty;
+    auto found = std::lower_bound(view_->fedIds.begin(), view_->fedIds.end(), fedid);
+    if (found == view_->fedIds.end() or *found != fedid) {
+      return empty;
+    }
+    return view_->data[found - view_->fedIds.begin()];
+  }
+  return data_[fedid];
+}
 
-FEDRawData& FEDRawDataCollection::FEDData(int fedid) { return data_[fedid]; }
+FEDRawData& FEDRawDataCollection::FEDData(int fedid) {
+  if (view_) {
+    throw std::runtime_error("FEDRawDataCollection::FEDData: non-const access to a read-only view.");
+  }
+  return data_[fedid];
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <CL/sycl.hpp>
+
+#include "SYCLCore/CachingAllocator.h"
+
+namespace {
+  std::size_t power(std::size_t base, unsigned int exp) {
+    std::size_t ret = 1;
+    while (exp-- > 0) {
+      ret *= base;
+    }
+    return ret;
+  }
+
+  const char* kindName(sycl::usm::alloc kind) {
+    switch (kind) {
+      case sycl::usm::alloc::host:
+        return "host";
+      case sycl::usm::alloc::device:
+        return "device";
+      case sycl::usm::alloc::shared:
+        return "shared";
+      default:
+        return "unknown";
+    }
+  }
+}  // namespace
+
+namespace cms::sycltools {
+  CachingAllocator::CachingAllocator(
+      unsigned int binGrowth, unsigned int minBin, unsigned int maxBin, std::size_t maxCachedBytes, bool debug)
+      : binGrowth_(binGrowth),
+        minBin_(minBin),
+        minBinBytes_(power(binGrowth, minBin)),
+        maxBinBytes_(power(binGrowth, maxBin)),
+        maxCachedBytes_(maxCachedBytes),
+        debug_(debug) {}
+
+  CachingAllocator::~CachingAllocator() {
+    try {
+      freeAllCached();
+    } catch (std::exception const& e) {
+      // the destructor must not throw, e.g. if the SYCL runtime is already gone
+      std::cerr << "CachingAllocator: failed to free the cached blocks: " << e.what() << std::endl;
+    }
+  }
+
+  std::tuple<unsigned int, std::size_t> CachingAllocator::bin(std::size_t bytes) const {
+    if (bytes <= minBinBytes_) {
+      return {minBin_, minBinBytes_};
+    }
+    unsigned int bin = minBin_;
+    std::size_t binBytes = minBinBytes_;
+    while (binBytes < bytes) {
+      ++bin;
+      binBytes *= binGrowth_;
+    }
+    return {bin, binBytes};
+  }
+
+  void* CachingAllocator::allocate(std::size_t bytes, sycl::queue queue, sycl::usm::alloc kind) {
+    if (bytes > maxBinBytes_) {
+      throw std::runtime_error("Tried to allocate " + std::to_string(bytes) + " bytes, but the allocator maximum is " +
+                               std::to_string(maxBinBytes_));
+    }
+    auto [binIndex, binBytes] = bin(bytes);
+
+    {
+      std::scoped_lock lock(mutex_);
+      ++stats_.requests;
+      auto [begin, end] = cachedBlocks_.equal_range({kind, binIndex});
+      for (auto it = begin; it != end; ++it) {
+        auto& block = it->second;
+        if (block.queue.get_device() != queue.get_device()) {
+          continue;
+        }
+        // the queues are in order, so the work on the same queue is always
+        // run after the work submitted before the free
+        if (block.queue != queue and block.ready->get_info<sycl::info::event::command_execution_status>() !=
+                                         sycl::info::event_command_status::complete) {
+          continue;
+        }
+        block.queue = queue;
+        block.ready.reset();
+        void* ptr = block.ptr;
+        stats_.cachedBytes -= block.bytes;
+        --stats_.cachedBlocks;
+        stats_.liveBytes += block.bytes;
+        ++stats_.liveBlocks;
+        stats_.maxLiveBytes = std::max(stats_.maxLiveBytes, stats_.liveBytes);
+        ++stats_.cacheHits;
+        liveBlocks_.emplace(ptr, std::move(block));
+        cachedBlocks_.erase(it);
+        if (debug_) {
+          std::cout << "CachingAllocator: reused cached " << kindName(kind) << " block at " << ptr << " (" << binBytes
+                    << " bytes)" << std::endl;
+        }
+        return ptr;
+      }
+    }
+
+    // no suitable cached block, allocate a new one outside of the lock
+    void* ptr = sycl::malloc(binBytes, queue, kind);
+    if (ptr == nullptr) {
+      // give the cached blocks back and try again
+      freeAllCached();
+      ptr = sycl::malloc(binBytes, queue, kind);
+      if (ptr == nullptr) {
+        throw std::runtime_error("Failed to allocate " + std::to_string(binBytes) + " bytes of " + kindName(kind) +
+                                 " memory");
+      }
+    }
+
+    std::scoped_lock lock(mutex_);
+    ++stats_.allocations;
+    stats_.liveBytes += binBytes;
+    ++stats_.liveBlocks;
+    stats_.maxLiveBytes = std::max(stats_.maxLiveBytes, stats_.liveBytes);
+    liveBlocks_.emplace(ptr, Block{ptr, binBytes, binIndex, kind, queue, std::nullopt});
+    if (debug_) {
+      std::cout << "CachingAllocator: allocated new " << kindName(kind) << " block at " << ptr << " (" << binBytes
+                << " bytes)" << std::endl;
+    }
+    return ptr;
+  }
+
+  void CachingAllocator::free(void* ptr) {
+    std::unique_lock lock(mutex_);
+    auto found = liveBlocks_.find(ptr);
+    if (found == liveBlocks_.end()) {
+      throw std::runtime_error("Tried to free a block that was not allocated by the CachingAllocator");
+    }
+    Block block = std::move(found->second);
+    liveBlocks_.erase(found);
+    stats_.liveBytes -= block.bytes;
+    --stats_.liveBlocks;
+
+    // the barrier marks the point of the queue after which the block is no longer used
+    block.ready = block.queue.submit_barrier();
+    if (maxCachedBytes_ == 0 or stats_.cachedBytes + block.bytes <= maxCachedBytes_) {
+      stats_.cachedBytes += block.bytes;
+      ++stats_.cachedBlocks;
+      if (debug_) {
+        std::cout << "CachingAllocator: cached " << kindName(block.kind) << " block at " << ptr << " (" << block.bytes
+                  << " bytes)" << std::endl;
+      }
+      cachedBlocks_.emplace(std::make_tuple(block.kind, block.bin), std::move(block));
+      return;
+    }
+
+    // the cache is full, give the block back outside of the lock
+    lock.unlock();
+    if (debug_) {
+      std::cout << "CachingAllocator: freed " << kindName(block.kind) << " block at " << ptr << " (" << block.bytes
+                << " bytes)" << std::endl;
+    }
+    release(block);
+  }
+
+  void CachingAllocator::release(Block& block) const {
+    // sycl::free() does not wait for the work that may still use the block
+    block.ready->wait();
+    sycl::free(block.ptr, block.queue);
+  }
+
+  void CachingAllocator::freeAllCached() {
+    decltype(cachedBlocks_) blocks;
+    {
+      std::scoped_lock lock(mutex_);
+      std::swap(blocks, cachedBlocks_);
+      stats_.cachedBlocks = 0;
+      stats_.cachedBytes = 0;
+    }
+    for (auto& [key, block] : blocks) {
+      release(block);
+    }
+  }
+
+  CachingAllocator::Statistics CachingAllocator::statistics() const {
+    std::scoped_lock lock(mutex_);
+    return stats_;
+  }
+
+  void CachingAllocator::printStatistics(std::ostream& out) const {
+    auto stats = statistics();
+    out << "CachingAllocator: " << stats.requests << " requests, " << stats.cacheHits << " served from the cache, "
+        << stats.allocations << " SYCL allocations\n"
+        << "CachingAllocator: " << stats.liveBlocks << " live blocks (" << stats.liveBytes << " bytes), "
+        << stats.cachedBlocks << " cached blocks (" << stats.cachedBytes << " bytes), peak of " << stats.maxLiveBytes
+        << " live bytes" << std::endl;
+  }
+}  // namespace cms::sycltools
@@ -0,0 +1,16 @@
+#ifndef HeterogeneousCore_SYCLCore_allocate_device_h
+#define HeterogeneousCore_SYCLCore_allocate_device_h
+
+#include <CL/sycl.hpp>
+
+namespace cms {
+  namespace sycltools {
+    // Allocate device memory
+    void *allocate_device(size_t nbytes, sycl::queue stream);
+
+    // Free device memory (to be called from unique_ptr)
+    void free_device(void *ptr, sycl::queue stream);
+  }  // namespace sycltools
+}  // namespace cms
+
+#endif
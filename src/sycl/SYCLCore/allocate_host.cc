@@ -0,0 +1,23 @@
+#include <CL/sycl.hpp>
+
+#include "SYCLCore/allocate_host.h"
+#include "SYCLCore/getCachingAllocator.h"
+
+namespace cms::sycltools {
+  void *allocate_host(size_t nbytes, sycl::queue stream) {
+    if constexpr (allocator::useCaching) {
+      return allocator::getCachingAllocator().allocate(nbytes, stream, sycl::usm::alloc::host);
+    } else {
+      return sycl::malloc_host(nbytes, stream);
+    }
+  }
+
+  void free_host(void *ptr, sycl::queue stream) {
+    if constexpr (allocator::useCaching) {
+      allocator::getCachingAllocator().free(ptr);
+    } else {
+      sycl::free(ptr, stream);
+    }
+  }
+
+}  // namespace cms::sycltools
@@ -0,0 +1,48 @@
+#ifndef HeterogeneousCore_SYCLCore_getCachingAllocator_h
+#define HeterogeneousCore_SYCLCore_getCachingAllocator_h
+
+#include <algorithm>
+#include <limits>
+
+#include <CL/sycl.hpp>
+
+#include "SYCLCore/CachingAllocator.h"
+#include "SYCLCore/chooseDevice.h"
+
+namespace cms::sycltools::allocator {
+  // Use caching or not
+  constexpr bool useCaching = true;
+  // Growth factor of the bins
+  constexpr unsigned int binGrowth = 8;
+  // Smallest bin, corresponds to binGrowth^minBin bytes
+  constexpr unsigned int minBin = 1;
+  // Largest bin, corresponds to binGrowth^maxBin bytes. Larger allocations are set to fail.
+  constexpr unsigned int maxBin = 10;
+  // Total storage for the allocator. 0 means no limit.
+  constexpr size_t maxCachedBytes = 0;
+  // Fraction of the global memory of the devices taken for the allocator. In case there are multiple devices with
+  // different amounts of memory, the smallest of them is taken. If maxCachedBytes is non-zero, the smallest of them is
+  // taken.
+  constexpr double maxCachedFraction = 0.8;
+  constexpr bool debug = false;
+
+  inline size_t minCachedBytes() {
+    size_t ret = std::numeric_limits<size_t>::max();
+    for (auto const& device : enumerateDevices()) {
+      auto memory = device.get_info<sycl::info::device::global_mem_size>();
+      ret = std::min(ret, static_cast<size_t>(maxCachedFraction * memory));
+    }
+    if (maxCachedBytes > 0) {
+      ret = std::min(ret, maxCachedBytes);
+    }
+    return ret;
+  }
+
+  inline CachingAllocator& getCachingAllocator() {
+    // the public interface is thread safe
+    static CachingAllocator allocator{binGrowth, minBin, maxBin, minCachedBytes(), debug};
+    return allocator;
+  }
+}  // namespace cms::sycltools::allocator
+
+#endif
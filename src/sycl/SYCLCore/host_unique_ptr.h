@@ -7,6 +7,8 @@
 
 #include <CL/sycl.hpp>
 
+#include "SYCLCore/allocate_host.h"
+
 namespace cms {
   namespace sycltools {
     namespace host {
@@ -19,7 +21,7 @@ namespace cms {
 
           void operator()(void *ptr) {
             if (stream_) {
-              sycl::free(ptr, *stream_);
+              free_host(ptr, *stream_);
             }
           }
 
@@ -52,7 +54,7 @@ namespace cms {
     typename host::impl::make_host_unique_selector<T>::non_array make_host_unique(sycl::queue stream) {
       static_assert(std::is_trivially_constructible<T>::value,
                     "Allocating with non-trivial constructor on the pinned host memory is not supported");
-      void *mem = sycl::malloc_host(sizeof(T), stream);
+      void *mem = allocate_host(sizeof(T), stream);
       return typename host::impl::make_host_unique_selector<T>::non_array{reinterpret_cast<T *>(mem),
                                                                           host::impl::HostDeleter{stream}};
     }
@@ -62,7 +64,7 @@ namespace cms {
       using element_type = typename std::remove_extent<T>::type;
       static_assert(std::is_trivially_constructible<element_type>::value,
                     "Allocating with non-trivial constructor on the pinned host memory is not supported");
-      void *mem = sycl::malloc_host(n * sizeof(element_type), stream);
+      void *mem = allocate_host(n * sizeof(element_type), stream);
       return typename host::impl::make_host_unique_selector<T>::unbounded_array{reinterpret_cast<element_type *>(mem),
                                                                                 host::impl::HostDeleter{stream}};
     }
@@ -73,7 +75,7 @@ namespace cms {
     // No check for the trivial constructor, make it clear in the interface
     template <typename T>
     typename host::impl::make_host_unique_selector<T>::non_array make_host_unique_uninitialized(sycl::queue stream) {
-      void *mem = sycl::malloc_host(sizeof(T), stream);
+      void *mem = allocate_host(sizeof(T), stream);
       return typename host::impl::make_host_unique_selector<T>::non_array{reinterpret_cast<T *>(mem),
                                                                           host::impl::HostDeleter{stream}};
     }
@@ -82,7 +84,7 @@ namespace cms {
     typename host::impl::make_host_unique_selector<T>::unbounded_array make_host_unique_uninitialized(
         size_t n, sycl::queue stream) {
       using element_type = typename std::remove_extent<T>::type;
-      void *mem = sycl::malloc_host(n * sizeof(element_type), stream);
+      void *mem = allocate_host(n * sizeof(element_type), stream);
       return typename host::impl::make_host_unique_selector<T>::unbounded_array{reinterpret_cast<element_type *>(mem),
                                                                                 host::impl::HostDeleter{stream}};
     }
@@ -19,7 +19,8 @@ namespace edm {
                             std::vector<std::string> const& path,
                             std::vector<std::string> const& esproducers,
                             std::filesystem::path const& datadir,
-                            bool validation);
+                            bool validation,
+                            Source::Mode sourceMode = Source::Mode::kRead);
 
     int maxEvents() const { return source_.maxEvents(); }
 
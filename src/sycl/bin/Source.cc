@@ -1,7 +1,20 @@
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "Source.h"
 
@@ -20,29 +33,109 @@ namespace {
     return rawCollection;
   }
 
+  // Builds the index of one event starting at offset. The FED payloads are not copied, unless some of them
+  // are not 8-byte aligned: they are read as 64-bit words, while in the file they are only 4-byte aligned
+  // (with the layout of raw.bin, in every other event). Then all the payloads of the event are copied to arena.
+  FEDRawDataCollection::View indexRaw(unsigned char const *begin,
+                                      std::size_t size,
+                                      std::size_t &offset,
+                                      std::vector<unsigned char> &arena) {
+    auto readUInt = [&]() {
+      if (offset + sizeof(unsigned int) > size) {
+        throw std::runtime_error("Truncated raw data file");
+      }
+      unsigned int value;
+      std::memcpy(&value, begin + offset, sizeof(unsigned int));
+      offset += sizeof(unsigned int);
+      return value;
+    };
+
+    unsigned int nfeds = readUInt();
+    // fedId, offset and size of the payloads
+    std::vector<std::tuple<int, std::size_t, std::size_t>> entries;
+    entries.reserve(nfeds);
+    bool aligned = true;
+    std::size_t alignedSize = 0;
+    for (unsigned int ifed = 0; ifed < nfeds; ++ifed) {
+      unsigned int fedId = readUInt();
+      unsigned int fedSize = readUInt();
+      if (offset + fedSize > size) {
+        throw std::runtime_error("Truncated raw data file");
+      }
+      entries.emplace_back(fedId, offset, fedSize);
+      aligned = aligned and reinterpret_cast<std::uintptr_t>(begin + offset) % alignof(uint64_t) == 0;
+      alignedSize += (fedSize + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+      offset += fedSize;
+    }
+
+    std::vector<std::pair<int, FEDRawData>> feds;
+    feds.reserve(nfeds);
+    if (aligned) {
+      for (auto const &[fedId, fedOffset, fedSize] : entries) {
+        feds.emplace_back(fedId, FEDRawData(begin + fedOffset, fedSize));
+      }
+    } else {
+      // the buffer of a std::vector is aligned for any fundamental type
+      arena.resize(alignedSize);
+      std::size_t arenaOffset = 0;
+      for (auto const &[fedId, fedOffset, fedSize] : entries) {
+        std::memcpy(arena.data() + arenaOffset, begin + fedOffset, fedSize);
+        feds.emplace_back(fedId, FEDRawData(arena.data() + arenaOffset, fedSize));
+        arenaOffset += (fedSize + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+      }
+    }
+    std::sort(feds.begin(), feds.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+
+    FEDRawDataCollection::View view;
+    view.fedIds.reserve(nfeds);
+    view.data.reserve(nfeds);
+    for (auto const &fed : feds) {
+      view.fedIds.push_back(fed.first);
+      view.data.push_back(fed.second);
+    }
+    return view;
+  }
 }  // namespace
 
 namespace edm {
-  Source::Source(int maxEvents, ProductRegistry &reg, std::filesystem::path const &datadir, bool validation)
+  Source::Source(int maxEvents, ProductRegistry &reg, std::filesystem::path const &datadir, bool validation, Mode mode)
       : maxEvents_(maxEvents), numEvents_(0), rawToken_(reg.produces<FEDRawDataCollection>()), validation_(validation) {
-    std::ifstream in_raw(datadir / "raw.bin", std::ios::binary);
-    std::ifstream in_digiclusters;
-    std::ifstream in_tracks;
-    std::ifstream in_vertices;
-
     if (validation_) {
       digiClusterToken_ = reg.produces<DigiClusterCount>();
       trackToken_ = reg.produces<TrackCount>();
       vertexToken_ = reg.produces<VertexCount>();
+    }
+
+    switch (mode) {
+      case Mode::kRead:
+        readRawFile(datadir / "raw.bin");
+        break;
+      case Mode::kMmap:
+        mapRawFile(datadir / "raw.bin");
+        break;
+    }
 
-      in_digiclusters = std::ifstream(datadir / "digicluster.bin", std::ios::binary);
-      in_tracks = std::ifstream(datadir / "tracks.bin", std::ios::binary);
-      in_vertices = std::ifstream(datadir / "vertices.bin", std::ios::binary);
-      in_digiclusters.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
-      in_tracks.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
-      in_vertices.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    if (validation_) {
+      readValidation(datadir);
+      //assert(raw_.size() == digiclusters_.size());
+      //assert(raw_.size() == tracks_.size());
+      //assert(raw_.size() == vertices_.size());
     }
 
+    if (maxEvents_ < 0) {
+      maxEvents_ = raw_.size();
+    }
+  }
+
+  Source::~Source() {
+    if (mapped_) {
+      munmap(mapped_, mappedSize_);
+    }
+  }
+
+  void Source::readRawFile(std::filesystem::path const &filename) {
+    std::ifstream in_raw(filename, std::ios::binary);
+
     unsigned int nfeds;
     in_raw.exceptions(std::ifstream::badbit);
     in_raw.read(reinterpret_cast<char *>(&nfeds), sizeof(unsigned int));
@@ -51,31 +144,72 @@ namespace edm {
 
       raw_.emplace_back(readRaw(in_raw, nfeds));
 
-      if (validation_) {
-        unsigned int nm, nd, nc, nt, nv;
-        in_digiclusters.read(reinterpret_cast<char *>(&nm), sizeof(unsigned int));
-        in_digiclusters.read(reinterpret_cast<char *>(&nd), sizeof(unsigned int));
-        in_digiclusters.read(reinterpret_cast<char *>(&nc), sizeof(unsigned int));
-        in_tracks.read(reinterpret_cast<char *>(&nt), sizeof(unsigned int));
-        in_vertices.read(reinterpret_cast<char *>(&nv), sizeof(unsigned int));
-        digiclusters_.emplace_back(nm, nd, nc);
-        tracks_.emplace_back(nt);
-        vertices_.emplace_back(nv);
-      }
-
       // next event
       in_raw.exceptions(std::ifstream::badbit);
       in_raw.read(reinterpret_cast<char *>(&nfeds), sizeof(unsigned int));
     }
+  }
 
-    if (validation_) {
-      //assert(raw_.size() == digiclusters_.size());
-      //assert(raw_.size() == tracks_.size());
-      //assert(raw_.size() == vertices_.size());
+  void Source::mapRawFile(std::filesystem::path const &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open " + filename.string() + ": " + std::strerror(errno));
     }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error("Failed to stat " + filename.string() + ": " + std::strerror(errno));
+    }
+    mappedSize_ = st.st_size;
+    if (mappedSize_ > 0) {
+      mapped_ = mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapped_ == MAP_FAILED) {
+      mapped_ = nullptr;
+      throw std::runtime_error("Failed to mmap " + filename.string() + ": " + std::strerror(errno));
+    }
+    // the events are indexed once in order, and then replayed in order
+    madvise(mapped_, mappedSize_, MADV_SEQUENTIAL);
 
-    if (maxEvents_ < 0) {
-      maxEvents_ = raw_.size();
+    // Only the offsets are collected here, the pages are faulted in
+    // lazily by the consumers of the FED payloads. The events with
+    // misaligned payloads are copied to arenas_.
+    auto const *begin = static_cast<unsigned char const *>(mapped_);
+    std::size_t offset = 0;
+    while (offset < mappedSize_) {
+      std::vector<unsigned char> arena;
+      views_.emplace_back(indexRaw(begin, mappedSize_, offset, arena));
+      if (not arena.empty()) {
+        arenas_.emplace_back(std::move(arena));
+      }
+    }
+
+    // views_ must not be modified after this point
+    raw_.reserve(views_.size());
+    for (auto const &view : views_) {
+      raw_.emplace_back(&view);
+    }
+  }
+
+  void Source::readValidation(std::filesystem::path const &datadir) {
+    std::ifstream in_digiclusters(datadir / "digicluster.bin", std::ios::binary);
+    std::ifstream in_tracks(datadir / "tracks.bin", std::ios::binary);
+    std::ifstream in_vertices(datadir / "vertices.bin", std::ios::binary);
+    in_digiclusters.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    in_tracks.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+    in_vertices.exceptions(std::ifstream::badbit | std::ifstream::failbit | std::ifstream::eofbit);
+
+    for (std::size_t i = 0; i < raw_.size(); ++i) {
+      unsigned int nm, nd, nc, nt, nv;
+      in_digiclusters.read(reinterpret_cast<char *>(&nm), sizeof(unsigned int));
+      in_digiclusters.read(reinterpret_cast<char *>(&nd), sizeof(unsigned int));
+      in_digiclusters.read(reinterpret_cast<char *>(&nc), sizeof(unsigned int));
+      in_tracks.read(reinterpret_cast<char *>(&nt), sizeof(unsigned int));
+      in_vertices.read(reinterpret_cast<char *>(&nv), sizeof(unsigned int));
+      digiclusters_.emplace_back(nm, nd, nc);
+      tracks_.emplace_back(nt);
+      vertices_.emplace_back(nv);
     }
   }
 
@@ -88,6 +222,7 @@ namespace edm {
     auto ev = std::make_unique<Event>(streamId, iev, reg);
     const int index = old % raw_.size();
 
+    // in Mode::kMmap this copies only the pointer to the view
     ev->emplace(rawToken_, raw_[index]);
     if (validation_) {
       ev->emplace(digiClusterToken_, digiclusters_[index]);
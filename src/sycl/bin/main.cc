@@ -11,6 +11,7 @@
 #include <tbb/task_scheduler_init.h>
 
 #include "SYCLCore/chooseDevice.h"
+#include "SYCLCore/getCachingAllocator.h"
 #include "EventProcessor.h"
 
 namespace {
@@ -18,7 +19,7 @@ namespace {
     std::cout
         << name
         << ": [--numberOfThreads NT] [--numberOfStreams NS] [--maxEvents ME] [--data PATH] [--transfer] [--validation] "
-           "[--histogram] [--empty]\n\n"
+           "[--histogram] [--empty] [--mmap]\n\n"
         << "Options\n"
         << " --numberOfThreads   Number of threads to use (default 1)\n"
         << " --numberOfStreams   Number of concurrent events (default 0=numberOfThreads)\n"
@@ -28,6 +29,7 @@ namespace {
         << " --validation        Run (rudimentary) validation at the end (implies --transfer)\n"
         << " --histogram         Produce histograms at the end (implies --transfer)\n"
         << " --empty             Ignore all producers (for testing only)\n"
+        << " --mmap              Memory-map the raw data file instead of reading it in memory\n"
         << std::endl;
   }
 }  // namespace
@@ -43,6 +45,7 @@ int main(int argc, char** argv) try {
   bool validation = false;
   bool histogram = false;
   bool empty = false;
+  auto sourceMode = edm::Source::Mode::kRead;
   for (auto i = args.begin() + 1, e = args.end(); i != e; ++i) {
     if (*i == "-h" or *i == "--help") {
       print_help(args.front());
@@ -69,6 +72,8 @@ int main(int argc, char** argv) try {
       histogram = true;
     } else if (*i == "--empty") {
       empty = true;
+    } else if (*i == "--mmap") {
+      sourceMode = edm::Source::Mode::kMmap;
     } else {
       std::cout << "Invalid parameter " << *i << std::endl << std::endl;
       print_help(args.front());
@@ -109,7 +114,7 @@ int main(int argc, char** argv) try {
     }
   }
   edm::EventProcessor processor(
-      maxEvents, numberOfStreams, std::move(edmodules), std::move(esmodules), datadir, validation);
+      maxEvents, numberOfStreams, std::move(edmodules), std::move(esmodules), datadir, validation, sourceMode);
   maxEvents = processor.maxEvents();
 
   std::cout << "Processing " << maxEvents << " events, of which " << numberOfStreams << " concurrently, with "
@@ -157,6 +162,13 @@ int main(int argc, char** argv) try {
   auto time = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1e6;
   std::cout << "Processed " << maxEvents << " events in " << std::scientific << time << " seconds, throughput "
             << std::defaultfloat << (maxEvents / time) << " events/s." << std::endl;
+
+  // Report the allocator statistics, and give the cached memory back to the SYCL runtime
+  if constexpr (cms::sycltools::allocator::useCaching) {
+    auto& allocator = cms::sycltools::allocator::getCachingAllocator();
+    allocator.printStatistics(std::cout);
+    allocator.freeAllCached();
+  }
   return EXIT_SUCCESS;
 } catch (sycl::exception const& exc) {
   std::cerr << exc.what() << "Exception caught at file:" << __FILE__ << ", line:" << __LINE__ << std::endl;
@@ -15,7 +15,7 @@
 #include "Framework/EDProducer.h"
 #include "SYCLCore/ScopedContext.h"
 
-#include "ErrorChecker.h"
+#include "FEDWordGatherer.h"
 #include "SiPixelRawToClusterGPUKernel.h"
 
 #include <memory>
@@ -42,6 +42,7 @@ private:
 
   pixelgpudetails::SiPixelRawToClusterGPUKernel gpuAlgo_;
   std::unique_ptr<pixelgpudetails::SiPixelRawToClusterGPUKernel::WordFedAppender> wordFedAppender_;
+  FEDWordGatherer gatherer_;
   PixelFormatterErrors errors_;
 
   const bool includeErrors_;
@@ -86,64 +87,12 @@ void SiPixelRawToClusterCUDA::acquire(const edm::Event& iEvent,
   errors_.clear();
 
   // GPU specific: Data extraction for RawToDigi GPU
-  unsigned int wordCounterGPU = 0;
-  unsigned int fedCounter = 0;
   bool errorsInEvent = false;
 
-  // In CPU algorithm this loop is part of PixelDataFormatter::interpretRawData()
-  ErrorChecker errorcheck;
-  for (int fedId : fedIds_) {
-    if (fedId == 40)
-      continue;  // skip pilot blade data
-
-    // for GPU
-    // first 150 index stores the fedId and next 150 will store the
-    // start index of word in that fed
-    //assert(fedId >= 1200);
-    fedCounter++;
-
-    // get event data for this fed
-    const FEDRawData& rawData = buffers.FEDData(fedId);
-
-    // GPU specific
-    int nWords = rawData.size() / sizeof(uint64_t);
-    if (nWords == 0) {
-      continue;
-    }
-
-    // check CRC bit
-    const uint64_t* trailer = reinterpret_cast<const uint64_t*>(rawData.data()) + (nWords - 1);
-    if (not errorcheck.checkCRC(errorsInEvent, fedId, trailer, errors_)) {
-      continue;
-    }
-
-    // check headers
-    const uint64_t* header = reinterpret_cast<const uint64_t*>(rawData.data());
-    header--;
-    bool moreHeaders = true;
-    while (moreHeaders) {
-      header++;
-      bool headerStatus = errorcheck.checkHeader(errorsInEvent, fedId, header, errors_);
-      moreHeaders = headerStatus;
-    }
-
-    // check trailers
-    bool moreTrailers = true;
-    trailer++;
-    while (moreTrailers) {
-      trailer--;
-      bool trailerStatus = errorcheck.checkTrailer(errorsInEvent, fedId, nWords, trailer, errors_);
-      moreTrailers = trailerStatus;
-    }
-
-    const uint32_t* bw = (const uint32_t*)(header + 1);
-    const uint32_t* ew = (const uint32_t*)(trailer);
-
-    //assert(0 == (ew - bw) % 2);
-    wordFedAppender_->initializeWordFed(fedId, wordCounterGPU, bw, (ew - bw));
-    wordCounterGPU += (ew - bw);
-
-  }  // end of for loop
+  // In CPU algorithm this is part of PixelDataFormatter::interpretRawData()
+  unsigned int wordCounterGPU = gatherer_.scan(buffers, fedIds_, errorsInEvent, errors_);
+  unsigned int fedCounter = gatherer_.fedCounter();
+  gatherer_.copy(wordFedAppender_->word(), wordFedAppender_->fedId());
 
   gpuAlgo_.makeClustersAsync(gpuMap,
                              gpuModulesToUnpack,
@@ -147,7 +147,9 @@ namespace pixelgpudetails {
       WordFedAppender();
       ~WordFedAppender() = default;
 
-      void initializeWordFed(int fedId, unsigned int wordCounterGPU, const uint32_t* src, unsigned int length);
+      // filled by FEDWordGatherer::copy()
+      unsigned int* word() { return word_.get(); }
+      unsigned char* fedId() { return fedId_.get(); }
 
       const unsigned int* word() const { return word_.get(); }
       const unsigned char* fedId() const { return fedId_.get(); }
@@ -0,0 +1,95 @@
+#ifndef HeterogeneousCore_SYCLCore_CachingAllocator_h
+#define HeterogeneousCore_SYCLCore_CachingAllocator_h
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <tuple>
+#include <unordered_map>
+
+#include <CL/sycl.hpp>
+
+namespace cms {
+  namespace sycltools {
+    // Caching allocator for SYCL USM (device, host and shared) memory,
+    // along the lines of notcub::CachingDeviceAllocator of the CUDA programs.
+    //
+    // The sizes of the blocks are rounded up to powers of binGrowth. A block
+    // that is freed is kept for the next allocation of the same bin, kind and
+    // device. The queues are in order, so the block can be reused right away
+    // on the queue it was freed on; on any other queue it is reused only once
+    // the work submitted before the free has completed.
+    //
+    // All the functions are thread safe.
+    class CachingAllocator {
+    public:
+      struct Statistics {
+        std::size_t requests = 0;     // calls to allocate()
+        std::size_t cacheHits = 0;    // allocations served by a cached block
+        std::size_t allocations = 0;  // calls to sycl::malloc()
+        std::size_t liveBlocks = 0;
+        std::size_t liveBytes = 0;
+        std::size_t cachedBlocks = 0;
+        std::size_t cachedBytes = 0;
+        std::size_t maxLiveBytes = 0;
+      };
+
+      // The allocations larger than binGrowth^maxBin bytes are not cached.
+      // maxCachedBytes limits the total size of the cached blocks, 0 means no limit.
+      CachingAllocator(unsigned int binGrowth,
+                       unsigned int minBin,
+                       unsigned int maxBin,
+                       std::size_t maxCachedBytes,
+                       bool debug = false);
+      // gives the cached blocks back to the SYCL runtime; the live blocks are left alone
+      ~CachingAllocator();
+
+      CachingAllocator(CachingAllocator const&) = delete;
+      CachingAllocator& operator=(CachingAllocator const&) = delete;
+
+      void* allocate(std::size_t bytes, sycl::queue queue, sycl::usm::alloc kind);
+
+      // the queue the block was allocated on is used for the stream-ordered reuse
+      void free(void* ptr);
+
+      // gives the cached blocks back to the SYCL runtime
+      void freeAllCached();
+
+      Statistics statistics() const;
+      void printStatistics(std::ostream& out) const;
+
+      std::size_t maxAllocationSize() const { return maxBinBytes_; }
+
+    private:
+      struct Block {
+        void* ptr = nullptr;
+        std::size_t bytes = 0;
+        unsigned int bin = 0;
+        sycl::usm::alloc kind = sycl::usm::alloc::unknown;
+        sycl::queue queue;
+        // signals when the queue has run to the point at which the block was freed
+        std::optional<sycl::event> ready;
+      };
+
+      // the bin of the allocation, and its size rounded up to the bin
+      std::tuple<unsigned int, std::size_t> bin(std::size_t bytes) const;
+      void release(Block& block) const;
+
+      const unsigned int binGrowth_;
+      const unsigned int minBin_;
+      const std::size_t minBinBytes_;
+      const std::size_t maxBinBytes_;
+      const std::size_t maxCachedBytes_;
+      const bool debug_;
+
+      mutable std::mutex mutex_;
+      std::unordered_map<void*, Block> liveBlocks_;
+      std::multimap<std::tuple<sycl::usm::alloc, unsigned int>, Block> cachedBlocks_;
+      Statistics stats_;
+    };
+  }  // namespace sycltools
+}  // namespace cms
+
+#endif
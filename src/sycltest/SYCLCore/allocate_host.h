@@ -0,0 +1,16 @@
+#ifndef HeterogeneousCore_SYCLCore_allocate_host_h
+#define HeterogeneousCore_SYCLCore_allocate_host_h
+
+#include <CL/sycl.hpp>
+
+namespace cms {
+  namespace sycltools {
+    // Allocate pinned host memory
+    void *allocate_host(size_t nbytes, sycl::queue stream);
+
+    // Free pinned host memory (to be called from unique_ptr)
+    void free_host(void *ptr, sycl::queue stream);
+  }  // namespace sycltools
+}  // namespace cms
+
+#endif
@@ -7,6 +7,8 @@
 
 #include <CL/sycl.hpp>
 
+#include "SYCLCore/allocate_device.h"
+
 namespace cms {
   namespace sycltools {
     namespace device {
@@ -19,7 +21,7 @@ namespace cms {
 
           void operator()(void *ptr) {
             if (stream_) {
-              sycl::free(ptr, *stream_);
+              free_device(ptr, *stream_);
             }
           }
 
@@ -51,7 +53,7 @@ namespace cms {
     typename device::impl::make_device_unique_selector<T>::non_array make_device_unique(sycl::queue stream) {
       static_assert(std::is_trivially_constructible<T>::value,
                     "Allocating with non-trivial constructor on the device memory is not supported");
-      void *mem = sycl::malloc_device(sizeof(T), stream);
+      void *mem = allocate_device(sizeof(T), stream);
       return typename device::impl::make_device_unique_selector<T>::non_array{reinterpret_cast<T *>(mem),
                                                                               device::impl::DeviceDeleter{stream}};
     }
@@ -62,7 +64,7 @@ namespace cms {
       using element_type = typename std::remove_extent<T>::type;
       static_assert(std::is_trivially_constructible<element_type>::value,
                     "Allocating with non-trivial constructor on the device memory is not supported");
-      void *mem = sycl::malloc_device(n * sizeof(element_type), stream);
+      void *mem = allocate_device(n * sizeof(element_type), stream);
       return typename device::impl::make_device_unique_selector<T>::unbounded_array{
           reinterpret_cast<element_type *>(mem), device::impl::DeviceDeleter{stream}};
     }
@@ -74,7 +76,7 @@ namespace cms {
     template <typename T>
     typename device::impl::make_device_unique_selector<T>::non_array make_device_unique_uninitialized(
         sycl::queue stream) {
-      void *mem = sycl::malloc_device(sizeof(T), stream);
+      void *mem = allocate_device(sizeof(T), stream);
       return typename device::impl::make_device_unique_selector<T>::non_array{reinterpret_cast<T *>(mem),
                                                                               device::impl::DeviceDeleter{stream}};
     }
@@ -83,7 +85,7 @@ namespace cms {
     typename device::impl::make_device_unique_selector<T>::unbounded_array make_device_unique_uninitialized(
         size_t n, sycl::queue stream) {
       using element_type = typename std::remove_extent<T>::type;
-      void *mem = sycl::malloc_device(n * sizeof(element_type), stream);
+      void *mem = allocate_device(n * sizeof(element_type), stream);
       return typename device::impl::make_device_unique_selector<T>::unbounded_array{
           reinterpret_cast<element_type *>(mem), device::impl::DeviceDeleter{stream}};
     }
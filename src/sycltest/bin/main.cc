@@ -10,6 +10,7 @@
 #include <tbb/task_scheduler_init.h>
 
 #include "SYCLCore/chooseDevice.h"
+#include "SYCLCore/getCachingAllocator.h"
 #include "EventProcessor.h"
 
 namespace {
@@ -142,6 +143,13 @@ int main(int argc, char** argv) try {
   auto time = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1e6;
   std::cout << "Processed " << maxEvents << " events in " << std::scientific << time << " seconds, throughput "
             << std::defaultfloat << (maxEvents / time) << " events/s." << std::endl;
+
+  // Report the allocator statistics, and give the cached memory back to the SYCL runtime
+  if constexpr (cms::sycltools::allocator::useCaching) {
+    auto& allocator = cms::sycltools::allocator::getCachingAllocator();
+    allocator.printStatistics(std::cout);
+    allocator.freeAllCached();
+  }
   return EXIT_SUCCESS;
 } catch (sycl::exception const& exc) {
   std::cerr << exc.what() << "Exception caught at file:" << __FILE__ << ", line:" << __LINE__ << std::endl;
@@ -0,0 +1,63 @@
+#include <cassert>
+#include <iostream>
+
+#include <CL/sycl.hpp>
+
+#include "SYCLCore/CachingAllocator.h"
+
+int main() {
+  sycl::queue queue{sycl::property::queue::in_order()};
+  sycl::queue other{queue.get_device(), sycl::property::queue::in_order()};
+
+  // bins of 8^1 ... 8^4 bytes, no limit on the cached bytes
+  cms::sycltools::CachingAllocator allocator{8, 1, 4, 0};
+  assert(4096 == allocator.maxAllocationSize());
+
+  void* first = allocator.allocate(100, queue, sycl::usm::alloc::device);
+  assert(first != nullptr);
+  allocator.free(first);
+  auto stats = allocator.statistics();
+  assert(1 == stats.allocations and 1 == stats.cachedBlocks and 512 == stats.cachedBytes);
+
+  // same bin and kind on the same queue, the block is reused right away
+  void* second = allocator.allocate(500, queue, sycl::usm::alloc::device);
+  assert(second == first);
+  assert(1 == allocator.statistics().cacheHits);
+
+  // a different kind or bin needs a new block
+  void* host = allocator.allocate(500, queue, sycl::usm::alloc::host);
+  void* small = allocator.allocate(10, queue, sycl::usm::alloc::device);
+  assert(host != first and small != first);
+  stats = allocator.statistics();
+  assert(3 == stats.allocations and 3 == stats.liveBlocks and 512 + 512 + 64 == stats.liveBytes);
+
+  // another queue reuses the block once the work submitted before the free has completed
+  allocator.free(second);
+  queue.wait();
+  void* third = allocator.allocate(200, other, sycl::usm::alloc::device);
+  assert(third == first);
+
+  allocator.free(third);
+  allocator.free(host);
+  allocator.free(small);
+  stats = allocator.statistics();
+  assert(5 == stats.requests and 2 == stats.cacheHits);
+  assert(0 == stats.liveBlocks and 3 == stats.cachedBlocks);
+  assert(512 + 512 + 64 == stats.maxLiveBytes);
+
+  // too large allocations are not supported
+  bool thrown = false;
+  try {
+    allocator.allocate(4097, queue, sycl::usm::alloc::shared);
+  } catch (std::runtime_error const&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  allocator.printStatistics(std::cout);
+  allocator.freeAllCached();
+  assert(0 == allocator.statistics().cachedBytes);
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}